@@ -0,0 +1,384 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/eigenBasis.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+namespace internal {
+
+namespace {
+
+    //
+    //  Indices of the points around the extraordinary vertex (see eigenBasis.h),
+    //  the nine additional points required by the three regular sub-patches of
+    //  the child following the K points:
+    //
+    inline int vertexPoint()             { return 0; }
+    inline int edgePoint(int N, int j)   { return 1 + 2 * ((j + N) % N); }
+    inline int facePoint(int N, int j)   { return 2 + 2 * ((j + N) % N); }
+    inline int outerPoint(int N, int i)  { return 2 * N + 1 + i; }
+    inline int extraPoint(int N, int i)  { return 2 * N + 8 + i; }
+
+    //
+    //  Catmark rules for smooth interior points, the first two arguments of the
+    //  edge rule being the end points of the edge and those of the vertex rule
+    //  its edge-adjacent and diagonal neighbors:
+    //
+    void
+    setFaceRule(double * row, int f0, int f1, int f2, int f3) {
+        row[f0] += 0.25;  row[f1] += 0.25;  row[f2] += 0.25;  row[f3] += 0.25;
+    }
+
+    void
+    setEdgeRule(double * row, int e0, int e1, int f0, int f1, int f2, int f3) {
+        row[e0] += 0.375;  row[e1] += 0.375;
+        row[f0] += 0.0625; row[f1] += 0.0625; row[f2] += 0.0625; row[f3] += 0.0625;
+    }
+
+    void
+    setVertexRule(double * row, int v, int e0, int e1, int e2, int e3,
+                                       int d0, int d1, int d2, int d3) {
+        double const eWeight = 3.0 / 32.0;
+        double const dWeight = 1.0 / 64.0;
+
+        row[v] += 9.0 / 16.0;
+        row[e0] += eWeight;  row[e1] += eWeight;  row[e2] += eWeight;  row[e3] += eWeight;
+        row[d0] += dWeight;  row[d1] += dWeight;  row[d2] += dWeight;  row[d3] += dWeight;
+    }
+
+    //
+    //  The (K + 9) x K matrix of one level of subdivision, the first K rows of
+    //  which form the square subdivision matrix:
+    //
+    void
+    computeSubdivisionMatrix(int N, std::vector<double> & matrix) {
+
+        int const K = 2 * N + 8;
+
+        matrix.assign((K + 9) * K, 0.0);
+
+        double * row = &matrix[vertexPoint() * K];
+        row[vertexPoint()] = (4.0 * N - 7.0) / (4.0 * N);
+        for (int j = 0; j < N; ++j) {
+            row[edgePoint(N, j)] = 3.0 / (2.0 * N * N);
+            row[facePoint(N, j)] = 1.0 / (4.0 * N * N);
+        }
+
+        int const V = vertexPoint();
+        for (int j = 0; j < N; ++j) {
+            setEdgeRule(&matrix[edgePoint(N, j) * K], V, edgePoint(N, j),
+                        edgePoint(N, j-1), facePoint(N, j-1), facePoint(N, j), edgePoint(N, j+1));
+            setFaceRule(&matrix[facePoint(N, j) * K], V, edgePoint(N, j),
+                        facePoint(N, j), edgePoint(N, j+1));
+        }
+
+        int const E0 = edgePoint(N, 0), E1 = edgePoint(N, 1), E2 = edgePoint(N, 2),
+                  EN = edgePoint(N, N-1);
+        int const F0 = facePoint(N, 0), F1 = facePoint(N, 1), FN = facePoint(N, N-1);
+
+        int O[7];
+        for (int i = 0; i < 7; ++i) {
+            O[i] = outerPoint(N, i);
+        }
+
+        setEdgeRule  (&matrix[O[0] * K], E0, FN, V, EN, O[0], O[1]);
+        setVertexRule(&matrix[O[1] * K], E0, V, O[1], F0, FN, E1, O[2], O[0], EN);
+        setEdgeRule  (&matrix[O[2] * K], E0, F0, V, E1, O[1], O[2]);
+        setVertexRule(&matrix[O[3] * K], F0, E0, O[2], O[4], E1, V, O[1], O[3], O[5]);
+        setEdgeRule  (&matrix[O[4] * K], F0, E1, V, E0, O[4], O[5]);
+        setVertexRule(&matrix[O[5] * K], E1, V, F0, O[5], F1, E0, O[4], O[6], E2);
+        setEdgeRule  (&matrix[O[6] * K], E1, F1, V, E2, O[5], O[6]);
+
+        setFaceRule(&matrix[extraPoint(N, 0) * K], FN, O[0], O[1], E0);
+        setEdgeRule(&matrix[extraPoint(N, 1) * K], E0, O[1], FN, O[0], O[2], F0);
+        setFaceRule(&matrix[extraPoint(N, 2) * K], E0, O[1], O[2], F0);
+        setEdgeRule(&matrix[extraPoint(N, 3) * K], F0, O[2], E0, O[1], O[3], O[4]);
+        setFaceRule(&matrix[extraPoint(N, 4) * K], F0, O[2], O[3], O[4]);
+        setEdgeRule(&matrix[extraPoint(N, 5) * K], F0, O[4], O[2], O[3], E1, O[5]);
+        setFaceRule(&matrix[extraPoint(N, 6) * K], E1, F0, O[4], O[5]);
+        setEdgeRule(&matrix[extraPoint(N, 7) * K], E1, O[5], F0, O[4], F1, O[6]);
+        setFaceRule(&matrix[extraPoint(N, 8) * K], F1, E1, O[5], O[6]);
+    }
+
+    //
+    //  The eigen values of the subdivision matrix follow in closed form from its
+    //  block structure:  the 2N+1 of the extraordinary vertex and its ring, which
+    //  decouple into frequencies of the discrete Fourier transform around the
+    //  vertex, and the seven of the outer points, those of a regular corner:
+    //
+    void
+    computeEigenValues(int N, std::vector<double> & eigenValues) {
+
+        eigenValues.clear();
+
+        //  Frequency 0 -- the 3 x 3 matrix acting on the vertex, edge and face
+        //  points, one of whose eigen values is 1:
+        double const m00 = (4.0 * N - 7.0) / (4.0 * N);
+        double const trace = m00 + 0.5 + 0.25;
+        double const det = m00 * (0.5 * 0.25 - 0.125 * 0.5)
+                         - (3.0 / (2.0 * N)) * (0.375 * 0.25 - 0.125 * 0.25)
+                         + (1.0 / (4.0 * N)) * (0.375 * 0.5 - 0.5 * 0.25);
+        double const sum = trace - 1.0;
+        double const product = det;
+        double const disc0 = std::sqrt(std::max(0.0, sum * sum - 4.0 * product));
+
+        eigenValues.push_back(1.0);
+        eigenValues.push_back(0.5 * (sum + disc0));
+        eigenValues.push_back(0.5 * (sum - disc0));
+
+        //  Frequencies 0 < w < N/2 -- 2 x 2 matrices acting on the edge and face
+        //  points, each eigen value shared by a cosine and a sine mode:
+        for (int w = 1; 2 * w < N; ++w) {
+            double const cosTheta = std::cos(2.0 * M_PI * w / N);
+
+            double const a  = 0.375 + 0.125 * cosTheta;
+            double const d  = 0.25;
+            double const bc = (1.0 + cosTheta) / 32.0;
+            double const disc = std::sqrt((a - d) * (a - d) + 4.0 * bc);
+
+            for (int m = 0; m < 2; ++m) {
+                eigenValues.push_back(0.5 * (a + d + disc));
+                eigenValues.push_back(0.5 * (a + d - disc));
+            }
+        }
+
+        //  Frequency N/2 (even valence) -- alternating edge or face points:
+        if ((N & 1) == 0) {
+            eigenValues.push_back(0.25);
+            eigenValues.push_back(0.25);
+        }
+
+        //  The outer points of the regular corner:
+        double const outer[7] = { 1.0 / 8.0,  1.0 / 8.0,  1.0 / 16.0, 1.0 / 16.0,
+                                  1.0 / 32.0, 1.0 / 32.0, 1.0 / 64.0 };
+        eigenValues.insert(eigenValues.end(), outer, outer + 7);
+
+        assert((int)eigenValues.size() == 2 * N + 8);
+    }
+
+    //
+    //  Reduces the n x n matrix m (stored by row) to reduced row echelon form,
+    //  treating pivots below the tolerance as zero -- returns the rank and the
+    //  pivot column of each of the leading rows:
+    //
+    int
+    reduceToRowEchelon(int n, double * m, double tolerance, int * pivotColumns) {
+
+        int rank = 0;
+        for (int col = 0; (col < n) && (rank < n); ++col) {
+            int pivot = rank;
+            for (int i = rank + 1; i < n; ++i) {
+                if (std::abs(m[i*n + col]) > std::abs(m[pivot*n + col])) pivot = i;
+            }
+            if (std::abs(m[pivot*n + col]) <= tolerance) continue;
+
+            if (pivot != rank) {
+                std::swap_ranges(&m[pivot*n], &m[pivot*n] + n, &m[rank*n]);
+            }
+            double const scale = 1.0 / m[rank*n + col];
+            for (int j = 0; j < n; ++j) {
+                m[rank*n + j] *= scale;
+            }
+            for (int i = 0; i < n; ++i) {
+                double const factor = m[i*n + col];
+                if ((i == rank) || (factor == 0.0)) continue;
+                for (int j = 0; j < n; ++j) {
+                    m[i*n + j] -= factor * m[rank*n + j];
+                }
+            }
+            pivotColumns[rank++] = col;
+        }
+        return rank;
+    }
+
+    //
+    //  Inverts the n x n matrix m (stored by row) by Gauss-Jordan elimination with
+    //  partial pivoting -- returns false if the matrix is (nearly) singular:
+    //
+    bool
+    invertMatrix(int n, std::vector<double> m, std::vector<double> & inverse) {
+
+        inverse.assign(n * n, 0.0);
+        for (int i = 0; i < n; ++i) {
+            inverse[i*n + i] = 1.0;
+        }
+
+        for (int col = 0; col < n; ++col) {
+            int pivot = col;
+            for (int i = col + 1; i < n; ++i) {
+                if (std::abs(m[i*n + col]) > std::abs(m[pivot*n + col])) pivot = i;
+            }
+            if (std::abs(m[pivot*n + col]) < 1.0e-12) return false;
+
+            if (pivot != col) {
+                std::swap_ranges(&m[pivot*n], &m[pivot*n] + n, &m[col*n]);
+                std::swap_ranges(&inverse[pivot*n], &inverse[pivot*n] + n, &inverse[col*n]);
+            }
+            double const scale = 1.0 / m[col*n + col];
+            for (int j = 0; j < n; ++j) {
+                m[col*n + j] *= scale;
+                inverse[col*n + j] *= scale;
+            }
+            for (int i = 0; i < n; ++i) {
+                double const factor = m[i*n + col];
+                if ((i == col) || (factor == 0.0)) continue;
+                for (int j = 0; j < n; ++j) {
+                    m[i*n + j] -= factor * m[col*n + j];
+                    inverse[i*n + j] -= factor * inverse[col*n + j];
+                }
+            }
+        }
+        return true;
+    }
+
+    //
+    //  Points of the child at positions (X,Y) relative to the extraordinary
+    //  vertex -- from which the three regular sub-patches are gathered:
+    //
+    int
+    getChildPoint(int N, int X, int Y) {
+
+        switch (Y) {
+        case -1: { int const p[5] = { -1, edgePoint(N, N-1), facePoint(N, N-1),
+                                      outerPoint(N, 0), extraPoint(N, 0) };
+                   return p[X+1]; }
+        case  0: { int const p[5] = { edgePoint(N, 2), vertexPoint(), edgePoint(N, 0),
+                                      outerPoint(N, 1), extraPoint(N, 1) };
+                   return p[X+1]; }
+        case  1: { int const p[5] = { facePoint(N, 1), edgePoint(N, 1), facePoint(N, 0),
+                                      outerPoint(N, 2), extraPoint(N, 2) };
+                   return p[X+1]; }
+        case  2: { int const p[5] = { outerPoint(N, 6), outerPoint(N, 5), outerPoint(N, 4),
+                                      outerPoint(N, 3), extraPoint(N, 3) };
+                   return p[X+1]; }
+        case  3: { int const p[5] = { extraPoint(N, 8), extraPoint(N, 7), extraPoint(N, 6),
+                                      extraPoint(N, 5), extraPoint(N, 4) };
+                   return p[X+1]; }
+        }
+        assert(0);
+        return -1;
+    }
+} // end namespace
+
+bool
+EigenBasis::Initialize(int valence) {
+
+    assert(valence >= 3);
+
+    int const N = valence;
+    int const K = 2 * N + 8;
+
+    _valence = 0;
+
+    std::vector<double> subdivision;
+    computeSubdivisionMatrix(N, subdivision);
+
+    std::vector<double> eigenValues;
+    computeEigenValues(N, eigenValues);
+    std::sort(eigenValues.begin(), eigenValues.end(), std::greater<double>());
+
+    //
+    //  Identify the eigen vectors of each distinct eigen value as the null space
+    //  of A - lambda I, which must match its multiplicity for the subdivision
+    //  matrix to be diagonalizable:
+    //
+    std::vector<double> eigenVectors(K * K, 0.0);
+    std::vector<double> reduced(K * K);
+    std::vector<int>    pivotColumns(K);
+
+    _eigenValues.resize(K);
+
+    int numEigenVectors = 0;
+    for (int i = 0; i < K; ) {
+        int multiplicity = 1;
+        while ((i + multiplicity < K) &&
+               (eigenValues[i] - eigenValues[i + multiplicity] < 1.0e-9)) {
+            ++multiplicity;
+        }
+        double const lambda = eigenValues[i + multiplicity / 2];
+
+        std::copy(subdivision.begin(), subdivision.begin() + K * K, reduced.begin());
+        for (int j = 0; j < K; ++j) {
+            reduced[j*K + j] -= lambda;
+        }
+        int rank = reduceToRowEchelon(K, &reduced[0], 1.0e-9, &pivotColumns[0]);
+        if (K - rank != multiplicity) return false;
+
+        for (int col = 0, r = 0; col < K; ++col) {
+            if ((r < rank) && (pivotColumns[r] == col)) {
+                ++r;
+                continue;
+            }
+            eigenVectors[col*K + numEigenVectors] = 1.0;
+            for (int p = 0; p < rank; ++p) {
+                eigenVectors[pivotColumns[p]*K + numEigenVectors] = -reduced[p*K + col];
+            }
+            _eigenValues[numEigenVectors++] = lambda;
+        }
+        i += multiplicity;
+    }
+    assert(numEigenVectors == K);
+
+    if (!invertMatrix(K, eigenVectors, _inverseEigenVectors)) return false;
+
+    //
+    //  The eigen functions are the points of the three sub-patches of the child
+    //  for each eigen vector, i.e. rows of the (K + 9) x K subdivision matrix
+    //  multiplied by the eigen vectors:
+    //
+    _eigenFunctions.assign(3 * 16 * K, 0.0);
+    for (int k = 0; k < 3; ++k) {
+        int const xOffset = (k == 2) ? -1 : 0;
+        int const yOffset = (k == 0) ? -1 : 0;
+
+        for (int p = 0; p < 16; ++p) {
+            int const point = getChildPoint(N, (p & 3) + xOffset, (p >> 2) + yOffset);
+
+            double const * row = &subdivision[point * K];
+            double * dst = &_eigenFunctions[(k * 16 + p) * K];
+            for (int m = 0; m < K; ++m) {
+                if (row[m] == 0.0) continue;
+                for (int i = 0; i < K; ++i) {
+                    dst[i] += row[m] * eigenVectors[m*K + i];
+                }
+            }
+        }
+    }
+
+    _valence = valence;
+    return true;
+}
+
+} // end namespace internal
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,114 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_EIGEN_BASIS_H
+#define OPENSUBDIV3_FAR_EIGEN_BASIS_H
+
+#include "../version.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+namespace internal {
+
+//
+//  Eigen structure of Catmark subdivision around an isolated extraordinary
+//  vertex, used for the exact evaluation of the limit surface of a quad at any
+//  parameter value (J. Stam, "Exact Evaluation of Catmull-Clark Subdivision
+//  Surfaces at Arbitrary Parameter Values", SIGGRAPH 1998).
+//
+//  The limit surface of a quad whose only extraordinary vertex V (of valence N)
+//  is smooth and interior, and whose other three vertices are smooth, interior
+//  and regular, is defined by the K = 2N+8 points surrounding it.  One level of
+//  subdivision transforms these into the K points of the child quad at V (the
+//  subdivision matrix A) and into the points of three regular B-spline patches
+//  covering the remainder of the quad.  Evaluation at any depth then reduces to
+//  a sum over the eigen vectors of A, each scaled by the power of its eigen
+//  value.
+//
+//  The K points are ordered as follows -- the 2N points of the ring around V
+//  alternating between edge (E) and face (F) neighbors, followed by the seven
+//  outer points (O) of the three regular corners:
+//
+//      O6 ----- O5 ----- O4 ----- O3
+//       |        |        |        |
+//       |        |        |        |
+//      F1 ----- E1 ----- F0 ----- O2
+//       |        | quad   |        |
+//       |        |        |        |
+//      E2 ------ V ----- E0 ----- O1
+//          .     |        |        |
+//            .   |        |        |
+//              E[N-1] -- F[N-1] - O0
+//
+//  with V at index 0, E[j] at 1+2j, F[j] at 2+2j and O[i] at 2N+1+i.  The face
+//  (V, E[j], F[j], E[j+1]) is the j-th face around V, and the quad is oriented
+//  with V at the origin, E0 along u and E1 along v.
+//
+class EigenBasis {
+public:
+    EigenBasis() : _valence(0) { }
+
+    //  Computes the eigen structure for the given valence (at least 3) -- returns
+    //  false if it could not be computed reliably
+    bool Initialize(int valence);
+
+    int GetValence() const { return _valence; }
+
+    int GetNumControlVertices() const { return 2 * _valence + 8; }
+
+    //  The K eigen values of the subdivision matrix
+    double const * GetEigenValues() const { return &_eigenValues[0]; }
+
+    //  The K x K inverse of the matrix of eigen vectors, i.e. the rows map the
+    //  K points to the coefficients of each eigen vector
+    double const * GetInverseEigenVectors() const { return &_inverseEigenVectors[0]; }
+
+    //  The 16 points of B-spline sub-patch k (0 to the right of the child quad
+    //  at V, 1 diagonal and 2 above it) for each eigen vector, i.e. 16 rows of
+    //  K coefficients ordered as the points of a regular patch
+    double const * GetEigenFunctions(int k) const {
+        return &_eigenFunctions[k * 16 * GetNumControlVertices()];
+    }
+
+private:
+    int _valence;
+
+    std::vector<double> _eigenValues;
+    std::vector<double> _inverseEigenVectors;
+    std::vector<double> _eigenFunctions;
+};
+
+} // end namespace internal
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_EIGEN_BASIS_H */
@@ -82,6 +82,23 @@ EndCapBSplineBasisPatchFactory::GetPatchPoints(
     Vtr::internal::Level::VSpan const cornerSpans[],
     int levelVertOffset, int fvarChannel) {
 
+    int numPrevPoints = _numVertices;
+
+    ConstIndexArray cvs = AssignPatchPoints(
+        level, thisFace, cornerSpans, levelVertOffset, fvarChannel);
+
+    AppendPatchPointStencils(level, thisFace, cornerSpans,
+        levelVertOffset, fvarChannel, cvs, numPrevPoints,
+        _vertexStencils, _varyingStencils);
+    return cvs;
+}
+
+int
+EndCapBSplineBasisPatchFactory::getIrregularCorner(
+    Vtr::internal::Level const * level, Index thisFace,
+    Vtr::internal::Level::VSpan const cornerSpans[],
+    int fvarChannel) const {
+
     //
     //  We can only use a faster method directly with B-Splines when we have a
     //  single interior irregular corner.  We defer to an intermediate Gregory
@@ -112,35 +129,91 @@ EndCapBSplineBasisPatchFactory::GetPatchPoints(
             }
         }
     }
-
-    if (useGregoryPatch) {
-        return getPatchPointsFromGregoryBasis(
-            level, thisFace, cornerSpans, facePoints,
-            levelVertOffset, fvarChannel);
-    } else {
-        return getPatchPoints(
-            level, thisFace, irregCornerIndex, facePoints,
-            levelVertOffset, fvarChannel);
-    }
+    return useGregoryPatch ? -1 : irregCornerIndex;
 }
 
 ConstIndexArray
-EndCapBSplineBasisPatchFactory::getPatchPointsFromGregoryBasis(
+EndCapBSplineBasisPatchFactory::AssignPatchPoints(
     Vtr::internal::Level const * level, Index thisFace,
     Vtr::internal::Level::VSpan const cornerSpans[],
-    ConstIndexArray facePoints, int levelVertOffset, int fvarChannel) {
-
-    // XXX: For now, always create new 16 indices for each patch.
-    // we'll optimize later to share all regular control points with
-    // other patches as well as try to make extra-ordinary verts watertight.
+    int levelVertOffset, int fvarChannel) {
 
     int offset = (fvarChannel < 0)
                ? _refiner->GetNumVerticesTotal()
                : _refiner->GetNumFVarValuesTotal(fvarChannel);
-    for (int i = 0; i < 16; ++i) {
-        _patchPoints.push_back(_numVertices + offset);
-        ++_numVertices;
+
+    int vid = getIrregularCorner(level, thisFace, cornerSpans, fvarChannel);
+
+    if (vid < 0) {
+        // XXX: For now, always create new 16 indices for each patch.
+        // we'll optimize later to share all regular control points with
+        // other patches as well as try to make extra-ordinary verts watertight.
+        for (int i = 0; i < 16; ++i) {
+            _patchPoints.push_back(_numVertices + offset);
+            ++_numVertices;
+        }
+    } else {
+        int patchPoints[16];
+        gatherPatchPoints(level, thisFace, vid, level->getFaceVertices(thisFace),
+                          levelVertOffset, patchPoints);
+
+        // patch points are assigned in the order of their stencils
+        // (Em) 6, 7, 8, (Ep) 4, 15, 14, (P) 5
+        patchPoints[3* vid + 6]        = (_numVertices++) + offset;
+        patchPoints[3*((vid+1)%4) + 4] = (_numVertices++) + offset;
+        patchPoints[3*((vid+1)%4) + 5] = (_numVertices++) + offset;
+        patchPoints[3* vid + 4]        = (_numVertices++) + offset;
+        patchPoints[3*((vid+3)%4) + 6] = (_numVertices++) + offset;
+        patchPoints[3*((vid+3)%4) + 5] = (_numVertices++) + offset;
+        patchPoints[3*vid + 5]         = (_numVertices++) + offset;
+
+        // reorder into UV row-column
+        static int const permuteRegular[16] =
+            { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
+        for (int i = 0; i < 16; ++i) {
+            _patchPoints.push_back(patchPoints[permuteRegular[i]]);
+        }
     }
+    ++_numPatches;
+    return ConstIndexArray(&_patchPoints[(_numPatches-1)*16], 16);
+}
+
+void
+EndCapBSplineBasisPatchFactory::AppendPatchPointStencils(
+    Vtr::internal::Level const * level, Index thisFace,
+    Vtr::internal::Level::VSpan const cornerSpans[],
+    int levelVertOffset, int fvarChannel,
+    ConstIndexArray /* patchPoints */, int /* numPrevPoints */,
+    StencilTable * vertexStencils, StencilTable * varyingStencils) const {
+
+    Vtr::ConstIndexArray facePoints = level->getFaceVertices(thisFace);
+
+    int vid = getIrregularCorner(level, thisFace, cornerSpans, fvarChannel);
+
+    if (vid < 0) {
+        appendGregoryBasisStencils(
+            level, thisFace, cornerSpans, facePoints,
+            levelVertOffset, fvarChannel, vertexStencils, varyingStencils);
+    } else {
+        //  The stencils combine the points gathered from the topology, some
+        //  of which are replaced by the new points in the patch:
+        int patchPoints[16];
+        gatherPatchPoints(level, thisFace, vid, facePoints,
+                          levelVertOffset, patchPoints);
+
+        appendPatchPointStencils(
+            level, vid, facePoints, patchPoints,
+            levelVertOffset, fvarChannel, vertexStencils, varyingStencils);
+    }
+}
+
+void
+EndCapBSplineBasisPatchFactory::appendGregoryBasisStencils(
+    Vtr::internal::Level const * level, Index thisFace,
+    Vtr::internal::Level::VSpan const cornerSpans[],
+    ConstIndexArray facePoints, int levelVertOffset, int fvarChannel,
+    StencilTable * vertexStencils, StencilTable * varyingStencils) const {
+
     GregoryBasis::ProtoBasis basis(*level, thisFace, cornerSpans, levelVertOffset, fvarChannel);
     // XXX: temporary hack. we should traverse topology and find existing
     //      vertices if available
@@ -195,31 +268,28 @@ EndCapBSplineBasisPatchFactory::getPatchPointsFromGregoryBasis(
                     p.AddWithWeight(H[i*4+k], Q[j][k]);
                 }
             }
-            GregoryBasis::AppendToStencilTable(p, _vertexStencils);
+            GregoryBasis::AppendToStencilTable(p, vertexStencils);
         }
     }
-    if (_varyingStencils) {
+    if (varyingStencils) {
         int varyingIndices[] = { 0, 0, 1, 1,
                                  0, 0, 1, 1,
                                  3, 3, 2, 2,
                                  3, 3, 2, 2,};
         for (int i = 0; i < 16; ++i) {
             int varyingIndex = facePoints[varyingIndices[i]] + levelVertOffset;
-            _varyingStencils->_sizes.push_back(1);
-            _varyingStencils->_indices.push_back(varyingIndex);
-            _varyingStencils->_weights.push_back(1.0f);
+            varyingStencils->_sizes.push_back(1);
+            varyingStencils->_indices.push_back(varyingIndex);
+            varyingStencils->_weights.push_back(1.0f);
         }
     }
-
-    ++_numPatches;
-    return ConstIndexArray(&_patchPoints[(_numPatches-1)*16], 16);
 }
 
 void
 EndCapBSplineBasisPatchFactory::computeLimitStencils(
     Vtr::internal::Level const *level,
     ConstIndexArray facePoints, int vid, int fvarChannel,
-    GregoryBasis::Point *P, GregoryBasis::Point *Ep, GregoryBasis::Point *Em)
+    GregoryBasis::Point *P, GregoryBasis::Point *Ep, GregoryBasis::Point *Em) const
 {
     int maxvalence = level->getMaxValence();
 
@@ -288,11 +358,11 @@ EndCapBSplineBasisPatchFactory::computeLimitStencils(
     Em->AddWithWeight(e1, sinf((float(2*M_PI) * float(prev)/float(valence))));
 }
 
-ConstIndexArray
-EndCapBSplineBasisPatchFactory::getPatchPoints(
+void
+EndCapBSplineBasisPatchFactory::gatherPatchPoints(
     Vtr::internal::Level const *level, Index thisFace,
     Index extraOrdinaryIndex, ConstIndexArray facePoints,
-    int levelVertOffset, int fvarChannel) {
+    int levelVertOffset, int patchPoints[16]) const {
 
     //  Fast B-spline endcap construction.
     //
@@ -316,25 +386,7 @@ EndCapBSplineBasisPatchFactory::getPatchPoints(
     //                                 Fitted patch points
     //                                   (from limit tangents and bezier CP)
     //
-    static int const rotation[4][16] = {
-        /*= 0 ring =*/ /* ================ 1 ring ================== */
-        { 0, 1, 2, 3,    4,  5,  6,  7,  8,  9, 10, 11, 12, 13 ,14, 15},
-        { 1, 2, 3, 0,    7,  8,  9, 10, 11, 12, 13, 14, 15,  4,  5,  6},
-        { 2, 3, 0, 1,   10, 11, 12, 13, 14, 15,  4,  5,  6,  7,  8,  9},
-        { 3, 0, 1, 2,   13, 14, 15,  4,  5,  6,  7,  8,  9, 10, 11, 12}};
-
-    int maxvalence = level->getMaxValence();
-    int stencilCapacity = 2*maxvalence + 16;
-    GregoryBasis::Point P(stencilCapacity), Em(stencilCapacity), Ep(stencilCapacity);
-
-    computeLimitStencils(level, facePoints, extraOrdinaryIndex, fvarChannel, &P, &Em, &Ep);
-    P.OffsetIndices(levelVertOffset);
-    Em.OffsetIndices(levelVertOffset);
-    Ep.OffsetIndices(levelVertOffset);
-
     // returning patch indices (a mix of cage vertices and patch points)
-    int patchPoints[16];
-
     // first, we traverse the topology to gather 15 vertices. This process is
     // similar to Vtr::Level::gatherQuadRegularInteriorPatchPoints
     int pointIndex = 0;
@@ -397,6 +449,33 @@ EndCapBSplineBasisPatchFactory::getPatchPoints(
             }
         }
     }
+}
+
+void
+EndCapBSplineBasisPatchFactory::appendPatchPointStencils(
+    Vtr::internal::Level const *level,
+    Index extraOrdinaryIndex, ConstIndexArray facePoints,
+    int const patchPoints[16],
+    int levelVertOffset, int fvarChannel,
+    StencilTable * vertexStencils, StencilTable * varyingStencils) const {
+
+    static int const rotation[4][16] = {
+        /*= 0 ring =*/ /* ================ 1 ring ================== */
+        { 0, 1, 2, 3,    4,  5,  6,  7,  8,  9, 10, 11, 12, 13 ,14, 15},
+        { 1, 2, 3, 0,    7,  8,  9, 10, 11, 12, 13, 14, 15,  4,  5,  6},
+        { 2, 3, 0, 1,   10, 11, 12, 13, 14, 15,  4,  5,  6,  7,  8,  9},
+        { 3, 0, 1, 2,   13, 14, 15,  4,  5,  6,  7,  8,  9, 10, 11, 12}};
+
+    int vid = extraOrdinaryIndex;
+
+    int maxvalence = level->getMaxValence();
+    int stencilCapacity = 2*maxvalence + 16;
+    GregoryBasis::Point P(stencilCapacity), Em(stencilCapacity), Ep(stencilCapacity);
+
+    computeLimitStencils(level, facePoints, extraOrdinaryIndex, fvarChannel, &P, &Em, &Ep);
+    P.OffsetIndices(levelVertOffset);
+    Em.OffsetIndices(levelVertOffset);
+    Ep.OffsetIndices(levelVertOffset);
 
     // stencils for patch points
     GregoryBasis::Point X5(stencilCapacity),
@@ -481,65 +560,45 @@ EndCapBSplineBasisPatchFactory::getPatchPoints(
     // patch point stencils will be stored in this order
     // (Em) 6, 7, 8, (Ep) 4, 15, 14, (P) 5
 
-    int offset = (fvarChannel < 0)
-               ? _refiner->GetNumVerticesTotal()
-               : _refiner->GetNumFVarValuesTotal(fvarChannel);
-
     int varyingIndex0 = facePoints[vid] + levelVertOffset;
     int varyingIndex1 = facePoints[(vid+1)&3] + levelVertOffset;
     int varyingIndex3 = facePoints[(vid+3)&3] + levelVertOffset;
 
     // push back to stencils;
-    patchPoints[3* vid + 6]        = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X6, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex0, _varyingStencils);
-    }
-
-    patchPoints[3*((vid+1)%4) + 4] = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X7, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex1, _varyingStencils);
+    GregoryBasis::AppendToStencilTable(X6, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex0, varyingStencils);
     }
 
-    patchPoints[3*((vid+1)%4) + 5] = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X8, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex1, _varyingStencils);
+    GregoryBasis::AppendToStencilTable(X7, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex1, varyingStencils);
     }
 
-    patchPoints[3* vid + 4]        = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X4, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex0, _varyingStencils);
+    GregoryBasis::AppendToStencilTable(X8, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex1, varyingStencils);
     }
 
-    patchPoints[3*((vid+3)%4) + 6] = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X15, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex3, _varyingStencils);
+    GregoryBasis::AppendToStencilTable(X4, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex0, varyingStencils);
     }
 
-    patchPoints[3*((vid+3)%4) + 5] = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X14, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex3, _varyingStencils);
+    GregoryBasis::AppendToStencilTable(X15, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex3, varyingStencils);
     }
 
-    patchPoints[3*vid + 5]         = (_numVertices++) + offset;
-    GregoryBasis::AppendToStencilTable(X5, _vertexStencils);
-    if (_varyingStencils) {
-        GregoryBasis::AppendToStencilTable(varyingIndex0, _varyingStencils);
+    GregoryBasis::AppendToStencilTable(X14, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex3, varyingStencils);
     }
 
-    // reorder into UV row-column
-    static int const permuteRegular[16] =
-        { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
-    for (int i = 0; i < 16; ++i) {
-        _patchPoints.push_back(patchPoints[permuteRegular[i]]);
+    GregoryBasis::AppendToStencilTable(X5, vertexStencils);
+    if (varyingStencils) {
+        GregoryBasis::AppendToStencilTable(varyingIndex0, varyingStencils);
     }
-    ++_numPatches;
-    return ConstIndexArray(&_patchPoints[(_numPatches-1)*16], 16);
 }
 
 } // end namespace Far
@@ -81,22 +81,66 @@ public:
         Vtr::internal::Level::VSpan const cornerSpans[],
         int levelVertOffset, int fvarChannel = -1);
 
+    /// \brief Returns end patch point indices for \a faceIndex of \a level
+    ///        as GetPatchPoints() does, but without appending the stencils
+    ///        of its new points (see AppendPatchPointStencils())
+    ///
+    ConstIndexArray AssignPatchPoints(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel = -1);
+
+    /// \brief Appends the stencils of the points first assigned to a patch
+    ///        by AssignPatchPoints() to the given stencil tables. Only reads
+    ///        the factory, so patches may be processed concurrently.
+    ///
+    /// @param patchPoints      point indices returned for the patch
+    ///
+    /// @param numPrevPoints    GetNumPatchPoints() before the patch was
+    ///                         assigned its points (all points of a B-spline
+    ///                         end cap are new, so only checked)
+    ///
+    void AppendPatchPointStencils(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel,
+        ConstIndexArray patchPoints, int numPrevPoints,
+        StencilTable * vertexStencils, StencilTable * varyingStencils) const;
+
+    /// \brief Returns the number of end patch points assigned so far
+    int GetNumPatchPoints() const { return _numVertices; }
+
 private:
-    ConstIndexArray getPatchPointsFromGregoryBasis(
+    //  Returns the irregular corner of a patch with a single interior
+    //  irregular corner, or -1 when an intermediate Gregory patch is required
+    int getIrregularCorner(
+        Vtr::internal::Level const * level, Index thisFace,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int fvarChannel) const;
+
+    void appendGregoryBasisStencils(
         Vtr::internal::Level const * level, Index thisFace,
         Vtr::internal::Level::VSpan const cornerSpans[],
         ConstIndexArray facePoints,
-        int levelVertOffset, int fvarChannel);
+        int levelVertOffset, int fvarChannel,
+        StencilTable * vertexStencils, StencilTable * varyingStencils) const;
 
-    ConstIndexArray getPatchPoints(
+    void gatherPatchPoints(
         Vtr::internal::Level const *level, Index thisFace,
         Index extraOrdinaryIndex, ConstIndexArray facePoints,
-        int levelVertOffset, int fvarChannel);
+        int levelVertOffset, int patchPoints[16]) const;
+
+    void appendPatchPointStencils(
+        Vtr::internal::Level const *level,
+        Index extraOrdinaryIndex, ConstIndexArray facePoints,
+        int const patchPoints[16],
+        int levelVertOffset, int fvarChannel,
+        StencilTable * vertexStencils, StencilTable * varyingStencils) const;
 
     void computeLimitStencils(
         Vtr::internal::Level const *level,
         ConstIndexArray facePoints, int vid, int fvarChannel,
-        GregoryBasis::Point *P, GregoryBasis::Point *Ep, GregoryBasis::Point *Em);
+        GregoryBasis::Point *P, GregoryBasis::Point *Ep, GregoryBasis::Point *Em) const;
 
     StencilTable * _vertexStencils;
     StencilTable * _varyingStencils;
@@ -74,7 +74,9 @@ EndCapGregoryBasisPatchFactory::addPatchBasis(Vtr::internal::Level const & level
                                               Vtr::internal::Level::VSpan const cornerSpans[],
                                               bool verticesMask[4][5],
                                               int levelVertOffset,
-                                              int fvarChannel) {
+                                              int fvarChannel,
+                                              StencilTable * vertexStencils,
+                                              StencilTable * varyingStencils) const {
 
     // Gather the CVs that influence the Gregory patch and their relative
     // weights in a basis
@@ -82,33 +84,33 @@ EndCapGregoryBasisPatchFactory::addPatchBasis(Vtr::internal::Level const & level
 
     for (int i = 0; i < 4; ++i) {
         if (verticesMask[i][0]) {
-            GregoryBasis::AppendToStencilTable(basis.P[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+            GregoryBasis::AppendToStencilTable(basis.P[i], vertexStencils);
+            if (varyingStencils) {
+                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], varyingStencils);
             }
         }
         if (verticesMask[i][1]) {
-            GregoryBasis::AppendToStencilTable(basis.Ep[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+            GregoryBasis::AppendToStencilTable(basis.Ep[i], vertexStencils);
+            if (varyingStencils) {
+                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], varyingStencils);
             }
         }
         if (verticesMask[i][2]) {
-            GregoryBasis::AppendToStencilTable(basis.Em[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+            GregoryBasis::AppendToStencilTable(basis.Em[i], vertexStencils);
+            if (varyingStencils) {
+                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], varyingStencils);
             }
         }
         if (verticesMask[i][3]) {
-            GregoryBasis::AppendToStencilTable(basis.Fp[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+            GregoryBasis::AppendToStencilTable(basis.Fp[i], vertexStencils);
+            if (varyingStencils) {
+                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], varyingStencils);
             }
         }
         if (verticesMask[i][4]) {
-            GregoryBasis::AppendToStencilTable(basis.Fm[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+            GregoryBasis::AppendToStencilTable(basis.Fm[i], vertexStencils);
+            if (varyingStencils) {
+                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], varyingStencils);
             }
         }
     }
@@ -127,6 +129,23 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
     Vtr::internal::Level::VSpan const cornerSpans[],
     int levelVertOffset, int fvarChannel) {
 
+    int numPrevPoints = _numGregoryBasisVertices;
+
+    ConstIndexArray cvs = AssignPatchPoints(
+        level, faceIndex, cornerSpans, levelVertOffset, fvarChannel);
+
+    AppendPatchPointStencils(level, faceIndex, cornerSpans,
+        levelVertOffset, fvarChannel, cvs, numPrevPoints,
+        _vertexStencils, _varyingStencils);
+    return cvs;
+}
+
+ConstIndexArray
+EndCapGregoryBasisPatchFactory::AssignPatchPoints(
+    Vtr::internal::Level const * level, Index faceIndex,
+    Vtr::internal::Level::VSpan const /* cornerSpans */ [],
+    int /* levelVertOffset */, int fvarChannel) {
+
     // allocate indices (awkward)
     // assert(Vtr::INDEX_INVALID==0xFFFFFFFF);
     for (int i = 0; i < 20; ++i) {
@@ -220,31 +239,46 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
         _levelAndFaceIndices.push_back(LevelAndFaceIndex::create(levelIndex, faceIndex));
     }
 
-    bool newVerticesMask[4][5];
-    for (int i = 0; i < 4; ++i) {
-        for (int j = 0; j < 5; ++j) {
-            if (dest[i*5+j]==Vtr::INDEX_INVALID) {
-                // assign new vertex
-                dest[i*5+j] =
-                    _numGregoryBasisVertices + gregoryVertexOffset;
-                ++_numGregoryBasisVertices;
-                newVerticesMask[i][j] = true;
-            } else {
-                // share vertex
-                newVerticesMask[i][j] = false;
-            }
+    for (int i = 0; i < 20; ++i) {
+        if (dest[i]==Vtr::INDEX_INVALID) {
+            // assign new vertex
+            dest[i] = _numGregoryBasisVertices + gregoryVertexOffset;
+            ++_numGregoryBasisVertices;
         }
     }
 
-    // add basis
-    addPatchBasis(*level, faceIndex, cornerSpans, newVerticesMask, levelVertOffset, fvarChannel);
-
     ++_numGregoryBasisPatches;
 
     // return cvs;
     return ConstIndexArray(dest, 20);
 }
 
+void
+EndCapGregoryBasisPatchFactory::AppendPatchPointStencils(
+    Vtr::internal::Level const * level, Index faceIndex,
+    Vtr::internal::Level::VSpan const cornerSpans[],
+    int levelVertOffset, int fvarChannel,
+    ConstIndexArray patchPoints, int numPrevPoints,
+    StencilTable * vertexStencils, StencilTable * varyingStencils) const {
+
+    int gregoryVertexOffset = (fvarChannel < 0)
+                            ? _refiner->GetNumVerticesTotal()
+                            : _refiner->GetNumFVarValuesTotal(fvarChannel);
+
+    // Points shared with previous patches were assigned before this one
+    bool newVerticesMask[4][5];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            newVerticesMask[i][j] =
+                (patchPoints[i*5+j] >= numPrevPoints + gregoryVertexOffset);
+        }
+    }
+
+    // add basis
+    addPatchBasis(*level, faceIndex, cornerSpans, newVerticesMask,
+                  levelVertOffset, fvarChannel, vertexStencils, varyingStencils);
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
@@ -88,6 +88,34 @@ public:
         Vtr::internal::Level::VSpan const cornerSpans[],
         int levelVertOffset, int fvarChannel = -1);
 
+    /// \brief Returns end patch point indices for \a faceIndex of \a level
+    ///        as GetPatchPoints() does, but without appending the stencils
+    ///        of its new points (see AppendPatchPointStencils())
+    ///
+    ConstIndexArray AssignPatchPoints(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel = -1);
+
+    /// \brief Appends the stencils of the points first assigned to a patch
+    ///        by AssignPatchPoints() to the given stencil tables. Only reads
+    ///        the factory, so patches may be processed concurrently.
+    ///
+    /// @param patchPoints      point indices returned for the patch
+    ///
+    /// @param numPrevPoints    GetNumPatchPoints() before the patch was
+    ///                         assigned its points
+    ///
+    void AppendPatchPointStencils(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel,
+        ConstIndexArray patchPoints, int numPrevPoints,
+        StencilTable * vertexStencils, StencilTable * varyingStencils) const;
+
+    /// \brief Returns the number of end patch points assigned so far
+    int GetNumPatchPoints() const { return _numGregoryBasisVertices; }
+
 private:
 
     /// Creates a basis for the vertices specified in mask on the face and
@@ -95,7 +123,9 @@ private:
     bool addPatchBasis(Vtr::internal::Level const & level, Index faceIndex,
                        Vtr::internal::Level::VSpan const cornerSpans[],
                        bool newVerticesMask[4][5],
-                       int levelVertOffset, int fvarChannel);
+                       int levelVertOffset, int fvarChannel,
+                       StencilTable * vertexStencils,
+                       StencilTable * varyingStencils) const;
 
     StencilTable *_vertexStencils;
     StencilTable *_varyingStencils;
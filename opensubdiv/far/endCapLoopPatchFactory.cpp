@@ -0,0 +1,459 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/gregoryBasis.h"
+#include "../far/endCapLoopPatchFactory.h"
+#include "../far/patchBasis.h"
+#include "../far/topologyRefiner.h"
+#include "../sdc/loopScheme.h"
+#include "../vtr/stackBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+    //
+    //  Local class to fulfill interface for <typename MASK> in the Scheme mask queries:
+    //
+    class LimitMask {
+    public:
+        typedef float Weight;  //  Also part of the expected interface
+
+    public:
+        LimitMask(Weight* v, Weight* e, Weight* f) :
+            _vertWeights(v), _edgeWeights(e), _faceWeights(f),
+            _vertCount(0), _edgeCount(0), _faceCount(0),
+            _faceWeightsForFaceCenters(false)
+        { }
+
+    public:  //  Generic interface expected of <typename MASK>:
+        int GetNumVertexWeights() const { return _vertCount; }
+        int GetNumEdgeWeights()   const { return _edgeCount; }
+        int GetNumFaceWeights()   const { return _faceCount; }
+
+        void SetNumVertexWeights(int count) { _vertCount = count; }
+        void SetNumEdgeWeights(  int count) { _edgeCount = count; }
+        void SetNumFaceWeights(  int count) { _faceCount = count; }
+
+        Weight const& VertexWeight(int index) const { return _vertWeights[index]; }
+        Weight const& EdgeWeight(  int index) const { return _edgeWeights[index]; }
+        Weight const& FaceWeight(  int index) const { return _faceWeights[index]; }
+
+        Weight& VertexWeight(int index) { return _vertWeights[index]; }
+        Weight& EdgeWeight(  int index) { return _edgeWeights[index]; }
+        Weight& FaceWeight(  int index) { return _faceWeights[index]; }
+
+        bool AreFaceWeightsForFaceCenters() const  { return _faceWeightsForFaceCenters; }
+        void SetFaceWeightsForFaceCenters(bool on) { _faceWeightsForFaceCenters = on; }
+
+    private:
+        Weight* _vertWeights;
+        Weight* _edgeWeights;
+        Weight* _faceWeights;
+
+        int _vertCount;
+        int _edgeCount;
+        int _faceCount;
+
+        bool _faceWeightsForFaceCenters;
+    };
+
+    //
+    //  Local class to fulfill interface for <typename VERTEX> in the Scheme mask
+    //  queries -- the neighborhood of a vertex with its edges rotated to begin
+    //  with a given edge, relative to which the limit tangents are oriented:
+    //
+    class RotatedVertex {
+    public:
+        RotatedVertex(Vtr::internal::Level const & level, Index vertex, int rotation) :
+            _level(level), _vertex(vertex), _rotation(rotation) { }
+
+    public:  //  Generic interface expected of <typename VERTEX>:
+        int GetNumEdges() const { return _level.getVertexEdges(_vertex).size(); }
+        int GetNumFaces() const { return _level.getVertexFaces(_vertex).size(); }
+
+        float  GetSharpness() const { return _level.getVertexSharpness(_vertex); }
+        float* GetSharpnessPerEdge(float pSharpness[]) const {
+            ConstIndexArray vEdges = _level.getVertexEdges(_vertex);
+            for (int i = 0; i < vEdges.size(); ++i) {
+                pSharpness[i] = _level.getEdgeSharpness(vEdges[(i + _rotation) % vEdges.size()]);
+            }
+            return pSharpness;
+        }
+
+    private:
+        Vtr::internal::Level const & _level;
+
+        Index _vertex;
+        int   _rotation;
+    };
+
+    //
+    //  Position of each point of the box spline in the lattice of the patch
+    //  (relative to the first corner along the first and second edges):
+    //
+    int const latticeCoords[12][2] = {
+        {  0, -1 }, { -1,  0 }, {  1, -1 }, {  0,  0 },
+        { -1,  1 }, {  2, -1 }, {  1,  0 }, {  0,  1 },
+        { -1,  2 }, {  2,  0 }, {  1,  1 }, {  0,  2 } };
+
+    //
+    //  Computes the weights of the limit position and tangents of the corners
+    //  combined to define each point of the patch.  The points of the planar
+    //  triangle of the limit positions lie in its plane at their positions in
+    //  the lattice.  When smooth, these are corrected by the least-squares
+    //  (minimum norm) solution matching the tangents of each corner toward the
+    //  next and previous corners, leaving the limit positions interpolated:
+    //
+    void
+    computeFitWeights(bool smooth, float fitWeights[12][9]) {
+
+        double F[12][9];
+        for (int i = 0; i < 12; ++i) {
+            double a = (double) latticeCoords[i][0];
+            double b = (double) latticeCoords[i][1];
+
+            for (int j = 0; j < 9; ++j) {
+                F[i][j] = 0.0;
+            }
+            F[i][0] = 1.0 - a - b;
+            F[i][3] = a;
+            F[i][6] = b;
+        }
+
+        if (smooth) {
+            //  Rows of the constraints at each corner -- the position of the
+            //  box spline and its derivatives toward the next and previous
+            //  corners (along the unit edges of the parametric triangle):
+            static int const cornerCoords[3][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 } };
+
+            PatchParam param;
+            param.Set(0, 0, 0, 0, false, 0, 0);
+
+            double A[9][12];
+            for (int i = 0; i < 3; ++i) {
+                float wP[12], wDs[12], wDt[12];
+                internal::GetLoopWeights(param,
+                    (float) cornerCoords[i][0], (float) cornerCoords[i][1], wP, wDs, wDt);
+
+                int const * c     = cornerCoords[i];
+                int const * cNext = cornerCoords[(i + 1) % 3];
+                int const * cPrev = cornerCoords[(i + 2) % 3];
+
+                for (int j = 0; j < 12; ++j) {
+                    A[3*i    ][j] = wP[j];
+                    A[3*i + 1][j] = (cNext[0] - c[0]) * wDs[j] + (cNext[1] - c[1]) * wDt[j];
+                    A[3*i + 2][j] = (cPrev[0] - c[0]) * wDs[j] + (cPrev[1] - c[1]) * wDt[j];
+                }
+            }
+
+            //  Solve (A * At) * Y = (I - A * F) for the correction At * Y:
+            double G[9][9], Y[9][9];
+            for (int i = 0; i < 9; ++i) {
+                for (int j = 0; j < 9; ++j) {
+                    G[i][j] = 0.0;
+                    Y[i][j] = (i == j) ? 1.0 : 0.0;
+                    for (int k = 0; k < 12; ++k) {
+                        G[i][j] += A[i][k] * A[j][k];
+                        Y[i][j] -= A[i][k] * F[k][j];
+                    }
+                }
+            }
+            for (int i = 0; i < 9; ++i) {
+                int pivot = i;
+                for (int j = i + 1; j < 9; ++j) {
+                    if (std::fabs(G[j][i]) > std::fabs(G[pivot][i])) pivot = j;
+                }
+                for (int j = 0; j < 9; ++j) {
+                    std::swap(G[i][j], G[pivot][j]);
+                    std::swap(Y[i][j], Y[pivot][j]);
+                }
+                assert(G[i][i] != 0.0);
+
+                double scale = 1.0 / G[i][i];
+                for (int j = 0; j < 9; ++j) {
+                    G[i][j] *= scale;
+                    Y[i][j] *= scale;
+                }
+                for (int k = 0; k < 9; ++k) {
+                    double factor = G[k][i];
+                    if ((k == i) || (factor == 0.0)) continue;
+
+                    for (int j = 0; j < 9; ++j) {
+                        G[k][j] -= factor * G[i][j];
+                        Y[k][j] -= factor * Y[i][j];
+                    }
+                }
+            }
+            for (int i = 0; i < 12; ++i) {
+                for (int j = 0; j < 9; ++j) {
+                    for (int k = 0; k < 9; ++k) {
+                        F[i][j] += A[k][i] * Y[k][j];
+                    }
+                }
+            }
+        }
+
+        //  Discard the round-off of weights that are zero:
+        for (int i = 0; i < 12; ++i) {
+            for (int j = 0; j < 9; ++j) {
+                fitWeights[i][j] = (std::fabs(F[i][j]) < 1.0e-6) ? 0.0f : (float) F[i][j];
+            }
+        }
+    }
+}
+
+EndCapLoopPatchFactory::EndCapLoopPatchFactory(
+    TopologyRefiner const & refiner,
+    StencilTable * vertexStencils,
+    StencilTable * varyingStencils,
+    bool smooth) :
+    _vertexStencils(vertexStencils), _varyingStencils(varyingStencils),
+    _smooth(smooth), _refiner(&refiner), _numVertices(0), _numPatches(0) {
+
+    // Sanity check: the mesh must be adaptively refined
+    assert(! refiner.IsUniform());
+    assert(refiner.GetSchemeType() == Sdc::SCHEME_LOOP);
+
+    computeFitWeights(_smooth, _fitWeights);
+}
+
+//
+//  Computes the limit position of a corner of the face and, when smooth, the
+//  limit tangents toward the next and previous corners -- scaled such that
+//  they are the derivatives of the regular patch at regular vertices:
+//
+void
+EndCapLoopPatchFactory::computeLimitStencils(
+    Vtr::internal::Level const * level, Index face, int corner,
+    int levelVertOffset, GregoryBasis::Point P[3]) const {
+
+    Sdc::Scheme<Sdc::SCHEME_LOOP> scheme(_refiner->GetSchemeOptions());
+
+    ConstIndexArray fVerts = level->getFaceVertices(face);
+
+    Index vertex = fVerts[corner];
+
+    ConstIndexArray vEdges = level->getVertexEdges(vertex);
+    ConstIndexArray vFaces = level->getVertexFaces(vertex);
+
+    int valence = vEdges.size();
+
+    Sdc::Crease::Rule rule = level->getVertexRule(vertex);
+
+    Vtr::internal::Level::VTag vTag = level->getVertexTag(vertex);
+
+    bool isCrease = (rule == Sdc::Crease::RULE_CREASE);
+    bool isCorner = (rule == Sdc::Crease::RULE_CORNER) || vTag._nonManifold ||
+                    (vTag._boundary && !isCrease);
+
+    //
+    //  Tangents are oriented relative to the first edge of the vertex, so its
+    //  edges are rotated to begin with the leading edge of the face -- or for
+    //  a crease, the leading crease edge of the span containing the face.  The
+    //  edges of the face then lie at angles in the span proportional to their
+    //  index in it (of the full circle when smooth, or half when a crease):
+    //
+    int faceInVertex = isCorner ? 0 : vFaces.FindIndex(face);
+    int rotation     = faceInVertex;
+    int spanSize     = valence;
+    double spanAngle = 2.0 * M_PI;
+
+    if (isCrease && !isCorner) {
+        while (Sdc::Crease::IsSmooth(level->getEdgeSharpness(vEdges[rotation]))) {
+            rotation = (rotation ? rotation : valence) - 1;
+        }
+        spanSize = 1;
+        while (Sdc::Crease::IsSmooth(
+                level->getEdgeSharpness(vEdges[(rotation + spanSize) % valence]))) {
+            ++spanSize;
+        }
+        spanAngle = M_PI;
+    }
+
+    Vtr::internal::StackBuffer<float,99> weights(3 * (1 + valence + vFaces.size()));
+
+    float * posWeights  = weights;
+    float * tan1Weights = posWeights  + 1 + valence + vFaces.size();
+    float * tan2Weights = tan1Weights + 1 + valence + vFaces.size();
+
+    LimitMask posMask( posWeights,  posWeights  + 1, posWeights  + 1 + valence);
+    LimitMask tan1Mask(tan1Weights, tan1Weights + 1, tan1Weights + 1 + valence);
+    LimitMask tan2Mask(tan2Weights, tan2Weights + 1, tan2Weights + 1 + valence);
+
+    RotatedVertex vHood(*level, vertex, rotation);
+
+    if (_smooth && !isCorner) {
+        scheme.ComputeVertexLimitMask(vHood, posMask, tan1Mask, tan2Mask, rule);
+    } else {
+        scheme.ComputeVertexLimitMask(vHood, posMask, rule);
+    }
+    //  Limit masks of the Loop scheme have no face weights:
+    assert(posMask.GetNumFaceWeights() == 0);
+
+    //  Gather the masks in terms of the vertices of the level:
+    LimitMask const * masks[3] = { &posMask, &tan1Mask, &tan2Mask };
+
+    GregoryBasis::Point stencils[3];
+    for (int i = 0; i < ((_smooth && !isCorner) ? 3 : 1); ++i) {
+        stencils[i].Clear(1 + valence);
+
+        stencils[i].AddWithWeight(vertex + levelVertOffset, masks[i]->VertexWeight(0));
+        for (int j = 0; j < masks[i]->GetNumEdgeWeights(); ++j) {
+            ConstIndexArray eVerts = level->getEdgeVertices(vEdges[(j + rotation) % valence]);
+
+            Index vOpposite = (eVerts[0] == vertex) ? eVerts[1] : eVerts[0];
+            stencils[i].AddWithWeight(vOpposite + levelVertOffset, masks[i]->EdgeWeight(j));
+        }
+    }
+    P[0] = stencils[0];
+
+    if (!_smooth) return;
+
+    if (isCorner) {
+        //  The limit surface is not smooth at corners -- the tangents are those
+        //  of the corner mask, i.e. the edges to the adjacent corners:
+        for (int i = 1; i < 3; ++i) {
+            P[i].Clear(2);
+            P[i].AddWithWeight(fVerts[(corner + i) % 3] + levelVertOffset,  1.0f);
+            P[i].AddWithWeight(vertex + levelVertOffset, -1.0f);
+        }
+    } else {
+        //  Smooth tangents are of magnitude valence/2 and crease tangents 3 for
+        //  unit edges in the plane:
+        float scale = isCrease ? (1.0f / 3.0f) : (2.0f / (float) valence);
+
+        int faceInSpan = (faceInVertex - rotation + valence) % valence;
+
+        for (int i = 1; i < 3; ++i) {
+            double angle = spanAngle * (double)(faceInSpan + i - 1) / (double) spanSize;
+
+            P[i].Clear(2 * (1 + valence));
+            P[i].AddWithWeight(stencils[1], scale * (float) std::cos(angle));
+            P[i].AddWithWeight(stencils[2], scale * (float) std::sin(angle));
+        }
+    }
+}
+
+ConstIndexArray
+EndCapLoopPatchFactory::GetPatchPoints(
+    Vtr::internal::Level const * level, Index thisFace,
+    Vtr::internal::Level::VSpan const cornerSpans[],
+    int levelVertOffset, int fvarChannel) {
+
+    int numPrevPoints = _numVertices;
+
+    ConstIndexArray cvs = AssignPatchPoints(
+        level, thisFace, cornerSpans, levelVertOffset, fvarChannel);
+
+    AppendPatchPointStencils(level, thisFace, cornerSpans,
+        levelVertOffset, fvarChannel, cvs, numPrevPoints,
+        _vertexStencils, _varyingStencils);
+    return cvs;
+}
+
+ConstIndexArray
+EndCapLoopPatchFactory::AssignPatchPoints(
+    Vtr::internal::Level const * /* level */, Index /* thisFace */,
+    Vtr::internal::Level::VSpan const /* cornerSpans */ [],
+    int /* levelVertOffset */, int fvarChannel) {
+
+    assert(fvarChannel < 0);
+    (void)fvarChannel;
+
+    int offset = _refiner->GetNumVerticesTotal();
+
+    for (int i = 0; i < 12; ++i) {
+        _patchPoints.push_back((_numVertices++) + offset);
+    }
+    ++_numPatches;
+    return ConstIndexArray(&_patchPoints[(_numPatches-1)*12], 12);
+}
+
+void
+EndCapLoopPatchFactory::AppendPatchPointStencils(
+    Vtr::internal::Level const * level, Index thisFace,
+    Vtr::internal::Level::VSpan const /* cornerSpans */ [],
+    int levelVertOffset, int fvarChannel,
+    ConstIndexArray /* patchPoints */, int /* numPrevPoints */,
+    StencilTable * vertexStencils, StencilTable * varyingStencils) const {
+
+    assert(fvarChannel < 0);
+    (void)fvarChannel;
+
+    ConstIndexArray facePoints = level->getFaceVertices(thisFace);
+    assert(facePoints.size() == 3);
+
+    //
+    //  Each point of the box spline combines the limit position and tangents
+    //  of the three corners (see computeFitWeights()):
+    //
+    GregoryBasis::Point L[9];
+    for (int i = 0; i < 3; ++i) {
+        computeLimitStencils(level, thisFace, i, levelVertOffset, &L[3*i]);
+    }
+
+    for (int i = 0; i < 12; ++i) {
+        float const * w = _fitWeights[i];
+
+        int size = 0;
+        for (int j = 0; j < 9; ++j) {
+            if (w[j] != 0.0f) size += L[j].GetSize();
+        }
+
+        GregoryBasis::Point P(size);
+        for (int j = 0; j < 9; ++j) {
+            if (w[j] != 0.0f) P.AddWithWeight(L[j], w[j]);
+        }
+
+        GregoryBasis::AppendToStencilTable(P, vertexStencils);
+
+        //  Varying data is linear over the triangle of the corner vertices:
+        if (varyingStencils) {
+            float a = (float) latticeCoords[i][0];
+            float b = (float) latticeCoords[i][1];
+
+            float wV[3] = { 1.0f - a - b, a, b };
+
+            GregoryBasis::Point V(3);
+            for (int j = 0; j < 3; ++j) {
+                if (wV[j] != 0.0f) V.AddWithWeight(facePoints[j] + levelVertOffset, wV[j]);
+            }
+
+            GregoryBasis::AppendToStencilTable(V, varyingStencils);
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
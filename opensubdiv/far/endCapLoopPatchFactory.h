@@ -0,0 +1,153 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_END_CAP_LOOP_PATCH_FACTORY_H
+#define OPENSUBDIV3_FAR_END_CAP_LOOP_PATCH_FACTORY_H
+
+#include "../far/gregoryBasis.h"
+#include "../far/types.h"
+#include "../vtr/level.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TopologyRefiner;
+
+/// \brief A Loop endcap factory
+///
+/// Irregular triangles of the Loop scheme are represented by patches of type
+/// LOOP whose 12 points are placed such that the patch interpolates the limit
+/// positions of the corners of the triangle.
+///
+/// When smooth, the points are fitted such that the patch also matches the
+/// limit tangents at each corner along both of its edges -- the tangent
+/// plane of the limit surface -- deviating least from the planar triangle
+/// otherwise.  This approximates the limit surface for all end cap types
+/// other than ENDCAP_BILINEAR_BASIS, for which the patch is the planar
+/// triangle spanned by the three limit positions (as the quartic box spline
+/// reproduces linear functions).
+///
+/// note: This is an internal use class in PatchTableFactory.  Only vertex
+///       data is supported, as face-varying patches of the Loop scheme are
+///       linear.
+///
+class EndCapLoopPatchFactory {
+
+public:
+    /// \brief This factory accumulates vertices for Loop end caps
+    ///
+    /// @param refiner                TopologyRefiner from which to generate patches
+    ///
+    /// @param vertexStencils         Output stencil table for the patch points
+    ///                               (vertex interpolation)
+    ///
+    /// @param varyingStencils        Output stencil table for the patch points
+    ///                               (varying interpolation)
+    ///
+    /// @param smooth                 Fit the limit tangents at the corners
+    ///                               rather than a planar triangle
+    ///
+    EndCapLoopPatchFactory(TopologyRefiner const & refiner,
+                           StencilTable * vertexStencils,
+                           StencilTable * varyingStencils,
+                           bool smooth = true);
+
+    /// \brief Returns end patch point indices for \a faceIndex of \a level.
+    ///        Note that end patch points are not included in the vertices in
+    ///        the topologyRefiner, they're expected to come after the end.
+    ///        The returned indices are offset by refiner->GetNumVerticesTotal.
+    ///
+    /// @param level            vtr refinement level
+    ///
+    /// @param faceIndex        vtr faceIndex at the level
+    ///
+    /// @param cornerSpans      (unused -- limit positions account for the
+    ///                         sharpness about each corner)
+    ///
+    /// @param levelVertOffset  relative offset of patch vertex indices
+    ///
+    /// @param fvarChannel      face-varying channel index (must be -1)
+    ///
+    ConstIndexArray GetPatchPoints(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel = -1);
+
+    /// \brief Returns end patch point indices for \a faceIndex of \a level
+    ///        as GetPatchPoints() does, but without appending the stencils
+    ///        of its new points (see AppendPatchPointStencils())
+    ///
+    ConstIndexArray AssignPatchPoints(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel = -1);
+
+    /// \brief Appends the stencils of the points first assigned to a patch
+    ///        by AssignPatchPoints() to the given stencil tables. Only reads
+    ///        the factory, so patches may be processed concurrently.
+    ///
+    /// @param patchPoints      point indices returned for the patch
+    ///
+    /// @param numPrevPoints    GetNumPatchPoints() before the patch was
+    ///                         assigned its points (all points of a Loop
+    ///                         end cap are new, so unused)
+    ///
+    void AppendPatchPointStencils(
+        Vtr::internal::Level const * level, Index faceIndex,
+        Vtr::internal::Level::VSpan const cornerSpans[],
+        int levelVertOffset, int fvarChannel,
+        ConstIndexArray patchPoints, int numPrevPoints,
+        StencilTable * vertexStencils, StencilTable * varyingStencils) const;
+
+    /// \brief Returns the number of end patch points assigned so far
+    int GetNumPatchPoints() const { return _numVertices; }
+
+private:
+    void computeLimitStencils(
+        Vtr::internal::Level const * level, Index face, int corner,
+        int levelVertOffset, GregoryBasis::Point P[3]) const;
+
+    StencilTable * _vertexStencils;
+    StencilTable * _varyingStencils;
+
+    //  Weights of the limit position and tangents of each corner (see
+    //  computeLimitStencils()) combined to define each patch point:
+    bool  _smooth;
+    float _fitWeights[12][9];
+
+    TopologyRefiner const *_refiner;
+    int _numVertices;
+    int _numPatches;
+    std::vector<Index> _patchPoints;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_FAR_END_CAP_LOOP_PATCH_FACTORY_H
@@ -23,8 +23,11 @@
 //
 
 #include "../far/patchBasis.h"
+#include "../far/eigenBasis.h"
+#include "../vtr/stackBuffer.h"
 
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
 namespace OpenSubdiv {
@@ -49,7 +52,8 @@ public:
     static void GetWeights(float t, float point[], float deriv[], float deriv2[]);
 
     // box-spline weights
-    static void GetWeights(float v, float w, float point[]);
+    static void GetWeights(float s, float t, float point[], float derivS[], float derivT[],
+        float derivSS[], float derivST[], float derivTT[]);
 
     // patch weights
     static void GetPatchWeights(PatchParam const & param,
@@ -128,54 +132,138 @@ inline void Spline<BASIS_BSPLINE>::GetWeights(
 
 template <>
 inline void Spline<BASIS_BOX_SPLINE>::GetWeights(
-    float v, float w, float point[12]) {
-
-    float u = 1.0f - v - w;
+    float s, float t, float point[12], float derivS[12], float derivT[12],
+    float derivSS[12], float derivST[12], float derivTT[12]) {
 
     //
-    //  The 12 basis functions of the quartic box spline (unscaled by their common
-    //  factor of 1/12 until later, and formatted to make it easy to spot any
-    //  typing errors):
+    //  The 12 basis functions of the quartic box spline are most compactly written
+    //  in terms of the barycentric coordinates u = 1-s-t, v = s and w = t, e.g.
+    //
+    //      point[0] = (u^4 + 2u^3v) / 12
     //
-    //      15 terms for the 3 points above the triangle corners
-    //       9 terms for the 3 points on faces opposite the triangle edges
-    //       2 terms for the 6 points on faces opposite the triangle corners
+    //  for each of the points on faces opposite the triangle corners.  To simplify
+    //  their differentiation, they are expanded here into the coefficients (scaled
+    //  by 12) of the 15 monomials s^i t^j with i + j <= 4:
     //
-    //  Powers of each variable for notational convenience:
-    float u2 = u*u;
-    float u3 = u*u2;
-    float u4 = u*u3;
-    float v2 = v*v;
-    float v3 = v*v2;
-    float v4 = v*v3;
-    float w2 = w*w;
-    float w3 = w*w2;
-    float w4 = w*w3;
-
-    //  And now the basis functions:
-    point[ 0] = u4 + 2.0f*u3*v;
-    point[ 1] = u4 + 2.0f*u3*w;
-    point[ 8] = w4 + 2.0f*w3*u;
-    point[11] = w4 + 2.0f*w3*v;
-    point[ 9] = v4 + 2.0f*v3*w;
-    point[ 5] = v4 + 2.0f*v3*u;
-
-    point[ 2] = u4 + 2.0f*u3*w + 6.0f*u3*v + 6.0f*u2*v*w + 12.0f*u2*v2 +
-                v4 + 2.0f*v3*w + 6.0f*v3*u + 6.0f*v2*u*w;
-    point[ 4] = w4 + 2.0f*w3*v + 6.0f*w3*u + 6.0f*w2*u*v + 12.0f*w2*u2 +
-                u4 + 2.0f*u3*v + 6.0f*u3*w + 6.0f*u2*v*w;
-    point[10] = v4 + 2.0f*v3*u + 6.0f*v3*w + 6.0f*v2*w*u + 12.0f*v2*w2 +
-                w4 + 2.0f*w3*u + 6.0f*w3*v + 6.0f*w3*u*v;
-
-    point[ 3] = v4 + 6*v3*w + 8*v3*u + 36*v2*w*u + 24*v2*u2 + 24*v*u3 +
-                w4 + 6*w3*v + 8*w3*u + 36*w2*v*u + 24*w2*u2 + 24*w*u3 + 6*u4 + 60*u2*v*w + 12*v2*w2;
-    point[ 6] = w4 + 6*w3*u + 8*w3*v + 36*w2*u*v + 24*w2*v2 + 24*w*v3 +
-                u4 + 6*u3*w + 8*u3*v + 36*u2*v*w + 24*u2*v2 + 24*u*v3 + 6*v4 + 60*v2*w*u + 12*w2*u2;
-    point[ 7] = u4 + 6*u3*v + 8*u3*w + 36*u2*v*w + 24*u2*w2 + 24*u*w3 +
-                v4 + 6*v3*u + 8*v3*w + 36*v2*u*w + 24*v2*w2 + 24*v*w3 + 6*w4 + 60*w2*u*v + 12*u2*v2;
+    static int const monoS[15] = { 0, 1, 0, 2, 1, 0, 3, 2, 1, 0, 4, 3, 2, 1, 0 };
+    static int const monoT[15] = { 0, 0, 1, 0, 1, 2, 0, 1, 2, 3, 0, 1, 2, 3, 4 };
+
+    static float const coeffs[12][15] = {
+        {   1,  -2,  -4,   0,   6,   6,   2,   0,  -6,  -4,  -1,  -2,   0,   2,   1 },
+        {   1,  -4,  -2,   6,   6,   0,  -4,  -6,   0,   2,   1,   2,   0,  -2,  -1 },
+        {   1,   2,  -2,   0,  -6,   0,  -4,   0,   6,   2,   2,   4,   0,  -2,  -1 },
+        {   6,   0,   0, -12, -12, -12,   8,  12,  12,   8,  -1,  -2,   0,  -2,  -1 },
+        {   1,  -2,   2,   0,  -6,   0,   2,   6,   0,  -4,  -1,  -2,   0,   4,   2 },
+        {   0,   0,   0,   0,   0,   0,   2,   0,   0,   0,  -1,  -2,   0,   0,   0 },
+        {   1,   4,   2,   6,   6,   0,  -4,  -6, -12,  -4,  -1,  -2,   0,   4,   2 },
+        {   1,   2,   4,   0,   6,   6,  -4, -12,  -6,  -4,   2,   4,   0,  -2,  -1 },
+        {   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   0,   0,   0,  -2,  -1 },
+        {   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   2,   0,   0,   0 },
+        {   0,   0,   0,   0,   0,   0,   2,   6,   6,   2,  -1,  -2,   0,  -2,  -1 },
+        {   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   1 } };
+
+    //  Powers of s and t offset by 2, so that the negative powers resulting from
+    //  differentiation of lower degree terms are zero:
+    float sPow[7] = { 0.0f, 0.0f, 1.0f, s, s*s, s*s*s, s*s*s*s };
+    float tPow[7] = { 0.0f, 0.0f, 1.0f, t, t*t, t*t*t, t*t*t*t };
+
+    //  The monomials and their derivatives:
+    float mP[15], mDs[15], mDt[15], mDss[15], mDst[15], mDtt[15];
+    for (int k = 0; k < 15; ++k) {
+        int   i  = monoS[k] + 2;
+        int   j  = monoT[k] + 2;
+        float fi = (float) monoS[k];
+        float fj = (float) monoT[k];
+
+        mP[k]   = sPow[i] * tPow[j];
+        mDs[k]  = fi * sPow[i-1] * tPow[j];
+        mDt[k]  = fj * sPow[i] * tPow[j-1];
+        mDss[k] = fi * (fi - 1.0f) * sPow[i-2] * tPow[j];
+        mDst[k] = fi * fj * sPow[i-1] * tPow[j-1];
+        mDtt[k] = fj * (fj - 1.0f) * sPow[i] * tPow[j-2];
+    }
 
-    for (int i = 0; i < 12; ++i) {
-        point[i] *= 1.0f / 12.0f;
+    float const * monomials[6] = { mP, mDs, mDt, mDss, mDst, mDtt };
+    float       * weights[6] = { point, derivS, derivT, derivSS, derivST, derivTT };
+
+    for (int d = 0; d < 6; ++d) {
+        if (weights[d] == 0) continue;
+
+        for (int b = 0; b < 12; ++b) {
+            float w = 0.0f;
+            for (int k = 0; k < 15; ++k) {
+                w += coeffs[b][k] * monomials[d][k];
+            }
+            weights[d][b] = w * (1.0f / 12.0f);
+        }
+    }
+}
+
+//
+//  Points of the box spline missing at boundaries are replaced with "phantom" points
+//  extrapolated from points of the patch.  Each rule { p, a, b, c } below defines the
+//  point p as a + b - c for the first edge, vertex or corner of the triangle, and the
+//  rules for the others are obtained by rotating the indices of the points:
+//
+//              8     11
+//
+//           4     7     10        The 12 points are ordered in rows parallel to
+//                                 the first edge of the triangle (3, 6), so that
+//        1     3     6     9      the corners of the triangle are 3, 6 and 7.
+//
+//           0     2     5
+//
+static int const boxSplineRotations[3][12] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11 },
+    {  9,  5, 10,  6,  2, 11,  7,  3,  0,  8,  4,  1 },
+    {  8, 11,  4,  7, 10,  1,  3,  6,  9,  0,  2,  5 } };
+
+static int const boxSplineEdgeRules[3][4] = {
+    { 0, 1, 3, 4 }, { 2, 3, 6, 7 }, { 5, 6, 9, 10 } };
+
+static int const boxSplineVertexRules[2][4] = {
+    { 0, 3, 2, 6 }, { 1, 3, 4, 7 } };
+
+static int const boxSplineCornerRules[6][4] = {
+    { 0, 3, 3, 7 }, { 1, 3, 3, 6 }, { 2, 3, 6, 7 },
+    { 4, 3, 7, 6 }, { 5, 6, 9, 10 }, { 8, 7, 11, 10 } };
+
+static inline void
+applyBoxSplineRules(int const rules[][4], int numRules, int rotation,
+    float weights[12]) {
+
+    int const * r = boxSplineRotations[rotation];
+
+    for (int i = 0; i < numRules; ++i) {
+        float w = weights[r[rules[i][0]]];
+
+        weights[r[rules[i][1]]] += w;
+        weights[r[rules[i][2]]] += w;
+        weights[r[rules[i][3]]] -= w;
+        weights[r[rules[i][0]]] = 0.0f;
+    }
+}
+
+static void
+adjustBoxSplineBoundaryWeights(int boundary, float weights[12]) {
+
+    if (boundary & 8) {
+        //  Boundary vertices with no boundary edges:
+        for (int i = 0; i < 3; ++i) {
+            if (boundary & (1 << i)) {
+                applyBoxSplineRules(boxSplineVertexRules, 2, i, weights);
+            }
+        }
+    } else if ((boundary == 1) || (boundary == 2) || (boundary == 4)) {
+        //  A single boundary edge:
+        int edge = boundary >> 1;
+        applyBoxSplineRules(boxSplineEdgeRules, 3, edge, weights);
+    } else if (boundary) {
+        //  A corner -- the vertex shared by the two boundary edges:
+        static int const cornerVertex[8] = { -1, -1, -1, 1, -1, 0, 2, -1 };
+
+        assert(cornerVertex[boundary] >= 0);
+        applyBoxSplineRules(boxSplineCornerRules, 6, cornerVertex[boundary], weights);
     }
 }
 
@@ -218,8 +306,8 @@ inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
             
             derivST[0] =  d2Scale;
             derivST[1] = -d2Scale;
-            derivST[2] = -d2Scale;
-            derivST[3] =  d2Scale;
+            derivST[2] =  d2Scale;
+            derivST[3] = -d2Scale;
         }
     }
 }
@@ -310,11 +398,99 @@ void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
     }
 }
 
+template <>
+void Spline<BASIS_BOX_SPLINE>::GetPatchWeights(PatchParam const & param,
+    float s, float t, float point[12], float derivS[12], float derivT[12], float derivSS[12], float derivST[12], float derivTT[12]) {
+
+    param.NormalizeTriangle(s,t);
+
+    bool findDerivs   = derivS && derivT;
+    bool findDerivs2  = findDerivs && derivSS && derivST && derivTT;
+
+    Spline<BASIS_BOX_SPLINE>::GetWeights(s, t, point,
+        findDerivs ? derivS : 0, findDerivs ? derivT : 0,
+        findDerivs2 ? derivSS : 0, findDerivs2 ? derivST : 0, findDerivs2 ? derivTT : 0);
+
+    int boundary = param.GetBoundary();
+
+    if (point && boundary) {
+        adjustBoxSplineBoundaryWeights(boundary, point);
+    }
+
+    if (findDerivs) {
+        //  The parametric directions of rotated triangles are reversed:
+        float dScale = (float)(1 << param.GetDepth());
+        if (param.IsTriangleRotated()) {
+            dScale = -dScale;
+        }
+
+        for (int i = 0; i < 12; ++i) {
+            derivS[i] *= dScale;
+            derivT[i] *= dScale;
+        }
+        if (boundary) {
+            adjustBoxSplineBoundaryWeights(boundary, derivS);
+            adjustBoxSplineBoundaryWeights(boundary, derivT);
+        }
+
+        if (findDerivs2) {
+            float d2Scale = dScale * dScale;
+
+            for (int i = 0; i < 12; ++i) {
+                derivSS[i] *= d2Scale;
+                derivST[i] *= d2Scale;
+                derivTT[i] *= d2Scale;
+            }
+            if (boundary) {
+                adjustBoxSplineBoundaryWeights(boundary, derivSS);
+                adjustBoxSplineBoundaryWeights(boundary, derivST);
+                adjustBoxSplineBoundaryWeights(boundary, derivTT);
+            }
+        }
+    }
+}
+
 void GetBilinearWeights(PatchParam const & param,
     float s, float t, float point[4], float deriv1[4], float deriv2[4], float deriv11[4], float deriv12[4], float deriv22[4]) {
     Spline<BASIS_BILINEAR>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
 }
 
+void GetLinearTriangleWeights(PatchParam const & param,
+    float s, float t, float point[3], float deriv1[3], float deriv2[3], float deriv11[3], float deriv12[3], float deriv22[3]) {
+
+    param.NormalizeTriangle(s,t);
+
+    if (point) {
+        point[0] = 1.0f - s - t;
+        point[1] = s;
+        point[2] = t;
+    }
+
+    if (deriv1 && deriv2) {
+        //  The parametric directions of rotated triangles are reversed:
+        float dScale = (float)(1 << param.GetDepth());
+        if (param.IsTriangleRotated()) {
+            dScale = -dScale;
+        }
+
+        deriv1[0] = -dScale;
+        deriv1[1] =  dScale;
+        deriv1[2] =  0.0f;
+
+        deriv2[0] = -dScale;
+        deriv2[1] =  0.0f;
+        deriv2[2] =  dScale;
+
+        if (deriv11 && deriv12 && deriv22) {
+            for (int i = 0; i < 3; ++i) {
+                deriv11[i] = 0.0f;
+                deriv12[i] = 0.0f;
+                deriv22[i] = 0.0f;
+            }
+        }
+    }
+}
+
 void GetBezierWeights(PatchParam const param,
     float s, float t, float point[16], float deriv1[16], float deriv2[16], float deriv11[16], float deriv12[16], float deriv22[16]) {
     Spline<BASIS_BEZIER>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
@@ -325,6 +501,49 @@ void GetBSplineWeights(PatchParam const & param,
     Spline<BASIS_BSPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
 }
 
+void GetLoopWeights(PatchParam const & param,
+    float s, float t, float point[12], float deriv1[12], float deriv2[12], float deriv11[12], float deriv12[12], float deriv22[12]) {
+    Spline<BASIS_BOX_SPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
+}
+
+void GetBSplineBasisPointWeights(PatchParam const & param, float wPoints[16][16]) {
+
+    //  Adjust the tensor product of the curve weights of each basis point as with
+    //  the weights of an evaluation:
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            float sWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float tWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            sWeights[j] = 1.0f;
+            tWeights[i] = 1.0f;
+
+            Spline<BASIS_BSPLINE>::AdjustBoundaryWeights(param, sWeights, tWeights);
+
+            float * w = wPoints[4*i + j];
+            for (int k = 0; k < 4; ++k) {
+                for (int l = 0; l < 4; ++l) {
+                    w[4*k + l] = sWeights[l] * tWeights[k];
+                }
+            }
+        }
+    }
+}
+
+void GetLoopBasisPointWeights(PatchParam const & param, float wPoints[12][12]) {
+
+    int boundary = param.GetBoundary();
+
+    for (int i = 0; i < 12; ++i) {
+        float * w = wPoints[i];
+        for (int j = 0; j < 12; ++j) {
+            w[j] = (i == j) ? 1.0f : 0.0f;
+        }
+        if (boundary) {
+            adjustBoxSplineBoundaryWeights(boundary, w);
+        }
+    }
+}
+
 void GetGregoryWeights(PatchParam const & param,
     float s, float t, float point[20], float deriv1[20], float deriv2[20], float deriv11[20], float deriv12[20], float deriv22[20]) {
     //
@@ -497,6 +716,151 @@ void GetGregoryWeights(PatchParam const & param,
     }
 }
 
+void GetEigenBasisWeights(EigenBasis const & basis, PatchParam const & param,
+    float s, float t, float point[], float deriv1[], float deriv2[], float deriv11[], float deriv12[], float deriv22[]) {
+
+    int const K = basis.GetNumControlVertices();
+
+    param.Normalize(s,t);
+
+    //  Orient (u,v) so that the extraordinary vertex lies at the origin:
+    int const rotation = param.GetRotation();
+
+    float u = s, v = t;
+    switch (rotation) {
+        case 1: u = t;        v = 1.0f - s; break;
+        case 2: u = 1.0f - s; v = 1.0f - t; break;
+        case 3: u = 1.0f - t; v = s;        break;
+    }
+
+    //  The limit position at the extraordinary vertex is given by the eigen
+    //  vector of eigen value 1 alone -- derivatives there are evaluated at the
+    //  corner of a sub-patch at a sufficient depth:
+    bool const atVertex = (u == 0.0f) && (v == 0.0f);
+    if (atVertex) {
+        u = v = 1.0f / (float)(1 << 30);
+    }
+
+    //  Find the level n at which (u,v) lies within one of the three regular
+    //  sub-patches around the child quad at the extraordinary vertex:
+    int n = 1;
+    while ((u < 0.5f) && (v < 0.5f)) {
+        u *= 2.0f;
+        v *= 2.0f;
+        ++n;
+    }
+
+    int subPatch;
+    if (v < 0.5f) {
+        subPatch = 0;  u = 2.0f * u - 1.0f;  v = 2.0f * v;
+    } else if (u < 0.5f) {
+        subPatch = 2;  u = 2.0f * u;         v = 2.0f * v - 1.0f;
+    } else {
+        subPatch = 1;  u = 2.0f * u - 1.0f;  v = 2.0f * v - 1.0f;
+    }
+
+    bool const computeDerivs  = deriv1 && deriv2;
+    bool const computeDerivs2 = computeDerivs && deriv11 && deriv12 && deriv22;
+
+    float uWeights[4], vWeights[4], duWeights[4], dvWeights[4], duuWeights[4], dvvWeights[4];
+
+    Spline<BASIS_BSPLINE>::GetWeights(u, uWeights, computeDerivs ? duWeights : 0, computeDerivs2 ? duuWeights : 0);
+    Spline<BASIS_BSPLINE>::GetWeights(v, vWeights, computeDerivs ? dvWeights : 0, computeDerivs2 ? dvvWeights : 0);
+
+    //
+    //  Project the B-spline weights of the sub-patch onto the eigen functions,
+    //  each scaled by its eigen value raised to the power n-1, then map them
+    //  back to the control vertices with the inverse of the eigen vectors:
+    //
+    int const numWeightSets = computeDerivs2 ? 6 : (computeDerivs ? 3 : 1);
+
+    Vtr::internal::StackBuffer<double, 6 * 40> coeffs(numWeightSets * K);
+    std::memset(&coeffs[0], 0, numWeightSets * K * sizeof(double));
+
+    double const * eigenValues    = basis.GetEigenValues();
+    double const * eigenFunctions = basis.GetEigenFunctions(subPatch);
+    double const * inverseVectors = basis.GetInverseEigenVectors();
+
+    double const dScale  = std::ldexp(1.0, n);
+    double const d2Scale = dScale * dScale;
+
+    for (int p = 0; p < 16; ++p) {
+        int const i = p >> 2;
+        int const j = p & 3;
+
+        double w[6];
+        w[0] = uWeights[j] * vWeights[i];
+        if (computeDerivs) {
+            w[1] = duWeights[j] * vWeights[i] * dScale;
+            w[2] = uWeights[j] * dvWeights[i] * dScale;
+        }
+        if (computeDerivs2) {
+            w[3] = duuWeights[j] * vWeights[i] * d2Scale;
+            w[4] = duWeights[j] * dvWeights[i] * d2Scale;
+            w[5] = uWeights[j] * dvvWeights[i] * d2Scale;
+        }
+        double const * f = eigenFunctions + p * K;
+        for (int m = 0; m < numWeightSets; ++m) {
+            double * c = &coeffs[m * K];
+            for (int e = 0; e < K; ++e) {
+                c[e] += w[m] * f[e];
+            }
+        }
+    }
+
+    for (int e = 0; e < K; ++e) {
+        double const scale = std::pow(eigenValues[e], n - 1);
+        for (int m = 0; m < numWeightSets; ++m) {
+            coeffs[m * K + e] *= scale;
+        }
+        if (atVertex && (std::abs(eigenValues[e] - 1.0) > 1.0e-9)) {
+            coeffs[e] = 0.0;
+        }
+    }
+
+    //  Map the coefficients to the control vertices and orient the derivatives
+    //  back to (s,t) -- scaling them to the depth of the patch:
+    float * weights[6] = { point, deriv1, deriv2, deriv11, deriv12, deriv22 };
+
+    double const dPatchScale  = (double)(1 << param.GetDepth());
+    double const d2PatchScale = dPatchScale * dPatchScale;
+
+    for (int cv = 0; cv < K; ++cv) {
+        double r[6];
+        for (int m = 0; m < numWeightSets; ++m) {
+            double sum = 0.0;
+            for (int e = 0; e < K; ++e) {
+                sum += coeffs[m * K + e] * inverseVectors[e * K + cv];
+            }
+            r[m] = sum;
+        }
+        if (point) {
+            point[cv] = (float) r[0];
+        }
+        if (computeDerivs) {
+            double dS = r[1], dT = r[2];
+            switch (rotation) {
+                case 1: dS = -r[2]; dT =  r[1]; break;
+                case 2: dS = -r[1]; dT = -r[2]; break;
+                case 3: dS =  r[2]; dT = -r[1]; break;
+            }
+            weights[1][cv] = (float) (dS * dPatchScale);
+            weights[2][cv] = (float) (dT * dPatchScale);
+        }
+        if (computeDerivs2) {
+            double dSS = r[3], dST = r[4], dTT = r[5];
+            if (rotation & 1) {
+                dSS = r[5];
+                dST = -r[4];
+                dTT = r[3];
+            }
+            weights[3][cv] = (float) (dSS * d2PatchScale);
+            weights[4][cv] = (float) (dST * d2PatchScale);
+            weights[5][cv] = (float) (dTT * d2PatchScale);
+        }
+    }
+}
+
 } // end namespace internal
 } // end namespace Far
 
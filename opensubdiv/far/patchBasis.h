@@ -35,6 +35,8 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 namespace internal {
 
+class EigenBasis;
+
 //
 // XXXX barfowl:  These functions are being kept in place while more complete
 // underlying support for all patch types is being worked out.  That support
@@ -48,6 +50,9 @@ namespace internal {
 void GetBilinearWeights(PatchParam const & patchParam,
     float s, float t, float wP[4], float wDs[4], float wDt[4], float wDss[4] = 0, float wDst[4] = 0, float wDtt[4] = 0);
 
+void GetLinearTriangleWeights(PatchParam const & patchParam,
+    float s, float t, float wP[3], float wDs[3], float wDt[3], float wDss[3] = 0, float wDst[3] = 0, float wDtt[3] = 0);
+
 void GetBezierWeights(PatchParam const & patchParam,
     float s, float t, float wP[16], float wDs[16], float wDt[16], float wDss[16] = 0, float wDst[16] = 0, float wDtt[16] = 0);
 
@@ -57,6 +62,22 @@ void GetBSplineWeights(PatchParam const & patchParam,
 void GetGregoryWeights(PatchParam const & patchParam,
     float s, float t, float wP[20], float wDs[20], float wDt[20], float wDss[20] = 0, float wDst[20] = 0, float wDtt[20] = 0);
 
+void GetLoopWeights(PatchParam const & patchParam,
+    float s, float t, float wP[12], float wDs[12], float wDt[12], float wDss[12] = 0, float wDst[12] = 0, float wDtt[12] = 0);
+
+//
+//  Weights of the points of a patch combined to define each point of its basis --
+//  the identity except where points missing at boundaries are extrapolated from
+//  those of the patch.  The non-negative basis functions of these patches bound
+//  the limit surface by the convex hull of the resulting points:
+//
+void GetBSplineBasisPointWeights(PatchParam const & patchParam, float wPoints[16][16]);
+
+void GetLoopBasisPointWeights(PatchParam const & patchParam, float wPoints[12][12]);
+
+void GetEigenBasisWeights(EigenBasis const & basis, PatchParam const & patchParam,
+    float s, float t, float wP[], float wDs[], float wDt[], float wDss[] = 0, float wDst[] = 0, float wDtt[] = 0);
+
 
 } // end namespace internal
 } // end namespace Far
@@ -42,7 +42,6 @@ ConstPatchDescriptorArray
 PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SchemeType type) {
 
     static PatchDescriptor _loopDescriptors[] = {
-        // XXXX work in progress !
         PatchDescriptor(LOOP),
     };
 
@@ -72,10 +71,14 @@ void
 PatchDescriptor::print() const {
     static char const * types[13] = {
         "NON_PATCH", "POINTS", "LINES", "QUADS", "TRIANGLES", "LOOP",
-            "REGULAR", "GREGORY", "GREGORY_BOUNDARY", "GREGORY_BASIS" };
+            "REGULAR", "GREGORY", "GREGORY_BOUNDARY", "GREGORY_BASIS",
+            "EIGEN_BASIS" };
 
-    printf("    type %s\n",
-        types[_type]);
+    if (_type == EIGEN_BASIS) {
+        printf("    type %s valence %d\n", types[_type], _valence);
+    } else {
+        printf("    type %s\n", types[_type]);
+    }
 }
 
 
@@ -45,7 +45,13 @@ namespace Far {
 ///   or TRIANGLES
 ///
 /// * Adaptively subdivided meshes contain bicubic patches of types REGULAR,
-///   GREGORY, GREGORY_BOUNDARY, GREGORY_BASIS.
+///   GREGORY, GREGORY_BOUNDARY, GREGORY_BASIS -- or quartic triangular patches
+///   of type LOOP for the Loop scheme.
+///
+/// * Patches of type EIGEN_BASIS exactly represent the limit surface of a quad
+///   with a single extraordinary vertex.  Their number of control vertices
+///   depends on the valence of the extraordinary vertex, which is part of the
+///   descriptor.
 ///
 class PatchDescriptor {
 
@@ -60,36 +66,54 @@ public:
         QUADS,             ///< bilinear quads-only patches
         TRIANGLES,         ///< bilinear triangles-only mesh
 
-        LOOP,              ///< Loop patch
+        LOOP,              ///< quartic triangular box-spline patches
 
         REGULAR,           ///< feature-adaptive bicubic patches
         GREGORY,
         GREGORY_BOUNDARY,
-        GREGORY_BASIS
+        GREGORY_BASIS,
+        EIGEN_BASIS        ///< exact patches around an extraordinary vertex
     };
 
 public:
 
     /// \brief Default constructor.
     PatchDescriptor() :
-        _type(NON_PATCH) { }
+        _type(NON_PATCH), _valence(0) { }
 
     /// \brief Constructor
     PatchDescriptor(int type) :
-        _type(type) { }
+        _type((unsigned short)type), _valence(0) { }
+
+    /// \brief Constructor
+    ///
+    /// @param type     The type of the patch
+    ///
+    /// @param valence  The valence of the extraordinary vertex of EIGEN_BASIS
+    ///                 patches (ignored for other types)
+    ///
+    PatchDescriptor(int type, int valence) :
+        _type((unsigned short)type),
+        _valence((unsigned short)((type == EIGEN_BASIS) ? valence : 0)) { }
 
     /// \brief Copy Constructor
     PatchDescriptor( PatchDescriptor const & d ) :
-        _type(d.GetType()) { }
+        _type(d._type), _valence(d._valence) { }
 
     /// \brief Returns the type of the patch
     Type GetType() const {
         return (Type)_type;
     }
 
+    /// \brief Returns the valence of the extraordinary vertex of EIGEN_BASIS
+    ///        patches (0 for all other types)
+    int GetValence() const {
+        return _valence;
+    }
+
     /// \brief Returns true if the type is an adaptive patch
     static inline bool IsAdaptive(Type type) {
-        return (type>=LOOP && type<=GREGORY_BASIS);
+        return (type>=LOOP && type<=EIGEN_BASIS);
     }
 
     /// \brief Returns true if the type is an adaptive patch
@@ -98,7 +122,7 @@ public:
     }
 
     /// \brief Returns the number of control vertices expected for a patch of the
-    /// type described
+    /// type described (-1 for EIGEN_BASIS, which varies with the valence)
     static inline short GetNumControlVertices( Type t );
 
     /// \brief Deprecated @see PatchDescriptor#GetNumControlVertices
@@ -107,7 +131,8 @@ public:
     /// \brief Returns the number of control vertices expected for a patch of the
     /// type described
     short GetNumControlVertices() const {
-        return GetNumControlVertices( this->GetType() );
+        return (GetType() == EIGEN_BASIS) ? GetEigenBasisPatchSize(_valence) :
+            GetNumControlVertices( this->GetType() );
     }
 
     /// \brief Deprecated @see PatchDescriptor#GetNumControlVertices
@@ -124,6 +149,13 @@ public:
     /// \brief Number of control vertices of Gregory patch basis (20)
     static short GetGregoryBasisPatchSize() { return 20; }
 
+    /// \brief Number of control vertices of Loop (box-spline) Patches in table.
+    static short GetLoopPatchSize() { return 12; }
+
+    /// \brief Number of control vertices of eigen basis patches of the given
+    /// valence (2 * valence + 8)
+    static short GetEigenBasisPatchSize(int valence) { return (short)(2 * valence + 8); }
+
 
     /// \brief Returns a vector of all the legal patch descriptors for the
     ///        given adaptive subdivision scheme
@@ -139,7 +171,8 @@ public:
     void print() const;
 
 private:
-    unsigned int _type;
+    unsigned short _type;
+    unsigned short _valence;
 };
 
 typedef Vtr::ConstArray<PatchDescriptor> ConstPatchDescriptorArray;
@@ -149,6 +182,7 @@ inline short
 PatchDescriptor::GetNumControlVertices( Type type ) {
     switch (type) {
         case REGULAR           : return GetRegularPatchSize();
+        case LOOP              : return GetLoopPatchSize();
         case QUADS             : return 4;
         case GREGORY           :
         case GREGORY_BOUNDARY  : return GetGregoryPatchSize();
@@ -169,13 +203,14 @@ PatchDescriptor::GetNumFVarControlVertices( Type type ) {
 // Allows ordering of patches by type
 inline bool
 PatchDescriptor::operator < ( PatchDescriptor const other ) const {
-    return (_type < other._type);
+    return (_type < other._type) ||
+        ((_type == other._type) && (_valence < other._valence));
 }
 
 // True if the descriptors are identical
 inline bool
 PatchDescriptor::operator == ( PatchDescriptor const other ) const {
-    return _type == other._type;
+    return (_type == other._type) && (_valence == other._valence);
 }
 
 
@@ -32,7 +32,8 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 // Constructor
-PatchMap::PatchMap( PatchTable const & patchTable ) {
+PatchMap::PatchMap( PatchTable const & patchTable ) :
+    _patchesAreTriangular(false) {
     initialize( patchTable );
 }
 
@@ -74,6 +75,11 @@ PatchMap::initialize( PatchTable const & patchTable ) {
     if (! narrays || ! npatches)
         return;
 
+    PatchDescriptor::Type patchType = patchTable.GetPatchArrayDescriptor(0).GetType();
+
+    _patchesAreTriangular = (patchType == PatchDescriptor::LOOP) ||
+                            (patchType == PatchDescriptor::TRIANGLES);
+
     // populate subpatch handles vector
     _handles.resize(npatches);
 
@@ -125,6 +131,40 @@ PatchMap::initialize( PatchTable const & patchTable ) {
                 continue;
             }
 
+            if (_patchesAreTriangular) {
+                // locate the triangle by its centroid (scaled by 3 to remain
+                // integral), accounting for the rotation of its parameterization
+                int depthFactor = 1 << depth;
+
+                int u = param.IsTriangleRotated()
+                      ? (3 * (depthFactor - param.GetU()) - 1) : (3 * param.GetU() + 1),
+                    v = param.IsTriangleRotated()
+                      ? (3 * (depthFactor - param.GetV()) - 1) : (3 * param.GetV() + 1),
+                    half = 3 * (depthFactor >> 1);
+
+                bool rotated = false;
+
+                for (unsigned char j=0; j<depth; ++j) {
+
+                    int quadrant = resolveTriangleChild(half, u, v, rotated);
+
+                    half = half >> 1;
+
+                    if (j==depth-1) {
+                        // we have reached the depth of the sub-patch : add a leaf
+                        assert( ! node->children[quadrant].isSet );
+                        node->SetChild(quadrant, handleIndex, true);
+                    } else if (! node->children[quadrant].isSet) {
+                        // create a new branch in the quadrant
+                        node = addChild(quadtree, node, quadrant);
+                    } else {
+                        // travel down an existing branch
+                        node = &(quadtree[ node->children[quadrant].idx ]);
+                    }
+                }
+                continue;
+            }
+
             int u = param.GetU(),
                 v = param.GetV(),
                 pdepth = param.NonQuadRoot() ? depth-2 : depth-1,
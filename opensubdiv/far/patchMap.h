@@ -115,6 +115,20 @@ private:
     //
     template <class T> static int resolveQuadrant(T & median, T & u, T & v);
 
+    // given a median, transforms the (u,v) to the child of a triangle they
+    // point to, and returns the index of the child.  A triangle occupies the
+    // lower half of the square at the origin of (u,v), or its upper half when
+    // rotated (the rotation of the child is returned).
+    //
+    // Children indexing matches that of the triangles of the Loop scheme:
+    // child 0 is at the origin of the triangle, children 1 and 2 are at its
+    // corners along u and v, and child 3 is the rotated child in its middle.
+    //
+    template <class T> static int resolveTriangleChild(T & median, T & u, T & v,
+                                                      bool & rotated);
+
+    bool _patchesAreTriangular;      // patches are triangles of a Loop mesh
+
     std::vector<Handle>   _handles;  // all the patches in the PatchTable
     std::vector<QuadNode> _quadtree; // quadtree nodes
 };
@@ -144,6 +158,42 @@ PatchMap::resolveQuadrant(T & median, T & u, T & v) {
     return quadrant;
 }
 
+template <class T> int
+PatchMap::resolveTriangleChild(T & median, T & u, T & v, bool & rotated) {
+
+    if (! rotated) {
+        if (u >= median) {
+            u -= median;
+            return 1;
+        }
+        if (v >= median) {
+            v -= median;
+            return 2;
+        }
+        if ((u + v) >= median) {
+            rotated = true;
+            return 3;
+        }
+        return 0;
+    } else {
+        if (u < median) {
+            v -= median;
+            return 1;
+        }
+        if (v < median) {
+            u -= median;
+            return 2;
+        }
+        u -= median;
+        v -= median;
+        if ((u + v) < median) {
+            rotated = false;
+            return 3;
+        }
+        return 0;
+    }
+}
+
 /// Returns a handle to the sub-patch of the face at the given (u,v).
 inline PatchMap::Handle const *
 PatchMap::FindPatch( int faceid, float u, float v ) const {
@@ -157,12 +207,16 @@ PatchMap::FindPatch( int faceid, float u, float v ) const {
 
     float half = 0.5f;
 
+    bool rotated = false;
+
     // 0xFF : we should never have depths greater than k_InfinitelySharp
     for (int depth=0; depth<0xFF; ++depth) {
 
         float delta = half * 0.5f;
 
-        int quadrant = resolveQuadrant( half, u, v );
+        int quadrant = _patchesAreTriangular
+                     ? resolveTriangleChild( half, u, v, rotated )
+                     : resolveQuadrant( half, u, v );
         assert(quadrant>=0);
 
         // is the quadrant a hole ?
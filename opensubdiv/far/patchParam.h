@@ -78,6 +78,11 @@ namespace Far {
 /// coordinates. This encoding also takes inspiration from the Ptex
 /// texture mapping specification.
 ///
+/// The boundary bitmask of a triangular patch identifies its three edges
+/// in its lower three bits. When the fourth bit is set, the lower three
+/// bits instead identify vertices of the patch that lie on a boundary
+/// while none of its edges do.
+///
 /// Bitfield layout :
 ///
 ///  Field0     | Bits | Content
@@ -90,7 +95,7 @@ namespace Far {
 ///  level      | 4    | the subdivision level of the patch
 ///  nonquad    | 1    | whether patch is refined from a non-quad face
 ///  regular    | 1    | whether patch is regular
-///  unused     | 2    | unused
+///  rotation   | 2    | corner of the extraordinary vertex (EIGEN_BASIS only)
 ///  boundary   | 4    | boundary edge mask encoding
 ///  v          | 10   | log2 value of u parameter at first patch corner
 ///  u          | 10   | log2 value of v parameter at first patch corner
@@ -165,10 +170,13 @@ struct PatchParam {
     ///
     /// @param regular whether the patch is regular
     ///
+    /// @param rotation corner of the face at which the extraordinary vertex
+    ///                 of an EIGEN_BASIS patch lies
+    ///
     void Set(Index faceid, short u, short v,
              unsigned short depth, bool nonquad,
              unsigned short boundary, unsigned short transition,
-             bool regular = false);
+             bool regular = false, unsigned short rotation = 0);
 
     /// \brief Resets everything to 0
     void Clear() { field0 = field1 = 0; }
@@ -215,9 +223,34 @@ struct PatchParam {
     ///
     void Unnormalize( float & u, float & v ) const;
 
+    /// \brief Returns whether a triangular patch is parameterized from its
+    /// opposite corner, i.e. is rotated with respect to its base face (only
+    /// meaningful for patches of triangular subdivision schemes)
+    bool IsTriangleRotated() const;
+
+    /// \brief A (u,v) pair in the fraction of parametric space covered by this
+    /// triangular face is mapped into a normalized parametric space.
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void NormalizeTriangle( float & u, float & v ) const;
+
+    /// \brief A (u,v) pair in a normalized parametric space is mapped back into
+    /// the fraction of parametric space covered by this triangular face.
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void UnnormalizeTriangle( float & u, float & v ) const;
+
     /// \brief Returns whether the patch is regular
     bool IsRegular() const { return (unpack(field1,1,5) != 0); }
 
+    /// \brief Returns the corner of the face at which the extraordinary vertex
+    ///        of an EIGEN_BASIS patch lies (0 for all other patches)
+    unsigned short GetRotation() const { return (unsigned short)unpack(field1,2,6); }
+
     unsigned int field0:32;
     unsigned int field1:32;
 
@@ -240,13 +273,14 @@ inline void
 PatchParam::Set(Index faceid, short u, short v,
                 unsigned short depth, bool nonquad,
                 unsigned short boundary, unsigned short transition,
-                bool regular) {
+                bool regular, unsigned short rotation) {
     field0 = pack(faceid,    28,  0) |
              pack(transition, 4, 28);
 
     field1 = pack(u,         10, 22) |
              pack(v,         10, 12) |
              pack(boundary,   4,  8) |
+             pack(rotation,   2,  6) |
              pack(regular,    1,  5) |
              pack(nonquad,    1,  4) |
              pack(depth,      4,  0);
@@ -285,6 +319,41 @@ PatchParam::Unnormalize( float & u, float & v ) const {
     v = v * frac + pv;
 }
 
+inline bool
+PatchParam::IsTriangleRotated() const {
+    return ((int)GetU() + (int)GetV()) >= (1 << GetDepth());
+}
+
+inline void
+PatchParam::NormalizeTriangle( float & u, float & v ) const {
+
+    if (IsTriangleRotated()) {
+        float frac = GetParamFraction();
+
+        int depthFactor = 1 << GetDepth();
+
+        u = (float)(depthFactor - GetU()) - (u / frac),
+        v = (float)(depthFactor - GetV()) - (v / frac);
+    } else {
+        Normalize(u, v);
+    }
+}
+
+inline void
+PatchParam::UnnormalizeTriangle( float & u, float & v ) const {
+
+    if (IsTriangleRotated()) {
+        float frac = GetParamFraction();
+
+        int depthFactor = 1 << GetDepth();
+
+        u = ((float)(depthFactor - GetU()) - u) * frac,
+        v = ((float)(depthFactor - GetV()) - v) * frac;
+    } else {
+        Unnormalize(u, v);
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
@@ -24,7 +24,10 @@
 
 #include "../far/patchTable.h"
 #include "../far/patchBasis.h"
+#include "../far/eigenBasis.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <cstdio>
 
@@ -55,7 +58,10 @@ PatchTable::PatchTable(PatchTable const & src) :
     _varyingDesc(src._varyingDesc),
     _fvarChannels(src._fvarChannels),
     _sharpnessIndices(src._sharpnessIndices),
-    _sharpnessValues(src._sharpnessValues) {
+    _sharpnessValues(src._sharpnessValues),
+    _adjacencyPatches(src._adjacencyPatches),
+    _adjacencyEdges(src._adjacencyEdges),
+    _adjacencyParams(src._adjacencyParams) {
 
     if (src._localPointStencils) {
         _localPointStencils =
@@ -65,6 +71,14 @@ PatchTable::PatchTable(PatchTable const & src) :
         _localPointVaryingStencils =
             new StencilTable(*src._localPointVaryingStencils);
     }
+    if (! src._eigenBases.empty()) {
+        _eigenBases.resize(src._eigenBases.size(), 0);
+        for (int i=0; i<(int)_eigenBases.size(); ++i) {
+            if (src._eigenBases[i]) {
+                _eigenBases[i] = new internal::EigenBasis(*src._eigenBases[i]);
+            }
+        }
+    }
     if (! src._localPointFaceVaryingStencils.empty()) {
         _localPointFaceVaryingStencils.resize(src._localPointFaceVaryingStencils.size());
         for (int fvc=0; fvc<(int)_localPointFaceVaryingStencils.size(); ++fvc) {
@@ -80,6 +94,9 @@ PatchTable::~PatchTable() {
     for (int fvc=0; fvc<(int)_localPointFaceVaryingStencils.size(); ++fvc) {
         delete _localPointFaceVaryingStencils[fvc];
 }
+    for (int i=0; i<(int)_eigenBases.size(); ++i) {
+        delete _eigenBases[i];
+    }
 }
 
 //
@@ -228,6 +245,21 @@ PatchTable::getPatchIndex(int arrayIndex, int patchIndex) const {
     assert(patchIndex<pa.numPatches);
     return pa.patchIndex + patchIndex;
 }
+PatchTable::PatchHandle
+PatchTable::getPatchHandle(Index patch) const {
+    PatchHandle handle;
+    for (int i=0; i<(int)_patchArrays.size(); ++i) {
+        PatchArray const & pa = _patchArrays[i];
+        if (patch < pa.patchIndex + pa.numPatches) {
+            handle.arrayIndex = i;
+            handle.patchIndex = patch;
+            handle.vertIndex  = (patch - pa.patchIndex) * pa.desc.GetNumControlVertices();
+            return handle;
+        }
+    }
+    assert(0);
+    return handle;
+}
 Index *
 PatchTable::getSharpnessIndices(int arrayIndex) {
     return &_sharpnessIndices[getPatchArray(arrayIndex).patchIndex];
@@ -348,6 +380,161 @@ PatchTable::GetSingleCreasePatchSharpnessValue(int arrayIndex, int patchIndex) c
     return _sharpnessValues[index];
 }
 
+bool
+PatchTable::GetPatchNeighbor(PatchHandle const & handle, int edge, int half,
+    PatchHandle & neighbor, int & neighborEdge) const {
+
+    if (! HasPatchAdjacency()) return false;
+
+    assert((edge>=0 && edge<4) && (half>=0 && half<2));
+    int slot = handle.patchIndex * 8 + edge * 2 + half;
+
+    if (_adjacencyPatches[slot] == Vtr::INDEX_INVALID) return false;
+
+    neighbor     = getPatchHandle(_adjacencyPatches[slot]);
+    neighborEdge = _adjacencyEdges[slot];
+    return true;
+}
+
+namespace {
+    //
+    //  Rotate and scale a displacement leaving a patch through one of its
+    //  edges into the neighbor entered through another -- decomposed into its
+    //  components along and outward from the edge, the latter being inward to
+    //  the neighbor and both scaled by the relative size of the neighbor:
+    //
+    inline void
+    crossPatchEdge(int edge, int adjEdge, float scale, float & ds, float & dt) {
+
+        float along = 0.0f, outward = 0.0f;
+        switch (edge) {
+            case 0: along =  ds; outward = -dt; break;
+            case 1: along =  dt; outward =  ds; break;
+            case 2: along = -ds; outward =  dt; break;
+            case 3: along = -dt; outward = -ds; break;
+        }
+        float nAlong  = along * scale,
+              nInward = outward * std::abs(scale);
+
+        switch (adjEdge) {
+            case 0: ds =  nAlong;  dt =  nInward; break;
+            case 1: ds = -nInward; dt =  nAlong;  break;
+            case 2: ds = -nAlong;  dt = -nInward; break;
+            case 3: ds =  nInward; dt = -nAlong;  break;
+        }
+    }
+}
+
+bool
+PatchTable::WalkPatchCoord(PatchHandle & handle, float & u, float & v,
+    float & du, float & dv) const {
+
+    if (! HasPatchAdjacency()) return false;
+
+    //
+    //  Follow the displacement in the normalized (s,t) space of each patch --
+    //  clipping it at the edge through which it leaves the patch and carrying
+    //  the remainder into the neighbor.  The whole displacement is carried
+    //  along with the remainder to return it in the space of the final patch:
+    //
+    PatchParam param = _paramTable[handle.patchIndex];
+
+    float s = u,
+          t = v;
+    param.Normalize(s, t);
+
+    float ds = du / param.GetParamFraction(),
+          dt = dv / param.GetParamFraction();
+
+    float dsTotal = ds,
+          dtTotal = dt;
+
+    //  Guard against cycling around a corner without progress:
+    int const maxStalledSteps = 8;
+
+    bool isComplete = true;
+    for (int stalledSteps = 0; ; ) {
+        s = std::max(0.0f, std::min(s, 1.0f));
+        t = std::max(0.0f, std::min(t, 1.0f));
+
+        float sEnd = s + ds,
+              tEnd = t + dt;
+        if ((sEnd >= 0.0f) && (sEnd <= 1.0f) && (tEnd >= 0.0f) && (tEnd <= 1.0f)) {
+            s = sEnd;
+            t = tEnd;
+            break;
+        }
+
+        //  Identify the first edge crossed, ordered counter-clockwise from v=0:
+        float clip = 2.0f;
+        int   edge = -1;
+        if ((tEnd < 0.0f) && (-t / dt < clip))         { clip = -t / dt;         edge = 0; }
+        if ((sEnd > 1.0f) && ((1.0f - s) / ds < clip)) { clip = (1.0f - s) / ds; edge = 1; }
+        if ((tEnd > 1.0f) && ((1.0f - t) / dt < clip)) { clip = (1.0f - t) / dt; edge = 2; }
+        if ((sEnd < 0.0f) && (-s / ds < clip))         { clip = -s / ds;         edge = 3; }
+        assert(edge >= 0);
+
+        s += clip * ds;
+        t += clip * dt;
+
+        ds *= 1.0f - clip;
+        dt *= 1.0f - clip;
+
+        float x = 0.0f;
+        switch (edge) {
+            case 0: x = s;        break;
+            case 1: x = t;        break;
+            case 2: x = 1.0f - s; break;
+            case 3: x = 1.0f - t; break;
+        }
+        x = std::max(0.0f, std::min(x, 1.0f));
+
+        int slot = handle.patchIndex * 8 + edge * 2 + ((x < 0.5f) ? 0 : 1);
+
+        stalledSteps = (clip > 0.0f) ? 0 : (stalledSteps + 1);
+
+        if ((_adjacencyPatches[slot] == Vtr::INDEX_INVALID) ||
+            (stalledSteps > maxStalledSteps)) {
+            isComplete = false;
+            break;
+        }
+
+        //  Locate the crossing on the edge of the neighbor and orient the
+        //  remaining (and whole) displacement with it:
+        float y0 = _adjacencyParams[slot * 2],
+              y1 = _adjacencyParams[slot * 2 + 1];
+
+        float scale = y1 - y0;
+        float y = std::max(0.0f, std::min(y0 + scale * x, 1.0f));
+
+        int adjEdge = _adjacencyEdges[slot];
+        switch (adjEdge) {
+            case 0: s = y;        t = 0.0f;     break;
+            case 1: s = 1.0f;     t = y;        break;
+            case 2: s = 1.0f - y; t = 1.0f;     break;
+            case 3: s = 0.0f;     t = 1.0f - y; break;
+        }
+        crossPatchEdge(edge, adjEdge, scale, ds, dt);
+        crossPatchEdge(edge, adjEdge, scale, dsTotal, dtTotal);
+
+        handle = getPatchHandle(_adjacencyPatches[slot]);
+    }
+
+    //  Clamp a location stopped at an edge (beyond which it may have been
+    //  pushed by round-off) before mapping it to the base face:
+    s = std::max(0.0f, std::min(s, 1.0f));
+    t = std::max(0.0f, std::min(t, 1.0f));
+
+    param = _paramTable[handle.patchIndex];
+    param.Unnormalize(s, t);
+
+    u = s;
+    v = t;
+    du = dsTotal * param.GetParamFraction();
+    dv = dtTotal * param.GetParamFraction();
+    return isComplete;
+}
+
 int
 PatchTable::GetNumLocalPoints() const {
     return _localPointStencils ? _localPointStencils->GetNumStencils() : 0;
@@ -378,8 +565,8 @@ PatchTable::IsFeatureAdaptive() const {
 
     for (int i=0; i<GetNumPatchArrays(); ++i) {
         PatchDescriptor const & desc = _patchArrays[i].desc;
-        if (desc.GetType()>=PatchDescriptor::REGULAR &&
-            desc.GetType()<=PatchDescriptor::GREGORY_BASIS) {
+        if (desc.GetType()>=PatchDescriptor::LOOP &&
+            desc.GetType()<=PatchDescriptor::EIGEN_BASIS) {
             return true;
         }
     }
@@ -441,8 +628,7 @@ PatchTable::populateVaryingVertices() {
     // patch. This indexing is redundant for triangles and quads and
     // could be made redunant for other patch types if we reorganized
     // the vertex patch indices so that the zero ring indices always occured
-    // first. This will also need to be updated when we add support for
-    // triangle patches.
+    // first.
     int numVaryingCVs = _varyingDesc.GetNumControlVertices();
     for (int arrayIndex=0; arrayIndex<(int)_patchArrays.size(); ++arrayIndex) {
         PatchArray const & pa = getPatchArray(arrayIndex);
@@ -460,6 +646,16 @@ PatchTable::populateVaryingVertices() {
                 _varyingVerts[start+1] = vertexCVs[5];
                 _varyingVerts[start+2] = vertexCVs[10];
                 _varyingVerts[start+3] = vertexCVs[15];
+            } else if (patchType == PatchDescriptor::EIGEN_BASIS) {
+                // the quad is oriented with the extraordinary vertex first
+                int rotation = GetPatchParam(arrayIndex, patch).GetRotation();
+                for (int i=0; i<4; ++i) {
+                    _varyingVerts[start+(rotation+i)%4] = vertexCVs[i];
+                }
+            } else if (patchType == PatchDescriptor::LOOP) {
+                _varyingVerts[start+0] = vertexCVs[3];
+                _varyingVerts[start+1] = vertexCVs[6];
+                _varyingVerts[start+2] = vertexCVs[7];
             } else if (patchType == PatchDescriptor::QUADS) {
                 _varyingVerts[start+0] = vertexCVs[0];
                 _varyingVerts[start+1] = vertexCVs[1];
@@ -574,15 +770,24 @@ PatchTable::EvaluateBasis(
     float wP[], float wDs[], float wDt[],
     float wDss[], float wDst[], float wDtt[]) const {
 
-    PatchDescriptor::Type patchType = GetPatchArrayDescriptor(handle.arrayIndex).GetType();
+    PatchDescriptor const & desc = GetPatchArrayDescriptor(handle.arrayIndex);
+    PatchDescriptor::Type patchType = desc.GetType();
     PatchParam const & param = _paramTable[handle.patchIndex];
 
     if (patchType == PatchDescriptor::REGULAR) {
         internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
         internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::EIGEN_BASIS) {
+        assert(desc.GetValence() < (int)_eigenBases.size() && _eigenBases[desc.GetValence()]);
+        internal::GetEigenBasisWeights(*_eigenBases[desc.GetValence()],
+            param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::QUADS) {
         internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::LOOP) {
+        internal::GetLoopWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::TRIANGLES) {
+        internal::GetLinearTriangleWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else {
         assert(0);
     }
@@ -599,7 +804,11 @@ PatchTable::EvaluateBasisVarying(
 
     PatchParam const & param = _paramTable[handle.patchIndex];
 
-    internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    if (_varyingDesc.GetType() == PatchDescriptor::TRIANGLES) {
+        internal::GetLinearTriangleWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else {
+        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    }
 }
 
 //
@@ -623,6 +832,10 @@ PatchTable::EvaluateBasisFaceVarying(
         internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::QUADS) {
         internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::LOOP) {
+        internal::GetLoopWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::TRIANGLES) {
+        internal::GetLinearTriangleWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else {
         assert(0);
     }
@@ -40,6 +40,10 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
+namespace internal {
+    class EigenBasis;
+}
+
 /// \brief Container for arrays of parametric patches
 ///
 /// PatchTable contains topology and parametric information about the patches
@@ -262,6 +266,74 @@ public:
     //@}
 
 
+    //@{
+    ///  @name Patch adjacency
+    ///
+    /// \anchor patch_adjacency
+    ///
+    /// \brief Accessors for the neighbors of patches, which are optionally
+    ///        generated for quadrilateral patches by the PatchTableFactory
+    ///
+    /// The edges of a patch are ordered counter-clockwise from the edge at
+    /// v=0 of its parameterization, and each half of an edge is adjacent to
+    /// a single patch -- the same for both halves unless the neighbor is of
+    /// the next level (as at transition edges).  Neighbors may be rotated
+    /// relative to the patch, e.g. when in adjacent faces.
+    ///
+
+    /// \brief Returns true if the table includes the adjacency of patches
+    bool HasPatchAdjacency() const { return ! _adjacencyPatches.empty(); }
+
+    /// \brief Returns the neighbor of half of an edge of a patch
+    ///
+    /// @param handle        A patch handle
+    ///
+    /// @param edge          The edge of the patch (0-3)
+    ///
+    /// @param half          The half of the edge (0 or 1, following the
+    ///                      orientation of the edge)
+    ///
+    /// @param neighbor      The handle of the neighboring patch
+    ///
+    /// @param neighborEdge  The edge of the neighbor adjacent to the patch
+    ///
+    /// @return              False if the edge has no neighbor, e.g. at a
+    ///                      boundary or hole, or adjacency was not generated
+    ///
+    bool GetPatchNeighbor(PatchHandle const & handle, int edge, int half,
+                          PatchHandle & neighbor, int & neighborEdge) const;
+
+    /// \brief Moves a (u,v) location of a patch by the given displacement,
+    ///        crossing into neighboring patches as necessary
+    ///
+    /// The displacement is followed in a straight line through each patch
+    /// it crosses -- rotated and scaled to the parameterization of each
+    /// neighbor entered -- without locating the patch of the result with a
+    /// PatchMap.  Patch adjacency is required.
+    ///
+    /// @param handle  The patch containing the location -- updated with the
+    ///                patch containing the result
+    ///
+    /// @param u       Patch coordinate (in base face normalized space)
+    ///
+    /// @param v       Patch coordinate (in base face normalized space)
+    ///
+    /// @param du      Displacement in u (in the normalized space of the base
+    ///                face of the initial patch) -- updated with the whole
+    ///                displacement rotated and scaled into that of the final
+    ///                patch, e.g. to continue in the same direction
+    ///
+    /// @param dv      Displacement in v (as with du)
+    ///
+    /// @return        False if the displacement was stopped short at an edge
+    ///                with no neighbor (where the location is left), or if
+    ///                the table has no patch adjacency
+    ///
+    bool WalkPatchCoord(PatchHandle & handle, float & u, float & v,
+                        float & du, float & dv) const;
+    //@}
+
+
     //@{
     ///  @name Varying data
     ///
@@ -371,6 +443,10 @@ public:
     /// \brief Evaluate basis functions for position and derivatives at a
     /// given (u,v) parametric location of a patch.
     ///
+    /// The weight arrays must hold as many weights as the patch has control
+    /// vertices (see PatchDescriptor::GetNumControlVertices()), which varies
+    /// with the valence for EIGEN_BASIS patches.
+    ///
     /// @param handle  A patch handle identifying the sub-patch containing the
     ///                (u,v) location
     ///
@@ -459,6 +535,8 @@ protected:
 
     Index getPatchIndex(int array, int patch) const;
 
+    PatchHandle getPatchHandle(Index patch) const;
+
     PatchParamArray getPatchParams(int arrayIndex);
 
     Index * getSharpnessIndices(Index arrayIndex);
@@ -544,6 +622,8 @@ private:
     StencilTable const * _localPointStencils;  // endcap basis conversion stencils
     StencilTable const * _localPointVaryingStencils; // endcap varying stencils (for convenience)
 
+    std::vector<internal::EigenBasis *> _eigenBases; // eigen structures (indexed by valence)
+
     //
     // Varying data
     //
@@ -566,6 +646,19 @@ private:
 
     std::vector<Index>   _sharpnessIndices; // Indices of single-crease sharpness (one per patch)
     std::vector<float>   _sharpnessValues;  // Sharpness values.
+
+    //
+    // Patch adjacency (optional)
+    //
+    // Each half of each edge of each patch (eight per patch) is assigned its
+    // neighbor, the adjacent edge of the neighbor, and the parameters along
+    // that edge (oriented counter-clockwise) at either end of the edge of the
+    // patch -- extrapolated beyond the neighbor when it is of the next level.
+    //
+
+    std::vector<Index>         _adjacencyPatches; // Neighbor (or INDEX_INVALID)
+    std::vector<unsigned char> _adjacencyEdges;   // Edge of the neighbor
+    std::vector<float>         _adjacencyParams;  // Parameters along the edge (two each)
 };
 
 template <class T>
@@ -23,6 +23,7 @@
 //
 #include "../far/patchTableFactory.h"
 #include "../far/error.h"
+#include "../far/patchMap.h"
 #include "../far/ptexIndices.h"
 #include "../far/topologyRefiner.h"
 #include "../vtr/level.h"
@@ -32,11 +33,18 @@
 #include "../far/endCapBSplineBasisPatchFactory.h"
 #include "../far/endCapGregoryBasisPatchFactory.h"
 #include "../far/endCapLegacyGregoryPatchFactory.h"
+#include "../far/endCapLoopPatchFactory.h"
+#include "../far/eigenBasis.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 namespace Far {
@@ -100,10 +108,53 @@ isEdgeSingular(Level const & level, FVarLevel const * fvarLevel, Index eIndex,
     return (*iTag & *iMask) > 0;
 }
 
+//
+//  Faces of the base level left unrefined by sparse refinement may share a vertex
+//  with an irregular face (which is always refined) -- no regular neighborhood
+//  exists around such a vertex, so its span is delimited by the edges of the
+//  irregular faces:
+//
+inline bool
+isVertexIncidentIrregularFace(Level const & level, Index vIndex, int regularFaceSize)
+{
+    ConstIndexArray vFaces = level.getVertexFaces(vIndex);
+    for (int i = 0; i < vFaces.size(); ++i) {
+        if (level.getNumFaceVertices(vFaces[i]) != regularFaceSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool
+isEdgeIncidentIrregularFace(Level const & level, Index eIndex, int regularFaceSize)
+{
+    ConstIndexArray eFaces = level.getEdgeFaces(eIndex);
+    for (int i = 0; i < eFaces.size(); ++i) {
+        if (level.getNumFaceVertices(eFaces[i]) != regularFaceSize) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool
+isEdgeSpanBoundary(Level const & level, FVarLevel const * fvarLevel, Index eIndex,
+                   Level::ETag eTagMask, int regularFaceSize)
+{
+    return isEdgeSingular(level, fvarLevel, eIndex, eTagMask) ||
+           (regularFaceSize && isEdgeIncidentIrregularFace(level, eIndex, regularFaceSize));
+}
+
+//
+//  When a regular face size is given, edges of faces of other sizes also
+//  delimit the span (see isVertexIncidentIrregularFace() above):
+//
 void
 identifyManifoldCornerSpan(Level const & level, Index fIndex,
                            int fCorner, Level::ETag eTagMask,
-                           Level::VSpan & vSpan, int fvc = -1)
+                           Level::VSpan & vSpan, int fvc = -1,
+                           int regularFaceSize = 0)
 {
     FVarLevel const * fvarLevel = (fvc < 0) ? 0 : &level.getFVarLevel(fvc);
 
@@ -120,14 +171,14 @@ identifyManifoldCornerSpan(Level const & level, Index fIndex,
     vSpan._numFaces = 1;
 
     int iLeading  = iLeadingStart;
-    while (! isEdgeSingular(level, fvarLevel, vEdges[iLeading], eTagMask)) {
+    while (! isEdgeSpanBoundary(level, fvarLevel, vEdges[iLeading], eTagMask, regularFaceSize)) {
         ++vSpan._numFaces;
         iLeading = (iLeading + nEdges - 1) % nEdges;
         if (iLeading == iTrailingStart) break;
     }
 
     int iTrailing = iTrailingStart;
-    while (! isEdgeSingular(level, fvarLevel, vEdges[iTrailing], eTagMask)) {
+    while (! isEdgeSpanBoundary(level, fvarLevel, vEdges[iTrailing], eTagMask, regularFaceSize)) {
         ++vSpan._numFaces;
         iTrailing = (iTrailing + 1) % nEdges;
         if (iTrailing == iLeadingStart) break;
@@ -201,6 +252,27 @@ offsetAndPermuteIndices(Far::Index const indices[], int count,
     }
 }
 
+//
+//  The boundary mask of a regular triangle combines the three bits of its
+//  boundary edges or, when it has no boundary edges, those of its boundary
+//  vertices with the fourth bit set.  Combinations of boundary edges and
+//  vertices other than those of the vertices of the boundary edges are not
+//  supported by the regular patch (-1 is returned):
+//
+inline int
+encodeTriangleBoundaryMask(int eBoundaryMask, int vBoundaryMask) {
+
+    if (eBoundaryMask == 0) {
+        return vBoundaryMask ? (vBoundaryMask | 8) : 0;
+    }
+    static int const eMaskToVMask[8] = { 0, 3, 6, 7, 5, 7, 7, 7 };
+
+    if ((eBoundaryMask == 7) || (vBoundaryMask & ~eMaskToVMask[eBoundaryMask])) {
+        return -1;
+    }
+    return eBoundaryMask;
+}
+
 inline int
 assignSharpnessIndex(float sharpness, std::vector<float> & sharpnessValues) {
 
@@ -243,6 +315,14 @@ public:
     };
     typedef std::vector<PatchTuple> PatchTupleVector;
 
+    // Classification of each patch, selecting the patch array it is packed in:
+    enum PatchClass {
+        PATCH_REGULAR = 0,
+        PATCH_IRREGULAR,
+        PATCH_IRREGULAR_BOUNDARY,
+        PATCH_INELIGIBLE
+    };
+
 public:
     BuilderContext(TopologyRefiner const & refiner, Options options);
 
@@ -262,6 +342,8 @@ public:
                                       Level::VSpan cornerSpans[4],
                                       int fvcFactory = -1) const;
 
+    int GetEigenBasisPatchCorner(int levelIndex, Index faceIndex) const;
+
     // Methods to gather points associated with the different patch types
     int GatherLinearPatchPoints(Index * iptrs,
                                 PatchTuple const & patch,
@@ -270,12 +352,45 @@ public:
                                  PatchTuple const & patch,
                                  int boundaryMask,
                                  int fvcFactory = -1) const;
+    int gatherRegularTrianglePatchPoints(Index * iptrs,
+                                         PatchTuple const & patch,
+                                         int boundaryMask) const;
     template <class END_CAP_FACTORY_TYPE>
     int GatherIrregularPatchPoints(END_CAP_FACTORY_TYPE *endCapFactory,
                                    Index * iptrs,
                                    PatchTuple const & patch,
                                    Level::VSpan cornerSpans[4],
                                    int fvcFactory = -1) const;
+    template <class END_CAP_FACTORY_TYPE>
+    int AssignIrregularPatchPoints(END_CAP_FACTORY_TYPE *endCapFactory,
+                                   Index * iptrs,
+                                   PatchTuple const & patch,
+                                   Level::VSpan cornerSpans[4],
+                                   int fvcFactory = -1) const;
+    template <class END_CAP_FACTORY_TYPE>
+    void AppendIrregularPatchPointStencils(END_CAP_FACTORY_TYPE const *endCapFactory,
+                                           Index const * iptrs,
+                                           int numPatchPoints,
+                                           PatchTuple const & patch,
+                                           Level::VSpan cornerSpans[4],
+                                           int numPrevPoints,
+                                           StencilTable * vertexStencils,
+                                           StencilTable * varyingStencils,
+                                           int fvcFactory = -1) const;
+    int GatherEigenBasisPatchPoints(Index * iptrs,
+                                    PatchTuple const & patch,
+                                    int corner) const;
+
+    // Methods to carry forward the stencils of the end caps of a previous table
+    void InitializePreviousEndCaps();
+
+    bool AppendPreviousPatchPointStencils(Index const * iptrs,
+                                          PatchDescriptor const & desc,
+                                          PatchTuple const & patch,
+                                          PatchParam const & param,
+                                          int numPrevPoints,
+                                          StencilTable * vertexStencils,
+                                          StencilTable * varyingStencils) const;
 
     // Additional simple queries -- most regarding face-varying channels that hide
     // the mapping between channels in the source Refiner and corresponding channels
@@ -314,13 +429,17 @@ public:
 
     PtexIndices const ptexIndices;
 
+    // Number of vertices of the regular faces of the scheme (4 or 3)
+    int const regularFaceSize;
+
     // Counters accumulating each type of patch during topology traversal
     int numRegularPatches;
     int numIrregularPatches;
     int numIrregularBoundaryPatches;
 
-    // Tuple for each patch identified during topology traversal
+    // Tuple and PatchClass for each patch identified during topology traversal
     PatchTupleVector patches;
+    std::vector<unsigned char> patchClasses;
 
     std::vector<int> levelVertOffsets;
     std::vector< std::vector<int> > levelFVarValueOffsets;
@@ -328,14 +447,33 @@ public:
     // These are the indices of face-varying channels in the refiner
     // or empty if we are not populating face-varying data.
     std::vector<int> fvarChannelIndices;
+
+    // The previous table of an update (or NULL) and, when its end caps can be
+    // carried forward, the current index of each of its refined vertices and
+    // its end caps ordered by their parameterization
+    struct PreviousEndCap {
+        long long    key;
+        int          arrayIndex;
+        int          patchIndex;
+        unsigned int createdPoints;  // mask of the local points it created
+
+        bool operator<(PreviousEndCap const & other) const { return key < other.key; }
+    };
+    static long long GetPreviousEndCapKey(PatchParam const & param);
+
+    PatchTable const * previousTable;
+
+    std::vector<Index> previousVertices;
+    std::vector<PreviousEndCap> previousEndCaps;
 };
 
 // Constructor
 PatchTableFactory::BuilderContext::BuilderContext(
     TopologyRefiner const & ref, Options opts) :
     refiner(ref), options(opts), ptexIndices(refiner),
+    regularFaceSize(Sdc::SchemeTypeTraits::GetRegularFaceSize(ref.GetSchemeType())),
     numRegularPatches(0), numIrregularPatches(0),
-    numIrregularBoundaryPatches(0) {
+    numIrregularBoundaryPatches(0), previousTable(NULL) {
 
     if (options.generateFVarTables) {
         // If client-code does not select specific channels, default to all
@@ -386,6 +524,10 @@ PatchTableFactory::BuilderContext::GatherRegularPatchPoints(
 
     int fvcRefiner = GetRefinerFVarChannel(fvcFactory);
 
+    if (regularFaceSize == 3) {
+        return gatherRegularTrianglePatchPoints(iptrs, patch, boundaryMask);
+    }
+
     Index patchVerts[16];
 
     int bType  = 0;
@@ -438,6 +580,87 @@ PatchTableFactory::BuilderContext::GatherRegularPatchPoints(
     return 16;
 }
 
+int
+PatchTableFactory::BuilderContext::gatherRegularTrianglePatchPoints(
+        Index * iptrs, PatchTuple const & patch, int boundaryMask) const {
+
+    Level const & level = refiner.getLevel(patch.levelIndex);
+
+    int levelVertOffset = levelVertOffsets[patch.levelIndex];
+
+    //
+    //  The points gathered by Vtr for each boundary configuration are permuted
+    //  into the 12 points of the box spline (points missing along boundaries
+    //  are assigned to phantom points by the basis).  The configuration is
+    //  rotated so that its boundary feature is relative to the first corner,
+    //  first edge or the first two corners of the triangle:
+    //
+    static int const permuteInterior[12] =
+        { 3, 11, 4, 0, 10, 5, 1, 2, 9, 6, 7, 8 };
+    static int const permuteBoundaryEdge[3][12] = {
+        { -1,  8, -1,  0,  7, -1,  1,  2,  6,  3,  4,  5 },
+        {  6,  5,  7,  2,  4,  8,  0,  1,  3, -1, -1, -1 },
+        {  3, -1,  4,  1, -1,  5,  2,  0, -1,  6,  7,  8 } };
+    static int const permuteBoundaryVertex[3][12] = {
+        { -1, -1,  3,  0,  9,  4,  1,  2,  8,  5,  6,  7 },
+        {  8,  7,  9,  2,  6, -1,  0,  1,  5, -1,  3,  4 },
+        {  5,  4,  6,  1,  3,  7,  2,  0, -1,  8,  9, -1 } };
+    static int const permuteCornerVertex[3][12] = {
+        { -1, -1, -1,  0, -1, -1,  1,  2, -1,  3,  4,  5 },
+        { -1,  5, -1,  2,  4, -1,  0,  1,  3, -1, -1, -1 },
+        {  3, -1,  4,  1, -1,  5,  2,  0, -1, -1, -1, -1 } };
+    static int const permuteCornerEdge[3][12] = {
+        { -1, -1,  3,  0,  7, -1,  1,  2,  6, -1,  4,  5 },
+        {  6,  5,  7,  2,  4, -1,  0,  1, -1, -1,  3, -1 },
+        { -1, -1,  4,  1,  3,  5,  2,  0, -1,  6,  7, -1 } };
+
+    //  Feature (edge or vertex) of each single and paired edge or vertex mask:
+    static int const singleFeature[8] = { -1, 0, 1, -1, 2, -1, -1, -1 };
+    static int const cornerFeature[8] = { -1, -1, -1, 1, -1, 0, 2, -1 };
+    static int const pairedFeature[8] = { -1, -1, -1, 0, -1, 2, 1, -1 };
+
+    Index patchVerts[12];
+
+    int const * permutation = 0;
+
+    //  Topologically interior triangles use the interior points regardless of
+    //  any inf-sharp features:
+    if (!level.getFaceCompositeVTag(patch.faceIndex)._boundary) {
+        boundaryMask = 0;
+    }
+
+    int mask = boundaryMask & 7;
+    if (boundaryMask == 0) {
+        level.gatherTriRegularInteriorPatchPoints(patch.faceIndex, patchVerts, 0);
+        permutation = permuteInterior;
+    } else if (boundaryMask & 8) {
+        if (singleFeature[mask] >= 0) {
+            int vertInFace = singleFeature[mask];
+            level.gatherTriRegularBoundaryVertexPatchPoints(patch.faceIndex, patchVerts, vertInFace);
+            permutation = permuteBoundaryVertex[vertInFace];
+        } else {
+            int edgeInFace = pairedFeature[mask];
+            assert(edgeInFace >= 0);
+            level.gatherTriRegularCornerEdgePatchPoints(patch.faceIndex, patchVerts, edgeInFace);
+            permutation = permuteCornerEdge[edgeInFace];
+        }
+    } else {
+        if (singleFeature[mask] >= 0) {
+            int edgeInFace = singleFeature[mask];
+            level.gatherTriRegularBoundaryEdgePatchPoints(patch.faceIndex, patchVerts, edgeInFace);
+            permutation = permuteBoundaryEdge[edgeInFace];
+        } else {
+            int vertInFace = cornerFeature[mask];
+            assert(vertInFace >= 0);
+            level.gatherTriRegularCornerVertexPatchPoints(patch.faceIndex, patchVerts, vertInFace);
+            permutation = permuteCornerVertex[vertInFace];
+        }
+    }
+
+    offsetAndPermuteIndices(patchVerts, 12, levelVertOffset, permutation, iptrs);
+    return 12;
+}
+
 template <class END_CAP_FACTORY_TYPE>
 int
 PatchTableFactory::BuilderContext::GatherIrregularPatchPoints(
@@ -461,6 +684,55 @@ PatchTableFactory::BuilderContext::GatherIrregularPatchPoints(
     return cvs.size();
 }
 
+template <class END_CAP_FACTORY_TYPE>
+int
+PatchTableFactory::BuilderContext::AssignIrregularPatchPoints(
+        END_CAP_FACTORY_TYPE *endCapFactory,
+        Index * iptrs, PatchTuple const & patch,
+        Level::VSpan cornerSpans[4],
+        int fvcFactory) const {
+
+    Level const & level = refiner.getLevel(patch.levelIndex);
+
+    int levelVertOffset = (fvcFactory < 0)
+                        ? levelVertOffsets[patch.levelIndex]
+                        : levelFVarValueOffsets[fvcFactory][patch.levelIndex];
+
+    int fvcRefiner = GetRefinerFVarChannel(fvcFactory);
+
+    ConstIndexArray cvs = endCapFactory->AssignPatchPoints(
+        &level, patch.faceIndex, cornerSpans, levelVertOffset, fvcRefiner);
+
+    for (int i = 0; i < cvs.size(); ++i) iptrs[i] = cvs[i];
+    return cvs.size();
+}
+
+template <class END_CAP_FACTORY_TYPE>
+void
+PatchTableFactory::BuilderContext::AppendIrregularPatchPointStencils(
+        END_CAP_FACTORY_TYPE const *endCapFactory,
+        Index const * iptrs, int numPatchPoints,
+        PatchTuple const & patch,
+        Level::VSpan cornerSpans[4],
+        int numPrevPoints,
+        StencilTable * vertexStencils,
+        StencilTable * varyingStencils,
+        int fvcFactory) const {
+
+    Level const & level = refiner.getLevel(patch.levelIndex);
+
+    int levelVertOffset = (fvcFactory < 0)
+                        ? levelVertOffsets[patch.levelIndex]
+                        : levelFVarValueOffsets[fvcFactory][patch.levelIndex];
+
+    int fvcRefiner = GetRefinerFVarChannel(fvcFactory);
+
+    endCapFactory->AppendPatchPointStencils(
+        &level, patch.faceIndex, cornerSpans, levelVertOffset, fvcRefiner,
+        ConstIndexArray(iptrs, numPatchPoints), numPrevPoints,
+        vertexStencils, varyingStencils);
+}
+
 bool
 PatchTableFactory::BuilderContext::IsPatchEligible(
         int levelIndex, Index faceIndex) const {
@@ -488,11 +760,21 @@ PatchTableFactory::BuilderContext::IsPatchEligible(
     //  their full neighborhood available and so are considered "incomplete":
     //
     Vtr::ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
-    assert(fVerts.size() == 4);
+    assert(fVerts.size() == regularFaceSize);
 
     if (level.getFaceCompositeVTag(fVerts)._incomplete) {
         return false;
     }
+
+    //
+    //  Children of faces not selected for refinement are incomplete even when all
+    //  of their vertices are complete (as occurs for the middle child of a triangle
+    //  surrounded by selected faces) -- their parent is the leaf:
+    //
+    if ((levelIndex > 0) &&
+        refiner.getRefinement(levelIndex-1).getChildFaceTag(faceIndex)._incomplete) {
+        return false;
+    }
     return true;
 }
 
@@ -559,6 +841,22 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
     //  Retrieve the composite VTag for the four corners:
     Level::VTag fCompVTag = level.getFaceCompositeVTag(faceIndex, fvcRefiner);
 
+    //  Faces of the base level are only left unrefined by sparse refinement when
+    //  away from the refined region -- those without a smooth corner (for which
+    //  no regular boundary patch exists) or sharing a vertex with an irregular
+    //  face are irregular:
+    if (levelIndex == 0) {
+        if ((regularFaceSize == 4) && !(fCompVTag._rule & Sdc::Crease::RULE_SMOOTH)) {
+            return false;
+        }
+        ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
+        for (int i = 0; i < fVerts.size(); ++i) {
+            if (isVertexIncidentIrregularFace(level, fVerts[i], regularFaceSize)) {
+                return false;
+            }
+        }
+    }
+
     //
     //  Patches around non-manifold features are currently regular -- will need to revise
     //  this when infinitely sharp patches are introduced later:
@@ -592,12 +890,15 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
             Level::VSpan vSpan;
             Level::ETag eMask = getSingularEdgeMask(true);
 
+            //  Number of faces regular on one side of an inf-sharp crease:
+            int regularCreaseFaces = (regularFaceSize == 4) ? 2 : 3;
+
             isRegular = true;
-            for (int i = 0; i < 4; ++i) {
+            for (int i = 0; i < regularFaceSize; ++i) {
                 if (vTags[i]._infIrregular) {
                     identifyManifoldCornerSpan(level, faceIndex, i, eMask, vSpan, fvcRefiner);
 
-                    isRegular = (vSpan._numFaces == (vTags[i]._infSharpCrease ? 2 : 1));
+                    isRegular = (vSpan._numFaces == (vTags[i]._infSharpCrease ? regularCreaseFaces : 1));
                     if (!isRegular) break;
                 }
             }
@@ -608,7 +909,7 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
         if (fCompVTag._xordinary && (levelIndex < 2)) {
             Level::VTag vTags[4];
             level.getFaceVTags(faceIndex, vTags, fvcRefiner);
-            for (int i = 0; i < 4; ++i) {
+            for (int i = 0; i < regularFaceSize; ++i) {
                 if (vTags[i]._xordinary && (vTags[i]._rule == Sdc::Crease::RULE_SMOOTH)) {
                     isRegular = false;
                 }
@@ -622,6 +923,12 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
             isRegular = IsPatchSmoothCorner(levelIndex, faceIndex, fvcRefiner);
         }
     }
+
+    //  Regular triangles are further limited to the boundaries supported by the
+    //  box spline patch:
+    if (isRegular && (regularFaceSize == 3)) {
+        isRegular = (GetRegularPatchBoundaryMask(levelIndex, faceIndex, fvcFactory) >= 0);
+    }
     return isRegular;
 }
 
@@ -634,6 +941,46 @@ PatchTableFactory::BuilderContext::GetRegularPatchBoundaryMask(
     //  Ignore the face-varying channel if the topology for the face is not distinct
     int fvcRefiner = GetDistinctRefinerFVarChannel(levelIndex, faceIndex, fvcFactory);
 
+    if (regularFaceSize == 3) {
+        //
+        //  Face-varying patches of the Loop scheme are linear, so only the vertex
+        //  topology is inspected here.  The boundary features used by the patch
+        //  (including inf-sharp features if inf-sharp patches are in use) must
+        //  be supported by the topology gathered for it, so unless the triangle is
+        //  topologically interior they must match its topological boundaries:
+        //
+        assert(fvcRefiner < 0);
+
+        Level::VTag vTags[3];
+        level.getFaceVTags(faceIndex, vTags);
+
+        Level::VTag fTag = Level::VTag::BitwiseOr(vTags, 3);
+        if (fTag._nonManifold) return -1;
+
+        ConstIndexArray fEdges = level.getFaceEdges(faceIndex);
+
+        int eTopoMask = 0, eSharpMask = 0;
+        int vTopoMask = 0, vSharpMask = 0;
+        for (int i = 0; i < 3; ++i) {
+            Level::ETag eTag = level.getEdgeTag(fEdges[i]);
+
+            eTopoMask  |= eTag._boundary << i;
+            eSharpMask |= (eTag._boundary ||
+                           (options.useInfSharpPatch && eTag._infSharp)) << i;
+
+            vTopoMask  |= vTags[i]._boundary << i;
+            vSharpMask |= (vTags[i]._boundary ||
+                           (options.useInfSharpPatch && vTags[i]._infSharpEdges)) << i;
+        }
+        int topoMask  = encodeTriangleBoundaryMask(eTopoMask,  vTopoMask);
+        int sharpMask = encodeTriangleBoundaryMask(eSharpMask, vSharpMask);
+
+        if ((topoMask == 15) || ((topoMask != 0) && (topoMask != sharpMask))) {
+            return -1;
+        }
+        return sharpMask;
+    }
+
     //  Gather the VTags for the four corners.  Regardless of the options for
     //  treating non-manifold or inf-sharp patches, for a regular patch we can
     //  infer all that we need need from tags for the corner vertices:
@@ -731,13 +1078,16 @@ PatchTableFactory::BuilderContext::GetIrregularPatchCornerSpans(
         bool noFVarMisMatch = (fvcRefiner < 0) || !fvarTags[i]._mismatch;
         bool testInfSharp   = options.useInfSharpPatch &&
                                 (vTags[i]._infSharpEdges && (vTags[i]._rule != Sdc::Crease::RULE_DART));
+        bool testIrregFaces = (levelIndex == 0) &&
+                                isVertexIncidentIrregularFace(level, fVerts[i], regularFaceSize);
 
-        if (noFVarMisMatch && !testInfSharp) {
+        if (noFVarMisMatch && !testInfSharp && !testIrregFaces) {
             cornerSpans[i].clear();
         } else {
             if (!vTags[i]._nonManifold) {
                 identifyManifoldCornerSpan(
-                        level, faceIndex, i, singularEdgeMask, cornerSpans[i], fvcRefiner);
+                        level, faceIndex, i, singularEdgeMask, cornerSpans[i], fvcRefiner,
+                        testIrregFaces ? regularFaceSize : 0);
             } else {
                 identifyNonManifoldCornerSpan(
                         level, faceIndex, i, singularEdgeMask, cornerSpans[i], fvcRefiner);
@@ -760,6 +1110,284 @@ PatchTableFactory::BuilderContext::GetIrregularPatchCornerSpans(
     }
 }
 
+//
+//  Identifies irregular patches that can be evaluated exactly with the eigen
+//  basis, returning the corner of their extraordinary vertex (or -1):  the face
+//  must be a quad whose only extraordinary vertex is smooth and interior, and
+//  whose other corners are smooth, interior and regular -- the same rules then
+//  applying at all levels of subdivision around the extraordinary vertex.
+//
+int
+PatchTableFactory::BuilderContext::GetEigenBasisPatchCorner(
+        int levelIndex, Index faceIndex) const {
+
+    Level const & level = refiner.getLevel(levelIndex);
+
+    ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
+    if (fVerts.size() != 4) return -1;
+
+    int corner = -1;
+    for (int i = 0; i < 4; ++i) {
+        Level::VTag vTag = level.getVertexTag(fVerts[i]);
+        if (vTag._nonManifold || vTag._boundary || vTag._infSharpEdges ||
+            vTag._semiSharpEdges || (vTag._rule != Sdc::Crease::RULE_SMOOTH)) {
+            return -1;
+        }
+
+        ConstIndexArray vFaces = level.getVertexFaces(fVerts[i]);
+        for (int j = 0; j < vFaces.size(); ++j) {
+            if (level.getFaceVertices(vFaces[j]).size() != 4) return -1;
+        }
+        if (vFaces.size() != 4) {
+            if ((corner >= 0) || (vFaces.size() < 3)) return -1;
+            corner = i;
+        }
+    }
+    return corner;
+}
+
+//
+//  Gathers the 2N+8 points of an eigen basis patch in the order expected by
+//  the EigenBasis (see eigenBasis.h), oriented from the given corner:
+//
+int
+PatchTableFactory::BuilderContext::GatherEigenBasisPatchPoints(
+        Index * iptrs, PatchTuple const & patch, int corner) const {
+
+    Level const & level = refiner.getLevel(patch.levelIndex);
+
+    int levelVertOffset = levelVertOffsets[patch.levelIndex];
+
+    ConstIndexArray fVerts = level.getFaceVertices(patch.faceIndex);
+
+    Index vIndex = fVerts[corner];
+
+    ConstIndexArray      vFaces   = level.getVertexFaces(vIndex);
+    ConstLocalIndexArray vInFaces = level.getVertexFaceLocalIndices(vIndex);
+
+    int valence = vFaces.size();
+    int start = vFaces.FindIndex(patch.faceIndex);
+
+    //  The ring of edge and face points, starting with the face of the patch:
+    int numPoints = 0;
+    iptrs[numPoints++] = vIndex;
+    for (int i = 0; i < valence; ++i) {
+        int j = (start + i) % valence;
+
+        ConstIndexArray fPoints = level.getFaceVertices(vFaces[j]);
+        iptrs[numPoints++] = fPoints[(vInFaces[j] + 1) & 3];
+        iptrs[numPoints++] = fPoints[(vInFaces[j] + 2) & 3];
+    }
+
+    //  The outer points from the faces diagonally opposite the patch at its
+    //  three regular corners:
+    static int const outerPoints[3][2] = { { 2, 3 }, { 1, 3 }, { 1, 2 } };
+
+    for (int i = 1; i < 4; ++i) {
+        Index cIndex = fVerts[(corner + i) & 3];
+
+        ConstIndexArray      cFaces   = level.getVertexFaces(cIndex);
+        ConstLocalIndexArray cInFaces = level.getVertexFaceLocalIndices(cIndex);
+
+        int diagonal = (cFaces.FindIndexIn4Tuple(patch.faceIndex) + 2) & 3;
+
+        ConstIndexArray fPoints = level.getFaceVertices(cFaces[diagonal]);
+        for (int k = outerPoints[i-1][0]; k <= outerPoints[i-1][1]; ++k) {
+            iptrs[numPoints++] = fPoints[(cInFaces[diagonal] + k) & 3];
+        }
+    }
+    assert(numPoints == 2 * valence + 8);
+
+    for (int i = 0; i < numPoints; ++i) {
+        iptrs[i] += levelVertOffset;
+    }
+    return numPoints;
+}
+
+//
+//  When updating the table of a refiner updated by TopologyRefiner::UpdateSparse(),
+//  an end cap of the previous table with the same type and parameterization, whose
+//  corners have the same neighborhoods as before, has the same local points -- the
+//  stencils of those it creates are then copied from the previous table with their
+//  sources remapped to the current refined vertices, provided the previous end cap
+//  also created them (rather than sharing them with preceding end caps):
+//
+long long
+PatchTableFactory::BuilderContext::GetPreviousEndCapKey(PatchParam const & param) {
+
+    return ((long long)param.GetFaceId() << 25) | ((long long)param.GetDepth() << 21) |
+           ((long long)param.GetU() << 11) | ((long long)param.GetV() << 1) |
+           (long long)param.NonQuadRoot();
+}
+
+void
+PatchTableFactory::BuilderContext::InitializePreviousEndCaps() {
+
+    previousVertices.clear();
+    previousEndCaps.clear();
+
+    int numPrevLevels = refiner.getNumPrevLevels();
+    if (!previousTable || (numPrevLevels == 0)) return;
+
+    //  Identify the current vertex of each previous refined vertex:
+    std::vector<int> prevLevelVertOffsets(numPrevLevels + 1, 0);
+    for (int levelIndex=0; levelIndex<numPrevLevels; ++levelIndex) {
+        prevLevelVertOffsets[levelIndex+1] =
+            prevLevelVertOffsets[levelIndex] + refiner.getNumPrevVertices(levelIndex);
+    }
+    previousVertices.resize(prevLevelVertOffsets[numPrevLevels], INDEX_INVALID);
+
+    int numLevels = std::min(numPrevLevels, refiner.GetNumLevels());
+    for (int levelIndex=0; levelIndex<numLevels; ++levelIndex) {
+        Level const & level = refiner.getLevel(levelIndex);
+
+        for (Index vert=0; vert<level.getNumVertices(); ++vert) {
+            Index prevVert = refiner.getPrevVertex(levelIndex, vert);
+            if (IndexIsValid(prevVert)) {
+                previousVertices[prevLevelVertOffsets[levelIndex] + prevVert] =
+                    levelVertOffsets[levelIndex] + vert;
+            }
+        }
+    }
+
+    //  Identify the end caps and the local points each of them created (those
+    //  it is the first to refer to):
+    int numPrevVertices = (int)previousVertices.size(),
+        numPrevLocalPoints = previousTable->GetNumLocalPoints();
+
+    std::vector<unsigned char> isLocalPointCreated(numPrevLocalPoints, false);
+
+    for (int arrayIndex=0; arrayIndex<previousTable->GetNumPatchArrays(); ++arrayIndex) {
+
+        int numPatchPoints =
+            previousTable->GetPatchArrayDescriptor(arrayIndex).GetNumControlVertices();
+        if (numPatchPoints > (int)(8 * sizeof(unsigned int))) continue;
+
+        ConstIndexArray points = previousTable->GetPatchArrayVertices(arrayIndex);
+        ConstPatchParamArray params = previousTable->GetPatchParams(arrayIndex);
+
+        for (int patchIndex=0; patchIndex<params.size(); ++patchIndex) {
+
+            PreviousEndCap endCap;
+            endCap.key = GetPreviousEndCapKey(params[patchIndex]);
+            endCap.arrayIndex = arrayIndex;
+            endCap.patchIndex = patchIndex;
+            endCap.createdPoints = 0;
+
+            bool hasLocalPoints = false;
+            for (int i=0; i<numPatchPoints; ++i) {
+                int localPoint = points[patchIndex * numPatchPoints + i] - numPrevVertices;
+                if (localPoint < 0) continue;
+
+                //  The previous table was not created from the previous refiner:
+                if (localPoint >= numPrevLocalPoints) {
+                    previousEndCaps.clear();
+                    return;
+                }
+                hasLocalPoints = true;
+                if (! isLocalPointCreated[localPoint]) {
+                    isLocalPointCreated[localPoint] = true;
+                    endCap.createdPoints |= (1u << i);
+                }
+            }
+            if (hasLocalPoints) {
+                previousEndCaps.push_back(endCap);
+            }
+        }
+    }
+    std::sort(previousEndCaps.begin(), previousEndCaps.end());
+}
+
+bool
+PatchTableFactory::BuilderContext::AppendPreviousPatchPointStencils(
+        Index const * iptrs, PatchDescriptor const & desc,
+        PatchTuple const & patch, PatchParam const & param,
+        int numPrevPoints,
+        StencilTable * vertexStencils,
+        StencilTable * varyingStencils) const {
+
+    if (previousEndCaps.empty()) return false;
+
+    PreviousEndCap endCapKey;
+    endCapKey.key = GetPreviousEndCapKey(param);
+
+    std::vector<PreviousEndCap>::const_iterator endCap =
+        std::lower_bound(previousEndCaps.begin(), previousEndCaps.end(), endCapKey);
+    if ((endCap == previousEndCaps.end()) || (endCap->key != endCapKey.key) ||
+        !(previousTable->GetPatchArrayDescriptor(endCap->arrayIndex) == desc)) {
+        return false;
+    }
+
+    ConstIndexArray fVerts = refiner.getLevel(patch.levelIndex).getFaceVertices(patch.faceIndex);
+    for (int i=0; i<fVerts.size(); ++i) {
+        if (! refiner.isPrevVertexNeighborhoodEqual(patch.levelIndex, fVerts[i])) {
+            return false;
+        }
+    }
+
+    StencilTable const * prevTables[2] = {
+        previousTable->GetLocalPointStencilTable(),
+        varyingStencils ? previousTable->GetLocalPointVaryingStencilTable() : NULL };
+    if (!prevTables[0] || (varyingStencils && !prevTables[1])) return false;
+
+    //  The points created (numbered in the order of their stencils) must have been
+    //  created by the previous end cap:
+    int numPatchPoints = desc.GetNumControlVertices(),
+        numPrevVertices = (int)previousVertices.size(),
+        firstPoint = refiner.GetNumVerticesTotal() + numPrevPoints;
+
+    Index const * prevIptrs =
+        &previousTable->GetPatchArrayVertices(endCap->arrayIndex)[endCap->patchIndex * numPatchPoints];
+
+    Index prevLocalPoints[8 * sizeof(unsigned int)];
+    int numCreatedPoints = 0,
+        lastCreatedPoint = -1;
+    for (int i=0; i<numPatchPoints; ++i) {
+        int point = iptrs[i] - firstPoint;
+        if (point < 0) continue;
+
+        if ((point >= numPatchPoints) || !(endCap->createdPoints & (1u << i))) return false;
+
+        prevLocalPoints[point] = prevIptrs[i] - numPrevVertices;
+        lastCreatedPoint = std::max(lastCreatedPoint, point);
+        ++numCreatedPoints;
+    }
+    if (lastCreatedPoint + 1 != numCreatedPoints) return false;
+
+    //  The sources of their stencils must all have current vertices:
+    for (int i=0; i<2; ++i) {
+        if (! prevTables[i]) continue;
+
+        for (int j=0; j<numCreatedPoints; ++j) {
+            if (prevLocalPoints[j] >= prevTables[i]->GetNumStencils()) return false;
+
+            Stencil stencil = prevTables[i]->GetStencil(prevLocalPoints[j]);
+            for (int k=0; k<stencil.GetSize(); ++k) {
+                Index src = stencil.GetVertexIndices()[k];
+                if ((src >= numPrevVertices) || !IndexIsValid(previousVertices[src])) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    StencilTable * tables[2] = { vertexStencils, varyingStencils };
+    for (int i=0; i<2; ++i) {
+        if (! tables[i]) continue;
+
+        for (int j=0; j<numCreatedPoints; ++j) {
+            Stencil stencil = prevTables[i]->GetStencil(prevLocalPoints[j]);
+
+            tables[i]->_sizes.push_back(stencil.GetSize());
+            for (int k=0; k<stencil.GetSize(); ++k) {
+                tables[i]->_indices.push_back(previousVertices[stencil.GetVertexIndices()[k]]);
+                tables[i]->_weights.push_back(stencil.GetWeights()[k]);
+            }
+        }
+    }
+    return true;
+}
+
 //
 //  Reserves tables based on the contents of the PatchArrayVector in the PatchTable:
 //
@@ -782,7 +1410,8 @@ PatchTableFactory::allocateVertexTables(
 
     if (! context.refiner.IsUniform()) {
         table->allocateVaryingVertices(
-            PatchDescriptor(PatchDescriptor::QUADS), npatches);
+            PatchDescriptor((context.regularFaceSize == 4)
+                ? PatchDescriptor::QUADS : PatchDescriptor::TRIANGLES), npatches);
     }
 
     if (context.options.useSingleCreasePatch) {
@@ -820,13 +1449,19 @@ PatchTableFactory::allocateFVarChannels(
             table->allocateFVarPatchChannelValues(
                 PatchDescriptor(uniformType), npatches, fvc);
 
+        } else if (context.regularFaceSize == 3) {
+            //  Face-varying patches of the Loop scheme are always linear:
+            table->allocateFVarPatchChannelValues(
+                PatchDescriptor(PatchDescriptor::TRIANGLES), npatches, fvc);
+
         } else {
             bool allLinear = context.options.generateFVarLegacyLinearPatches ||
                 (interpolation == Sdc::Options::FVAR_LINEAR_ALL);
 
             PatchDescriptor::Type adaptiveType = allLinear
                     ? PatchDescriptor::QUADS
-                    : ((context.options.GetEndCapType() == Options::ENDCAP_GREGORY_BASIS)
+                    : (((context.options.GetEndCapType() == Options::ENDCAP_GREGORY_BASIS) ||
+                        (context.options.GetEndCapType() == Options::ENDCAP_EIGEN_BASIS))
                         ? PatchDescriptor::GREGORY_BASIS
                         : PatchDescriptor::REGULAR);
 
@@ -854,6 +1489,41 @@ PatchTableFactory::computePatchParam(
         v = 0,
         ofs = 1;
 
+    //
+    //  Triangles of the Loop scheme are parameterized with respect to their base
+    //  face, with the middle (and rotated) child of each triangle parameterized
+    //  from its opposite corner -- the rotation is encoded in the result:
+    //
+    if (refiner.GetSchemeType() == Sdc::SCHEME_LOOP) {
+        bool rotated = false;
+
+        for (int i = depth; i > 0; --i) {
+            Refinement const& refinement = refiner.getRefinement(i-1);
+
+            switch ( refinement.getChildFaceInParentFace(faceIndex) ) {
+                case 0 :                                             break;
+                case 1 : { u+=ofs;                                 } break;
+                case 2 : {         v+=ofs;                         } break;
+                case 3 : { u=ofs-u; v=ofs-v; rotated = !rotated; } break;
+            }
+            ofs = (unsigned short)(ofs << 1);
+
+            faceIndex = refinement.getChildFaceParentFace(faceIndex);
+        }
+        if (rotated) {
+            u = ofs - u;
+            v = ofs - v;
+        }
+
+        Index ptexIndex = context.ptexIndices.GetFaceId(faceIndex);
+        assert(ptexIndex!=-1);
+
+        PatchParam param;
+        param.Set(ptexIndex, (short)u, (short)v, (unsigned short) depth, false,
+                  (unsigned short) boundaryMask, (unsigned short) transitionMask);
+        return param;
+    }
+
     bool nonquad = (refiner.GetLevel(depth).GetFaceVertices(faceIndex).size() != 4);
 
     for (int i = depth; i > 0; --i) {
@@ -907,11 +1577,33 @@ PatchTableFactory::computePatchParam(
 PatchTable *
 PatchTableFactory::Create(TopologyRefiner const & refiner, Options options) {
 
-    if (refiner.IsUniform()) {
-        return createUniform(refiner, options);
-    } else {
-        return createAdaptive(refiner, options);
-    }
+    return create(refiner, options, NULL);
+}
+
+PatchTable *
+PatchTableFactory::Update(TopologyRefiner const & refiner, PatchTable const & previous,
+                          Options options) {
+
+    return create(refiner, options, &previous);
+}
+
+PatchTable *
+PatchTableFactory::create(TopologyRefiner const & refiner, Options options,
+                          PatchTable const * previous) {
+
+    PatchTable * table = refiner.IsUniform() ? createUniform(refiner, options)
+                                             : createAdaptive(refiner, options, previous);
+
+    //  Patch adjacency is limited to quadrilateral patches that each cover a
+    //  distinct part of the surface (only one level of a uniform table):
+    if (options.generatePatchAdjacency &&
+        (Sdc::SchemeTypeTraits::GetRegularFaceSize(refiner.GetSchemeType()) == 4) &&
+        !(refiner.IsUniform() && (options.generateAllLevels ||
+                                  options.triangulateQuads ||
+                                  (refiner.GetMaxLevel() == 0)))) {
+        populatePatchAdjacency(refiner, table);
+    }
+    return table;
 }
 
 PatchTable *
@@ -1070,11 +1762,16 @@ PatchTableFactory::createUniform(TopologyRefiner const & refiner, Options option
 }
 
 PatchTable *
-PatchTableFactory::createAdaptive(TopologyRefiner const & refiner, Options options) {
+PatchTableFactory::createAdaptive(TopologyRefiner const & refiner, Options options,
+                                  PatchTable const * previous) {
 
     assert(! refiner.IsUniform());
 
+    //  Single-crease patches are only supported for quadrilateral schemes:
+    options.useSingleCreasePatch &= (refiner.GetSchemeType() == Sdc::SCHEME_CATMARK);
+
     BuilderContext context(refiner, options);
+    context.previousTable = previous;
 
     //
     //  First identify the patches -- accumulating an inventory of
@@ -1121,6 +1818,13 @@ PatchTableFactory::identifyAdaptivePatches(BuilderContext & context) {
     //
     int reservePatches = refiner.GetNumFacesTotal();
     context.patches.reserve(reservePatches);
+    context.patchClasses.reserve(reservePatches);
+
+    bool legacyGregory =
+        (context.options.GetEndCapType() == Options::ENDCAP_LEGACY_GREGORY) &&
+        (context.regularFaceSize == 4);
+
+    std::vector<unsigned char> faceClasses;
 
     context.levelVertOffsets.push_back(0);
     context.levelFVarValueOffsets.resize(context.fvarChannelIndices.size());
@@ -1141,26 +1845,52 @@ PatchTableFactory::identifyAdaptivePatches(BuilderContext & context) {
                 + level.getNumFVarValues(refinerChannel));
         }
 
-        for (int faceIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
+        //
+        //  Classify the faces of the level independently of each other, then
+        //  gather the patches in face order:
+        //
+        int numFaces = level.getNumFaces();
 
-            if (context.IsPatchEligible(levelIndex, faceIndex)) {
+        faceClasses.resize(numFaces);
 
-                context.patches.push_back(BuilderContext::PatchTuple(faceIndex, levelIndex));
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1024)
+#endif
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
 
-                // Count the patches here to simplify subsequent allocation.
-                if (context.IsPatchRegular(levelIndex, faceIndex)) {
-                    ++context.numRegularPatches;
-                } else {
-                    ++context.numIrregularPatches;
+            unsigned char patchClass = BuilderContext::PATCH_INELIGIBLE;
 
+            if (context.IsPatchEligible(levelIndex, faceIndex)) {
+                if (context.IsPatchRegular(levelIndex, faceIndex)) {
+                    patchClass = BuilderContext::PATCH_REGULAR;
+                } else if (legacyGregory &&
+                           level.getFaceCompositeVTag(faceIndex)._boundary) {
                     // For legacy gregory patches we need to know how many
                     // irregular patches are also boundary patches.
-                    if (context.options.GetEndCapType() == Options::ENDCAP_LEGACY_GREGORY) {
-                        bool isBoundaryPatch = level.getFaceCompositeVTag(faceIndex)._boundary;
-                        context.numIrregularBoundaryPatches += isBoundaryPatch;
-                    }
+                    patchClass = BuilderContext::PATCH_IRREGULAR_BOUNDARY;
+                } else {
+                    patchClass = BuilderContext::PATCH_IRREGULAR;
                 }
             }
+            faceClasses[faceIndex] = patchClass;
+        }
+
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+
+            unsigned char patchClass = faceClasses[faceIndex];
+            if (patchClass == BuilderContext::PATCH_INELIGIBLE) continue;
+
+            context.patches.push_back(BuilderContext::PatchTuple(faceIndex, levelIndex));
+            context.patchClasses.push_back(patchClass);
+
+            // Count the patches here to simplify subsequent allocation.
+            if (patchClass == BuilderContext::PATCH_REGULAR) {
+                ++context.numRegularPatches;
+            } else {
+                ++context.numIrregularPatches;
+                context.numIrregularBoundaryPatches +=
+                    (patchClass == BuilderContext::PATCH_IRREGULAR_BOUNDARY);
+            }
         }
     }
 }
@@ -1176,16 +1906,20 @@ PatchTableFactory::populateAdaptivePatches(
 
     // State needed to populate an array in the patch table.
     // Pointers in this structure are initialized after the patch array
-    // data buffers have been allocated and are then incremented as we
-    // populate data into the patch table. Currently, we'll have at
-    // most 3 patch arrays: Regular, Irregular, and IrregularBoundary.
+    // data buffers have been allocated and address the data of the first
+    // patch of the array, each patch being populated at its own slot.
+    // Other than the patch arrays for eigen basis end caps (one per valence),
+    // we'll have at most 3 patch arrays: Regular, Irregular, and
+    // IrregularBoundary.
     struct PatchArrayBuilder {
         PatchArrayBuilder()
-            : patchType(PatchDescriptor::REGULAR), numPatches(0)
-            , iptr(NULL), pptr(NULL), sptr(NULL) { }
+            : patchType(PatchDescriptor::REGULAR), valence(0), numPatches(0)
+            , numPatchPoints(0), iptr(NULL), pptr(NULL), sptr(NULL) { }
 
         PatchDescriptor::Type patchType;
+        int valence;
         int numPatches;
+        int numPatchPoints;
 
         Far::Index *iptr;
         Far::PatchParam *pptr;
@@ -1198,15 +1932,87 @@ PatchTableFactory::populateAdaptivePatches(
         PatchArrayBuilder(PatchArrayBuilder const &) {}
         PatchArrayBuilder & operator=(PatchArrayBuilder const &) {return *this;}
 
-    } arrayBuilders[3];
+    };
     int R = 0, IR = 1, IRB = 2; // Regular, Irregular, IrregularBoundary
 
+    int numPatches = (int)context.patches.size();
+
+    // Irregular patches evaluated exactly with the eigen basis are identified
+    // by the corner of their extraordinary vertex, and the eigen structure is
+    // computed once for each valence encountered
+    std::vector<internal::EigenBasis *> eigenBases;
+    std::vector<signed char> patchEigenCorners;
+    std::vector<int> eigenValenceArrays;
+    int numEigenPatches = 0;
+    int numEigenArrays = 0;
+
+    if ((context.regularFaceSize == 4) &&
+        (context.options.GetEndCapType() == Options::ENDCAP_EIGEN_BASIS)) {
+
+        patchEigenCorners.resize(numPatches, -1);
+
+        std::vector<int> valenceCounts;
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+            if (context.patchClasses[patchIndex] == BuilderContext::PATCH_REGULAR) continue;
+
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
+
+            int corner = context.GetEigenBasisPatchCorner(patch.levelIndex, patch.faceIndex);
+            if (corner < 0) continue;
+
+            Level const & level = refiner.getLevel(patch.levelIndex);
+            int valence = level.getVertexFaces(
+                level.getFaceVertices(patch.faceIndex)[corner]).size();
+
+            if (valence >= (int)eigenBases.size()) {
+                eigenBases.resize(valence + 1, 0);
+                valenceCounts.resize(valence + 1, 0);
+            }
+            if (eigenBases[valence] == 0) {
+                eigenBases[valence] = new internal::EigenBasis;
+                if (! eigenBases[valence]->Initialize(valence)) {
+                    valenceCounts[valence] = -1;
+                }
+            }
+            if (valenceCounts[valence] < 0) continue;
+
+            patchEigenCorners[patchIndex] = (signed char)corner;
+            ++valenceCounts[valence];
+            ++numEigenPatches;
+        }
+
+        eigenValenceArrays.resize(eigenBases.size(), -1);
+        for (int valence=0; valence<(int)eigenBases.size(); ++valence) {
+            if (valenceCounts[valence] > 0) {
+                eigenValenceArrays[valence] = numEigenArrays++;
+            } else {
+                delete eigenBases[valence];
+                eigenBases[valence] = 0;
+            }
+        }
+    }
+
+    PatchArrayBuilder * arrayBuilders = new PatchArrayBuilder[3 + numEigenArrays];
+
     // Regular patches patches will be packed into the first patch array
     arrayBuilders[R].patchType = PatchDescriptor::REGULAR;
     arrayBuilders[R].numPatches = context.numRegularPatches;
     int numPatchArrays = (arrayBuilders[R].numPatches > 0);
 
-    switch(context.options.GetEndCapType()) {
+    // Irregular triangles of the Loop scheme are converted to the box spline
+    // basis for all types of end caps (see EndCapLoopPatchFactory) and are
+    // packed into the same patch array as regular patches
+    bool loopEndCaps = (context.regularFaceSize == 3) &&
+        (context.options.GetEndCapType() != Options::ENDCAP_NONE);
+
+    if (context.regularFaceSize == 3) {
+        arrayBuilders[R].patchType = PatchDescriptor::LOOP;
+        if (loopEndCaps) {
+            IR = IRB = R;
+            arrayBuilders[R].numPatches += context.numIrregularPatches;
+            numPatchArrays = (arrayBuilders[R].numPatches > 0);
+        }
+    } else switch(context.options.GetEndCapType()) {
     case Options::ENDCAP_BSPLINE_BASIS:
         // Irregular patches are converted to bspline basis and
         // will be packed into the same patch array as regular patches
@@ -1224,6 +2030,33 @@ PatchTableFactory::populateAdaptivePatches(
         arrayBuilders[IR].numPatches += context.numIrregularPatches;
         numPatchArrays += (arrayBuilders[IR].numPatches > 0);
         break;
+    case Options::ENDCAP_EIGEN_BASIS:
+        // Irregular patches not evaluated with the eigen basis are converted
+        // to Gregory basis as above, the others being packed into additional
+        // patch arrays for each valence
+        IR = IRB = numPatchArrays;
+        arrayBuilders[IR].patchType = PatchDescriptor::GREGORY_BASIS;
+        arrayBuilders[IR].numPatches += context.numIrregularPatches - numEigenPatches;
+        numPatchArrays += (arrayBuilders[IR].numPatches > 0);
+
+        for (int valence=0; valence<(int)eigenValenceArrays.size(); ++valence) {
+            if (eigenValenceArrays[valence] < 0) continue;
+
+            eigenValenceArrays[valence] = numPatchArrays++;
+            arrayBuilders[eigenValenceArrays[valence]].patchType = PatchDescriptor::EIGEN_BASIS;
+            arrayBuilders[eigenValenceArrays[valence]].valence = valence;
+        }
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+            if (patchEigenCorners[patchIndex] < 0) continue;
+
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
+            Level const & level = refiner.getLevel(patch.levelIndex);
+            int valence = level.getVertexFaces(level.getFaceVertices(
+                patch.faceIndex)[patchEigenCorners[patchIndex]]).size();
+
+            ++arrayBuilders[eigenValenceArrays[valence]].numPatches;
+        }
+        break;
     case Options::ENDCAP_LEGACY_GREGORY:
         // Irregular interior and irregular boundary patches each will be
         // packed into separate additional patch arrays.
@@ -1248,7 +2081,7 @@ PatchTableFactory::populateAdaptivePatches(
     int voffset=0, poffset=0, qoffset=0;
     for (int arrayIndex=0; arrayIndex<numPatchArrays; ++arrayIndex) {
         PatchArrayBuilder & arrayBuilder = arrayBuilders[arrayIndex];
-        table->pushPatchArray(PatchDescriptor(arrayBuilder.patchType),
+        table->pushPatchArray(PatchDescriptor(arrayBuilder.patchType, arrayBuilder.valence),
             arrayBuilder.numPatches, &voffset, &poffset, &qoffset );
     }
 
@@ -1264,6 +2097,8 @@ PatchTableFactory::populateAdaptivePatches(
     for (int arrayIndex=0; arrayIndex<numPatchArrays; ++arrayIndex) {
         PatchArrayBuilder & arrayBuilder = arrayBuilders[arrayIndex];
 
+        arrayBuilder.numPatchPoints =
+            table->GetPatchArrayDescriptor(arrayIndex).GetNumControlVertices();
         arrayBuilder.iptr = table->getPatchArrayVertices(arrayIndex).begin();
         arrayBuilder.pptr = table->getPatchParams(arrayIndex).begin();
         if (hasSharpness) {
@@ -1292,6 +2127,7 @@ PatchTableFactory::populateAdaptivePatches(
     EndCapBSplineBasisPatchFactory *endCapBSpline = NULL;
     EndCapGregoryBasisPatchFactory *endCapGregoryBasis = NULL;
     EndCapLegacyGregoryPatchFactory *endCapLegacyGregory = NULL;
+    EndCapLoopPatchFactory *endCapLoop = NULL;
     Vtr::internal::StackBuffer<EndCapBSplineBasisPatchFactory*,1> fvarEndCapBSpline;
     Vtr::internal::StackBuffer<EndCapGregoryBasisPatchFactory*,1> fvarEndCapGregoryBasis;
 
@@ -1299,8 +2135,17 @@ PatchTableFactory::populateAdaptivePatches(
     StencilTable *localPointVaryingStencils = NULL;
     Vtr::internal::StackBuffer<StencilTable*,1> localPointFVarStencils;
 
-    switch(context.options.GetEndCapType()) {
+    if (loopEndCaps) {
+        localPointStencils = new StencilTable(0);
+        localPointVaryingStencils = new StencilTable(0);
+        endCapLoop = new EndCapLoopPatchFactory(
+            refiner,
+            localPointStencils,
+            localPointVaryingStencils,
+            context.options.GetEndCapType() != Options::ENDCAP_BILINEAR_BASIS);
+    } else switch(context.options.GetEndCapType()) {
     case Options::ENDCAP_GREGORY_BASIS:
+    case Options::ENDCAP_EIGEN_BASIS:
         localPointStencils = new StencilTable(0);
         localPointVaryingStencils = new StencilTable(0);
         endCapGregoryBasis = new EndCapGregoryBasisPatchFactory(
@@ -1330,8 +2175,16 @@ PatchTableFactory::populateAdaptivePatches(
         localPointFVarStencils.SetSize((int)context.fvarChannelIndices.size());
 
         for (int fvc=0; fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
+            localPointFVarStencils[fvc] = NULL;
+            fvarEndCapBSpline[fvc] = NULL;
+            fvarEndCapGregoryBasis[fvc] = NULL;
+
+            // Face-varying patches of the Loop scheme are linear
+            if (context.regularFaceSize == 3) continue;
+
             switch(context.options.GetEndCapType()) {
             case Options::ENDCAP_GREGORY_BASIS:
+            case Options::ENDCAP_EIGEN_BASIS:
                 localPointFVarStencils[fvc] = new StencilTable(0);
                 fvarEndCapGregoryBasis[fvc] = new EndCapGregoryBasisPatchFactory(
                     refiner,
@@ -1352,8 +2205,45 @@ PatchTableFactory::populateAdaptivePatches(
         }
     }
 
-    // Populate patch data buffers
-    for (int patchIndex=0; patchIndex<(int)context.patches.size(); ++patchIndex) {
+    //
+    //  Assign each patch its slot in the array it is packed in (preserving
+    //  the order of the patches) so that patches can be populated
+    //  independently of each other.  Patches of a class for which no array
+    //  was allocated (i.e. irregular patches without end caps) are skipped.
+    //
+    int classArrays[3] = { R, IR, IRB };
+    std::vector<int> arrayCounts(numPatchArrays, 0);
+
+    std::vector<int> patchArrayIndices(numPatches);
+    std::vector<int> patchSlots(numPatches);
+    for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+        int arrayIndex = classArrays[context.patchClasses[patchIndex]];
+        if (numEigenPatches && (patchEigenCorners[patchIndex] >= 0)) {
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
+            Level const & level = refiner.getLevel(patch.levelIndex);
+            int valence = level.getVertexFaces(level.getFaceVertices(
+                patch.faceIndex)[patchEigenCorners[patchIndex]]).size();
+
+            arrayIndex = eigenValenceArrays[valence];
+        }
+        patchArrayIndices[patchIndex] = arrayIndex;
+        patchSlots[patchIndex] = (arrayIndex < numPatchArrays) ?
+            arrayCounts[arrayIndex]++ : -1;
+    }
+
+    std::vector<float> patchSharpness(hasSharpness ? numPatches : 0, 0.0f);
+
+    std::vector<unsigned char> patchRequiresEndCap(numPatches, false);
+
+    // Populate patch data buffers -- except for the points of irregular
+    // patches, which are gathered from the end-cap factories below
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+
+        int patchSlot = patchSlots[patchIndex];
+        if (patchSlot < 0) continue;
 
         BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
 
@@ -1361,19 +2251,18 @@ PatchTableFactory::populateAdaptivePatches(
 
         Level::VTag faceVTags = level.getFaceCompositeVTag(patch.faceIndex);
 
-        PatchArrayBuilder * arrayBuilder = 0;
+        PatchArrayBuilder const & arrayBuilder = arrayBuilders[patchArrayIndices[patchIndex]];
 
         // Properties to potentially be shared across vertex and face-varying patches:
         int          regBoundaryMask = 0;
         bool         isRegSingleCrease = false;
-        Level::VSpan irregCornerSpans[4];
         float        sharpness = 0.0f;
 
-        bool isRegular = context.IsPatchRegular(patch.levelIndex, patch.faceIndex);
-        if (isRegular) {
-            // Build the regular patch array
-            arrayBuilder = &arrayBuilders[R];
+        int eigenCorner = numEigenPatches ? patchEigenCorners[patchIndex] : -1;
 
+        bool isRegular =
+            (context.patchClasses[patchIndex] == BuilderContext::PATCH_REGULAR);
+        if (isRegular) {
             regBoundaryMask = context.GetRegularPatchBoundaryMask(patch.levelIndex, patch.faceIndex);
 
             // Test regular interior patches for a single-crease patch when specified:
@@ -1393,55 +2282,21 @@ PatchTableFactory::populateAdaptivePatches(
                     }
                 }
             }
-            
+
+            Index * iptr = arrayBuilder.iptr + patchSlot * arrayBuilder.numPatchPoints;
+
             //  The single-crease patch is an interior patch so ignore boundary mask when gathering:
             if (isRegSingleCrease) {
-                arrayBuilder->iptr +=
-                    context.GatherRegularPatchPoints(arrayBuilder->iptr, patch, 0);
+                context.GatherRegularPatchPoints(iptr, patch, 0);
             } else {
-                arrayBuilder->iptr +=
-                    context.GatherRegularPatchPoints(arrayBuilder->iptr, patch, regBoundaryMask);
+                context.GatherRegularPatchPoints(iptr, patch, regBoundaryMask);
             }
-        } else {
-            // Build the irregular patch array
-            arrayBuilder = &arrayBuilders[IR];
-
-            context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex, irregCornerSpans);
+        } else if (eigenCorner >= 0) {
+            Index * iptr = arrayBuilder.iptr + patchSlot * arrayBuilder.numPatchPoints;
 
-            // switch endcap patch type by option
-            switch(context.options.GetEndCapType()) {
-            case Options::ENDCAP_GREGORY_BASIS:
-                arrayBuilder->iptr +=
-                    context.GatherIrregularPatchPoints(
-                        endCapGregoryBasis, arrayBuilder->iptr, patch, irregCornerSpans);
-                break;
-            case Options::ENDCAP_BSPLINE_BASIS:
-                arrayBuilder->iptr +=
-                    context.GatherIrregularPatchPoints(
-                        endCapBSpline, arrayBuilder->iptr, patch, irregCornerSpans);
-                break;
-            case Options::ENDCAP_LEGACY_GREGORY:
-                // For legacy gregory patches we may need to switch to
-                // the irregular boundary patch array.
-                if (!faceVTags._boundary) {
-                    arrayBuilder->iptr +=
-                        context.GatherIrregularPatchPoints(
-                            endCapLegacyGregory, arrayBuilder->iptr, patch, irregCornerSpans);
-                } else {
-                    arrayBuilder = &arrayBuilders[IRB];
-                    arrayBuilder->iptr +=
-                        context.GatherIrregularPatchPoints(
-                            endCapLegacyGregory, arrayBuilder->iptr, patch, irregCornerSpans);
-                }
-                break;
-            case Options::ENDCAP_BILINEAR_BASIS:
-                // not implemented yet
-                assert(false);
-                break;
-            default:
-                // no endcap
-                break;
-            }
+            context.GatherEigenBasisPatchPoints(iptr, patch, eigenCorner);
+        } else {
+            patchRequiresEndCap[patchIndex] = true;
         }
 
         // Assign the patch param (why is transition mask 0 if not regular?)
@@ -1453,11 +2308,18 @@ PatchTableFactory::populateAdaptivePatches(
             computePatchParam(context,
                               patch.levelIndex, patch.faceIndex,
                               paramBoundaryMask, paramTransitionMask);
-        *arrayBuilder->pptr++ = patchParam;
+        if (eigenCorner >= 0) {
+            patchParam.Set(
+                patchParam.GetFaceId(),
+                patchParam.GetU(), patchParam.GetV(),
+                patchParam.GetDepth(),
+                patchParam.NonQuadRoot(),
+                0, 0, false, (unsigned short)eigenCorner);
+        }
+        arrayBuilder.pptr[patchSlot] = patchParam;
 
         if (hasSharpness) {
-            *arrayBuilder->sptr++ =
-                assignSharpnessIndex(sharpness, table->_sharpnessValues);
+            patchSharpness[patchIndex] = sharpness;
         }
 
         if (context.RequiresFVarPatches()) {
@@ -1469,12 +2331,14 @@ PatchTableFactory::populateAdaptivePatches(
 
                 PatchParam fvarPatchParam = patchParam;
 
+                Index * fptr = arrayBuilder.fptr[fvc] +
+                               patchSlot * desc.GetNumControlVertices();
+
                 // Deal with the linear cases trivially first
-                if (desc.GetType() == PatchDescriptor::QUADS) {
-                    arrayBuilder->fptr[fvc] +=
-                        context.GatherLinearPatchPoints(
-                            arrayBuilder->fptr[fvc], fvarPatch, fvc);
-                    *arrayBuilder->fpptr[fvc]++ = fvarPatchParam;
+                if ((desc.GetType() == PatchDescriptor::QUADS) ||
+                    (desc.GetType() == PatchDescriptor::TRIANGLES)) {
+                    context.GatherLinearPatchPoints(fptr, fvarPatch, fvc);
+                    arrayBuilder.fpptr[fvc][patchSlot] = fvarPatchParam;
                     continue;
                 }
 
@@ -1493,35 +2357,13 @@ PatchTableFactory::populateAdaptivePatches(
                         context.GetRegularPatchBoundaryMask(patch.levelIndex, patch.faceIndex, fvc);
 
                     if (isRegSingleCrease && fvarTopologyMatches) {
-                        context.GatherRegularPatchPoints(
-                                arrayBuilder->fptr[fvc], fvarPatch, 0, fvc);
+                        context.GatherRegularPatchPoints(fptr, fvarPatch, 0, fvc);
                     } else {
-                        context.GatherRegularPatchPoints(
-                                arrayBuilder->fptr[fvc], fvarPatch, fvarBoundaryMask, fvc);
+                        context.GatherRegularPatchPoints(fptr, fvarPatch, fvarBoundaryMask, fvc);
                     }
                 } else {
-                    Level::VSpan  localCornerSpans[4];
-                    Level::VSpan* fvarCornerSpans = localCornerSpans;
-                    if (fvarTopologyMatches) {
-                        fvarCornerSpans = irregCornerSpans;
-                    } else {
-                        context.GetIrregularPatchCornerSpans(
-                                patch.levelIndex, patch.faceIndex, fvarCornerSpans, fvc);
-                    }
-
-                    if (desc.GetType() == PatchDescriptor::REGULAR) {
-                        context.GatherIrregularPatchPoints(
-                                fvarEndCapBSpline[fvc],
-                                arrayBuilder->fptr[fvc], fvarPatch, fvarCornerSpans, fvc);
-                    } else if (desc.GetType() == PatchDescriptor::GREGORY_BASIS) {
-                        context.GatherIrregularPatchPoints(
-                                fvarEndCapGregoryBasis[fvc],
-                                arrayBuilder->fptr[fvc], fvarPatch, fvarCornerSpans, fvc);
-                    } else {
-                        assert("Unknown Descriptor for FVar patch" == 0);
-                    }
+                    patchRequiresEndCap[patchIndex] = true;
                 }
-                arrayBuilder->fptr[fvc] += desc.GetNumControlVertices();
 
                 fvarPatchParam.Set(
                     patchParam.GetFaceId(),
@@ -1531,11 +2373,313 @@ PatchTableFactory::populateAdaptivePatches(
                     (fvarIsRegular ? fvarBoundaryMask : 0),
                     patchParam.GetTransition(),
                     fvarIsRegular);
-                *arrayBuilder->fpptr[fvc]++ = fvarPatchParam;
+                arrayBuilder.fpptr[fvc][patchSlot] = fvarPatchParam;
             }
         }
     }
 
+    //
+    //  The end-cap factories number their local points (possibly shared with
+    //  previous patches) as patches are added, so the points of irregular
+    //  patches are first assigned serially in the order of the patches. Only
+    //  the topology is traversed to number the points, and the factories of
+    //  the vertex patches and of each face-varying channel are independent,
+    //  so each of them numbers its points in parallel with the others (stream
+    //  0 for the vertex patches, followed by one for each face-varying
+    //  channel).  The end caps of each stream are recorded with the number of
+    //  points assigned before them, from which their stencils are computed
+    //  below:
+    //
+    int numEndCapStreams = 1 + (int)context.fvarChannelIndices.size();
+
+    std::vector<std::vector<int> > endCapPatches(numEndCapStreams),
+                                   endCapPrevPoints(numEndCapStreams);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int stream=0; stream<numEndCapStreams; ++stream) {
+
+        int fvc = stream - 1;
+
+        PatchDescriptor fvarDesc = (fvc >= 0) ?
+            table->GetFVarPatchDescriptor(fvc) : PatchDescriptor();
+
+        if ((fvarDesc.GetType() == PatchDescriptor::QUADS) ||
+            (fvarDesc.GetType() == PatchDescriptor::TRIANGLES)) continue;
+
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+
+            if (! patchRequiresEndCap[patchIndex]) continue;
+
+            int patchSlot = patchSlots[patchIndex];
+
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
+
+            PatchArrayBuilder const & arrayBuilder = arrayBuilders[patchArrayIndices[patchIndex]];
+
+            bool isRegular =
+                (context.patchClasses[patchIndex] == BuilderContext::PATCH_REGULAR);
+
+            //  Legacy Gregory patches have no local points (nor stencils):
+            int numPrevPoints = -1;
+
+            if (fvc < 0) {
+                if (isRegular) continue;
+
+                bool isEigen = numEigenPatches && (patchEigenCorners[patchIndex] >= 0);
+                if (isEigen) continue;
+
+                Level::VSpan irregCornerSpans[4];
+                context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex, irregCornerSpans);
+
+                Index * iptr = arrayBuilder.iptr + patchSlot * arrayBuilder.numPatchPoints;
+
+                // switch endcap patch type by option
+                if (endCapLoop) {
+                    numPrevPoints = endCapLoop->GetNumPatchPoints();
+                    context.AssignIrregularPatchPoints(
+                        endCapLoop, iptr, patch, irregCornerSpans);
+                } else switch(context.options.GetEndCapType()) {
+                case Options::ENDCAP_GREGORY_BASIS:
+                case Options::ENDCAP_EIGEN_BASIS:
+                    numPrevPoints = endCapGregoryBasis->GetNumPatchPoints();
+                    context.AssignIrregularPatchPoints(
+                        endCapGregoryBasis, iptr, patch, irregCornerSpans);
+                    break;
+                case Options::ENDCAP_BSPLINE_BASIS:
+                    numPrevPoints = endCapBSpline->GetNumPatchPoints();
+                    context.AssignIrregularPatchPoints(
+                        endCapBSpline, iptr, patch, irregCornerSpans);
+                    break;
+                case Options::ENDCAP_LEGACY_GREGORY:
+                    // Irregular boundary patches were already assigned to the
+                    // irregular boundary patch array.
+                    context.GatherIrregularPatchPoints(
+                        endCapLegacyGregory, iptr, patch, irregCornerSpans);
+                    break;
+                case Options::ENDCAP_BILINEAR_BASIS:
+                    // not implemented yet
+                    assert(false);
+                    break;
+                default:
+                    // no endcap
+                    break;
+                }
+            } else {
+                BuilderContext::PatchTuple fvarPatch(patch);
+
+                bool fvarTopologyMatches = context.DoesFaceVaryingPatchMatch(
+                        patch.levelIndex, patch.faceIndex, fvc);
+
+                bool fvarIsRegular = fvarTopologyMatches ? isRegular :
+                        context.IsPatchRegular(patch.levelIndex, patch.faceIndex, fvc);
+
+                if (fvarIsRegular) continue;
+
+                Level::VSpan fvarCornerSpans[4];
+                context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex,
+                        fvarCornerSpans, fvarTopologyMatches ? -1 : fvc);
+
+                Index * fptr = arrayBuilder.fptr[fvc] +
+                               patchSlot * fvarDesc.GetNumControlVertices();
+
+                if (fvarDesc.GetType() == PatchDescriptor::REGULAR) {
+                    numPrevPoints = fvarEndCapBSpline[fvc]->GetNumPatchPoints();
+                    context.AssignIrregularPatchPoints(
+                            fvarEndCapBSpline[fvc],
+                            fptr, fvarPatch, fvarCornerSpans, fvc);
+                } else if (fvarDesc.GetType() == PatchDescriptor::GREGORY_BASIS) {
+                    numPrevPoints = fvarEndCapGregoryBasis[fvc]->GetNumPatchPoints();
+                    context.AssignIrregularPatchPoints(
+                            fvarEndCapGregoryBasis[fvc],
+                            fptr, fvarPatch, fvarCornerSpans, fvc);
+                } else {
+                    assert("Unknown Descriptor for FVar patch" == 0);
+                }
+            }
+
+            if (numPrevPoints >= 0) {
+                endCapPatches[stream].push_back(patchIndex);
+                endCapPrevPoints[stream].push_back(numPrevPoints);
+            }
+        }
+    }
+
+    //
+    //  The stencils of the local points are then computed in parallel: the
+    //  end caps of each stream are split into contiguous ranges -- one per
+    //  thread and for a minimum number of end caps -- each of which appends
+    //  the stencils of its points to its own stencil tables.  The first range
+    //  of a stream appends to the stencil tables of the stream directly, and
+    //  the tables of the other ranges are concatenated to them in order, so
+    //  that the stencils follow the numbering of the points.
+    //
+    int const minEndCapsPerRange = 64;
+
+    if (localPointStencils) {
+        context.InitializePreviousEndCaps();
+    }
+
+    int numThreads = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+
+    std::vector<int> numStreamRanges(numEndCapStreams, 0),
+                     rangeStreams,
+                     rangesInStream;
+    for (int stream=0; stream<numEndCapStreams; ++stream) {
+        int numEndCaps = (int)endCapPatches[stream].size();
+        if (numEndCaps == 0) continue;
+
+        numStreamRanges[stream] = std::max(1, std::min(numThreads,
+                                                numEndCaps / minEndCapsPerRange));
+        for (int range=0; range<numStreamRanges[stream]; ++range) {
+            rangeStreams.push_back(stream);
+            rangesInStream.push_back(range);
+        }
+    }
+    int numRanges = (int)rangeStreams.size();
+
+    std::vector<StencilTable *> rangeStencils(numRanges, (StencilTable *)NULL),
+                                rangeVaryingStencils(numRanges, (StencilTable *)NULL);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int range=0; range<numRanges; ++range) {
+
+        int stream = rangeStreams[range],
+            fvc = stream - 1;
+
+        std::vector<int> const & streamPatches = endCapPatches[stream];
+        std::vector<int> const & streamPrevPoints = endCapPrevPoints[stream];
+
+        int numEndCaps = (int)streamPatches.size(),
+            rangeInStream = rangesInStream[range];
+
+        int rangeFirst = (int)(((long long)numEndCaps * rangeInStream) / numStreamRanges[stream]),
+            rangeLast = (int)(((long long)numEndCaps * (rangeInStream+1)) / numStreamRanges[stream]);
+
+        StencilTable * vertexStencils =
+            (fvc < 0) ? localPointStencils : localPointFVarStencils[fvc];
+        StencilTable * varyingStencils =
+            (fvc < 0) ? localPointVaryingStencils : NULL;
+
+        if (rangeInStream > 0) {
+            vertexStencils = rangeStencils[range] = new StencilTable(0);
+            if (varyingStencils) {
+                varyingStencils = rangeVaryingStencils[range] = new StencilTable(0);
+            }
+        }
+
+        PatchDescriptor fvarDesc = (fvc >= 0) ?
+            table->GetFVarPatchDescriptor(fvc) : PatchDescriptor();
+
+        for (int i=rangeFirst; i<rangeLast; ++i) {
+
+            int patchIndex = streamPatches[i];
+            int patchSlot = patchSlots[patchIndex];
+
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
+
+            PatchArrayBuilder const & arrayBuilder = arrayBuilders[patchArrayIndices[patchIndex]];
+
+            if (fvc < 0) {
+                Index const * iptr = arrayBuilder.iptr + patchSlot * arrayBuilder.numPatchPoints;
+
+                if (context.AppendPreviousPatchPointStencils(iptr,
+                        table->GetPatchArrayDescriptor(patchArrayIndices[patchIndex]),
+                        patch, arrayBuilder.pptr[patchSlot], streamPrevPoints[i],
+                        vertexStencils, varyingStencils)) {
+                    continue;
+                }
+
+                Level::VSpan irregCornerSpans[4];
+                context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex, irregCornerSpans);
+
+                if (endCapLoop) {
+                    context.AppendIrregularPatchPointStencils(
+                        endCapLoop, iptr, arrayBuilder.numPatchPoints, patch,
+                        irregCornerSpans, streamPrevPoints[i],
+                        vertexStencils, varyingStencils);
+                } else if (endCapGregoryBasis) {
+                    context.AppendIrregularPatchPointStencils(
+                        endCapGregoryBasis, iptr, arrayBuilder.numPatchPoints, patch,
+                        irregCornerSpans, streamPrevPoints[i],
+                        vertexStencils, varyingStencils);
+                } else if (endCapBSpline) {
+                    context.AppendIrregularPatchPointStencils(
+                        endCapBSpline, iptr, arrayBuilder.numPatchPoints, patch,
+                        irregCornerSpans, streamPrevPoints[i],
+                        vertexStencils, varyingStencils);
+                }
+            } else {
+                BuilderContext::PatchTuple fvarPatch(patch);
+
+                bool fvarTopologyMatches = context.DoesFaceVaryingPatchMatch(
+                        patch.levelIndex, patch.faceIndex, fvc);
+
+                Level::VSpan fvarCornerSpans[4];
+                context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex,
+                        fvarCornerSpans, fvarTopologyMatches ? -1 : fvc);
+
+                int numFVarPatchPoints = fvarDesc.GetNumControlVertices();
+
+                Index const * fptr = arrayBuilder.fptr[fvc] +
+                                     patchSlot * numFVarPatchPoints;
+
+                if (fvarDesc.GetType() == PatchDescriptor::REGULAR) {
+                    context.AppendIrregularPatchPointStencils(
+                            fvarEndCapBSpline[fvc], fptr, numFVarPatchPoints,
+                            fvarPatch, fvarCornerSpans, streamPrevPoints[i],
+                            vertexStencils, NULL, fvc);
+                } else {
+                    context.AppendIrregularPatchPointStencils(
+                            fvarEndCapGregoryBasis[fvc], fptr, numFVarPatchPoints,
+                            fvarPatch, fvarCornerSpans, streamPrevPoints[i],
+                            vertexStencils, NULL, fvc);
+                }
+            }
+        }
+    }
+
+    for (int range=0; range<numRanges; ++range) {
+        if (rangesInStream[range] == 0) continue;
+
+        int fvc = rangeStreams[range] - 1;
+
+        StencilTable * streamTables[2] = {
+            (fvc < 0) ? localPointStencils : localPointFVarStencils[fvc],
+            (fvc < 0) ? localPointVaryingStencils : NULL };
+        StencilTable * rangeTables[2] = {
+            rangeStencils[range], rangeVaryingStencils[range] };
+
+        for (int i=0; i<2; ++i) {
+            if (! rangeTables[i]) continue;
+
+            StencilTable & dst = *streamTables[i];
+            StencilTable const & src = *rangeTables[i];
+            dst._sizes.insert(dst._sizes.end(), src._sizes.begin(), src._sizes.end());
+            dst._indices.insert(dst._indices.end(), src._indices.begin(), src._indices.end());
+            dst._weights.insert(dst._weights.end(), src._weights.begin(), src._weights.end());
+            delete rangeTables[i];
+        }
+    }
+
+    // Sharpness values are indexed in the order they are first encountered
+    if (hasSharpness) {
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+
+            int patchSlot = patchSlots[patchIndex];
+            if (patchSlot < 0) continue;
+
+            arrayBuilders[patchArrayIndices[patchIndex]].sptr[patchSlot] =
+                assignSharpnessIndex(patchSharpness[patchIndex], table->_sharpnessValues);
+        }
+    }
+
     table->populateVaryingVertices();
 
     // finalize end patches
@@ -1553,8 +2697,13 @@ PatchTableFactory::populateAdaptivePatches(
         localPointVaryingStencils = NULL;
     }
 
-    switch(context.options.GetEndCapType()) {
+    if (endCapLoop) {
+        table->_localPointStencils = localPointStencils;
+        table->_localPointVaryingStencils = localPointVaryingStencils;
+        delete endCapLoop;
+    } else switch(context.options.GetEndCapType()) {
     case Options::ENDCAP_GREGORY_BASIS:
+    case Options::ENDCAP_EIGEN_BASIS:
         table->_localPointStencils = localPointStencils;
         table->_localPointVaryingStencils = localPointVaryingStencils;
         delete endCapGregoryBasis;
@@ -1580,7 +2729,8 @@ PatchTableFactory::populateAdaptivePatches(
                                         context.fvarChannelIndices.size());
 
         for (int fvc=0; fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
-            if (localPointFVarStencils[fvc]->GetNumStencils() > 0) {
+            if (localPointFVarStencils[fvc] &&
+                localPointFVarStencils[fvc]->GetNumStencils() > 0) {
                 localPointFVarStencils[fvc]->finalize();
             } else {
                 delete localPointFVarStencils[fvc];
@@ -1589,6 +2739,7 @@ PatchTableFactory::populateAdaptivePatches(
 
             switch(context.options.GetEndCapType()) {
             case Options::ENDCAP_GREGORY_BASIS:
+            case Options::ENDCAP_EIGEN_BASIS:
                 delete fvarEndCapGregoryBasis[fvc];
                 break;
             case Options::ENDCAP_BSPLINE_BASIS:
@@ -1602,6 +2753,271 @@ PatchTableFactory::populateAdaptivePatches(
                                         localPointFVarStencils[fvc];
         }
     }
+
+    table->_eigenBases.swap(eigenBases);
+
+    delete [] arrayBuilders;
+}
+
+//
+//  Helpers for identifying the neighbors of patches across the sides of their
+//  ptex faces:
+//
+namespace {
+
+    //
+    //  The sides of ptex faces are ordered counter-clockwise from v=0, as are
+    //  locations along them:
+    //
+    inline void
+    getPtexSidePoint(int side, float p, float uv[2]) {
+
+        switch (side) {
+            case 0: uv[0] = p;        uv[1] = 0.0f;     break;
+            case 1: uv[0] = 1.0f;     uv[1] = p;        break;
+            case 2: uv[0] = 1.0f - p; uv[1] = 1.0f;     break;
+            case 3: uv[0] = 0.0f;     uv[1] = 1.0f - p; break;
+            default:
+                assert(0);
+                uv[0] = uv[1] = 0.0f;
+                break;
+        }
+    }
+
+    inline float
+    getPtexSideLocation(int side, float const uv[2]) {
+
+        switch (side) {
+            case 0: return uv[0];
+            case 1: return uv[1];
+            case 2: return 1.0f - uv[0];
+            case 3: return 1.0f - uv[1];
+        }
+        return 0.0f;
+    }
+
+    //
+    //  The sides of ptex faces are related to those of adjacent ptex faces by
+    //  the edges of the base faces.  The sub-faces of an irregular face span
+    //  the first half of the edge following their vertex (at v=0) and the
+    //  second half of the edge preceding it (at u=0), and abut each other
+    //  along their remaining sides:
+    //
+    class PtexSideMap {
+    public:
+        PtexSideMap(TopologyRefiner const & refiner);
+
+        //  Returns the ptex face across a side of a ptex face at the given
+        //  location (or -1 if none), the adjacent side of that face and the
+        //  (u,v) within it of the ends of the side:
+        int GetAdjacentFace(int ptexFace, int side, float p,
+                            int & adjSide, float uv0[2], float uv1[2]) const;
+
+    private:
+        TopologyLevel const & _level;
+        PtexIndices           _ptexIndices;
+
+        std::vector<Index> _ptexBaseFaces;
+        std::vector<int>   _ptexSubFaces;
+    };
+
+    PtexSideMap::PtexSideMap(TopologyRefiner const & refiner) :
+        _level(refiner.GetLevel(0)), _ptexIndices(refiner) {
+
+        _ptexBaseFaces.resize(_ptexIndices.GetNumFaces());
+        _ptexSubFaces.resize(_ptexIndices.GetNumFaces());
+        for (Index face = 0; face < _level.GetNumFaces(); ++face) {
+            int ptexFace = _ptexIndices.GetFaceId(face);
+            int faceSize = _level.GetFaceVertices(face).size();
+            if (faceSize == 4) {
+                _ptexBaseFaces[ptexFace] = face;
+                _ptexSubFaces[ptexFace]  = -1;
+            } else {
+                for (int i = 0; i < faceSize; ++i) {
+                    _ptexBaseFaces[ptexFace + i] = face;
+                    _ptexSubFaces[ptexFace + i]  = i;
+                }
+            }
+        }
+    }
+
+    int
+    PtexSideMap::GetAdjacentFace(int ptexFace, int side, float p,
+                                 int & adjSide, float uv0[2], float uv1[2]) const {
+
+        Index face     = _ptexBaseFaces[ptexFace];
+        int   sub      = _ptexSubFaces[ptexFace];
+        int   faceSize = _level.GetFaceVertices(face).size();
+
+        //  Sides of sub-faces abutting the next or previous sub-face:
+        if ((sub >= 0) && ((side == 1) || (side == 2))) {
+            int adjSub = (side == 1) ? ((sub + 1) % faceSize) :
+                                       ((sub + faceSize - 1) % faceSize);
+            adjSide = 3 - side;
+            getPtexSidePoint(adjSide, 1.0f, uv0);
+            getPtexSidePoint(adjSide, 0.0f, uv1);
+            return _ptexIndices.GetFaceId(face) + adjSub;
+        }
+
+        //  Otherwise the side spans the edge of the base face, or half of it,
+        //  at w = w0 + p * dw along the face-edge:
+        int   faceEdge = side;
+        float w0 = 0.0f;
+        float dw = 1.0f;
+        if (sub >= 0) {
+            faceEdge = (side == 0) ? sub : ((sub + faceSize - 1) % faceSize);
+            w0 = (side == 0) ? 0.0f : 0.5f;
+            dw = 0.5f;
+        }
+
+        Index edge = _level.GetFaceEdges(face)[faceEdge];
+
+        ConstIndexArray edgeFaces = _level.GetEdgeFaces(edge);
+        if (edgeFaces.size() != 2) return -1;
+
+        Index adjFace = (edgeFaces[0] == face) ? edgeFaces[1] : edgeFaces[0];
+        if (adjFace == face) return -1;
+
+        ConstIndexArray adjFaceEdges = _level.GetFaceEdges(adjFace);
+
+        int adjFaceEdge = adjFaceEdges.FindIndex(edge);
+        int adjFaceSize = adjFaceEdges.size();
+
+        //  Locations along the face-edges are reversed if the faces are
+        //  oriented consistently:
+        Index edgeVert = _level.GetEdgeVertices(edge)[0];
+
+        bool isReversed = ((_level.GetFaceVertices(face)[faceEdge] == edgeVert) !=
+                           (_level.GetFaceVertices(adjFace)[adjFaceEdge] == edgeVert));
+
+        float adjW0 = isReversed ? (1.0f - w0) : w0;
+        float adjDW = isReversed ? -dw : dw;
+        float adjW  = adjW0 + p * adjDW;
+
+        //  Identify the ptex face and side spanning that part of the adjacent
+        //  face-edge, and the locations along it of the ends of the side:
+        int   adjPtexFace = _ptexIndices.GetFaceId(adjFace);
+        float adjP0 = adjW0;
+        float adjDP = adjDW;
+        if (adjFaceSize == 4) {
+            adjSide = adjFaceEdge;
+        } else if (adjW < 0.5f) {
+            adjPtexFace += adjFaceEdge;
+            adjSide = 0;
+            adjP0   = 2.0f * adjW0;
+            adjDP   = 2.0f * adjDW;
+        } else {
+            adjPtexFace += (adjFaceEdge + 1) % adjFaceSize;
+            adjSide = 3;
+            adjP0   = 2.0f * adjW0 - 1.0f;
+            adjDP   = 2.0f * adjDW;
+        }
+        getPtexSidePoint(adjSide, adjP0, uv0);
+        getPtexSidePoint(adjSide, adjP0 + adjDP, uv1);
+        return adjPtexFace;
+    }
+}
+
+//
+//  Identify the neighbor of each half of each edge of each patch -- the patch
+//  containing a location inward from the middle of that half (by a quarter of
+//  the size of the patch, so the location lies within a neighbor of the next
+//  level) -- and the locations of the ends of the edge along that neighbor:
+//
+void
+PatchTableFactory::populatePatchAdjacency(TopologyRefiner const & refiner,
+                                          PatchTable * table) {
+
+    int numPatches = table->GetNumPatchesTotal();
+
+    table->_adjacencyPatches.assign(numPatches * 8, Vtr::INDEX_INVALID);
+    table->_adjacencyEdges.assign(numPatches * 8, 0);
+    table->_adjacencyParams.assign(numPatches * 16, 0.0f);
+
+    PatchMap    patchMap(*table);
+    PtexSideMap sideMap(refiner);
+
+    static float const corners[5][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f },
+                                         { 1.0f, 1.0f }, { 0.0f, 1.0f },
+                                         { 0.0f, 0.0f } };
+    static float const inward[4][2]  = { { 0.0f, 1.0f }, { -1.0f, 0.0f },
+                                         { 0.0f, -1.0f }, { 1.0f, 0.0f } };
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static, 256)
+#endif
+    for (int patch = 0; patch < numPatches; ++patch) {
+        PatchParam const & param = table->_paramTable[patch];
+
+        int   ptexFace = param.GetFaceId();
+        int   numCells = 1 << (param.GetDepth() - (param.NonQuadRoot() ? 1 : 0));
+        float frac     = param.GetParamFraction();
+
+        for (int edge = 0; edge < 4; ++edge) {
+            float ends[2][2];
+            for (int i = 0; i < 2; ++i) {
+                ends[i][0] = ((float)param.GetU() + corners[edge + i][0]) * frac;
+                ends[i][1] = ((float)param.GetV() + corners[edge + i][1]) * frac;
+            }
+
+            bool isOnSide = (edge == 0) ? (param.GetV() == 0) :
+                            (edge == 1) ? (param.GetU() == numCells - 1) :
+                            (edge == 2) ? (param.GetV() == numCells - 1) :
+                                          (param.GetU() == 0);
+
+            for (int half = 0; half < 2; ++half) {
+                float x = 0.25f + 0.5f * (float)half;
+
+                //  Locate the ends of the edge in the ptex face of the neighbor
+                //  (scaled relative to that of the patch):
+                int   adjPtexFace = ptexFace;
+                int   adjEdge     = (edge + 2) % 4;
+                float adjScale    = 1.0f;
+                float adjEnds[2][2] = { { ends[0][0], ends[0][1] },
+                                        { ends[1][0], ends[1][1] } };
+
+                if (isOnSide) {
+                    float p0 = getPtexSideLocation(edge, ends[0]);
+                    float p1 = getPtexSideLocation(edge, ends[1]);
+
+                    float uv0[2] = { 0.0f, 0.0f },
+                          uv1[2] = { 0.0f, 0.0f };
+                    adjPtexFace = sideMap.GetAdjacentFace(ptexFace, edge,
+                        p0 + x * (p1 - p0), adjEdge, uv0, uv1);
+                    if (adjPtexFace < 0) continue;
+
+                    float p[2] = { p0, p1 };
+                    for (int i = 0; i < 2; ++i) {
+                        adjEnds[i][0] = uv0[0] + p[i] * (uv1[0] - uv0[0]);
+                        adjEnds[i][1] = uv0[1] + p[i] * (uv1[1] - uv0[1]);
+                    }
+                    adjScale = std::abs(uv1[0] - uv0[0]) + std::abs(uv1[1] - uv0[1]);
+                }
+
+                float offset = 0.25f * frac * adjScale;
+                float u = adjEnds[0][0] + x * (adjEnds[1][0] - adjEnds[0][0]) +
+                          offset * inward[adjEdge][0];
+                float v = adjEnds[0][1] + x * (adjEnds[1][1] - adjEnds[0][1]) +
+                          offset * inward[adjEdge][1];
+
+                PatchMap::Handle const * neighbor = patchMap.FindPatch(adjPtexFace,
+                    std::max(0.0f, std::min(u, 1.0f)), std::max(0.0f, std::min(v, 1.0f)));
+                if (! neighbor) continue;
+
+                PatchParam const & adjParam = table->_paramTable[neighbor->patchIndex];
+
+                int slot = patch * 8 + edge * 2 + half;
+
+                table->_adjacencyPatches[slot] = neighbor->patchIndex;
+                table->_adjacencyEdges[slot]   = (unsigned char)adjEdge;
+                for (int i = 0; i < 2; ++i) {
+                    float st[2] = { adjEnds[i][0], adjEnds[i][1] };
+                    adjParam.Normalize(st[0], st[1]);
+                    table->_adjacencyParams[slot * 2 + i] = getPtexSideLocation(adjEdge, st);
+                }
+            }
+        }
+    }
 }
 
 //
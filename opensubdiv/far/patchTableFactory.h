@@ -50,9 +50,13 @@ public:
         enum EndCapType {
             ENDCAP_NONE = 0,             ///< no endcap
             ENDCAP_BILINEAR_BASIS,       ///< use bilinear quads (4 cp) as end-caps
+                                         ///< (planar Loop patches for the Loop scheme,
+                                         ///< whose other end-caps are smooth Loop patches)
             ENDCAP_BSPLINE_BASIS,        ///< use BSpline basis patches (16 cp) as end-caps
             ENDCAP_GREGORY_BASIS,        ///< use Gregory basis patches (20 cp) as end-caps
-            ENDCAP_LEGACY_GREGORY        ///< use legacy (2.x) Gregory patches (4 cp + valence table) as end-caps
+            ENDCAP_LEGACY_GREGORY,       ///< use legacy (2.x) Gregory patches (4 cp + valence table) as end-caps
+            ENDCAP_EIGEN_BASIS           ///< use exact eigen basis patches (2*valence+8 cp) at isolated
+                                         ///< extraordinary vertices, Gregory basis patches otherwise
         };
 
         Options(unsigned int maxIsolation=10) :
@@ -64,6 +68,7 @@ public:
              endCapType(ENDCAP_GREGORY_BASIS),
              shareEndCapPatchPoints(true),
              generateFVarTables(false),
+             generatePatchAdjacency(false),
              generateFVarLegacyLinearPatches(true),
              generateLegacySharpCornerPatches(true),
              numFVarChannels(-1),
@@ -90,6 +95,10 @@ public:
                      // face-varying
                      generateFVarTables  : 1, ///< Generate face-varying patch tables
 
+                     // adjacency
+                     generatePatchAdjacency : 1, ///< Generate the neighbors of quadrilateral patches
+                                                 ///< (not with 'generateAllLevels' or 'triangulateQuads')
+
                      // legacy behaviors (default to true)
                      generateFVarLegacyLinearPatches  : 1, ///< Generate all linear face-varying patches (legacy)
                      generateLegacySharpCornerPatches : 1; ///< Generate sharp regular patches at smooth corners (legacy)
@@ -109,6 +118,27 @@ public:
     static PatchTable * Create(TopologyRefiner const & refiner,
                                Options options=Options());
 
+    /// \brief Factory constructor updating the PatchTable of a refinement
+    ///        updated by TopologyRefiner::UpdateSparse()
+    ///
+    /// The result is that of Create(), but the stencils of the local points of
+    /// end caps whose neighborhood was carried forward by the update are
+    /// copied from the previous table rather than computed, so that the cost
+    /// of the end caps is limited to the regions affected by the update.
+    ///
+    /// @param refiner              TopologyRefiner from which to generate patches
+    ///
+    /// @param previous             PatchTable created with the same options from
+    ///                             the refinement preceding the last update
+    ///
+    /// @param options              Options controlling the creation of the table
+    ///
+    /// @return                     A new instance of PatchTable
+    ///
+    static PatchTable * Update(TopologyRefiner const & refiner,
+                               PatchTable const & previous,
+                               Options options=Options());
+
 private:
     //
     // Private helper structures
@@ -121,8 +151,13 @@ private:
     static PatchTable * createUniform(TopologyRefiner const & refiner,
                                       Options options);
 
+    static PatchTable * create(TopologyRefiner const & refiner,
+                               Options options,
+                               PatchTable const * previous);
+
     static PatchTable * createAdaptive(TopologyRefiner const & refiner,
-                                       Options options);
+                                       Options options,
+                                       PatchTable const * previous);
 
     //
     //  High-level methods for identifying and populating patches associated with faces:
@@ -133,6 +168,9 @@ private:
     static void populateAdaptivePatches(BuilderContext & context,
                                         PatchTable * table);
 
+    static void populatePatchAdjacency(TopologyRefiner const & refiner,
+                                       PatchTable * table);
+
     static void allocateVertexTables(BuilderContext const & context,
                                      PatchTable * table);
 
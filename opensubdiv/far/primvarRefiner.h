@@ -56,11 +56,31 @@ namespace Far {
 class PrimvarRefiner {
 
 public:
-    PrimvarRefiner(TopologyRefiner const & refiner) : _refiner(refiner) { }
+    ///
+    ///  \brief Options controlling the application of refinement operations
+    ///
+    struct Options {
+
+        Options() : parallel(false) { }
+
+        unsigned int parallel : 1;  ///< distribute the interpolation of each group
+                                    ///< of vertices (those originating from faces,
+                                    ///< edges and vertices) across threads when the
+                                    ///< client code is compiled with OpenMP.  Each
+                                    ///< group completes before the next one starts,
+                                    ///< and distinct destination elements must be
+                                    ///< safely writable from concurrent threads.
+    };
+
+    PrimvarRefiner(TopologyRefiner const & refiner, Options options = Options()) :
+        _refiner(refiner), _options(options) { }
     ~PrimvarRefiner() { }
 
     TopologyRefiner const & GetTopologyRefiner() const { return _refiner; }
 
+    /// \brief Returns the options specified on construction
+    Options GetOptions() const { return _options; }
+
     //@{
     ///  @name Primvar data interpolation
     ///
@@ -181,10 +201,54 @@ public:
 
     //@}
 
+    //@{
+    ///  @name Primvar data interpolation of float buffers
+    ///
+    /// \anchor floatBuffers
+    ///
+    /// \note These overloads of the interpolation methods operate directly on
+    ///       buffers of floats, avoiding the need for a client class to wrap
+    ///       each primvar layout.  Each element of a buffer consists of
+    ///       \c length consecutive floats and the first floats of successive
+    ///       elements are \c stride floats apart, so that any number of float
+    ///       primvars interleaved in a single buffer are refined in one pass.
+    ///       <br><br>
+    ///       As with the templated methods, \c src and \c dst point to the
+    ///       first element of the source and destination levels respectively,
+    ///       and the layout of all buffers involved in a call is the same.
+    ///
+
+    /// \brief Apply vertex interpolation weights to a float buffer for a single
+    ///        level of refinement (see Interpolate())
+    void Interpolate(int level, float const * src, float * dst, int length, int stride) const;
+
+    /// \brief Apply only varying interpolation weights to a float buffer for a
+    ///        single level of refinement (see InterpolateVarying())
+    void InterpolateVarying(int level, float const * src, float * dst, int length, int stride) const;
+
+    /// \brief Apply face-varying interpolation weights to a float buffer
+    ///        associated with a particular face-varying channel
+    ///        (see InterpolateFaceVarying())
+    void InterpolateFaceVarying(int level, float const * src, float * dst,
+        int length, int stride, int channel = 0) const;
+
+    /// \brief Apply limit weights to a float buffer (see Limit())
+    void Limit(float const * src, float * dstPos, int length, int stride) const;
+
+    void Limit(float const * src, float * dstPos, float * dstTan1, float * dstTan2,
+        int length, int stride) const;
+
+    /// \brief Apply face-varying limit weights to a float buffer
+    ///        (see LimitFaceVarying())
+    void LimitFaceVarying(float const * src, float * dst,
+        int length, int stride, int channel = 0) const;
+
+    //@}
+
 private:
 
     //  Non-copyable:
-    PrimvarRefiner(PrimvarRefiner const & src) : _refiner(src._refiner) { }
+    PrimvarRefiner(PrimvarRefiner const & src) : _refiner(src._refiner), _options(src._options) { }
     PrimvarRefiner & operator=(PrimvarRefiner const &) { return *this; }
 
     template <Sdc::SchemeType SCHEME, class T, class U> void interpFromFaces(int, T const &, U &) const;
@@ -199,11 +263,12 @@ private:
     void limit(T const & src, U & pos, U1 * tan1, U2 * tan2) const;
 
     template <Sdc::SchemeType SCHEME, class T, class U>
-    void limitFVar(T const & src, U * dst, int channel) const;
+    void limitFVar(T const & src, U & dst, int channel) const;
 
 private:
 
     TopologyRefiner const &  _refiner;
+    Options                  _options;
 
 private:
     //
@@ -253,6 +318,66 @@ private:
 
         bool _faceWeightsForFaceCenters;
     };
+
+private:
+    //
+    //  Local classes to fulfill the interface for <class T> and <class U> in the
+    //  interpolation methods given strided buffers of floats -- each element is
+    //  a light-weight reference to the "length" floats it combines:
+    //
+    class ConstFloatElement {
+    public:
+        ConstFloatElement(float const * data, int length) : _data(data), _length(length) { }
+
+        float const * _data;
+        int           _length;
+    };
+
+    class FloatElement {
+    public:
+        FloatElement(float * data, int length) : _data(data), _length(length) { }
+
+        void Clear() {
+            for (int i = 0; i < _length; ++i) {
+                _data[i] = 0.0f;
+            }
+        }
+        void AddWithWeight(ConstFloatElement const & src, float weight) {
+            addWithWeight(src._data, weight);
+        }
+        void AddWithWeight(FloatElement const & src, float weight) {
+            addWithWeight(src._data, weight);
+        }
+
+    private:
+        void addWithWeight(float const * src, float weight) {
+            for (int i = 0; i < _length; ++i) {
+                _data[i] += weight * src[i];
+            }
+        }
+
+        float * _data;
+        int     _length;
+    };
+
+    template <class ELEMENT, typename FLOAT>
+    class FloatBuffer {
+    public:
+        FloatBuffer(FLOAT * data, int length, int stride) :
+            _data(data), _length(length), _stride(stride) { }
+
+        ELEMENT operator[](Index index) const {
+            return ELEMENT(_data + (size_t)index * _stride, _length);
+        }
+
+    private:
+        FLOAT * _data;
+        int     _length;
+        int     _stride;
+    };
+
+    typedef FloatBuffer<ConstFloatElement, float const> ConstFloatBuffer;
+    typedef FloatBuffer<FloatElement, float>            MutableFloatBuffer;
 };
 
 
@@ -383,6 +508,65 @@ PrimvarRefiner::LimitFaceVarying(T const & src, U & dst, int channel) const {
     }
 }
 
+inline void
+PrimvarRefiner::Interpolate(int level, float const * src, float * dst, int length, int stride) const {
+
+    ConstFloatBuffer   srcBuffer(src, length, stride);
+    MutableFloatBuffer dstBuffer(dst, length, stride);
+
+    Interpolate(level, srcBuffer, dstBuffer);
+}
+
+inline void
+PrimvarRefiner::InterpolateVarying(int level, float const * src, float * dst, int length, int stride) const {
+
+    ConstFloatBuffer   srcBuffer(src, length, stride);
+    MutableFloatBuffer dstBuffer(dst, length, stride);
+
+    InterpolateVarying(level, srcBuffer, dstBuffer);
+}
+
+inline void
+PrimvarRefiner::InterpolateFaceVarying(int level, float const * src, float * dst,
+        int length, int stride, int channel) const {
+
+    ConstFloatBuffer   srcBuffer(src, length, stride);
+    MutableFloatBuffer dstBuffer(dst, length, stride);
+
+    InterpolateFaceVarying(level, srcBuffer, dstBuffer, channel);
+}
+
+inline void
+PrimvarRefiner::Limit(float const * src, float * dstPos, int length, int stride) const {
+
+    ConstFloatBuffer   srcBuffer(src, length, stride);
+    MutableFloatBuffer dstPosBuffer(dstPos, length, stride);
+
+    Limit(srcBuffer, dstPosBuffer);
+}
+
+inline void
+PrimvarRefiner::Limit(float const * src, float * dstPos, float * dstTan1, float * dstTan2,
+        int length, int stride) const {
+
+    ConstFloatBuffer   srcBuffer(src, length, stride);
+    MutableFloatBuffer dstPosBuffer(dstPos, length, stride);
+    MutableFloatBuffer dstTan1Buffer(dstTan1, length, stride);
+    MutableFloatBuffer dstTan2Buffer(dstTan2, length, stride);
+
+    Limit(srcBuffer, dstPosBuffer, dstTan1Buffer, dstTan2Buffer);
+}
+
+inline void
+PrimvarRefiner::LimitFaceVarying(float const * src, float * dst,
+        int length, int stride, int channel) const {
+
+    ConstFloatBuffer   srcBuffer(src, length, stride);
+    MutableFloatBuffer dstBuffer(dst, length, stride);
+
+    LimitFaceVarying(srcBuffer, dstBuffer, channel);
+}
+
 template <class T, class U>
 inline void
 PrimvarRefiner::InterpolateFaceUniform(int level, T const & src, U & dst) const {
@@ -392,6 +576,9 @@ PrimvarRefiner::InterpolateFaceUniform(int level, T const & src, U & dst) const
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const & child = refinement.child();
 
+#ifdef _OPENMP
+    #pragma omp parallel for if (_options.parallel)
+#endif
     for (int cFace = 0; cFace < child.getNumFaces(); ++cFace) {
 
         Vtr::Index pFace = refinement.getChildFaceParentFace(cFace);
@@ -415,6 +602,9 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
     //
     if (refinement.getNumChildVerticesFromFaces() > 0) {
 
+#ifdef _OPENMP
+        #pragma omp parallel for if (_options.parallel)
+#endif
         for (int face = 0; face < parent.getNumFaces(); ++face) {
 
             Vtr::Index cVert = refinement.getFaceChildVertex(face);
@@ -432,6 +622,9 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
             }
         }
     }
+#ifdef _OPENMP
+    #pragma omp parallel for if (_options.parallel)
+#endif
     for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
@@ -445,6 +638,9 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
             dst[cVert].AddWithWeight(src[eVerts[1]], 0.5f);
         }
     }
+#ifdef _OPENMP
+    #pragma omp parallel for if (_options.parallel)
+#endif
     for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
@@ -473,8 +669,15 @@ PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::StackBuffer<float,16> fVertWeights(parent.getMaxValence());
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int face = 0; face < parent.getNumFaces(); ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
@@ -497,6 +700,7 @@ PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
             dst[cVert].AddWithWeight(src[fVerts[i]], fVertWeights[i]);
         }
     }
+    }
 }
 
 template <Sdc::SchemeType SCHEME, class T, class U>
@@ -507,13 +711,47 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
     Vtr::internal::Level const &      parent     = refinement.parent();
     Vtr::internal::Level const &      child      = refinement.child();
 
+    //  Bilinear edge-vertices are the midpoints of their parent edges regardless of
+    //  sharpness or incident faces -- apply the weights without consulting the mask:
+    if (SCHEME == Sdc::SCHEME_BILINEAR) {
+#ifdef _OPENMP
+        #pragma omp parallel for if (_options.parallel)
+#endif
+        for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
+
+            Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
+
+            ConstIndexArray eVerts = parent.getEdgeVertices(edge);
+
+            dst[cVert].Clear();
+            dst[cVert].AddWithWeight(src[eVerts[0]], 0.5f);
+            dst[cVert].AddWithWeight(src[eVerts[1]], 0.5f);
+        }
+        return;
+    }
+
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
+    //  Smooth edges with two incident faces have a fixed mask for Catmark -- unless
+    //  the smooth triangle option alters it for triangles (only present at level 0):
+    bool applyRegularEdgeMask = (SCHEME == Sdc::SCHEME_CATMARK) &&
+        ((parent.getDepth() > 0) ||
+         (_refiner._subdivOptions.GetTriangleSubdivision() != Sdc::Options::TRI_SUB_SMOOTH));
+
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::EdgeInterface eHood(parent);
 
     float                               eVertWeights[2];
     Vtr::internal::StackBuffer<float,8> eFaceWeights(parent.getMaxEdgeFaces());
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
@@ -524,11 +762,26 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
         ConstIndexArray eVerts = parent.getEdgeVertices(edge),
                         eFaces = parent.getEdgeFaces(edge);
 
+        Sdc::Crease::Rule pRule = (parent.getEdgeSharpness(edge) > 0.0f) ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
+
+        //  Apply the fixed weights of the regular case directly, bypassing the mask:
+        if (applyRegularEdgeMask && (pRule == Sdc::Crease::RULE_SMOOTH) && (eFaces.size() == 2)) {
+            Vtr::Index cVertOfFace0 = refinement.getFaceChildVertex(eFaces[0]);
+            Vtr::Index cVertOfFace1 = refinement.getFaceChildVertex(eFaces[1]);
+            assert(Vtr::IndexIsValid(cVertOfFace0) && Vtr::IndexIsValid(cVertOfFace1));
+
+            dst[cVert].Clear();
+            dst[cVert].AddWithWeight(src[eVerts[0]], 0.25f);
+            dst[cVert].AddWithWeight(src[eVerts[1]], 0.25f);
+            dst[cVert].AddWithWeight(dst[cVertOfFace0], 0.25f);
+            dst[cVert].AddWithWeight(dst[cVertOfFace1], 0.25f);
+            continue;
+        }
+
         Mask eMask(eVertWeights, 0, eFaceWeights);
 
         eHood.SetIndex(edge);
 
-        Sdc::Crease::Rule pRule = (parent.getEdgeSharpness(edge) > 0.0f) ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH;
         Sdc::Crease::Rule cRule = child.getVertexRule(cVert);
 
         scheme.ComputeEdgeVertexMask(eHood, eMask, pRule, cRule);
@@ -566,6 +819,7 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
             }
         }
     }
+    }
 }
 
 template <Sdc::SchemeType SCHEME, class T, class U>
@@ -576,12 +830,36 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
     Vtr::internal::Level const &      parent     = refinement.parent();
     Vtr::internal::Level const &      child      = refinement.child();
 
+    //  Bilinear vertex-vertices simply retain the position of their parent vertices:
+    if (SCHEME == Sdc::SCHEME_BILINEAR) {
+#ifdef _OPENMP
+        #pragma omp parallel for if (_options.parallel)
+#endif
+        for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
+
+            Vtr::Index cVert = refinement.getVertexChildVertex(vert);
+            if (!Vtr::IndexIsValid(cVert))
+                continue;
+
+            dst[cVert].Clear();
+            dst[cVert].AddWithWeight(src[vert], 1.0f);
+        }
+        return;
+    }
+
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::VertexInterface vHood(parent, child);
 
     Vtr::internal::StackBuffer<float,32> weightBuffer(2*parent.getMaxValence());
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
@@ -592,6 +870,30 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
         ConstIndexArray vEdges = parent.getVertexEdges(vert),
                         vFaces = parent.getVertexFaces(vert);
 
+        //  Regular Catmark vertices (smooth, interior and valence 4) have a fixed mask
+        //  of 1/16 for all edges and faces and 1/2 for the vertex -- apply it directly
+        //  (in the same order as the general case below):
+        if (SCHEME == Sdc::SCHEME_CATMARK) {
+            Vtr::internal::Level::VTag vTag = parent.getVertexTag(vert);
+
+            if ((vTag._rule == Sdc::Crease::RULE_SMOOTH) && !vTag._xordinary &&
+                    (vFaces.size() == 4) && (vEdges.size() == 4)) {
+                dst[cVert].Clear();
+                for (int i = 0; i < 4; ++i) {
+                    Vtr::Index cVertOfFace = refinement.getFaceChildVertex(vFaces[i]);
+                    assert(Vtr::IndexIsValid(cVertOfFace));
+                    dst[cVert].AddWithWeight(dst[cVertOfFace], 0.0625f);
+                }
+                for (int i = 0; i < 4; ++i) {
+                    ConstIndexArray eVerts = parent.getEdgeVertices(vEdges[i]);
+                    Vtr::Index pVertOppositeEdge = (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
+                    dst[cVert].AddWithWeight(src[pVertOppositeEdge], 0.0625f);
+                }
+                dst[cVert].AddWithWeight(src[vert], 0.5f);
+                continue;
+            }
+        }
+
         float   vVertWeight,
               * vEdgeWeights = weightBuffer,
               * vFaceWeights = vEdgeWeights + vEdges.size();
@@ -635,6 +937,7 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
         }
         dst[cVert].AddWithWeight(src[vert], vVertWeight);
     }
+    }
 }
 
 
@@ -657,8 +960,15 @@ PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int chann
     Vtr::internal::FVarLevel const & parentFVar = parentLevel.getFVarLevel(channel);
     Vtr::internal::FVarLevel const & childFVar  = childLevel.getFVarLevel(channel);
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::StackBuffer<float,16> fValueWeights(parentLevel.getMaxValence());
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int face = 0; face < parentLevel.getNumFaces(); ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
@@ -687,6 +997,7 @@ PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int chann
             dst[cVertValue].AddWithWeight(src[fValues[i]], fValueWeights[i]);
         }
     }
+    }
 }
 
 template <Sdc::SchemeType SCHEME, class T, class U>
@@ -704,6 +1015,10 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
     Vtr::internal::FVarLevel const &      parentFVar = parentLevel.getFVarLevel(channel);
     Vtr::internal::FVarLevel const &      childFVar  = childLevel.getFVarLevel(channel);
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     //
     //  Allocate and initialize (if linearly interpolated) interpolation weights for
     //  the edge mask:
@@ -725,6 +1040,9 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
 
     Vtr::internal::EdgeInterface eHood(parentLevel);
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int edge = 0; edge < parentLevel.getNumEdges(); ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
@@ -831,6 +1149,7 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
             }
         }
     }
+    }
 }
 
 template <Sdc::SchemeType SCHEME, class T, class U>
@@ -850,12 +1169,19 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
 
     bool isLinearFVar = parentFVar.isLinear() || (_refiner._subdivType == Sdc::SCHEME_BILINEAR);
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::StackBuffer<float,32> weightBuffer(2*parentLevel.getMaxValence());
 
     Vtr::internal::StackBuffer<Vtr::Index,16> vEdgeValues(parentLevel.getMaxValence());
 
     Vtr::internal::VertexInterface vHood(parentLevel, childLevel);
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int vert = 0; vert < parentLevel.getNumVertices(); ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
@@ -998,6 +1324,7 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
             }
         }
     }
+    }
 }
 
 template <Sdc::SchemeType SCHEME, class T, class U, class U1, class U2>
@@ -1012,6 +1339,10 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
     bool hasTangents = (dstTan1Ptr && dstTan2Ptr);
     int  numMasks = 1 + (hasTangents ? 2 : 0);
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::StackBuffer<Index,33> indexBuffer(maxWeightsPerMask);
     Vtr::internal::StackBuffer<float,99> weightBuffer(numMasks * maxWeightsPerMask);
 
@@ -1033,6 +1364,9 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
     //  this mask type was intended for another purpose.  Consider one for the limit:
     Vtr::internal::VertexInterface vHood(level, level);
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int vert = 0; vert < level.getNumVertices(); ++vert) {
         ConstIndexArray vEdges = level.getVertexEdges(vert);
 
@@ -1132,11 +1466,12 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
             dstTan2[vert].AddWithWeight(src[vert], vTan2Weights[0]);
         }
     }
+    }
 }
 
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
+PrimvarRefiner::limitFVar(T const & src, U & dst, int channel) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
@@ -1145,12 +1480,19 @@ PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
 
     int maxWeightsPerMask = 1 + 2 * level.getMaxValence();
 
+#ifdef _OPENMP
+    #pragma omp parallel if (_options.parallel)
+#endif
+    {
     Vtr::internal::StackBuffer<float,33> weightBuffer(maxWeightsPerMask);
     Vtr::internal::StackBuffer<Index,16> vEdgeBuffer(level.getMaxValence());
 
     //  This is a bit obscure -- assign both parent and child as last level
     Vtr::internal::VertexInterface vHood(level, level);
 
+#ifdef _OPENMP
+    #pragma omp for
+#endif
     for (int vert = 0; vert < level.getNumVertices(); ++vert) {
 
         ConstIndexArray vEdges  = level.getVertexEdges(vert);
@@ -1240,6 +1582,7 @@ PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
             }
         }
     }
+    }
 }
 
 } // end namespace Far
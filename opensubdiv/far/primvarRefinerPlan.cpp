@@ -0,0 +1,81 @@
+//
+//   Copyright 2015 DreamWorks Animation LLC.
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/primvarRefinerPlan.h"
+#include "../far/stencilTableFactory.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+    void
+    deleteTables(std::vector<StencilTable const *> & tables) {
+        for (int i = 0; i < (int)tables.size(); ++i) {
+            delete tables[i];
+        }
+        tables.clear();
+    }
+}
+
+PrimvarRefinerPlan::PrimvarRefinerPlan(TopologyRefiner const & refiner,
+                                       Options options) :
+    _options(options) {
+
+    StencilTableFactory::Options tableOptions;
+    tableOptions.maxLevel = refiner.GetMaxLevel();
+
+    tableOptions.interpolationMode = StencilTableFactory::INTERPOLATE_VERTEX;
+    StencilTableFactory::CreateLevelStencilTables(refiner, _vertexTables, tableOptions);
+
+    if (options.generateVarying) {
+        tableOptions.interpolationMode = StencilTableFactory::INTERPOLATE_VARYING;
+        StencilTableFactory::CreateLevelStencilTables(refiner, _varyingTables, tableOptions);
+    }
+
+    if (options.generateFaceVarying) {
+        _fvarTables.resize(refiner.GetNumFVarChannels());
+
+        tableOptions.interpolationMode = StencilTableFactory::INTERPOLATE_FACE_VARYING;
+        for (int channel = 0; channel < (int)_fvarTables.size(); ++channel) {
+            tableOptions.fvarChannel = channel;
+            StencilTableFactory::CreateLevelStencilTables(refiner, _fvarTables[channel], tableOptions);
+        }
+    }
+}
+
+PrimvarRefinerPlan::~PrimvarRefinerPlan() {
+
+    deleteTables(_vertexTables);
+    deleteTables(_varyingTables);
+    for (int channel = 0; channel < (int)_fvarTables.size(); ++channel) {
+        deleteTables(_fvarTables[channel]);
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,205 @@
+//
+//   Copyright 2015 DreamWorks Animation LLC.
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_PRIMVAR_REFINER_PLAN_H
+#define OPENSUBDIV3_FAR_PRIMVAR_REFINER_PLAN_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+#include "../far/stencilTable.h"
+#include "../far/topologyRefiner.h"
+
+#include <vector>
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+///  \brief Pre-compiled refinement operations for generic primvar data.
+///
+///  A PrimvarRefinerPlan records, for each level of a TopologyRefiner, the
+///  list of parent values and weights contributing to every child value.
+///  The weights of each level are stored as a StencilTable whose stencils
+///  reference the values of the previous level only (see
+///  StencilTableFactory::CreateLevelStencilTables()).
+///
+///  Once compiled, the interpolation methods mirror those of PrimvarRefiner
+///  and accept the same primvar types (requiring Clear() and AddWithWeight()),
+///  but replace the evaluation of subdivision masks and the traversal of the
+///  topology with a single pass over the recorded weights.  This is suited to
+///  the repeated refinement of primvar data for topology that does not change.
+///
+class PrimvarRefinerPlan {
+
+public:
+
+    ///
+    ///  \brief Options controlling the content of the plan
+    ///
+    struct Options {
+
+        Options() : generateVarying(false),
+                    generateFaceVarying(false),
+                    parallel(false) { }
+
+        unsigned int generateVarying     : 1, ///< record varying interpolation
+                     generateFaceVarying : 1, ///< record face-varying interpolation
+                                              ///< for all channels
+                     parallel            : 1; ///< distribute the values of each level
+                                              ///< across threads when the client code
+                                              ///< is compiled with OpenMP
+    };
+
+    /// \brief Compiles the refinement operations of all levels of \c refiner
+    PrimvarRefinerPlan(TopologyRefiner const & refiner, Options options = Options());
+    ~PrimvarRefinerPlan();
+
+    /// \brief Returns the options specified on construction
+    Options GetOptions() const { return _options; }
+
+    /// \brief Returns the highest level of refinement recorded in the plan
+    int GetMaxLevel() const { return (int)_vertexTables.size(); }
+
+    /// \brief Returns the number of face-varying channels recorded in the plan
+    int GetNumFVarChannels() const { return (int)_fvarTables.size(); }
+
+    /// \brief Returns the weights used to interpolate vertex data to \c level
+    StencilTable const * GetLevelStencilTable(int level) const {
+        return _vertexTables[level-1];
+    }
+
+    /// \brief Returns the weights used to interpolate varying data to \c level
+    ///        (null if varying interpolation was not requested)
+    StencilTable const * GetLevelVaryingStencilTable(int level) const {
+        return _varyingTables.empty() ? 0 : _varyingTables[level-1];
+    }
+
+    /// \brief Returns the weights used to interpolate face-varying data of
+    ///        \c channel to \c level (null if not requested)
+    StencilTable const * GetLevelFaceVaryingStencilTable(int level, int channel = 0) const {
+        return _fvarTables.empty() ? 0 : _fvarTables[channel][level-1];
+    }
+
+    /// \brief Apply vertex interpolation weights to a primvar buffer for a single
+    ///        level of refinement (see PrimvarRefiner::Interpolate())
+    ///
+    /// @param level  The refinement level
+    ///
+    /// @param src    Source primvar buffer (control vertex data at level-1)
+    ///
+    /// @param dst    Destination primvar buffer (refined data at level)
+    ///
+    template <class T, class U>
+    void Interpolate(int level, T const & src, U & dst) const {
+        apply(*GetLevelStencilTable(level), src, dst);
+    }
+
+    /// \brief Apply only varying interpolation weights to a primvar buffer
+    ///        for a single level of refinement (see PrimvarRefiner::InterpolateVarying())
+    ///
+    /// @param level  The refinement level
+    ///
+    /// @param src    Source primvar buffer (control vertex data at level-1)
+    ///
+    /// @param dst    Destination primvar buffer (refined data at level)
+    ///
+    template <class T, class U>
+    void InterpolateVarying(int level, T const & src, U & dst) const {
+        assert(GetLevelVaryingStencilTable(level));
+        apply(*GetLevelVaryingStencilTable(level), src, dst);
+    }
+
+    /// \brief Apply face-varying interpolation weights to a primvar buffer
+    ///        associated with a particular face-varying channel
+    ///        (see PrimvarRefiner::InterpolateFaceVarying())
+    ///
+    /// @param level    The refinement level
+    ///
+    /// @param src      Source primvar buffer (control vertex data at level-1)
+    ///
+    /// @param dst      Destination primvar buffer (refined data at level)
+    ///
+    /// @param channel  The face-varying channel
+    ///
+    template <class T, class U>
+    void InterpolateFaceVarying(int level, T const & src, U & dst, int channel = 0) const {
+        assert(GetLevelFaceVaryingStencilTable(level, channel));
+        apply(*GetLevelFaceVaryingStencilTable(level, channel), src, dst);
+    }
+
+private:
+
+    //  Non-copyable:
+    PrimvarRefinerPlan(PrimvarRefinerPlan const &);
+    PrimvarRefinerPlan & operator=(PrimvarRefinerPlan const &);
+
+    template <class T, class U>
+    void apply(StencilTable const & table, T const & src, U & dst) const;
+
+private:
+
+    Options _options;
+
+    std::vector<StencilTable const *>                _vertexTables;
+    std::vector<StencilTable const *>                _varyingTables;
+    std::vector<std::vector<StencilTable const *> >  _fvarTables;
+};
+
+template <class T, class U>
+inline void
+PrimvarRefinerPlan::apply(StencilTable const & table, T const & src, U & dst) const {
+
+    int numValues = table.GetNumStencils();
+    if (numValues == 0) return;
+
+    int   const * sizes   = &table.GetSizes()[0];
+    Index const * offsets = &table.GetOffsets()[0];
+    Index const * indices = &table.GetControlIndices()[0];
+    float const * weights = &table.GetWeights()[0];
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (_options.parallel)
+#endif
+    for (int i = 0; i < numValues; ++i) {
+
+        Index const * valueIndices = indices + offsets[i];
+        float const * valueWeights = weights + offsets[i];
+
+        dst[i].Clear();
+        for (int j = 0; j < sizes[i]; ++j) {
+            dst[i].AddWithWeight(src[valueIndices[j]], valueWeights[j]);
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_PRIMVAR_REFINER_PLAN_H */
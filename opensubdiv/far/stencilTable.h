@@ -344,6 +344,9 @@ class LimitStencilTable : public StencilTable {
                     bool includeCoarseVerts,
                     size_t firstOffset);
 
+    LimitStencilTable(int numControlVerts)
+        : StencilTable(numControlVerts) { }
+
 public:
 
     /// \brief Returns a LimitStencil at index i in the table
@@ -24,17 +24,25 @@
 
 #include "../far/stencilTableFactory.h"
 #include "../far/stencilBuilder.h"
+#include "../far/error.h"
 #include "../far/endCapGregoryBasisPatchFactory.h"
 #include "../far/patchTable.h"
 #include "../far/patchTableFactory.h"
 #include "../far/patchMap.h"
+#include "../far/ptexIndices.h"
 #include "../far/topologyRefiner.h"
 #include "../far/primvarRefiner.h"
+#include "../vtr/stackBuffer.h"
 
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 #include <iostream>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -51,6 +59,39 @@ namespace {
 #ifdef __INTEL_COMPILER
 #pragma warning (pop)
 #endif
+
+    //
+    //  Destination of the stencils of a level whose carried vertices are copied
+    //  from a previous table rather than interpolated -- the stencils of those
+    //  vertices are skipped, except for face-vertices whose stencils are combined
+    //  in those of other vertices:
+    //
+    class CarriedStencilIndex {
+    public:
+        CarriedStencilIndex(internal::StencilBuilder::Index const & index,
+                            std::vector<unsigned char> const & isSkipped)
+            : _index(index), _isSkipped(&isSkipped), _skip(false) { }
+
+        CarriedStencilIndex operator[](int index) const {
+            CarriedStencilIndex dst(_index[index], *_isSkipped);
+            dst._skip = ((*_isSkipped)[index] != 0);
+            return dst;
+        }
+
+        void Clear() { }
+
+        void AddWithWeight(internal::StencilBuilder::Index const & src, float weight) {
+            if (!_skip) _index.AddWithWeight(src, weight);
+        }
+        void AddWithWeight(CarriedStencilIndex const & src, float weight) {
+            if (!_skip) _index.AddWithWeight(src._index, weight);
+        }
+
+    private:
+        internal::StencilBuilder::Index    _index;
+        std::vector<unsigned char> const * _isSkipped;
+        bool                               _skip;
+    };
 }
 
 //------------------------------------------------------------------------------
@@ -148,6 +189,172 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
 
 //------------------------------------------------------------------------------
 
+void
+StencilTableFactory::CreateLevelStencilTables(TopologyRefiner const & refiner,
+    std::vector<StencilTable const *> & levelTables, Options options) {
+
+    createLevelStencilTables(refiner, levelTables, 1, options,
+                             std::vector<StencilTable const *>());
+}
+
+void
+StencilTableFactory::UpdateLevelStencilTables(TopologyRefiner const & refiner,
+    std::vector<StencilTable const *> & levelTables, int firstLevel, Options options) {
+
+    firstLevel = std::max(firstLevel, 1);
+
+    //  The previous tables of the regenerated levels are retained until the
+    //  stencils of their carried vertices have been copied:
+    std::vector<StencilTable const *> prevTables;
+    if (firstLevel <= (int)levelTables.size()) {
+        prevTables.assign(levelTables.begin() + firstLevel - 1, levelTables.end());
+    }
+    levelTables.resize(std::min((int)levelTables.size(), firstLevel-1));
+
+    createLevelStencilTables(refiner, levelTables, (int)levelTables.size() + 1, options,
+                             prevTables);
+
+    for (int i = 0; i < (int)prevTables.size(); ++i) {
+        delete prevTables[i];
+    }
+}
+
+void
+StencilTableFactory::createLevelStencilTables(TopologyRefiner const & refiner,
+    std::vector<StencilTable const *> & levelTables, int firstLevel, Options options,
+    std::vector<StencilTable const *> const & prevTables) {
+
+    bool interpolateVertex = options.interpolationMode==INTERPOLATE_VERTEX;
+    bool interpolateVarying = options.interpolationMode==INTERPOLATE_VARYING;
+    bool interpolateFaceVarying = options.interpolationMode==INTERPOLATE_FACE_VARYING;
+
+    int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
+
+    levelTables.resize(maxlevel, 0);
+
+    PrimvarRefiner primvarRefiner(refiner);
+
+    for (int level=firstLevel; level<=maxlevel; ++level) {
+
+        int numParentVerts = !interpolateFaceVarying
+            ? refiner.GetLevel(level-1).GetNumVertices()
+            : refiner.GetLevel(level-1).GetNumFVarValues(options.fvarChannel);
+
+        //
+        // All vertices of the parent level are considered as coarse verts,
+        // so the stencils are never resolved beyond the parent level. The
+        // child vertices follow them -- child vertices are also sources of
+        // other child vertices (e.g. face-vertices of edge-vertices) and are
+        // resolved into the parent vertices only when indexed beyond them.
+        //
+        internal::StencilBuilder builder(numParentVerts,
+                                    /*genControlVerts*/ false,
+                                    /*compactWeights*/  true);
+
+        internal::StencilBuilder::Index srcIndex(&builder, 0);
+        internal::StencilBuilder::Index dstIndex(&builder, numParentVerts);
+
+        //
+        //  When the level was regenerated by TopologyRefiner::UpdateSparse(), the
+        //  stencils of the vertices carried forward are copied from the previous
+        //  table of the level (if consistent with the previous levels) with their
+        //  sources remapped to the current parent level:
+        //
+        int prevIndex = level - firstLevel;
+
+        StencilTable const * prevTable = (prevIndex < (int)prevTables.size()) ?
+                                         prevTables[prevIndex] : 0;
+
+        ConstIndexArray carriedVerts = refiner.GetCarriedVertices(level);
+
+        if (prevTable && !interpolateFaceVarying && !carriedVerts.empty() &&
+            (refiner._firstCarriedLevel == firstLevel) &&
+            (prevTable->GetNumStencils() == refiner.getNumPrevVertices(level)) &&
+            (prevTable->GetNumControlVertices() == refiner.getNumPrevVertices(level-1))) {
+
+            Vtr::internal::Refinement const & refinement = refiner.getRefinement(level-1);
+
+            std::vector<unsigned char> isSkipped(carriedVerts.size(), 0);
+            for (int vert = 0; vert < carriedVerts.size(); ++vert) {
+                isSkipped[vert] = IndexIsValid(carriedVerts[vert]);
+            }
+            for (int face = 0; (refinement.getNumChildVerticesFromFaces() > 0) &&
+                               (face < refinement.parent().getNumFaces()); ++face) {
+                Index cVert = refinement.getFaceChildVertex(face);
+                if (IndexIsValid(cVert)) {
+                    isSkipped[cVert] = false;
+                }
+            }
+
+            CarriedStencilIndex carriedDstIndex(dstIndex, isSkipped);
+            if (interpolateVertex) {
+                primvarRefiner.Interpolate(level, srcIndex, carriedDstIndex);
+            } else {
+                primvarRefiner.InterpolateVarying(level, srcIndex, carriedDstIndex);
+            }
+
+            std::vector<Index> parentVerts(prevTable->GetNumControlVertices(), INDEX_INVALID);
+            for (Index vert = 0; vert < numParentVerts; ++vert) {
+                Index prevVert = refiner.getPrevVertex(level-1, vert);
+                if (IndexIsValid(prevVert)) {
+                    parentVerts[prevVert] = vert;
+                }
+            }
+
+            std::vector<int> const &   sizes   = builder.GetStencilSizes();
+            std::vector<int> const &   offsets = builder.GetStencilOffsets();
+            std::vector<int> const &   sources = builder.GetStencilSources();
+            std::vector<float> const & weights = builder.GetStencilWeights();
+
+            StencilTable * table = new StencilTable(numParentVerts);
+            table->reserve(carriedVerts.size(), (int)sources.size());
+
+            for (int vert = 0; vert < carriedVerts.size(); ++vert) {
+                if (isSkipped[vert]) {
+                    Stencil prevStencil = prevTable->GetStencil(carriedVerts[vert]);
+
+                    table->_sizes.push_back(prevStencil.GetSize());
+                    for (int i = 0; i < prevStencil.GetSize(); ++i) {
+                        Index src = parentVerts[prevStencil.GetVertexIndices()[i]];
+                        assert(IndexIsValid(src));
+                        table->_indices.push_back(src);
+                        table->_weights.push_back(prevStencil.GetWeights()[i]);
+                    }
+                } else {
+                    int i = numParentVerts + vert;
+                    table->_sizes.push_back(sizes[i]);
+                    table->_indices.insert(table->_indices.end(),
+                        sources.begin() + offsets[i], sources.begin() + offsets[i] + sizes[i]);
+                    table->_weights.insert(table->_weights.end(),
+                        weights.begin() + offsets[i], weights.begin() + offsets[i] + sizes[i]);
+                }
+            }
+            table->finalize();
+
+            levelTables[level-1] = table;
+            continue;
+        }
+
+        if (interpolateVertex) {
+            primvarRefiner.Interpolate(level, srcIndex, dstIndex);
+        } else if (interpolateVarying) {
+            primvarRefiner.InterpolateVarying(level, srcIndex, dstIndex);
+        } else {
+            primvarRefiner.InterpolateFaceVarying(level, srcIndex, dstIndex, options.fvarChannel);
+        }
+
+        levelTables[level-1] = new StencilTable(numParentVerts,
+                                                builder.GetStencilOffsets(),
+                                                builder.GetStencilSizes(),
+                                                builder.GetStencilSources(),
+                                                builder.GetStencilWeights(),
+                                                /*includeCoarseVerts*/ false,
+                                                /*firstOffset*/ numParentVerts);
+    }
+}
+
+//------------------------------------------------------------------------------
+
 StencilTable const *
 StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
 
@@ -389,179 +596,720 @@ StencilTableFactory::appendLocalPointStencilTable(
 }
 
 //------------------------------------------------------------------------------
-LimitStencilTable const *
-LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
-    LocationArrayVec const & locationArrays,
-        StencilTable const * cvStencilsIn,
-          PatchTable const * patchTableIn,
-                     Options options) {
-
-    // Compute the total number of stencils to generate
-    int numStencils=0, numLimitStencils=0;
-    for (int i=0; i<(int)locationArrays.size(); ++i) {
-        assert(locationArrays[i].numLocations>=0);
-        numStencils += locationArrays[i].numLocations;
-    }
-    if (numStencils<=0) {
-        return 0;
-    }
 
-    bool uniform = refiner.IsUniform();
+namespace {
 
-    int maxlevel = refiner.GetMaxLevel();
+    //
+    //  Generate stencils for the control vertices - this is necessary to
+    //  properly factorize patches with control vertices at level 0 (natural
+    //  regular patches, such as in a torus)
+    //  note: the control vertices of the mesh are added as single-index
+    //        stencils of weight 1.0f
+    //
+    StencilTable const *
+    createCVStencilTable(TopologyRefiner const & refiner) {
 
-    StencilTable const * cvstencils = cvStencilsIn;
-    if (! cvstencils) {
-        // Generate stencils for the control vertices - this is necessary to
-        // properly factorize patches with control vertices at level 0 (natural
-        // regular patches, such as in a torus)
-        // note: the control vertices of the mesh are added as single-index
-        //       stencils of weight 1.0f
         StencilTableFactory::Options options;
-        options.generateIntermediateLevels = uniform ? false :true;
+        options.generateIntermediateLevels = refiner.IsUniform() ? false :true;
         options.generateControlVerts = true;
         options.generateOffsets = true;
 
         // PERFORMANCE: We could potentially save some mem-copies by not
         // instantiating the stencil tables and work directly off the source
         // data.
-        cvstencils = StencilTableFactory::Create(refiner, options);
-    } else {
-        // Sanity checks
-        //
-        // Note that the input cvStencils could be larger than the number of
-        // refiner's vertices, due to the existence of the end cap stencils.
-        if (cvstencils->GetNumStencils() < (uniform ?
-            refiner.GetLevel(maxlevel).GetNumVertices() :
-                refiner.GetNumVerticesTotal())) {
-                return 0;
-        }
+        return StencilTableFactory::Create(refiner, options);
     }
 
-    // If a stencil table was given, use it, otherwise, create a new one
-    PatchTable const * patchtable = patchTableIn;
-
-    if (! patchtable) {
-        // XXXX (manuelk) If no patch-table was passed, we should be able to
-        // infer the patches fairly easily from the refiner. Once more tags
-        // have been added to the refiner, maybe we can remove the need for the
-        // patch table.
+    //
+    //  XXXX (manuelk) If no patch-table was passed, we should be able to
+    //  infer the patches fairly easily from the refiner. Once more tags
+    //  have been added to the refiner, maybe we can remove the need for the
+    //  patch table.
+    //
+    PatchTable const *
+    createPatchTable(TopologyRefiner const & refiner) {
 
         PatchTableFactory::Options options;
         options.SetEndCapType(
             Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
-        options.useInfSharpPatch = !uniform &&
+        options.useInfSharpPatch = !refiner.IsUniform() &&
             refiner.GetAdaptiveOptions().useInfSharpPatch;
 
-        patchtable = PatchTableFactory::Create(refiner, options);
-
-        if (! cvStencilsIn) {
-            // if cvstencils is just created above, append endcap stencils
-            if (StencilTable const *localPointStencilTable =
-                patchtable->GetLocalPointStencilTable()) {
-                StencilTable const *table =
-                    StencilTableFactory::AppendLocalPointStencilTable(
-                        refiner, cvstencils, localPointStencilTable);
-                delete cvstencils;
-                cvstencils = table;
+        return PatchTableFactory::Create(refiner, options);
+    }
+
+    //
+    //  Returns the number of patch points indexed by the patches: the
+    //  control vertices, the refined vertices and the local points.
+    //
+    int
+    getNumPatchPoints(TopologyRefiner const & refiner,
+                      PatchTable const & patchTable) {
+
+        int numVertices = refiner.IsUniform()
+            ? (refiner.GetLevel(0).GetNumVertices() +
+               refiner.GetLevel(refiner.GetMaxLevel()).GetNumVertices())
+            : refiner.GetNumVerticesTotal();
+
+        return numVertices + patchTable.GetNumLocalPoints();
+    }
+
+    //
+    //  Resolves the tables supporting the generation of limit stencils: the
+    //  stencils of the refined vertices and the patches -- both are created
+    //  (and owned) here when not provided by the client. The stencils are
+    //  not required when the limit stencils are not factorized.
+    //
+    class LimitStencilSupport {
+    public:
+        LimitStencilSupport(TopologyRefiner const & refiner,
+                            StencilTable const * cvStencilsIn,
+                            PatchTable const * patchTableIn,
+                            bool factorize);
+        ~LimitStencilSupport();
+
+        bool IsValid() const { return _isValid; }
+
+        StencilTable const * GetStencilTable() const { return _cvStencils; }
+        PatchTable const & GetPatchTable() const { return *_patchTable; }
+
+    private:
+        StencilTable const * _cvStencils;
+        PatchTable const * _patchTable;
+
+        bool _ownsStencilTable,
+             _ownsPatchTable,
+             _isValid;
+    };
+
+    LimitStencilSupport::LimitStencilSupport(TopologyRefiner const & refiner,
+        StencilTable const * cvStencilsIn, PatchTable const * patchTableIn,
+            bool factorize) :
+                _cvStencils(cvStencilsIn), _patchTable(patchTableIn),
+                _ownsStencilTable(false), _ownsPatchTable(false),
+                _isValid(false) {
+
+        bool uniform = refiner.IsUniform();
+
+        int maxlevel = refiner.GetMaxLevel();
+
+        if (! _cvStencils) {
+            if (factorize) {
+                _cvStencils = createCVStencilTable(refiner);
+                _ownsStencilTable = true;
+            }
+        } else if (! factorize) {
+            // Without factorization the limit stencils are expressed in
+            // terms of the patch points, which the given stencils would
+            // have replaced
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in LimitStencilTableFactory -- cvStencils cannot be "
+                "applied without factorizePatchPoints.");
+            return;
+        } else {
+            // Sanity checks
+            //
+            // Note that the input cvStencils could be larger than the number of
+            // refiner's vertices, due to the existence of the end cap stencils.
+            if (_cvStencils->GetNumStencils() < (uniform ?
+                refiner.GetLevel(maxlevel).GetNumVertices() :
+                    refiner.GetNumVerticesTotal())) {
+                return;
             }
         }
-    } else {
-        // Sanity checks
-        if (patchtable->IsFeatureAdaptive()==uniform) {
-            if (! cvStencilsIn) {
-                assert(cvstencils && cvstencils!=cvStencilsIn);
-                delete cvstencils;
+
+        if (! _patchTable) {
+            _patchTable = createPatchTable(refiner);
+            _ownsPatchTable = true;
+
+            if (_ownsStencilTable) {
+                // if cvstencils is just created above, append endcap stencils
+                if (StencilTable const *localPointStencilTable =
+                    _patchTable->GetLocalPointStencilTable()) {
+                    StencilTable const *table =
+                        StencilTableFactory::AppendLocalPointStencilTable(
+                            refiner, _cvStencils, localPointStencilTable);
+                    delete _cvStencils;
+                    _cvStencils = table;
+                }
+            }
+        } else {
+            // Sanity checks
+            if (_patchTable->IsFeatureAdaptive()==uniform) {
+                return;
             }
-            return 0;
         }
+        _isValid = true;
     }
 
-    assert(patchtable && cvstencils);
+    LimitStencilSupport::~LimitStencilSupport() {
+        if (_ownsStencilTable) {
+            delete _cvStencils;
+        }
+        if (_ownsPatchTable) {
+            delete _patchTable;
+        }
+    }
 
-    // Create a patch-map to locate sub-patches faster
-    PatchMap patchmap( *patchtable );
+    //
+    //  Provides the stencils of the patch points: either their factorized
+    //  stencils, or trivial stencils referring to the patch points themselves.
+    //
+    class PatchPointStencils {
+    public:
+        PatchPointStencils(StencilTable const * table) :
+            _table(table), _size(1), _index(0), _weight(1.0f) { }
+
+        Stencil operator[] (Index index) {
+            if (_table) {
+                return (*_table)[index];
+            }
+            _index = index;
+            return Stencil(&_size, &_index, &_weight);
+        }
+
+    private:
+        StencilTable const * _table;
+
+        int   _size;
+        Index _index;
+        float _weight;
+    };
 
     //
-    // Generate limit stencils for locations
+    //  Populates the offsets of each location array in the flattened sequence
+    //  of locations and returns the total number of locations.
     //
+    int
+    computeLocationArrayOffsets(
+        LimitStencilTableFactory::LocationArrayVec const & locationArrays,
+        std::vector<int> & arrayOffsets) {
+
+        int numLocations = 0;
+
+        arrayOffsets.resize(locationArrays.size());
+        for (int i=0; i<(int)locationArrays.size(); ++i) {
+            assert(locationArrays[i].numLocations>=0);
+            arrayOffsets[i] = numLocations;
+            numLocations += locationArrays[i].numLocations;
+        }
+        return numLocations;
+    }
 
-    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
-                                /*genControlVerts*/ false,
-                                /*compactWeights*/  true);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
+    //
+    //  Appends to the builder the limit stencils of the locations [first, last)
+    //  of the flattened sequence of location arrays and returns the number of
+    //  stencils generated (locations not found in the patch map are skipped).
+    //
+    int
+    appendLimitStencils(internal::StencilBuilder & builder,
+        LimitStencilTableFactory::LocationArrayVec const & locationArrays,
+        std::vector<int> const & arrayOffsets,
+        int first, int last,
+        StencilTable const * cvStencils,
+        PatchTable const & patchtable,
+        PatchMap const & patchmap,
+        LimitStencilTableFactory::Options options) {
+
+        internal::StencilBuilder::Index origin(&builder, 0);
+        internal::StencilBuilder::Index dst = origin;
+
+        PatchPointStencils src(cvStencils);
+
+        //  Weights are sized for the patches with the most control vertices:
+        int maxPatchSize = 0;
+        for (int k=0; k<patchtable.GetNumPatchArrays(); ++k) {
+            maxPatchSize = std::max(maxPatchSize,
+                (int)patchtable.GetPatchArrayDescriptor(k).GetNumControlVertices());
+        }
+        Vtr::internal::StackBuffer<float, 6 * 20> weights(6 * maxPatchSize);
+
+        float * wP   = &weights[0];
+        float * wDs  = wP   + maxPatchSize;
+        float * wDt  = wDs  + maxPatchSize;
+        float * wDss = wDt  + maxPatchSize;
+        float * wDst = wDss + maxPatchSize;
+        float * wDtt = wDst + maxPatchSize;
+
+        int numLimitStencils = 0;
+
+        // Locate the array containing the first location
+        int i = (int)(std::upper_bound(arrayOffsets.begin(),
+            arrayOffsets.end(), first) - arrayOffsets.begin()) - 1;
+
+        for (int location=first; location<last; ++i) {
+            LimitStencilTableFactory::LocationArray const & array = locationArrays[i];
+            assert(array.ptexIdx>=0);
+
+            int j    = location - arrayOffsets[i],
+                jEnd = std::min(array.numLocations, j + (last - location));
+
+            location += jEnd - j;
+
+            for ( ; j<jEnd; ++j) { // for each face we're working on
+                float s = array.s[j],
+                      t = array.t[j]; // for each target (s,t) point on that face
+
+                PatchMap::Handle const * handle =
+                                            patchmap.FindPatch(array.ptexIdx, s, t);
+                if (handle) {
+                    ConstIndexArray cvs = patchtable.GetPatchVertices(*handle);
+
+                    dst = origin[numLimitStencils];
+
+                    if (options.generate2ndDerivatives) {
+                        patchtable.EvaluateBasis(*handle, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+
+                        dst.Clear();
+                        for (int k = 0; k < cvs.size(); ++k) {
+                            dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k], wDss[k], wDst[k], wDtt[k]);
+                        }
+                    } else if (options.generate1stDerivatives) {
+                        patchtable.EvaluateBasis(*handle, s, t, wP, wDs, wDt);
+
+                        dst.Clear();
+                        for (int k = 0; k < cvs.size(); ++k) {
+                            dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k]);
+                        }
+                    } else {
+                        patchtable.EvaluateBasis(*handle, s, t, wP);
+
+                        dst.Clear();
+                        for (int k = 0; k < cvs.size(); ++k) {
+                            dst.AddWithWeight(src[cvs[k]], wP[k]);
+                        }
+                    }
 
-    float wP[20], wDs[20], wDt[20], wDss[20], wDst[20], wDtt[20];
+                    ++numLimitStencils;
+                }
+            }
+        }
+        return numLimitStencils;
+    }
 
-    for (size_t i=0; i<locationArrays.size(); ++i) {
-        LocationArray const & array = locationArrays[i];
-        assert(array.ptexIdx>=0);
+    //
+    //  The limit surface of the bilinear scheme is that of its base faces:  the
+    //  bilinear interpolation of the vertices of quads, and of the corner vertex,
+    //  edge midpoints and center of each sub-face of other faces.  Limit stencils
+    //  are computed directly from the base faces when no PatchTable is provided,
+    //  without refined vertices, patches or a PatchMap.
+    //
+    inline bool
+    isBilinearLimitDirect(TopologyRefiner const & refiner,
+        PatchTable const * patchTable, LimitStencilTableFactory::Options options) {
 
-        for (int j=0; j<array.numLocations; ++j) { // for each face we're working on
-            float s = array.s[j],
-                  t = array.t[j]; // for each target (s,t) point on that face
+        return (refiner.GetSchemeType() == Sdc::SCHEME_BILINEAR) &&
+               (patchTable == 0) && options.factorizePatchPoints;
+    }
+
+    //
+    //  Distributes the weights of the four corners of a face (quads) or of the
+    //  sub-face at the given corner (other faces) to the vertices of the face --
+    //  the corners of a sub-face are its vertex, the midpoint of the following
+    //  edge, the face center and the midpoint of the preceding edge:
+    //
+    inline void
+    distributeCornerWeights(int N, int corner, float const cornerWeights[4],
+        float weights[]) {
+
+        if (N == 4) {
+            std::memcpy(weights, cornerWeights, 4 * sizeof(float));
+            return;
+        }
+        float centerWeight = cornerWeights[2] / (float)N;
+        for (int k = 0; k < N; ++k) {
+            weights[k] = centerWeight;
+        }
+        weights[corner]               += cornerWeights[0] + 0.5f * (cornerWeights[1] + cornerWeights[3]);
+        weights[(corner + 1) % N]     += 0.5f * cornerWeights[1];
+        weights[(corner + N - 1) % N] += 0.5f * cornerWeights[3];
+    }
+
+    //
+    //  Appends to the builder the limit stencils of the locations [first, last)
+    //  evaluated directly on the base faces of a bilinear mesh (locations of
+    //  holes and invalid ptex faces are skipped).
+    //
+    int
+    appendBilinearLimitStencils(internal::StencilBuilder & builder,
+        LimitStencilTableFactory::LocationArrayVec const & locationArrays,
+        std::vector<int> const & arrayOffsets,
+        int first, int last,
+        TopologyLevel const & baseLevel,
+        PtexIndices const & ptexIndices,
+        LimitStencilTableFactory::Options options) {
+
+        internal::StencilBuilder::Index origin(&builder, 0);
+        internal::StencilBuilder::Index dst = origin;
+
+        PatchPointStencils src(0);
+
+        int numLimitStencils = 0;
+
+        Vtr::internal::StackBuffer<float, 6 * 8> weights;
 
-            PatchMap::Handle const * handle = 
-                                        patchmap.FindPatch(array.ptexIdx, s, t);
-            if (handle) {
-                ConstIndexArray cvs = patchtable->GetPatchVertices(*handle);
+        int i = (int)(std::upper_bound(arrayOffsets.begin(),
+            arrayOffsets.end(), first) - arrayOffsets.begin()) - 1;
+
+        for (int location=first; location<last; ++i) {
+            LimitStencilTableFactory::LocationArray const & array = locationArrays[i];
+            assert(array.ptexIdx>=0);
+
+            int j    = location - arrayOffsets[i],
+                jEnd = std::min(array.numLocations, j + (last - location));
+
+            location += jEnd - j;
+
+            if (array.ptexIdx >= ptexIndices.GetNumFaces()) continue;
+
+            //  Identify the base face of the ptex face -- the last face whose first
+            //  ptex face does not exceed it -- and the sub-face within it:
+            Index faceLo = 0,
+                  faceHi = baseLevel.GetNumFaces() - 1;
+            while (faceLo < faceHi) {
+                Index faceMid = (faceLo + faceHi + 1) / 2;
+                if (ptexIndices.GetFaceId(faceMid) <= array.ptexIdx) {
+                    faceLo = faceMid;
+                } else {
+                    faceHi = faceMid - 1;
+                }
+            }
+            Index face = faceLo;
+
+            if (baseLevel.IsFaceHole(face)) continue;
+
+            ConstIndexArray fVerts = baseLevel.GetFaceVertices(face);
+
+            int N      = fVerts.size();
+            int corner = array.ptexIdx - ptexIndices.GetFaceId(face);
+
+            //  As with the patches of a PatchTable -- whose depth for faces other
+            //  than quads includes the split into sub-faces -- derivatives of the
+            //  sub-faces are scaled by 2:
+            float dScale = (N == 4) ? 1.0f : 2.0f;
+
+            weights.SetSize(6 * N);
+
+            float * wP   = &weights[0];
+            float * wDs  = wP   + N;
+            float * wDt  = wDs  + N;
+            float * wDss = wDt  + N;
+            float * wDst = wDss + N;
+            float * wDtt = wDst + N;
+
+            std::memset(wDss, 0, N * sizeof(float));
+            std::memset(wDtt, 0, N * sizeof(float));
+
+            for ( ; j<jEnd; ++j) {
+                float s = array.s[j],
+                      t = array.t[j];
+
+                assert((s>=0.0f) && (s<=1.0f) && (t>=0.0f) && (t<=1.0f));
+
+                //  Weights of the four corners of the face or sub-face:
+                float sC = 1.0f - s,
+                      tC = 1.0f - t;
+
+                float cP[4]  = { sC * tC, s * tC, s * t, sC * t };
+                float cDs[4] = { -tC * dScale, tC * dScale,  t * dScale, -t * dScale };
+                float cDt[4] = { -sC * dScale, -s * dScale,  s * dScale, sC * dScale };
+
+                float cDst[4] = { dScale * dScale, -dScale * dScale,
+                                  dScale * dScale, -dScale * dScale };
+
+                distributeCornerWeights(N, corner, cP,   wP);
+                distributeCornerWeights(N, corner, cDs,  wDs);
+                distributeCornerWeights(N, corner, cDt,  wDt);
+                distributeCornerWeights(N, corner, cDst, wDst);
 
-                StencilTable const & src = *cvstencils;
                 dst = origin[numLimitStencils];
+                dst.Clear();
 
                 if (options.generate2ndDerivatives) {
-                    patchtable->EvaluateBasis(*handle, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-
-                    dst.Clear();
-                    for (int k = 0; k < cvs.size(); ++k) {
-                        dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k], wDss[k], wDst[k], wDtt[k]);
+                    for (int k = 0; k < N; ++k) {
+                        dst.AddWithWeight(src[fVerts[k]], wP[k], wDs[k], wDt[k], wDss[k], wDst[k], wDtt[k]);
                     }
                 } else if (options.generate1stDerivatives) {
-                    patchtable->EvaluateBasis(*handle, s, t, wP, wDs, wDt);
-
-                    dst.Clear();
-                    for (int k = 0; k < cvs.size(); ++k) {
-                        dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k]);
+                    for (int k = 0; k < N; ++k) {
+                        dst.AddWithWeight(src[fVerts[k]], wP[k], wDs[k], wDt[k]);
                     }
                 } else {
-                    patchtable->EvaluateBasis(*handle, s, t, wP);
-
-                    dst.Clear();
-                    for (int k = 0; k < cvs.size(); ++k) {
-                        dst.AddWithWeight(src[cvs[k]], wP[k]);
+                    for (int k = 0; k < N; ++k) {
+                        dst.AddWithWeight(src[fVerts[k]], wP[k]);
                     }
                 }
-
                 ++numLimitStencils;
             }
         }
+        return numLimitStencils;
     }
 
-    if (! cvStencilsIn) {
-        delete cvstencils;
+    template <typename T> void
+    appendElements(std::vector<T> & dst, size_t offset, std::vector<T> const & src) {
+        if (! src.empty()) {
+            std::memcpy(&dst[offset], &src[0], src.size()*sizeof(T));
+        }
     }
+}
 
-    if (! patchTableIn) {
-        delete patchtable;
+LimitStencilTable const *
+LimitStencilTableFactory::createLimitStencils(TopologyRefiner const & refiner,
+    LocationArrayVec const & locationArrays,
+    std::vector<int> const & arrayOffsets,
+    int first, int last,
+    StencilTable const * cvStencils,
+    PatchTable const * patchTable,
+    PatchMap const * patchMap,
+    PtexIndices const * ptexIndices,
+    Options options) {
+
+    // Unless factorized, the stencils refer to the patch points directly
+    int numControlVerts = options.factorizePatchPoints
+        ? refiner.GetLevel(0).GetNumVertices()
+        : getNumPatchPoints(refiner, *patchTable);
+
+    //
+    // Split the locations into contiguous ranges, each of which accumulates
+    // its stencils into its own builder, so that the ranges can be processed
+    // concurrently. The ranges are then concatenated in order.
+    //
+    // Each builder reserves a sizable amount of memory, so ranges are only
+    // created one per thread and for a minimum number of locations.
+    //
+    int const minLocationsPerRange = 1024;
+
+    int numLocations = last - first,
+        numRanges = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    numRanges = std::max(1, std::min(omp_get_max_threads(),
+                                     numLocations / minLocationsPerRange));
+#endif
+
+    if (! options.factorizePatchPoints) {
+        cvStencils = 0;
+    }
+
+    std::vector<internal::StencilBuilder *> builders(numRanges);
+    std::vector<int> numRangeStencils(numRanges, 0);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static, 1)
+#endif
+    for (int range=0; range<numRanges; ++range) {
+
+        int rangeFirst = first + (int)(((long long)numLocations * range) / numRanges),
+            rangeLast = first + (int)(((long long)numLocations * (range+1)) / numRanges);
+
+        builders[range] = new internal::StencilBuilder(numControlVerts,
+                                           /*genControlVerts*/ false,
+                                           /*compactWeights*/  true);
+
+        if (patchTable) {
+            numRangeStencils[range] = appendLimitStencils(*builders[range],
+                locationArrays, arrayOffsets, rangeFirst, rangeLast,
+                    cvStencils, *patchTable, *patchMap, options);
+        } else {
+            numRangeStencils[range] = appendBilinearLimitStencils(*builders[range],
+                locationArrays, arrayOffsets, rangeFirst, rangeLast,
+                    refiner.GetLevel(0), *ptexIndices, options);
+        }
     }
 
     //
     // Copy the proto-stencils into the limit stencil table
     //
-    LimitStencilTable * result = new LimitStencilTable(
-                                          refiner.GetLevel(0).GetNumVertices(),
-                                          builder.GetStencilOffsets(),
-                                          builder.GetStencilSizes(),
-                                          builder.GetStencilSources(),
-                                          builder.GetStencilWeights(),
-                                          builder.GetStencilDuWeights(),
-                                          builder.GetStencilDvWeights(),
-                                          builder.GetStencilDuuWeights(),
-                                          builder.GetStencilDuvWeights(),
-                                          builder.GetStencilDvvWeights(),
-                                          /*ctrlVerts*/false,
-                                          /*fristOffset*/0);
+    int numStencils = 0,
+        numElements = 0;
+    for (int range=0; range<numRanges; ++range) {
+        numStencils += numRangeStencils[range];
+        numElements += (int)builders[range]->GetStencilSources().size();
+    }
+
+    bool has1stDerivs = options.generate1stDerivatives || options.generate2ndDerivatives,
+         has2ndDerivs = options.generate2ndDerivatives;
+
+    LimitStencilTable * result = new LimitStencilTable(numControlVerts);
+
+    result->_sizes.resize(numStencils, 0);
+    result->_indices.resize(numElements);
+    result->_weights.resize(numElements);
+    if (has1stDerivs) {
+        result->_duWeights.resize(numElements);
+        result->_dvWeights.resize(numElements);
+    }
+    if (has2ndDerivs) {
+        result->_duuWeights.resize(numElements);
+        result->_duvWeights.resize(numElements);
+        result->_dvvWeights.resize(numElements);
+    }
+
+    int stencilOffset = 0,
+        elementOffset = 0;
+    for (int range=0; range<numRanges; ++range) {
+        internal::StencilBuilder const & builder = *builders[range];
+
+        // Trailing stencils without any contribution have no size entry
+        std::vector<int> const & sizes = builder.GetStencilSizes();
+        int numSizes = std::min(numRangeStencils[range], (int)sizes.size());
+        if (numSizes > 0) {
+            std::memcpy(&result->_sizes[stencilOffset], &sizes[0],
+                numSizes*sizeof(int));
+        }
+
+        appendElements(result->_indices, elementOffset, builder.GetStencilSources());
+        appendElements(result->_weights, elementOffset, builder.GetStencilWeights());
+        if (has1stDerivs) {
+            appendElements(result->_duWeights, elementOffset, builder.GetStencilDuWeights());
+            appendElements(result->_dvWeights, elementOffset, builder.GetStencilDvWeights());
+        }
+        if (has2ndDerivs) {
+            appendElements(result->_duuWeights, elementOffset, builder.GetStencilDuuWeights());
+            appendElements(result->_duvWeights, elementOffset, builder.GetStencilDuvWeights());
+            appendElements(result->_dvvWeights, elementOffset, builder.GetStencilDvvWeights());
+        }
+
+        stencilOffset += numRangeStencils[range];
+        elementOffset += (int)builder.GetStencilSources().size();
+
+        delete builders[range];
+    }
+
+    result->generateOffsets();
+
+    return result;
+}
+
+LimitStencilTable const *
+LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
+    LocationArrayVec const & locationArrays,
+        StencilTable const * cvStencilsIn,
+          PatchTable const * patchTableIn,
+                     Options options) {
+
+    // Compute the total number of stencils to generate
+    std::vector<int> arrayOffsets;
+    int numStencils = computeLocationArrayOffsets(locationArrays, arrayOffsets);
+    if (numStencils<=0) {
+        return 0;
+    }
+
+    if (isBilinearLimitDirect(refiner, patchTableIn, options)) {
+        PtexIndices ptexIndices(refiner);
+
+        return createLimitStencils(refiner, locationArrays, arrayOffsets,
+            0, numStencils, 0, 0, 0, &ptexIndices, options);
+    }
+
+    LimitStencilSupport support(refiner, cvStencilsIn, patchTableIn,
+        options.factorizePatchPoints);
+    if (! support.IsValid()) {
+        return 0;
+    }
+
+    // Create a patch-map to locate sub-patches faster
+    PatchMap patchmap( support.GetPatchTable() );
+
+    //
+    // Generate limit stencils for locations
+    //
+    return createLimitStencils(refiner, locationArrays, arrayOffsets,
+        0, numStencils, support.GetStencilTable(), &support.GetPatchTable(),
+            &patchmap, 0, options);
+}
+
+int
+LimitStencilTableFactory::CreateChunked(TopologyRefiner const & refiner,
+    LocationArrayVec const & locationArrays,
+                       int chunkSize,
+             ChunkCallback callback,
+                    void * clientData,
+        StencilTable const * cvStencilsIn,
+          PatchTable const * patchTableIn,
+                     Options options) {
+
+    if (! callback) {
+        return -1;
+    }
+
+    std::vector<int> arrayOffsets;
+    int numLocations = computeLocationArrayOffsets(locationArrays, arrayOffsets);
+    if (numLocations<=0) {
+        return 0;
+    }
+    if (chunkSize<=0) {
+        chunkSize = numLocations;
+    }
+
+    if (isBilinearLimitDirect(refiner, patchTableIn, options)) {
+        PtexIndices ptexIndices(refiner);
+
+        int numStencils = 0;
+        for (int first=0; first<numLocations; first+=chunkSize) {
+            int last = std::min(first + chunkSize, numLocations);
+
+            LimitStencilTable const * chunk = createLimitStencils(refiner,
+                locationArrays, arrayOffsets, first, last, 0, 0, 0,
+                    &ptexIndices, options);
+
+            int numChunkStencils = chunk->GetNumStencils();
+
+            callback(chunk, numStencils, clientData);
+
+            numStencils += numChunkStencils;
+        }
+        return numStencils;
+    }
+
+    // The supporting tables and the patch map are shared by all chunks
+    LimitStencilSupport support(refiner, cvStencilsIn, patchTableIn,
+        options.factorizePatchPoints);
+    if (! support.IsValid()) {
+        return -1;
+    }
+
+    PatchMap patchmap( support.GetPatchTable() );
+
+    int numStencils = 0;
+    for (int first=0; first<numLocations; first+=chunkSize) {
+        int last = std::min(first + chunkSize, numLocations);
+
+        LimitStencilTable const * chunk = createLimitStencils(refiner,
+            locationArrays, arrayOffsets, first, last,
+                support.GetStencilTable(), &support.GetPatchTable(),
+                    &patchmap, 0, options);
+
+        int numChunkStencils = chunk->GetNumStencils();
+
+        callback(chunk, numStencils, clientData);
+
+        numStencils += numChunkStencils;
+    }
+    return numStencils;
+}
+
+StencilTable const *
+LimitStencilTableFactory::CreatePatchPointStencilTable(
+    TopologyRefiner const & refiner, PatchTable const * patchTableIn) {
+
+    PatchTable const * patchtable = patchTableIn;
+    if (! patchtable) {
+        patchtable = createPatchTable(refiner);
+    }
+
+    StencilTable const * result = createCVStencilTable(refiner);
+
+    if (StencilTable const *localPointStencilTable =
+        patchtable->GetLocalPointStencilTable()) {
+        StencilTable const *table =
+            StencilTableFactory::AppendLocalPointStencilTable(
+                refiner, result, localPointStencilTable);
+        delete result;
+        result = table;
+    }
+
+    if (! patchTableIn) {
+        delete patchtable;
+    }
     return result;
 }
 
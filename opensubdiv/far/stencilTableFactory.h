@@ -37,6 +37,8 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 class TopologyRefiner;
+class PatchMap;
+class PtexIndices;
 
 class Stencil;
 class StencilTable;
@@ -92,6 +94,59 @@ public:
         Options options = Options());
 
 
+    /// \brief Instantiates one StencilTable per level of refinement, each
+    ///        expressed in terms of the vertices of the previous level.
+    ///
+    /// As an alternative to tables factorized down to the control vertices,
+    /// whose stencils grow rapidly with the depth of refinement, the stencils
+    /// of each level here only combine the few vertices of the previous level
+    /// given by the subdivision masks, so that the total number of weights
+    /// remains nearly linear in the number of refined vertices.
+    ///
+    /// The table for level i (stored at index i-1) has as many "control
+    /// vertices" as there are vertices in level i-1 and one stencil for each
+    /// vertex of level i, so that the tables must be applied in order. When
+    /// all levels are stored contiguously in a single buffer, each table reads
+    /// the vertices of the previous level and writes those of its own level
+    /// (see Osd::CpuEvaluator::EvalLevelStencils()).
+    ///
+    /// \note Only the interpolation mode, face-varying channel and maximum
+    ///       level of the options are relevant to these tables.
+    ///
+    /// @param refiner     The TopologyRefiner containing the topology
+    ///
+    /// @param levelTables Vector receiving the table of each level (ownership
+    ///                    is transferred to the client)
+    ///
+    /// @param options     Options controlling the creation of the tables
+    ///
+    static void CreateLevelStencilTables(TopologyRefiner const & refiner,
+        std::vector<StencilTable const *> & levelTables,
+        Options options = Options());
+
+    /// \brief Updates the per-level stencil tables of a refiner whose levels
+    ///        were partially regenerated (see TopologyRefiner::UpdateSparse())
+    ///
+    /// The tables of levels shallower than \c firstLevel are kept while those
+    /// of \c firstLevel and deeper are replaced by tables for the levels of the
+    /// refiner, as CreateLevelStencilTables() would create them.  Only the
+    /// stencils of vertices that were not carried forward by the update (see
+    /// TopologyRefiner::GetCarriedVertices()) are computed -- the others are
+    /// copied from the previous tables -- so the tables must be updated after
+    /// each update of the refiner.  Face-varying tables are always recomputed.
+    ///
+    /// @param refiner     The TopologyRefiner containing the topology
+    ///
+    /// @param levelTables Tables previously created by CreateLevelStencilTables()
+    ///
+    /// @param firstLevel  The first level whose table is to be regenerated
+    ///
+    /// @param options     Options controlling the creation of the tables
+    ///
+    static void UpdateLevelStencilTables(TopologyRefiner const & refiner,
+        std::vector<StencilTable const *> & levelTables, int firstLevel,
+        Options options = Options());
+
     /// \brief Instantiates StencilTable by concatenating an array of existing
     ///        stencil tables.
     ///
@@ -156,6 +211,12 @@ private:
     // Generate stencils for the coarse control-vertices (single weight = 1.0f)
     static void generateControlVertStencils(int numControlVerts, Stencil & dst);
 
+    // Create the per-level stencil tables from the given level on (copying the
+    // stencils of carried vertices from the previous tables of those levels)
+    static void createLevelStencilTables(TopologyRefiner const & refiner,
+        std::vector<StencilTable const *> & levelTables, int firstLevel,
+        Options options, std::vector<StencilTable const *> const & prevTables);
+
     // Internal method to splice local point stencils
     static StencilTable const * appendLocalPointStencilTable(
         TopologyRefiner const &refiner,
@@ -197,15 +258,25 @@ public:
     struct Options {
 
         Options() : generate1stDerivatives(true),
-                    generate2ndDerivatives(false) { }
+                    generate2ndDerivatives(false),
+                    factorizePatchPoints(true) { }
 
         unsigned int generate1stDerivatives      : 1, ///< Generate weights for 1st derivatives
-                     generate2ndDerivatives      : 1; ///< Generate weights for 2nd derivatives
+                     generate2ndDerivatives      : 1, ///< Generate weights for 2nd derivatives
+                     factorizePatchPoints        : 1; ///< accumulate stencil weights from control
+                                                      ///  vertices or leave them expressed in
+                                                      ///  terms of the patch points (see
+                                                      ///  CreatePatchPointStencilTable())
     };
 
     /// \brief Instantiates LimitStencilTable from a TopologyRefiner that has
     ///        been refined either uniformly or adaptively.
     ///
+    /// The limit surface of the Bilinear scheme is that of the base faces, so
+    /// unless a PatchTable is provided (or the patch points are not to be
+    /// factorized), its limit stencils are computed directly from the base
+    /// faces -- the refiner need not be refined and \c cvStencils is ignored.
+    ///
     /// @param refiner          The TopologyRefiner containing the topology
     ///
     /// @param locationArrays   An array of surface location descriptors
@@ -213,7 +284,8 @@ public:
     ///
     /// @param cvStencils       A set of StencilTable generated from the
     ///                         TopologyRefiner (optional: prevents redundant
-    ///                         instantiation of the table if available)
+    ///                         instantiation of the table if available --
+    ///                         an error without \c factorizePatchPoints)
     ///
     /// @param patchTable       A set of PatchTable generated from the
     ///                         TopologyRefiner (optional: prevents redundant
@@ -227,6 +299,98 @@ public:
               PatchTable const * patchTable=0,
                          Options options=Options());
 
+    /// \brief Instantiates the StencilTable computing the patch points from
+    ///        the control vertices.
+    ///
+    /// Limit stencils created without \c factorizePatchPoints only combine
+    /// the 16 to 20 points of the patch containing each location, i.e. the
+    /// control vertices, refined vertices and local points indexed by the
+    /// PatchTable. The patch points are computed first by applying this
+    /// table to the control vertices, then the limit stencils are applied
+    /// to the patch points -- both steps can be performed by the Osd
+    /// evaluators' EvalStencils(), as with any other stencil table.
+    ///
+    /// @param refiner          The TopologyRefiner containing the topology
+    ///
+    /// @param patchTable       The PatchTable used to create the limit
+    ///                         stencils (optional: if not provided, the
+    ///                         default PatchTable of the LimitStencilTable
+    ///                         factory is used)
+    ///
+    static StencilTable const * CreatePatchPointStencilTable(
+        TopologyRefiner const & refiner,
+          PatchTable const * patchTable=0);
+
+    /// \brief Client callback receiving each chunk of limit stencils
+    ///
+    /// @param chunk        The limit stencils of the chunk (ownership is
+    ///                     transferred to the client)
+    ///
+    /// @param firstStencil Index of the first stencil of the chunk in the
+    ///                     sequence of all stencils generated
+    ///
+    /// @param clientData   The client data passed to CreateChunked()
+    ///
+    typedef void (*ChunkCallback)(LimitStencilTable const * chunk,
+        int firstStencil, void * clientData);
+
+    /// \brief Generates limit stencils in a sequence of bounded-size
+    ///        LimitStencilTables.
+    ///
+    /// The locations are processed in order, at most \c chunkSize at a time,
+    /// and each chunk is handed to the callback as soon as it is complete.
+    /// Concatenating the chunks yields the same stencils as Create(), while
+    /// only one chunk needs to reside in memory at any time.
+    ///
+    /// @param refiner          The TopologyRefiner containing the topology
+    ///
+    /// @param locationArrays   An array of surface location descriptors
+    ///                         (see LocationArray)
+    ///
+    /// @param chunkSize        Maximum number of locations per chunk
+    ///
+    /// @param callback         Client function receiving each chunk
+    ///
+    /// @param clientData       Opaque pointer passed back to the callback
+    ///
+    /// @param cvStencils       A set of StencilTable generated from the
+    ///                         TopologyRefiner (optional -- an error without
+    ///                         \c factorizePatchPoints)
+    ///
+    /// @param patchTable       A set of PatchTable generated from the
+    ///                         TopologyRefiner (optional)
+    ///
+    /// @param options          Options controlling the creation of the table
+    ///
+    /// @return                 The total number of limit stencils generated,
+    ///                         or -1 if the inputs are inconsistent
+    ///
+    static int CreateChunked(TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays,
+                           int chunkSize,
+                 ChunkCallback callback,
+                        void * clientData,
+            StencilTable const * cvStencils=0,
+              PatchTable const * patchTable=0,
+                         Options options=Options());
+
+private:
+
+    // Generates the limit stencils for the locations [first, last) of the
+    // flattened sequence of location arrays -- sub-ranges are processed
+    // concurrently when threading is available.  Locations are found in the
+    // patch map or, without a patch table, evaluated directly on the base
+    // faces of a bilinear mesh identified by the ptex indices
+    static LimitStencilTable const * createLimitStencils(
+        TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays,
+        std::vector<int> const & arrayOffsets,
+        int first, int last,
+        StencilTable const * cvStencils,
+        PatchTable const * patchTable,
+        PatchMap const * patchMap,
+        PtexIndices const * ptexIndices,
+        Options options);
 };
 
 
@@ -0,0 +1,297 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/tileRefiner.h"
+#include "../far/topologyDescriptor.h"
+#include "../far/primvarRefiner.h"
+#include "../far/error.h"
+
+#include <cassert>
+#include <algorithm>
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    inline void
+    sortUnique(std::vector<Index> & indices) {
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    }
+
+    inline Index
+    findSorted(std::vector<Index> const & indices, Index index) {
+        return (Index)(std::lower_bound(indices.begin(), indices.end(), index) - indices.begin());
+    }
+
+    //
+    //  Topology of the tile of a base face, i.e. the face and its 1-ring, with
+    //  vertices and faces local to the tile.  The base face is always the first
+    //  face of the tile:
+    //
+    struct TileTopology {
+
+        std::vector<Index> faces;
+        std::vector<Index> vertices;
+
+        std::vector<int>   faceSizes;
+        std::vector<Index> faceVertices;
+
+        std::vector<Index> creaseVertexPairs;
+        std::vector<float> creaseWeights;
+
+        std::vector<Index> cornerVertices;
+        std::vector<float> cornerWeights;
+
+        std::vector<Index> holes;
+
+        void Initialize(TopologyLevel const & level, Index face);
+
+        void GetDescriptor(TopologyDescriptor & desc) const;
+    };
+
+    void
+    TileTopology::Initialize(TopologyLevel const & level, Index face) {
+
+        ConstIndexArray fVerts = level.GetFaceVertices(face);
+
+        //  Gather the 1-ring of faces (other than the face itself) and their vertices:
+        faces.clear();
+        for (int i = 0; i < fVerts.size(); ++i) {
+            ConstIndexArray vFaces = level.GetVertexFaces(fVerts[i]);
+            for (int j = 0; j < vFaces.size(); ++j) {
+                if (vFaces[j] != face) {
+                    faces.push_back(vFaces[j]);
+                }
+            }
+        }
+        sortUnique(faces);
+        faces.insert(faces.begin(), face);
+
+        vertices.clear();
+        std::vector<Index> edges;
+        for (int i = 0; i < (int)faces.size(); ++i) {
+            ConstIndexArray tVerts = level.GetFaceVertices(faces[i]);
+            ConstIndexArray tEdges = level.GetFaceEdges(faces[i]);
+
+            vertices.insert(vertices.end(), tVerts.begin(), tVerts.end());
+            edges.insert(edges.end(), tEdges.begin(), tEdges.end());
+        }
+        sortUnique(vertices);
+        sortUnique(edges);
+
+        //  Assign the faces with vertices local to the tile:
+        faceSizes.resize(faces.size());
+        faceVertices.clear();
+        holes.clear();
+        for (int i = 0; i < (int)faces.size(); ++i) {
+            ConstIndexArray tVerts = level.GetFaceVertices(faces[i]);
+
+            faceSizes[i] = tVerts.size();
+            for (int j = 0; j < tVerts.size(); ++j) {
+                faceVertices.push_back(findSorted(vertices, tVerts[j]));
+            }
+            if (level.IsFaceHole(faces[i])) {
+                holes.push_back(i);
+            }
+        }
+
+        //  Transfer the sharpness of all edges and vertices of the tile:
+        creaseVertexPairs.clear();
+        creaseWeights.clear();
+        for (int i = 0; i < (int)edges.size(); ++i) {
+            float sharpness = level.GetEdgeSharpness(edges[i]);
+            if (sharpness > 0.0f) {
+                ConstIndexArray eVerts = level.GetEdgeVertices(edges[i]);
+
+                creaseVertexPairs.push_back(findSorted(vertices, eVerts[0]));
+                creaseVertexPairs.push_back(findSorted(vertices, eVerts[1]));
+                creaseWeights.push_back(sharpness);
+            }
+        }
+        cornerVertices.clear();
+        cornerWeights.clear();
+        for (int i = 0; i < (int)vertices.size(); ++i) {
+            float sharpness = level.GetVertexSharpness(vertices[i]);
+            if (sharpness > 0.0f) {
+                cornerVertices.push_back(i);
+                cornerWeights.push_back(sharpness);
+            }
+        }
+    }
+
+    void
+    TileTopology::GetDescriptor(TopologyDescriptor & desc) const {
+
+        desc.numVertices        = (int)vertices.size();
+        desc.numFaces           = (int)faces.size();
+        desc.numVertsPerFace    = &faceSizes[0];
+        desc.vertIndicesPerFace = &faceVertices[0];
+
+        desc.numCreases             = (int)creaseWeights.size();
+        desc.creaseVertexIndexPairs = creaseWeights.empty() ? 0 : &creaseVertexPairs[0];
+        desc.creaseWeights          = creaseWeights.empty() ? 0 : &creaseWeights[0];
+
+        desc.numCorners          = (int)cornerWeights.size();
+        desc.cornerVertexIndices = cornerWeights.empty() ? 0 : &cornerVertices[0];
+        desc.cornerWeights       = cornerWeights.empty() ? 0 : &cornerWeights[0];
+
+        desc.numHoles    = (int)holes.size();
+        desc.holeIndices = holes.empty() ? 0 : &holes[0];
+    }
+}
+
+TileRefiner::TileRefiner(TopologyRefiner const & refiner, int level) :
+    _refiner(refiner), _level(level) {
+
+    if (_level < 1) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TileRefiner::TileRefiner() -- "
+            "level of refinement must be at least 1.");
+        _level = 1;
+    }
+}
+
+TileRefiner::~TileRefiner() {
+}
+
+void
+TileRefiner::RefineFace(Index face, float const * src, int length, int stride,
+        Tile & tile) const {
+
+    TopologyLevel const & baseLevel = _refiner.GetLevel(0);
+
+    tile.length   = length;
+    tile.faceSize = Sdc::SchemeTypeTraits::GetRegularFaceSize(_refiner.GetSchemeType());
+    tile.vertexValues.clear();
+    tile.faceVertices.clear();
+
+    if (baseLevel.IsFaceHole(face)) return;
+
+    //
+    //  Extract the tile and refine it uniformly:
+    //
+    TileTopology topology;
+    topology.Initialize(baseLevel, face);
+
+    TopologyDescriptor desc;
+    topology.GetDescriptor(desc);
+
+    typedef TopologyRefinerFactory<TopologyDescriptor> RefinerFactory;
+
+    TopologyRefiner * tileRefiner = RefinerFactory::Create(desc,
+        RefinerFactory::Options(_refiner.GetSchemeType(), _refiner.GetSchemeOptions()));
+    if (tileRefiner == 0) return;
+
+    tileRefiner->RefineUniform(TopologyRefiner::UniformOptions(_level));
+
+    //
+    //  Interpolate the vertex data of the tile through all levels:
+    //
+    std::vector<float> values(tileRefiner->GetNumVerticesTotal() * length);
+
+    for (int i = 0; i < (int)topology.vertices.size(); ++i) {
+        float const * srcValue = src + (size_t)topology.vertices[i] * stride;
+        std::copy(srcValue, srcValue + length, &values[i * length]);
+    }
+
+    PrimvarRefiner primvarRefiner(*tileRefiner);
+
+    float * levelValues = &values[0];
+    for (int level = 1; level <= _level; ++level) {
+        float * childValues = levelValues +
+            tileRefiner->GetLevel(level-1).GetNumVertices() * length;
+
+        primvarRefiner.Interpolate(level, levelValues, childValues, length, length);
+        levelValues = childValues;
+    }
+
+    //
+    //  Identify the refined faces descending from the base face (the first of the
+    //  tile) and emit them with the vertices they use:
+    //
+    std::vector<Index> faces(1, 0), childFaces;
+    for (int level = 0; level < _level; ++level) {
+        TopologyLevel const & parentLevel = tileRefiner->GetLevel(level);
+
+        childFaces.clear();
+        for (int i = 0; i < (int)faces.size(); ++i) {
+            ConstIndexArray cFaces = parentLevel.GetFaceChildFaces(faces[i]);
+            childFaces.insert(childFaces.end(), cFaces.begin(), cFaces.end());
+        }
+        std::swap(faces, childFaces);
+    }
+
+    TopologyLevel const & lastLevel = tileRefiner->GetLevel(_level);
+
+    std::vector<Index> tileVertexIndices(lastLevel.GetNumVertices(), INDEX_INVALID);
+    int numTileVertices = 0;
+
+    tile.faceVertices.reserve(faces.size() * tile.faceSize);
+    for (int i = 0; i < (int)faces.size(); ++i) {
+        ConstIndexArray fVerts = lastLevel.GetFaceVertices(faces[i]);
+        assert(fVerts.size() == tile.faceSize);
+
+        for (int j = 0; j < fVerts.size(); ++j) {
+            Index & tileVertex = tileVertexIndices[fVerts[j]];
+            if (!IndexIsValid(tileVertex)) {
+                tileVertex = numTileVertices++;
+
+                float const * value = levelValues + fVerts[j] * length;
+                tile.vertexValues.insert(tile.vertexValues.end(), value, value + length);
+            }
+            tile.faceVertices.push_back(tileVertex);
+        }
+    }
+
+    delete tileRefiner;
+}
+
+void
+TileRefiner::RefineFaces(float const * src, int length, int stride,
+        std::vector<Tile> & tiles) const {
+
+    int numFaces = _refiner.GetLevel(0).GetNumFaces();
+
+    tiles.resize(numFaces);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (int face = 0; face < numFaces; ++face) {
+        RefineFace(face, src, length, stride, tiles[face]);
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
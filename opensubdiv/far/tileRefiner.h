@@ -0,0 +1,131 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_TILE_REFINER_H
+#define OPENSUBDIV3_FAR_TILE_REFINER_H
+
+#include "../version.h"
+
+#include "../far/topologyRefiner.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Refines the faces of a mesh independently of each other.
+///
+/// Rather than refining the whole mesh, a TileRefiner refines each face of
+/// the base level of a TopologyRefiner in isolation:  the "tile" of a face --
+/// the face and all faces incident its vertices (its 1-ring) -- is extracted
+/// and uniformly refined, and only the refined vertices and faces descending
+/// from the face itself are retained.  These are identical to those of a
+/// global uniform refinement, as the tile includes the full support of the
+/// face at every level.
+///
+/// The memory required to refine a face is bounded by the size of its tile
+/// rather than the size of the mesh, and faces can be refined concurrently.
+/// This is suited to the export of tessellations or other uses where only
+/// the refined vertices of each face are of interest.
+///
+class TileRefiner {
+
+public:
+
+    ///
+    /// \brief The refined vertices and faces of a single base face
+    ///
+    struct Tile {
+
+        /// \brief Returns the number of refined vertices in the tile
+        int GetNumVertices() const { return (int)vertexValues.size() / length; }
+
+        /// \brief Returns the number of refined faces in the tile
+        int GetNumFaces() const { return (int)faceVertices.size() / faceSize; }
+
+        int                length;       ///< number of floats per vertex
+        int                faceSize;     ///< number of vertices per face
+
+        std::vector<float> vertexValues; ///< refined vertex data (length floats each)
+        std::vector<Index> faceVertices; ///< vertices of the refined faces (faceSize
+                                         ///< each), local to the tile
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param refiner  TopologyRefiner whose base level is to be refined (only
+    ///                 the base level is used and it need not be refined)
+    ///
+    /// @param level    Level of refinement applied to each face (at least 1)
+    ///
+    TileRefiner(TopologyRefiner const & refiner, int level);
+
+    /// \brief Destructor
+    ~TileRefiner();
+
+    /// \brief Returns the level of refinement applied to each face
+    int GetLevel() const { return _level; }
+
+    /// \brief Refines a single base face and the vertex data of its tile
+    ///
+    /// This method is thread-safe:  distinct faces can be refined concurrently.
+    ///
+    /// @param face    Index of the face in the base level
+    ///
+    /// @param src     Vertex data of the base level (see PrimvarRefiner for the
+    ///                layout of float buffers)
+    ///
+    /// @param length  Number of floats of each vertex
+    ///
+    /// @param stride  Number of floats between successive vertices in \c src
+    ///
+    /// @param tile    Tile receiving the refined vertices and faces (empty if the
+    ///                face is a hole)
+    ///
+    void RefineFace(Index face, float const * src, int length, int stride,
+        Tile & tile) const;
+
+    /// \brief Refines all base faces (in parallel if enabled) -- the tile of
+    ///        each face is returned at the index of the face.
+    void RefineFaces(float const * src, int length, int stride,
+        std::vector<Tile> & tiles) const;
+
+private:
+
+    TopologyRefiner const & _refiner;
+
+    int _level;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TILE_REFINER_H */
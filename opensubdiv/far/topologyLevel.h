@@ -29,6 +29,7 @@
 #include "../vtr/level.h"
 #include "../vtr/refinement.h"
 #include "../far/types.h"
+#include "../far/error.h"
 
 #include <vector>
 
@@ -111,10 +112,16 @@ public:
     ConstLocalIndexArray GetVertexFaceLocalIndices(Index v) const { return _level->getVertexFaceLocalIndices(v); }
 
     /// \brief Access the local indices of a vertex with respect to its incident edges
-    ConstLocalIndexArray GetVertexEdgeLocalIndices(Index v) const { return _level->getVertexEdgeLocalIndices(v); }
+    ///
+    /// An error is reported and an empty array returned if the local indices
+    /// were released by the stencilTopologyOnly refinement option.
+    ConstLocalIndexArray GetVertexEdgeLocalIndices(Index v) const;
 
     /// \brief Access the local indices of an edge with respect to its incident faces
-    ConstLocalIndexArray GetEdgeFaceLocalIndices(Index e) const   { return _level->getEdgeFaceLocalIndices(e); }
+    ///
+    /// An error is reported and an empty array returned if the local indices
+    /// were released by the stencilTopologyOnly refinement option.
+    ConstLocalIndexArray GetEdgeFaceLocalIndices(Index e) const;
 
     /// \brief Identify the edge matching the given vertex pair
     Index FindEdge(Index v0, Index v1) const { return _level->findEdge(v0, v1); }
@@ -225,10 +232,16 @@ public:
     ConstIndexArray GetFaceChildFaces(Index f) const { return _refToChild->getFaceChildFaces(f); }
 
     /// \brief Access the child edges (in the next level) of a given face
-    ConstIndexArray GetFaceChildEdges(Index f) const { return _refToChild->getFaceChildEdges(f); }
+    ///
+    /// An error is reported and an empty array returned if the child edges
+    /// were released by the stencilTopologyOnly refinement option.
+    ConstIndexArray GetFaceChildEdges(Index f) const;
 
     /// \brief Access the child edges (in the next level) of a given edge
-    ConstIndexArray GetEdgeChildEdges(Index e) const { return _refToChild->getEdgeChildEdges(e); }
+    ///
+    /// An error is reported and an empty array returned if the child edges
+    /// were released by the stencilTopologyOnly refinement option.
+    ConstIndexArray GetEdgeChildEdges(Index e) const;
 
     /// \brief Return the child vertex (in the next level) of a given face
     Index GetFaceChildVertex(  Index f) const { return _refToChild->getFaceChildVertex(f); }
@@ -264,6 +277,46 @@ public:
     ~TopologyLevel() { }
 };
 
+inline ConstLocalIndexArray
+TopologyLevel::GetVertexEdgeLocalIndices(Index v) const {
+    if (!_level->hasRefinementLocalIndices()) {
+        Error(FAR_CODING_ERROR, "Failure in TopologyLevel::GetVertexEdgeLocalIndices() -- "
+            "local indices were released by stencilTopologyOnly refinement.");
+        return ConstLocalIndexArray();
+    }
+    return _level->getVertexEdgeLocalIndices(v);
+}
+
+inline ConstLocalIndexArray
+TopologyLevel::GetEdgeFaceLocalIndices(Index e) const {
+    if (!_level->hasRefinementLocalIndices()) {
+        Error(FAR_CODING_ERROR, "Failure in TopologyLevel::GetEdgeFaceLocalIndices() -- "
+            "local indices were released by stencilTopologyOnly refinement.");
+        return ConstLocalIndexArray();
+    }
+    return _level->getEdgeFaceLocalIndices(e);
+}
+
+inline ConstIndexArray
+TopologyLevel::GetFaceChildEdges(Index f) const {
+    if (!_refToChild->hasChildEdgeMappings()) {
+        Error(FAR_CODING_ERROR, "Failure in TopologyLevel::GetFaceChildEdges() -- "
+            "child edges were released by stencilTopologyOnly refinement.");
+        return ConstIndexArray();
+    }
+    return _refToChild->getFaceChildEdges(f);
+}
+
+inline ConstIndexArray
+TopologyLevel::GetEdgeChildEdges(Index e) const {
+    if (!_refToChild->hasChildEdgeMappings()) {
+        Error(FAR_CODING_ERROR, "Failure in TopologyLevel::GetEdgeChildEdges() -- "
+            "child edges were released by stencilTopologyOnly refinement.");
+        return ConstIndexArray();
+    }
+    return _refToChild->getEdgeChildEdges(e);
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
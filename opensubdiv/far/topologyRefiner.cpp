@@ -23,6 +23,7 @@
 //
 #include "../far/topologyRefiner.h"
 #include "../far/error.h"
+#include "../far/primvarRefiner.h"
 #include "../vtr/fvarLevel.h"
 #include "../vtr/sparseSelector.h"
 #include "../vtr/quadRefinement.h"
@@ -30,6 +31,7 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cmath>
 
 
 namespace OpenSubdiv {
@@ -53,7 +55,9 @@ TopologyRefiner::TopologyRefiner(Sdc::SchemeType schemeType, Sdc::Options scheme
     _totalEdges(0),
     _totalFaces(0),
     _totalFaceVertices(0),
-    _maxValence(0) {
+    _maxValence(0),
+    _numPrevLevels(0),
+    _firstCarriedLevel(0) {
 
     //  Need to revisit allocation scheme here -- want to use smart-ptrs for these
     //  but will probably have to settle for explicit new/delete...
@@ -89,6 +93,10 @@ TopologyRefiner::Unrefine() {
     }
     _refinements.clear();
 
+    _numPrevLevels = 0;
+    _firstCarriedLevel = 0;
+    _carriedLevels.clear();
+
     assembleFarLevels();
 }
 
@@ -184,6 +192,36 @@ TopologyRefiner::GetNumFVarValuesTotal(int channel) const {
 }
 
 
+size_t
+TopologyRefiner::GetByteSize() const {
+
+    size_t byteSize = 0;
+    for (int i = 0; i < (int)_levels.size(); ++i) {
+        byteSize += _levels[i]->getByteSize();
+    }
+    for (int i = 0; i < (int)_refinements.size(); ++i) {
+        byteSize += _refinements[i]->getByteSize();
+    }
+    return byteSize;
+}
+
+namespace {
+    //
+    //  Release the topology of a parent level and its refinement that is no longer
+    //  needed once the child level has been refined -- the local indices of the
+    //  parent are still required by any face-varying channels, and those of the
+    //  base level are kept so that it can be refined again:
+    //
+    void
+    releaseRefinedTopology(Vtr::internal::Level & parent, Vtr::internal::Refinement & refinement) {
+
+        if ((parent.getDepth() > 0) && (parent.getNumFVarChannels() == 0)) {
+            parent.releaseRefinementLocalIndices();
+        }
+        refinement.releaseChildEdgeMappings();
+    }
+}
+
 //
 //  Main refinement method -- allocating and initializing levels and refinements:
 //
@@ -215,8 +253,9 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
     //  Initialize refinement options for Vtr -- adjusting full-topology for the last level:
     //
     Vtr::internal::Refinement::Options refineOptions;
-    refineOptions._sparse         = false;
-    refineOptions._faceVertsFirst = options.orderVerticesFromFacesFirst;
+    refineOptions._sparse            = false;
+    refineOptions._faceVertsFirst    = options.orderVerticesFromFacesFirst;
+    refineOptions._vertsByParentFace = options.orderVerticesByParentFace;
 
     for (int i = 1; i <= (int)options.refinementLevel; ++i) {
         refineOptions._minimalTopology =
@@ -233,6 +272,10 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
         }
         refinement->refine(refineOptions);
 
+        if (options.stencilTopologyOnly) {
+            releaseRefinedTopology(parentLevel, *refinement);
+        }
+
         appendLevel(childLevel);
         appendRefinement(*refinement);
     }
@@ -347,6 +390,225 @@ namespace internal {
 void
 TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
 
+    refineAdaptive(options, 0, 0.0f, 0, 0);
+}
+
+void
+TopologyRefiner::RefineAdaptive(AdaptiveOptions options,
+                                float const * vertexPositions, float tolerance) {
+
+    refineAdaptive(options, vertexPositions, tolerance, 0, 0);
+}
+
+void
+TopologyRefiner::RefineAdaptive(AdaptiveOptions options, AdaptiveBudget const & budget,
+                                AdaptiveIsolation * isolation) {
+
+    refineAdaptive(options, budget.vertexPositions, -1.0f, &budget, isolation);
+}
+
+//
+//  Local utility functions for refinement within a budget -- faces selected for their
+//  features are ranked by priority, though those that could not otherwise be represented
+//  by patches are required and always precede the others:
+//
+namespace {
+    Vtr::internal::Refinement *
+    createRefinement(Sdc::Split splitType, Vtr::internal::Level & parent,
+                     Vtr::internal::Level & child, Sdc::Options const & options) {
+
+        if (splitType == Sdc::SPLIT_TO_QUADS) {
+            return new Vtr::internal::QuadRefinement(parent, child, options);
+        } else {
+            return new Vtr::internal::TriRefinement(parent, child, options);
+        }
+    }
+
+    bool
+    isFaceRefinementRequired(Vtr::internal::Level const & level, Index face, int regularFaceSize) {
+
+        if (!(level.getFaceCompositeVTag(face)._rule & Sdc::Crease::RULE_SMOOTH)) {
+            return true;
+        }
+        if (level.getDepth() == 0) {
+            ConstIndexArray fVerts = level.getFaceVertices(face);
+            for (int i = 0; i < fVerts.size(); ++i) {
+                ConstIndexArray vFaces = level.getVertexFaces(fVerts[i]);
+                for (int j = 0; j < vFaces.size(); ++j) {
+                    if (level.getNumFaceVertices(vFaces[j]) != regularFaceSize) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    //
+    //  The number of patches added by refining a face -- its child faces replace it:
+    //
+    inline int
+    getFacePatchCost(Vtr::internal::Level const & level, Index face, Sdc::Split splitType) {
+
+        int numChildFaces = (splitType == Sdc::SPLIT_TO_QUADS) ? level.getNumFaceVertices(face) : 4;
+        return numChildFaces - 1;
+    }
+
+    float
+    getFacePriority(Vtr::internal::Level const & level, Index face,
+                    TopologyRefiner::AdaptiveBudget::Priority priority,
+                    float const * positions) {
+
+        typedef TopologyRefiner::AdaptiveBudget Budget;
+
+        ConstIndexArray fVerts = level.getFaceVertices(face);
+        ConstIndexArray fEdges = level.getFaceEdges(face);
+
+        float value = 0.0f;
+        for (int i = 0; i < fVerts.size(); ++i) {
+            if (priority == Budget::PRIORITY_SHARPNESS) {
+                value = std::max(value, level.getVertexSharpness(fVerts[i]));
+                value = std::max(value, level.getEdgeSharpness(fEdges[i]));
+            } else if (priority == Budget::PRIORITY_VALENCE) {
+                if (level.getVertexTag(fVerts[i])._xordinary) {
+                    value = std::max(value, (float) level.getVertexEdges(fVerts[i]).size());
+                }
+            } else if ((priority == Budget::PRIORITY_SIZE) && positions) {
+                float const * p0 = positions + 3 * fVerts[i];
+                float const * p1 = positions + 3 * fVerts[(i + 1) % fVerts.size()];
+
+                float d[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                value = std::max(value, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            }
+        }
+        return value;
+    }
+
+    struct FacePriorityCompare {
+        FacePriorityCompare(std::vector<float> const & priorities, int numPriorities) :
+            _priorities(priorities), _numPriorities(numPriorities) { }
+
+        bool operator()(int a, int b) const {
+            float const * pa = &_priorities[a * _numPriorities];
+            float const * pb = &_priorities[b * _numPriorities];
+            for (int i = 0; i < _numPriorities; ++i) {
+                if (pa[i] != pb[i]) return pa[i] > pb[i];
+            }
+            return false;
+        }
+
+        std::vector<float> const & _priorities;
+        int                        _numPriorities;
+    };
+
+    //
+    //  Orders the faces selected by a refinement with the required faces first and the
+    //  others by decreasing priority, returning the number of required faces:
+    //
+    int
+    rankSelectedFaces(Vtr::internal::Refinement const & refinement,
+                      TopologyRefiner::AdaptiveBudget const & budget,
+                      float const * positions, std::vector<Index> & rankedFaces) {
+
+        Vtr::internal::Level const & level = refinement.parent();
+
+        std::vector<Index> requiredFaces, otherFaces;
+        for (Index face = 0; face < level.getNumFaces(); ++face) {
+            if (refinement.getParentFaceSparseTag(face)._selected) {
+                if (isFaceRefinementRequired(level, face, refinement.getRegularFaceSize())) {
+                    requiredFaces.push_back(face);
+                } else {
+                    otherFaces.push_back(face);
+                }
+            }
+        }
+
+        int numPriorities = 3;
+        std::vector<float> priorities(otherFaces.size() * numPriorities);
+        std::vector<int>   order(otherFaces.size());
+        for (int i = 0; i < (int)otherFaces.size(); ++i) {
+            for (int j = 0; j < numPriorities; ++j) {
+                priorities[i * numPriorities + j] =
+                    getFacePriority(level, otherFaces[i], budget.priorities[j], positions);
+            }
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), FacePriorityCompare(priorities, numPriorities));
+
+        rankedFaces = requiredFaces;
+        for (int i = 0; i < (int)order.size(); ++i) {
+            rankedFaces.push_back(otherFaces[order[i]]);
+        }
+        return (int)requiredFaces.size();
+    }
+
+    //
+    //  Updates the isolation of the base components from a refinement, i.e. the level
+    //  reached by those whose descendants were selected, and maps the descendants in
+    //  the child level to the base components for the next refinement:
+    //
+    void
+    updateIsolation(Vtr::internal::Refinement const & refinement,
+                    TopologyRefiner::AdaptiveIsolation & isolation,
+                    std::vector<Index> & faceBaseFaces,
+                    std::vector<Index> & vertBaseVerts,
+                    std::vector<Index> & edgeBaseEdges) {
+
+        Vtr::internal::Level const & parent = refinement.parent();
+        Vtr::internal::Level const & child  = refinement.child();
+
+        int level = child.getDepth();
+
+        std::vector<Index> childBaseFaces(child.getNumFaces());
+        for (Index face = 0; face < parent.getNumFaces(); ++face) {
+            if (refinement.getParentFaceSparseTag(face)._selected) {
+                isolation.faceLevels[faceBaseFaces[face]] = level;
+            }
+        }
+        for (Index face = 0; face < child.getNumFaces(); ++face) {
+            childBaseFaces[face] = faceBaseFaces[refinement.getChildFaceParentFace(face)];
+        }
+
+        std::vector<Index> childBaseVerts(child.getNumVertices(), INDEX_INVALID);
+        for (Index vert = 0; vert < parent.getNumVertices(); ++vert) {
+            Index baseVert = vertBaseVerts[vert];
+            if (IndexIsValid(baseVert)) {
+                if (refinement.getParentVertexSparseTag(vert)._selected) {
+                    isolation.vertexLevels[baseVert] = level;
+                }
+                Index childVert = refinement.getVertexChildVertex(vert);
+                if (IndexIsValid(childVert)) {
+                    childBaseVerts[childVert] = baseVert;
+                }
+            }
+        }
+
+        std::vector<Index> childBaseEdges(child.getNumEdges(), INDEX_INVALID);
+        for (Index edge = 0; edge < parent.getNumEdges(); ++edge) {
+            Index baseEdge = edgeBaseEdges[edge];
+            if (IndexIsValid(baseEdge)) {
+                if (refinement.getParentEdgeSparseTag(edge)._selected) {
+                    isolation.edgeLevels[baseEdge] = level;
+                }
+                ConstIndexArray childEdges = refinement.getEdgeChildEdges(edge);
+                for (int i = 0; i < childEdges.size(); ++i) {
+                    if (IndexIsValid(childEdges[i])) {
+                        childBaseEdges[childEdges[i]] = baseEdge;
+                    }
+                }
+            }
+        }
+
+        std::swap(faceBaseFaces, childBaseFaces);
+        std::swap(vertBaseVerts, childBaseVerts);
+        std::swap(edgeBaseEdges, childBaseEdges);
+    }
+}
+
+void
+TopologyRefiner::refineAdaptive(AdaptiveOptions options,
+                                float const * vertexPositions, float tolerance,
+                                AdaptiveBudget const * budget, AdaptiveIsolation * isolation) {
     if (_levels[0]->getNumVertices() == 0) {
         Error(FAR_RUNTIME_ERROR,
             "Failure in TopologyRefiner::RefineAdaptive() -- base level is uninitialized.");
@@ -357,9 +619,9 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             "Failure in TopologyRefiner::RefineAdaptive() -- previous refinements already applied.");
         return;
     }
-    if (_subdivType != Sdc::SCHEME_CATMARK) {
+    if (_subdivType == Sdc::SCHEME_BILINEAR) {
         Error(FAR_RUNTIME_ERROR,
-            "Failure in TopologyRefiner::RefineAdaptive() -- currently only supported for Catmark scheme.");
+            "Failure in TopologyRefiner::RefineAdaptive() -- not supported for Bilinear scheme.");
         return;
     }
 
@@ -406,13 +668,388 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     //
     Vtr::internal::Refinement::Options refineOptions;
 
+    refineOptions._sparse            = true;
+    refineOptions._minimalTopology   = false;
+    refineOptions._faceVertsFirst    = options.orderVerticesFromFacesFirst;
+    refineOptions._vertsByParentFace = options.orderVerticesByParentFace;
+
+    Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
+
+    //
+    //  If a geometric tolerance is to be applied, positions are interpolated to each
+    //  new level to inspect the faces selected in it:
+    //
+    std::vector<float> levelPositions;
+    if (vertexPositions) {
+        levelPositions.assign(vertexPositions, vertexPositions + 3 * _levels[0]->getNumVertices());
+    }
+    PrimvarRefiner primvarRefiner(*this);
+
+    //
+    //  When refining within a budget, patches are accounted for as the faces left
+    //  unrefined -- each refined face replacing itself with its child faces -- and
+    //  the base face, vertex and edge from which each component of the current level
+    //  originates is kept to report the isolation achieved:
+    //
+    int  numPatches = 0;
+    bool isBudgetExhausted = false;
+    if (budget) {
+        for (Index face = 0; face < _levels[0]->getNumFaces(); ++face) {
+            if (!_levels[0]->isFaceHole(face)) {
+                ++numPatches;
+            }
+        }
+    }
+
+    std::vector<Index> faceBaseFaces, vertBaseVerts, edgeBaseEdges;
+    if (isolation) {
+        isolation->faceLevels.assign(_levels[0]->getNumFaces(), 0);
+        isolation->vertexLevels.assign(_levels[0]->getNumVertices(), 0);
+        isolation->edgeLevels.assign(_levels[0]->getNumEdges(), 0);
+
+        faceBaseFaces.resize(_levels[0]->getNumFaces());
+        for (Index face = 0; face < (Index)faceBaseFaces.size(); ++face) {
+            faceBaseFaces[face] = face;
+        }
+        vertBaseVerts.resize(_levels[0]->getNumVertices());
+        for (Index vert = 0; vert < (Index)vertBaseVerts.size(); ++vert) {
+            vertBaseVerts[vert] = vert;
+        }
+        edgeBaseEdges.resize(_levels[0]->getNumEdges());
+        for (Index edge = 0; edge < (Index)edgeBaseEdges.size(); ++edge) {
+            edgeBaseEdges[edge] = edge;
+        }
+    }
+    std::vector<Index> rankedFaces;
+
+    for (int i = 1; i <= potentialMaxLevel; ++i) {
+
+        Vtr::internal::Level& parentLevel     = getLevel(i-1);
+        Vtr::internal::Level* childLevel      = new Vtr::internal::Level;
+
+        Vtr::internal::Refinement* refinement = createRefinement(splitType, parentLevel, *childLevel, _subdivOptions);
+
+        //
+        //  Initialize a Selector to mark a sparse set of components for refinement -- choose
+        //  the feature selection mask appropriate to the level:
+        //
+        bool isSelectionEmpty = true;
+        bool isRefined        = false;
+        {
+            Vtr::internal::SparseSelector selector(*refinement);
+
+            selectFeatureAdaptiveComponents(selector, (i <= shallowLevel) ? moreFeaturesMask : lessFeaturesMask,
+                                            (vertexPositions && (tolerance >= 0.0f)) ? &levelPositions[0] : 0,
+                                            tolerance);
+            isSelectionEmpty = selector.isSelectionEmpty();
+        }
+
+        if (budget && !isSelectionEmpty) {
+            //
+            //  Rank the selected faces and reselect the required faces and as many of
+            //  the others as the budget allows -- if memory is exceeded on refinement,
+            //  reduce the faces proportionally and refine again:
+            //
+            int numRequired = rankSelectedFaces(*refinement, *budget,
+                                                vertexPositions ? &levelPositions[0] : 0, rankedFaces);
+            int numFaces = numRequired;
+            if (!isBudgetExhausted) {
+                int numPatchesSelected = numPatches;
+                for (int j = 0; j < numRequired; ++j) {
+                    numPatchesSelected += getFacePatchCost(parentLevel, rankedFaces[j], splitType);
+                }
+                while (numFaces < (int)rankedFaces.size()) {
+                    int faceCost = getFacePatchCost(parentLevel, rankedFaces[numFaces], splitType);
+                    if (budget->maxPatches && (numPatchesSelected + faceCost > budget->maxPatches)) break;
+
+                    numPatchesSelected += faceCost;
+                    ++numFaces;
+                }
+            }
+
+            size_t bytesOfLevels = GetByteSize();
+            for (;;) {
+                delete refinement;
+                delete childLevel;
+                childLevel = new Vtr::internal::Level;
+                refinement = createRefinement(splitType, parentLevel, *childLevel, _subdivOptions);
+
+                Vtr::internal::SparseSelector selector(*refinement);
+                for (int j = 0; j < numFaces; ++j) {
+                    selector.selectFace(rankedFaces[j]);
+                }
+                isSelectionEmpty = selector.isSelectionEmpty();
+                if (isSelectionEmpty || !budget->maxBytes) break;
+
+                refinement->refine(refineOptions);
+                isRefined = true;
+
+                size_t bytesOfLevel = childLevel->getByteSize() + refinement->getByteSize();
+                if ((numFaces == numRequired) || (bytesOfLevels + bytesOfLevel <= budget->maxBytes)) break;
+
+                size_t bytesAvailable = (budget->maxBytes > bytesOfLevels) ? (budget->maxBytes - bytesOfLevels) : 0;
+                int numReduced = numRequired + (int)((double)(numFaces - numRequired) *
+                                                     (double)bytesAvailable / (double)bytesOfLevel * 0.9);
+                numFaces = std::min(numReduced, numFaces - 1);
+                isRefined = false;
+            }
+            isBudgetExhausted |= (numFaces < (int)rankedFaces.size());
+
+            for (int j = 0; j < numFaces; ++j) {
+                numPatches += getFacePatchCost(parentLevel, rankedFaces[j], splitType);
+            }
+        }
+
+        if (isSelectionEmpty) {
+            delete refinement;
+            delete childLevel;
+            break;
+        } else {
+            if (!isRefined) {
+                refinement->refine(refineOptions);
+            }
+            if (isolation) {
+                updateIsolation(*refinement, *isolation, faceBaseFaces, vertBaseVerts, edgeBaseEdges);
+            }
+            if (options.stencilTopologyOnly) {
+                releaseRefinedTopology(parentLevel, *refinement);
+            }
+
+            appendLevel(*childLevel);
+            appendRefinement(*refinement);
+
+            if (vertexPositions && (i < potentialMaxLevel)) {
+                std::vector<float> childPositions(3 * childLevel->getNumVertices());
+                primvarRefiner.Interpolate(i, &levelPositions[0], &childPositions[0], 3, 3);
+                std::swap(levelPositions, childPositions);
+            }
+        }
+    }
+    _maxLevel = (unsigned int) _refinements.size();
+
+    if (options.stencilTopologyOnly && _maxLevel && (_levels.back()->getNumFVarChannels() == 0)) {
+        _levels.back()->releaseRefinementLocalIndices();
+    }
+    assembleFarLevels();
+}
+
+//
+//  Sparse refinement of faces to individual levels -- the target level of each
+//  face is inherited from its parent face and faces are selected while short of
+//  their target level.  Faces that could not otherwise be represented by patches
+//  (faces without a smooth corner, and those sharing a vertex with an irregular
+//  face of the base level) are also selected, as adaptive refinement would, but
+//  only when within or adjacent to the refined region -- those elsewhere remain
+//  end caps at their current level.  Irregular faces of the base level (and those
+//  of the above around non-manifold features) cannot be represented by patches
+//  at all and so are always refined once:
+//
+namespace {
+    inline bool
+    isSparseFaceNearSelection(Vtr::internal::Level const & level, Index face,
+                              std::vector<int> const & faceLevels) {
+
+        ConstIndexArray fVerts = level.getFaceVertices(face);
+        for (int i = 0; i < fVerts.size(); ++i) {
+            ConstIndexArray vFaces = level.getVertexFaces(fVerts[i]);
+            for (int j = 0; j < vFaces.size(); ++j) {
+                if (faceLevels[vFaces[j]] > level.getDepth()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    inline bool
+    isSparseFaceSelected(Vtr::internal::Level const & level,
+                         Vtr::internal::Refinement const * refinementToLevel,
+                         Index face, std::vector<int> const & faceLevels,
+                         int regularFaceSize) {
+
+        //  Incomplete faces (including children of faces that were not selected)
+        //  only exist to support their neighbors:
+        if (level.isFaceHole(face) || level.getFaceCompositeVTag(face)._incomplete) {
+            return false;
+        }
+        if (refinementToLevel && refinementToLevel->getChildFaceTag(face)._incomplete) {
+            return false;
+        }
+        if (faceLevels[face] > level.getDepth()) {
+            return true;
+        }
+        if (!isFaceRefinementRequired(level, face, regularFaceSize)) {
+            return false;
+        }
+        if ((level.getDepth() == 0) && ((level.getNumFaceVertices(face) != regularFaceSize) ||
+                                        level.getFaceCompositeVTag(face)._nonManifold)) {
+            return true;
+        }
+        return isSparseFaceNearSelection(level, face, faceLevels);
+    }
+
+    inline void
+    inheritSparseFaceLevels(Vtr::internal::Refinement const & refinement,
+                            std::vector<int> & faceLevels) {
+
+        std::vector<int> childFaceLevels(refinement.child().getNumFaces());
+        for (Index face = 0; face < (Index)childFaceLevels.size(); ++face) {
+            childFaceLevels[face] = faceLevels[refinement.getChildFaceParentFace(face)];
+        }
+        std::swap(faceLevels, childFaceLevels);
+    }
+}
+
+void
+TopologyRefiner::RefineSparse(SparseOptions options, int const baseFaceLevels[]) {
+
+    if (_levels[0]->getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::RefineSparse() -- base level is uninitialized.");
+        return;
+    }
+    if (_refinements.size()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::RefineSparse() -- previous refinements already applied.");
+        return;
+    }
+
+    std::vector<int> faceLevels(baseFaceLevels, baseFaceLevels + _levels[0]->getNumFaces());
+
+    refineSparseLevels(options, faceLevels);
+}
+
+void
+TopologyRefiner::RefineSparse(SparseOptions options, ConstIndexArray baseFaces) {
+
+    std::vector<int> baseFaceLevels(_levels[0]->getNumFaces(), 0);
+    for (int i = 0; i < baseFaces.size(); ++i) {
+        if ((baseFaces[i] < 0) || (baseFaces[i] >= (Index)baseFaceLevels.size())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::RefineSparse() -- face index %d out of range.",
+                baseFaces[i]);
+            return;
+        }
+        baseFaceLevels[baseFaces[i]] = options.refinementLevel;
+    }
+    RefineSparse(options, baseFaceLevels.empty() ? 0 : &baseFaceLevels[0]);
+}
+
+int
+TopologyRefiner::UpdateSparse(SparseOptions options, int const baseFaceLevels[]) {
+
+    if (_levels[0]->getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateSparse() -- base level is uninitialized.");
+        return 0;
+    }
+    if (_isUniform && _refinements.size()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateSparse() -- uniform refinement cannot be updated.");
+        return 0;
+    }
+
+    std::vector<int> faceLevels(baseFaceLevels, baseFaceLevels + _levels[0]->getNumFaces());
+
+    //
+    //  Retain the levels whose refinement selected the same faces as the new levels
+    //  would -- vertex ordering must also be preserved for them to be reused, and
+    //  levels whose topology was released for stencils cannot be refined further:
+    //
+    int numLevelsKept = 1;
+    if (!_adaptiveOptions.stencilTopologyOnly && !_adaptiveOptions.orderVerticesByParentFace &&
+        (options.orderVerticesFromFacesFirst == _adaptiveOptions.orderVerticesFromFacesFirst)) {
+        for ( ; numLevelsKept <= (int)_refinements.size(); ++numLevelsKept) {
+            if (numLevelsKept > (int)options.refinementLevel) break;
+
+            Vtr::internal::Level const &      parentLevel = getLevel(numLevelsKept - 1);
+            Vtr::internal::Refinement const & refinement  = getRefinement(numLevelsKept - 1);
+
+            Vtr::internal::Refinement const * refinementToParent =
+                (numLevelsKept > 1) ? &getRefinement(numLevelsKept - 2) : 0;
+
+            bool isSelectionUnchanged = true;
+            for (Index face = 0; isSelectionUnchanged && (face < parentLevel.getNumFaces()); ++face) {
+                isSelectionUnchanged =
+                    (isSparseFaceSelected(parentLevel, refinementToParent, face,
+                                          faceLevels, refinement.getRegularFaceSize()) ==
+                     (bool) refinement.getParentFaceSparseTag(face)._selected);
+            }
+            if (!isSelectionUnchanged) break;
+
+            inheritSparseFaceLevels(refinement, faceLevels);
+        }
+    }
+
+    //
+    //  Refine the remaining levels anew -- the previous ones are retained until the
+    //  refinement of the regions that remain selected has been carried forward from
+    //  them (which requires their full topology):
+    //
+    bool carryForward = !_adaptiveOptions.stencilTopologyOnly;
+
+    std::vector<Vtr::internal::Level*> levelsKept(_levels.begin() + 1, _levels.begin() + numLevelsKept);
+
+    std::vector<Vtr::internal::Level*>      prevLevels(_levels.begin() + numLevelsKept, _levels.end());
+    std::vector<Vtr::internal::Refinement*> prevRefinements(_refinements.begin() + numLevelsKept - 1,
+                                                            _refinements.end());
+    _refinements.resize(numLevelsKept - 1);
+
+    _levels.resize(1);
+    initializeInventory();
+    for (int i = 0; i < (int)levelsKept.size(); ++i) {
+        appendLevel(*levelsKept[i]);
+    }
+
+    refineSparseLevels(options, faceLevels);
+
+    if (carryForward) {
+        carryForwardSparseLevels(numLevelsKept, prevLevels, prevRefinements);
+    } else {
+        _numPrevLevels = 0;
+        _firstCarriedLevel = 0;
+        _carriedLevels.clear();
+    }
+
+    for (int i = 0; i < (int)prevLevels.size(); ++i) {
+        delete prevLevels[i];
+        delete prevRefinements[i];
+    }
+    return numLevelsKept;
+}
+
+ConstIndexArray
+TopologyRefiner::GetCarriedVertices(int level) const {
+
+    int carriedIndex = level - _firstCarriedLevel;
+    if ((carriedIndex < 0) || (carriedIndex >= (int)_carriedLevels.size())) {
+        return ConstIndexArray(0, 0);
+    }
+    std::vector<Index> const & carriedVertices = _carriedLevels[carriedIndex].carriedVertices;
+    return carriedVertices.empty() ? ConstIndexArray(0, 0) :
+                                     ConstIndexArray(&carriedVertices[0], (int)carriedVertices.size());
+}
+
+void
+TopologyRefiner::refineSparseLevels(SparseOptions options, std::vector<int> & faceLevels) {
+
+    //
+    //  The resulting hierarchy is used as if adaptively refined, so initialize the
+    //  adaptive options to reflect the refinement applied:
+    //
+    _isUniform = false;
+    _adaptiveOptions = AdaptiveOptions(options.refinementLevel);
+    _adaptiveOptions.orderVerticesFromFacesFirst = options.orderVerticesFromFacesFirst;
+
+    Vtr::internal::Refinement::Options refineOptions;
+
     refineOptions._sparse          = true;
     refineOptions._minimalTopology = false;
     refineOptions._faceVertsFirst  = options.orderVerticesFromFacesFirst;
 
     Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
 
-    for (int i = 1; i <= potentialMaxLevel; ++i) {
+    for (int i = (int)_levels.size(); i <= (int)options.refinementLevel; ++i) {
 
         Vtr::internal::Level& parentLevel     = getLevel(i-1);
         Vtr::internal::Level& childLevel      = *(new Vtr::internal::Level);
@@ -424,13 +1061,18 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             refinement = new Vtr::internal::TriRefinement(parentLevel, childLevel, _subdivOptions);
         }
 
-        //
-        //  Initialize a Selector to mark a sparse set of components for refinement -- choose
-        //  the feature selection mask appropriate to the level:
-        //
         Vtr::internal::SparseSelector selector(*refinement);
 
-        selectFeatureAdaptiveComponents(selector, (i <= shallowLevel) ? moreFeaturesMask : lessFeaturesMask);
+        Vtr::internal::Refinement const * refinementToParent =
+            (i > 1) ? &getRefinement(i-2) : 0;
+
+        for (Index face = 0; face < parentLevel.getNumFaces(); ++face) {
+            if (isSparseFaceSelected(parentLevel, refinementToParent, face,
+                                     faceLevels, refinement->getRegularFaceSize())) {
+                selector.selectFace(face);
+            }
+        }
+
         if (selector.isSelectionEmpty()) {
             delete refinement;
             delete &childLevel;
@@ -438,6 +1080,8 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
         } else {
             refinement->refine(refineOptions);
 
+            inheritSparseFaceLevels(*refinement, faceLevels);
+
             appendLevel(childLevel);
             appendRefinement(*refinement);
         }
@@ -447,10 +1091,350 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     assembleFarLevels();
 }
 
+//
+//  Carrying forward the refinement of regions that remain selected when levels are
+//  regenerated by UpdateSparse() -- the components of each regenerated level are
+//  matched with those of the level they replace through the children of matching
+//  parent components (all of those of the last level kept match themselves).  The
+//  children are matched by their position in their parent, so a child edge or face
+//  only matches when its vertices (and edges) match in order.
+//
+//  Matching vertices are "carried" when also interpolated identically:  the masks of
+//  face-vertices only depend on their parent face, while those of edge-vertices and
+//  vertex-vertices also depend on the sharpness and rules of their parent and child
+//  vertices and on the faces and edges around their parent.  The neighborhoods of
+//  matching vertices are also compared to identify patches that remain the same:
+//
+namespace {
+    inline bool
+    isVTagEqual(Vtr::internal::Level::VTag const & a, Vtr::internal::Level::VTag const & b) {
+
+        return (a._nonManifold    == b._nonManifold)    && (a._xordinary      == b._xordinary) &&
+               (a._boundary       == b._boundary)       && (a._corner         == b._corner) &&
+               (a._infSharp       == b._infSharp)       && (a._semiSharp      == b._semiSharp) &&
+               (a._semiSharpEdges == b._semiSharpEdges) && (a._rule           == b._rule) &&
+               (a._incomplete     == b._incomplete)     && (a._infSharpEdges  == b._infSharpEdges) &&
+               (a._infSharpCrease == b._infSharpCrease) && (a._infIrregular   == b._infIrregular);
+    }
+
+    inline bool
+    isETagEqual(Vtr::internal::Level::ETag const & a, Vtr::internal::Level::ETag const & b) {
+
+        return (a._nonManifold == b._nonManifold) && (a._boundary  == b._boundary) &&
+               (a._infSharp    == b._infSharp)    && (a._semiSharp == b._semiSharp);
+    }
+
+    //  Whether the components of an array match those of the previous array in order:
+    inline bool
+    isArrayMatched(ConstIndexArray components, ConstIndexArray prevComponents,
+                   std::vector<Index> const & prevMap) {
+
+        if (components.size() != prevComponents.size()) return false;
+
+        for (int i = 0; i < components.size(); ++i) {
+            if (prevMap[components[i]] != prevComponents[i]) return false;
+        }
+        return true;
+    }
+
+    inline void
+    matchChild(Index child, Index prevChild, std::vector<Index> & prevMap) {
+
+        if (IndexIsValid(child) && IndexIsValid(prevChild)) {
+            prevMap[child] = prevChild;
+        }
+    }
+
+    inline void
+    matchChildren(ConstIndexArray children, ConstIndexArray prevChildren,
+                  std::vector<Index> & prevMap) {
+
+        if (children.size() != prevChildren.size()) return;
+
+        for (int i = 0; i < children.size(); ++i) {
+            matchChild(children[i], prevChildren[i], prevMap);
+        }
+    }
+}
+
+void
+TopologyRefiner::carryForwardSparseLevels(int firstLevel,
+        std::vector<Vtr::internal::Level *> const & prevLevels,
+        std::vector<Vtr::internal::Refinement *> const & prevRefinements) {
+
+    _numPrevLevels = firstLevel + (int)prevLevels.size();
+    _firstCarriedLevel = firstLevel;
+
+    _carriedLevels.clear();
+    _carriedLevels.resize(std::max(_numPrevLevels, (int)_levels.size()) - firstLevel);
+
+    for (int i = 0; i < (int)_carriedLevels.size(); ++i) {
+        _carriedLevels[i].numPrevVertices = (i < (int)prevLevels.size()) ?
+                                            prevLevels[i]->getNumVertices() : 0;
+    }
+
+    Vtr::internal::Level const & lastLevelKept = getLevel(firstLevel - 1);
+
+    std::vector<Index> parentFaces(lastLevelKept.getNumFaces()),
+                       parentEdges(lastLevelKept.getNumEdges()),
+                       parentVerts(lastLevelKept.getNumVertices());
+    for (Index face = 0; face < (Index)parentFaces.size(); ++face) parentFaces[face] = face;
+    for (Index edge = 0; edge < (Index)parentEdges.size(); ++edge) parentEdges[edge] = edge;
+    for (Index vert = 0; vert < (Index)parentVerts.size(); ++vert) parentVerts[vert] = vert;
+
+    int numLevelsMatched = std::min(_numPrevLevels, (int)_levels.size());
+
+    for (int level = firstLevel; level < numLevelsMatched; ++level) {
+
+        Vtr::internal::Refinement const & refinement     = getRefinement(level - 1);
+        Vtr::internal::Refinement const & prevRefinement = *prevRefinements[level - firstLevel];
+
+        Vtr::internal::Level const & parent     = refinement.parent();
+        Vtr::internal::Level const & child      = refinement.child();
+        Vtr::internal::Level const & prevParent = prevRefinement.parent();
+        Vtr::internal::Level const & prevChild  = prevRefinement.child();
+
+        //
+        //  Match the children of matching parent components, discarding child edges
+        //  and faces whose vertices do not match in order:
+        //
+        //  Triangles of the Loop scheme have no face-vertices:
+        bool hasFaceVertices = (refinement.getNumChildVerticesFromFaces() > 0) &&
+                               (prevRefinement.getNumChildVerticesFromFaces() > 0);
+
+        std::vector<Index> childFaces(child.getNumFaces(), INDEX_INVALID),
+                           childEdges(child.getNumEdges(), INDEX_INVALID),
+                           childVerts(child.getNumVertices(), INDEX_INVALID);
+
+        for (Index face = 0; face < parent.getNumFaces(); ++face) {
+            Index prevFace = parentFaces[face];
+            if (!IndexIsValid(prevFace)) continue;
+
+            matchChildren(refinement.getFaceChildFaces(face),
+                          prevRefinement.getFaceChildFaces(prevFace), childFaces);
+            matchChildren(refinement.getFaceChildEdges(face),
+                          prevRefinement.getFaceChildEdges(prevFace), childEdges);
+            if (hasFaceVertices) {
+                matchChild(refinement.getFaceChildVertex(face),
+                           prevRefinement.getFaceChildVertex(prevFace), childVerts);
+            }
+        }
+        for (Index edge = 0; edge < parent.getNumEdges(); ++edge) {
+            Index prevEdge = parentEdges[edge];
+            if (!IndexIsValid(prevEdge)) continue;
+
+            matchChildren(refinement.getEdgeChildEdges(edge),
+                          prevRefinement.getEdgeChildEdges(prevEdge), childEdges);
+            matchChild(refinement.getEdgeChildVertex(edge),
+                       prevRefinement.getEdgeChildVertex(prevEdge), childVerts);
+        }
+        for (Index vert = 0; vert < parent.getNumVertices(); ++vert) {
+            Index prevVert = parentVerts[vert];
+            if (!IndexIsValid(prevVert)) continue;
+
+            matchChild(refinement.getVertexChildVertex(vert),
+                       prevRefinement.getVertexChildVertex(prevVert), childVerts);
+        }
+
+        for (Index edge = 0; edge < child.getNumEdges(); ++edge) {
+            Index prevEdge = childEdges[edge];
+            if (IndexIsValid(prevEdge) &&
+                !isArrayMatched(child.getEdgeVertices(edge),
+                                prevChild.getEdgeVertices(prevEdge), childVerts)) {
+                childEdges[edge] = INDEX_INVALID;
+            }
+        }
+        for (Index face = 0; face < child.getNumFaces(); ++face) {
+            Index prevFace = childFaces[face];
+            if (IndexIsValid(prevFace) &&
+                !(isArrayMatched(child.getFaceVertices(face),
+                                 prevChild.getFaceVertices(prevFace), childVerts) &&
+                  isArrayMatched(child.getFaceEdges(face),
+                                 prevChild.getFaceEdges(prevFace), childEdges))) {
+                childFaces[face] = INDEX_INVALID;
+            }
+        }
+
+        //
+        //  Identify the matching vertices that are interpolated identically:
+        //
+        std::vector<Index> carriedVerts(child.getNumVertices(), INDEX_INVALID);
+
+        for (Index face = 0; hasFaceVertices && (face < parent.getNumFaces()); ++face) {
+            Index cVert = refinement.getFaceChildVertex(face);
+            if (IndexIsValid(cVert)) {
+                carriedVerts[cVert] = childVerts[cVert];
+            }
+        }
+        for (Index edge = 0; edge < parent.getNumEdges(); ++edge) {
+            Index cVert = refinement.getEdgeChildVertex(edge);
+            if (!IndexIsValid(cVert) || !IndexIsValid(childVerts[cVert])) continue;
+
+            Index prevEdge = parentEdges[edge];
+            if ((parent.getEdgeSharpness(edge) == prevParent.getEdgeSharpness(prevEdge)) &&
+                (child.getVertexRule(cVert) == prevChild.getVertexRule(childVerts[cVert])) &&
+                isArrayMatched(parent.getEdgeFaces(edge),
+                               prevParent.getEdgeFaces(prevEdge), parentFaces)) {
+                carriedVerts[cVert] = childVerts[cVert];
+            }
+        }
+        for (Index vert = 0; vert < parent.getNumVertices(); ++vert) {
+            Index cVert = refinement.getVertexChildVertex(vert);
+            if (!IndexIsValid(cVert) || !IndexIsValid(childVerts[cVert])) continue;
+
+            Index prevVert = parentVerts[vert];
+
+            Vtr::internal::Level::VTag vTag     = parent.getVertexTag(vert);
+            Vtr::internal::Level::VTag prevVTag = prevParent.getVertexTag(prevVert);
+            if ((vTag._rule != prevVTag._rule) || (vTag._xordinary != prevVTag._xordinary) ||
+                (parent.getVertexSharpness(vert) != prevParent.getVertexSharpness(prevVert)) ||
+                (child.getVertexRule(cVert) != prevChild.getVertexRule(childVerts[cVert])) ||
+                (child.getVertexSharpness(cVert) != prevChild.getVertexSharpness(childVerts[cVert]))) {
+                continue;
+            }
+
+            ConstIndexArray vEdges     = parent.getVertexEdges(vert),
+                            prevVEdges = prevParent.getVertexEdges(prevVert);
+            if (!isArrayMatched(vEdges, prevVEdges, parentEdges) ||
+                !isArrayMatched(parent.getVertexFaces(vert),
+                                prevParent.getVertexFaces(prevVert), parentFaces)) {
+                continue;
+            }
+
+            bool isSharpnessEqual = true;
+            for (int i = 0; isSharpnessEqual && (i < vEdges.size()); ++i) {
+                isSharpnessEqual = (parent.getEdgeSharpness(vEdges[i]) ==
+                                    prevParent.getEdgeSharpness(prevVEdges[i]));
+            }
+            if (isSharpnessEqual) {
+                carriedVerts[cVert] = childVerts[cVert];
+            }
+        }
+
+        //
+        //  Identify the matching vertices whose incident faces and edges also match
+        //  (with the same tags and sharpness):
+        //
+        std::vector<unsigned char> sameNeighborhoods(child.getNumVertices(), 0);
+
+        for (Index vert = 0; vert < child.getNumVertices(); ++vert) {
+            Index prevVert = childVerts[vert];
+            if (!IndexIsValid(prevVert)) continue;
+
+            if (!isVTagEqual(child.getVertexTag(vert), prevChild.getVertexTag(prevVert)) ||
+                (child.getVertexSharpness(vert) != prevChild.getVertexSharpness(prevVert))) {
+                continue;
+            }
+
+            ConstIndexArray vFaces     = child.getVertexFaces(vert),
+                            prevVFaces = prevChild.getVertexFaces(prevVert),
+                            vEdges     = child.getVertexEdges(vert),
+                            prevVEdges = prevChild.getVertexEdges(prevVert);
+            if (!isArrayMatched(vFaces, prevVFaces, childFaces) ||
+                !isArrayMatched(vEdges, prevVEdges, childEdges)) {
+                continue;
+            }
+
+            bool isSame = true;
+            for (int i = 0; isSame && (i < vFaces.size()); ++i) {
+                isSame = (child.isFaceHole(vFaces[i]) == prevChild.isFaceHole(prevVFaces[i]));
+            }
+            for (int i = 0; isSame && (i < vEdges.size()); ++i) {
+                isSame = isETagEqual(child.getEdgeTag(vEdges[i]), prevChild.getEdgeTag(prevVEdges[i])) &&
+                         (child.getEdgeSharpness(vEdges[i]) == prevChild.getEdgeSharpness(prevVEdges[i]));
+            }
+            sameNeighborhoods[vert] = isSame;
+        }
+
+        CarriedLevel & carriedLevel = _carriedLevels[level - firstLevel];
+
+        carriedLevel.prevVertices.swap(childVerts);
+        carriedLevel.carriedVertices.swap(carriedVerts);
+        carriedLevel.sameNeighborhoods.swap(sameNeighborhoods);
+
+        parentFaces.swap(childFaces);
+        parentEdges.swap(childEdges);
+        parentVerts = carriedLevel.prevVertices;
+    }
+}
+
 //
 //  Local utility functions for selecting features in faces for adaptive refinement:
 //
 namespace {
+    //
+    //  Geometric test of the control hull of a face, i.e. the face and the vertices
+    //  adjacent its corners, against a tolerance.  The deviation of the hull is the
+    //  largest distance of its vertices to the plane through the center of the face
+    //  (oriented by its Newell normal).  Degenerate faces without a normal measure
+    //  the distance to the center instead, so tiny features are also within
+    //  tolerance:
+    //
+    inline float
+    distanceToPlane(float const * p, float const * center, float const * normal) {
+
+        float d[3] = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+        if (normal) {
+            return std::abs(d[0] * normal[0] + d[1] * normal[1] + d[2] * normal[2]);
+        } else {
+            return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+    }
+
+    bool
+    isFaceHullWithinTolerance(Vtr::internal::Level const & level, Index face,
+                              float const * positions, float tolerance) {
+
+        ConstIndexArray fVerts = level.getFaceVertices(face);
+
+        float center[3] = { 0.0f, 0.0f, 0.0f };
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < fVerts.size(); ++i) {
+            float const * p0 = positions + 3 * fVerts[i];
+            float const * p1 = positions + 3 * fVerts[(i + 1) % fVerts.size()];
+
+            center[0] += p0[0];
+            center[1] += p0[1];
+            center[2] += p0[2];
+
+            normal[0] += (p0[1] - p1[1]) * (p0[2] + p1[2]);
+            normal[1] += (p0[2] - p1[2]) * (p0[0] + p1[0]);
+            normal[2] += (p0[0] - p1[0]) * (p0[1] + p1[1]);
+        }
+        float invSize = 1.0f / (float) fVerts.size();
+        center[0] *= invSize;
+        center[1] *= invSize;
+        center[2] *= invSize;
+
+        float normalLength = std::sqrt(normal[0] * normal[0] +
+                                       normal[1] * normal[1] +
+                                       normal[2] * normal[2]);
+        float * planeNormal = 0;
+        if (normalLength > 0.0f) {
+            normal[0] /= normalLength;
+            normal[1] /= normalLength;
+            normal[2] /= normalLength;
+            planeNormal = normal;
+        }
+
+        for (int i = 0; i < fVerts.size(); ++i) {
+            if (distanceToPlane(positions + 3 * fVerts[i], center, planeNormal) >= tolerance) {
+                return false;
+            }
+
+            ConstIndexArray vEdges = level.getVertexEdges(fVerts[i]);
+            for (int j = 0; j < vEdges.size(); ++j) {
+                ConstIndexArray eVerts = level.getEdgeVertices(vEdges[j]);
+                Index vOther = eVerts[eVerts[0] == fVerts[i]];
+
+                if (distanceToPlane(positions + 3 * vOther, center, planeNormal) >= tolerance) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     //
     //  First is a low-level utility method to perform the same analysis on a set of
     //  VTags for a face given a FeatureMask.  This is shared between the analysis of
@@ -661,7 +1645,8 @@ namespace {
 //
 void
 TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector& selector,
-                                                 internal::FeatureMask const & featureMask) {
+                                                 internal::FeatureMask const & featureMask,
+                                                 float const * levelPositions, float tolerance) {
 
     if (featureMask.IsEmpty()) return;
 
@@ -719,6 +1704,16 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
                 }
             }
         }
+
+        //
+        //  Features whose control hull is flat to within the given tolerance need no
+        //  further isolation -- unless no corner is smooth, as such a face cannot be
+        //  represented by a patch:
+        //
+        if (selectFace && levelPositions &&
+                (level.getFaceCompositeVTag(face)._rule & Sdc::Crease::RULE_SMOOTH)) {
+            selectFace = !isFaceHullWithinTolerance(level, face, levelPositions, tolerance);
+        }
         if (selectFace) {
             selector.selectFace(face);
         }
@@ -90,6 +90,9 @@ public:
     /// \brief Returns the total number of face vertices in all levels
     int GetNumFaceVerticesTotal() const { return _totalFaceVertices; }
 
+    /// \brief Returns the memory used by the topology of all levels (in bytes)
+    size_t GetByteSize() const;
+
     /// \brief Returns a handle to access data specific to a particular level
     TopologyLevel const & GetLevel(int level) const { return _farLevels[level]; }
 
@@ -114,19 +117,43 @@ public:
     /// faces of vertices, the option to generate full topology in the last
     /// level should be enabled.
     ///
+    /// When the refiner is only used to construct stencil and patch tables, the
+    /// stencilTopologyOnly option (also available for adaptive refinement)
+    /// releases the local indices of edge-faces and vertex-edges, and the child
+    /// edges of faces and edges, as soon as they are no longer needed to refine.
+    /// Those relations of TopologyLevel are then unavailable for refined levels
+    /// (the base level and levels with face-varying channels retain their local
+    /// indices) -- their accessors report an error and return empty arrays --
+    /// and a subsequent UpdateSparse() refines all levels anew.
+    ///
+    /// By default, the vertices of each refined level are grouped by the type
+    /// of their parent component -- faces, edges or vertices -- so that the
+    /// children of neighboring parent components are far apart.  The option
+    /// to orderVerticesByParentFace (also available for adaptive refinement)
+    /// instead keeps the children of each parent face together, improving the
+    /// locality of vertex data interpolated or computed from stencils.  It
+    /// takes precedence over orderVerticesFromFacesFirst.
+    ///
     struct UniformOptions {
 
         UniformOptions(int level) :
             refinementLevel(level),
             orderVerticesFromFacesFirst(false),
-            fullTopologyInLastLevel(false) { }
+            orderVerticesByParentFace(false),
+            fullTopologyInLastLevel(false),
+            stencilTopologyOnly(false) { }
 
         unsigned int refinementLevel:4,             ///< Number of refinement iterations
                      orderVerticesFromFacesFirst:1, ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
-                     fullTopologyInLastLevel:1;     ///< Skip topological relationships in the last
+                     orderVerticesByParentFace:1,   ///< Order child vertices by parent face
+                                                    ///< rather than by type of parent
+                     fullTopologyInLastLevel:1,     ///< Skip topological relationships in the last
                                                     ///< level of refinement that are not needed for
                                                     ///< interpolation (keep false if using limit).
+                     stencilTopologyOnly:1;         ///< Release relationships of each level that are
+                                                    ///< not needed for interpolation, stencils or
+                                                    ///< patches once the next level is refined
     };
 
     /// \brief Refine the topology uniformly
@@ -157,7 +184,9 @@ public:
             useSingleCreasePatch(false),
             useInfSharpPatch(false),
             considerFVarChannels(false),
-            orderVerticesFromFacesFirst(false) { }
+            orderVerticesFromFacesFirst(false),
+            orderVerticesByParentFace(false),
+            stencilTopologyOnly(false) { }
 
         unsigned int isolationLevel:4;              ///< Number of iterations applied to isolate
                                                     ///< extraordinary vertices and creases
@@ -171,17 +200,211 @@ public:
                                                     ///< isolate when irregular features present
         unsigned int orderVerticesFromFacesFirst:1; ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
+        unsigned int orderVerticesByParentFace:1;   ///< Order child vertices by parent face
+                                                    ///< rather than by type of parent
+        unsigned int stencilTopologyOnly:1;         ///< Release relationships of each level that are
+                                                    ///< not needed for interpolation, stencils or
+                                                    ///< patches once the next level is refined
     };
 
-    /// \brief Feature Adaptive topology refinement (restricted to scheme Catmark)
+    /// \brief Feature Adaptive topology refinement (restricted to schemes Catmark
+    ///        and Loop)
     ///
     /// @param options   Options controlling adaptive refinement
     ///
     void RefineAdaptive(AdaptiveOptions options);
 
+    /// \brief Feature Adaptive topology refinement limited by a geometric tolerance
+    ///
+    /// Features are isolated as with the options alone, except that isolation of
+    /// a feature stops once the control hull around it is flat to within the
+    /// given tolerance:  a face is not refined further when all vertices of the
+    /// face and its neighboring vertices lie within \c tolerance of the plane of
+    /// the face.  Large flat regions and tiny details so produce fewer patches.
+    ///
+    /// The tolerance is expressed in the space of the positions given, so that
+    /// a screen-space tolerance results from projected positions.  Positions are
+    /// interpolated to each level to be tested.  Faces without a smooth corner
+    /// are always isolated, as they cannot otherwise be represented by patches,
+    /// and patches left around extraordinary vertices that are not isolated
+    /// require end-caps other than ENDCAP_LEGACY_GREGORY.
+    ///
+    /// @param options          Options controlling adaptive refinement
+    ///
+    /// @param vertexPositions  Positions of the base vertices (3 floats each)
+    ///
+    /// @param tolerance        Deviation of the control hull below which
+    ///                         features are no longer isolated
+    ///
+    void RefineAdaptive(AdaptiveOptions options,
+                        float const * vertexPositions, float tolerance);
+
+    /// \brief Budget for adaptive refinement
+    ///
+    /// Limits the refinement applied by RefineAdaptive() to a number of patches
+    /// and/or an amount of memory, with the features to isolate first ranked
+    /// by a list of priorities.
+    ///
+    struct AdaptiveBudget {
+
+        enum Priority {
+            PRIORITY_NONE = 0,  ///< No further ranking
+            PRIORITY_SHARPNESS, ///< Sharpest edges and vertices first
+            PRIORITY_VALENCE,   ///< Extraordinary vertices of highest valence first
+            PRIORITY_SIZE       ///< Largest faces first (requires vertexPositions)
+        };
+
+        AdaptiveBudget() :
+            maxPatches(0),
+            maxBytes(0),
+            vertexPositions(0) {
+
+            priorities[0] = PRIORITY_SHARPNESS;
+            priorities[1] = PRIORITY_VALENCE;
+            priorities[2] = PRIORITY_SIZE;
+        }
+
+        int           maxPatches;      ///< Maximum number of patches, i.e. of faces
+                                       ///< left unrefined (0 if unlimited)
+        size_t        maxBytes;        ///< Maximum memory of the topology of all levels
+                                       ///< as given by GetByteSize() (0 if unlimited)
+        Priority      priorities[3];   ///< Order in which features are ranked
+        float const * vertexPositions; ///< Positions of the base vertices (3 floats
+                                       ///< each), only required for PRIORITY_SIZE
+    };
+
+    /// \brief Isolation achieved by refinement within a budget
+    ///
+    /// The level to which the features of each base face, vertex and edge were
+    /// isolated, i.e. the deepest level to which the face, or the faces around
+    /// the vertex or along the edge, or any of their descendants were refined.
+    /// Features whose level falls short of that reached without a budget were
+    /// not fully isolated.
+    ///
+    struct AdaptiveIsolation {
+        std::vector<int> faceLevels;   ///< Level reached within each base face
+        std::vector<int> vertexLevels; ///< Level reached around each base vertex
+        std::vector<int> edgeLevels;   ///< Level reached along each base edge
+    };
+
+    /// \brief Feature Adaptive topology refinement within a budget
+    ///
+    /// Features are isolated level by level as with the options alone, but at
+    /// each level the faces selected for their features are ranked by the
+    /// priorities of the budget and only refined while the budget allows.  Once
+    /// the next face would exceed the budget, no further features are isolated.
+    ///
+    /// Faces that patches cannot represent unless refined -- those around
+    /// non-quad faces and those without a smooth corner -- are always refined
+    /// and so count against the budget before others.  They are refined even
+    /// when they exceed the budget, so the number of patches and the memory used
+    /// exceed the limits given whenever these faces alone do.
+    ///
+    /// @param options          Options controlling adaptive refinement
+    ///
+    /// @param budget           Budget and priorities of the refinement
+    ///
+    /// @param isolation        Optional isolation achieved for each base face,
+    ///                         vertex and edge
+    ///
+    void RefineAdaptive(AdaptiveOptions options, AdaptiveBudget const & budget,
+                        AdaptiveIsolation * isolation = 0);
+
     /// \brief Returns the options specified on refinement
     AdaptiveOptions GetAdaptiveOptions() const { return _adaptiveOptions; }
 
+    //
+    // Sparse refinement
+    //
+
+    /// \brief Sparse refinement options
+    struct SparseOptions {
+
+        SparseOptions(int level) :
+            refinementLevel(level),
+            orderVerticesFromFacesFirst(false) { }
+
+        unsigned int refinementLevel:4,             ///< Maximum number of refinement iterations
+                     orderVerticesFromFacesFirst:1; ///< Order child vertices from faces first
+                                                    ///< instead of child vertices of vertices
+    };
+
+    /// \brief Refine selected faces of the base level to individual levels
+    ///
+    /// Rather than selecting features for refinement, as is done by adaptive
+    /// refinement, each face of the base level is refined to the level given
+    /// for it (clamped to the refinementLevel of the options).  This suits
+    /// view-dependent refinement or refinement of other regions of interest.
+    ///
+    /// The resulting refiner is not uniform and is used like an adaptively
+    /// refined one to create stencil and patch tables, i.e. patches are created
+    /// for the faces at the deepest level of refinement of each region.  Faces
+    /// within or adjacent to the refined region that could not otherwise be
+    /// represented by patches (faces without a smooth corner, or faces sharing
+    /// a vertex with an irregular base face) are refined further, as they would
+    /// be by adaptive refinement, while those elsewhere are left at their level
+    /// and represented by end caps.  So faces given a level of 0 are not refined
+    /// away from the region -- with the exception of irregular faces of the base
+    /// level, e.g. triangles in a quad mesh, and faces around non-manifold
+    /// features that require refinement, which are always refined once.
+    ///
+    /// @param options          Options controlling sparse refinement
+    ///
+    /// @param baseFaceLevels   Level of refinement for each base face
+    ///
+    void RefineSparse(SparseOptions options, int const baseFaceLevels[]);
+
+    /// \brief Refine the given faces of the base level to the refinementLevel
+    ///        of the options (see the per-face variant above)
+    ///
+    /// Refinement fails with an error if any index is not that of a base face.
+    ///
+    /// @param options          Options controlling sparse refinement
+    ///
+    /// @param baseFaces        Indices of the base faces to refine
+    ///
+    void RefineSparse(SparseOptions options, ConstIndexArray baseFaces);
+
+    /// \brief Update an adaptive or sparse refinement to new per-face levels
+    ///
+    /// The result is that of RefineSparse() with the given levels, but levels
+    /// of the existing refinement are reused as long as the faces refined in
+    /// them remain the same, i.e. only levels from the shallowest one affected
+    /// by the change are regenerated.  Changes confined to deeper levels, e.g.
+    /// when faces are refined one level further, so leave the shallower levels
+    /// intact along with anything derived from them -- in particular the
+    /// stencil tables of StencilTableFactory::CreateLevelStencilTables(),
+    /// which StencilTableFactory::UpdateLevelStencilTables() updates for the
+    /// regenerated levels only.
+    ///
+    /// Within the regenerated levels, the refinement of regions whose faces
+    /// remain selected is carried forward:  vertices refined exactly as before
+    /// are identified (see GetCarriedVertices()), so that the level stencils
+    /// and the patches of those regions are copied rather than recomputed
+    /// (see also PatchTableFactory::Update()).
+    ///
+    /// @param options          Options controlling sparse refinement
+    ///
+    /// @param baseFaceLevels   Level of refinement for each base face
+    ///
+    /// @return                 The first level that was regenerated -- all
+    ///                         shallower levels are unchanged
+    ///
+    int UpdateSparse(SparseOptions options, int const baseFaceLevels[]);
+
+    /// \brief Returns the vertices of a level carried forward by the last
+    ///        UpdateSparse()
+    ///
+    /// For each vertex of a regenerated level, the array holds the index of
+    /// the vertex of the replaced level that it corresponds to, if both are
+    /// interpolated identically from corresponding vertices of their parent
+    /// levels, and INDEX_INVALID otherwise.  The array is empty for levels
+    /// that were not regenerated or that did not exist before the update.
+    ///
+    /// @param level            The level of the vertices
+    ///
+    ConstIndexArray GetCarriedVertices(int level) const;
+
     /// \brief Unrefine the topology, keeping only the base level.
     void Unrefine();
 
@@ -214,6 +437,7 @@ protected:
     friend class EndCapLegacyGregoryPatchFactory;
     friend class PtexIndices;
     friend class PrimvarRefiner;
+    friend class StencilTableFactory;
 
     Vtr::internal::Level & getLevel(int l) { return *_levels[l]; }
     Vtr::internal::Level const & getLevel(int l) const { return *_levels[l]; }
@@ -221,14 +445,34 @@ protected:
     Vtr::internal::Refinement & getRefinement(int l) { return *_refinements[l]; }
     Vtr::internal::Refinement const & getRefinement(int l) const { return *_refinements[l]; }
 
+    //  Correspondence of the vertices of each level with those of the refinement
+    //  replaced by the last UpdateSparse() -- levels that were kept correspond to
+    //  themselves, and none correspond when no such refinement exists:
+    int   getNumPrevLevels() const { return _numPrevLevels; }
+    int   getNumPrevVertices(int l) const;
+    Index getPrevVertex(int l, Index v) const;
+    bool  isPrevVertexNeighborhoodEqual(int l, Index v) const;
+
 private:
     //  Not default constructible or copyable:
     TopologyRefiner() : _uniformOptions(0), _adaptiveOptions(0) { }
     TopologyRefiner(TopologyRefiner const &) : _uniformOptions(0), _adaptiveOptions(0) { }
     TopologyRefiner & operator=(TopologyRefiner const &) { return *this; }
 
+    void refineSparseLevels(SparseOptions options, std::vector<int> & faceLevels);
+
+    void carryForwardSparseLevels(int firstLevel,
+                                  std::vector<Vtr::internal::Level *> const & prevLevels,
+                                  std::vector<Vtr::internal::Refinement *> const & prevRefinements);
+
+    void refineAdaptive(AdaptiveOptions options,
+                        float const * vertexPositions, float tolerance,
+                        AdaptiveBudget const * budget, AdaptiveIsolation * isolation);
+
     void selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector& selector,
-                                         internal::FeatureMask const & mask);
+                                         internal::FeatureMask const & mask,
+                                         float const * levelPositions = 0,
+                                         float tolerance = 0.0f);
 
     void initializeInventory();
     void updateInventory(Vtr::internal::Level const & newLevel);
@@ -262,8 +506,43 @@ private:
     std::vector<Vtr::internal::Refinement *> _refinements;
 
     std::vector<TopologyLevel> _farLevels;
+
+    //  Vertices of the levels regenerated by UpdateSparse() (from the first kept
+    //  level on) and of the levels they replaced:
+    struct CarriedLevel {
+        int                        numPrevVertices;
+        std::vector<Index>         prevVertices;
+        std::vector<Index>         carriedVertices;
+        std::vector<unsigned char> sameNeighborhoods;
+    };
+    int                       _numPrevLevels;
+    int                       _firstCarriedLevel;
+    std::vector<CarriedLevel> _carriedLevels;
 };
 
+inline int
+TopologyRefiner::getNumPrevVertices(int l) const {
+
+    return (l < _firstCarriedLevel) ? _levels[l]->getNumVertices() :
+                                      _carriedLevels[l - _firstCarriedLevel].numPrevVertices;
+}
+inline Index
+TopologyRefiner::getPrevVertex(int l, Index v) const {
+
+    if (l < _firstCarriedLevel) return v;
+
+    std::vector<Index> const & prevVertices = _carriedLevels[l - _firstCarriedLevel].prevVertices;
+    return prevVertices.empty() ? INDEX_INVALID : prevVertices[v];
+}
+inline bool
+TopologyRefiner::isPrevVertexNeighborhoodEqual(int l, Index v) const {
+
+    if (l < _firstCarriedLevel) return true;
+
+    std::vector<unsigned char> const & same = _carriedLevels[l - _firstCarriedLevel].sameNeighborhoods;
+    return !same.empty() && same[v];
+}
+
 
 inline int
 TopologyRefiner::GetNumFVarChannels() const {
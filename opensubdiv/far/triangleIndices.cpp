@@ -0,0 +1,303 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/triangleIndices.h"
+#include "../far/error.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //
+    //  Scoring of vertices from "Linear-Speed Vertex Cache Optimisation" (Tom
+    //  Forsyth, 2006) -- vertices recently used score highest (though not the
+    //  three of the last triangle, to avoid long strips), and vertices with few
+    //  triangles remaining are boosted so that they are retired quickly:
+    //
+    float const CACHE_DECAY_POWER   = 1.5f;
+    float const LAST_TRIANGLE_SCORE = 0.75f;
+    float const VALENCE_BOOST_SCALE = 2.0f;
+    float const VALENCE_BOOST_POWER = 0.5f;
+
+    //  Scores are tabulated for cache positions and for the small numbers of
+    //  triangles remaining that are typical -- only larger valences are scored
+    //  explicitly:
+    class VertexScorer {
+    public:
+        VertexScorer(int cacheSize) : _cacheScores(cacheSize), _valenceScores(MAX_TABULATED_VALENCE) {
+
+            for (int i = 0; i < cacheSize; ++i) {
+                _cacheScores[i] = (i < 3) ? LAST_TRIANGLE_SCORE :
+                    std::pow(1.0f - (float)(i - 3) / (float)(cacheSize - 3), CACHE_DECAY_POWER);
+            }
+            for (int i = 1; i < MAX_TABULATED_VALENCE; ++i) {
+                _valenceScores[i] = computeValenceScore(i);
+            }
+        }
+
+        float GetScore(int cachePosition, int numTrianglesRemaining) const {
+
+            if (numTrianglesRemaining == 0) return -1.0f;
+
+            return ((cachePosition < 0) ? 0.0f : _cacheScores[cachePosition]) +
+                   ((numTrianglesRemaining < MAX_TABULATED_VALENCE) ?
+                        _valenceScores[numTrianglesRemaining] :
+                        computeValenceScore(numTrianglesRemaining));
+        }
+
+    private:
+        static float computeValenceScore(int numTrianglesRemaining) {
+            return VALENCE_BOOST_SCALE *
+                std::pow((float)numTrianglesRemaining, -VALENCE_BOOST_POWER);
+        }
+
+        static int const MAX_TABULATED_VALENCE = 32;
+
+        std::vector<float> _cacheScores;
+        std::vector<float> _valenceScores;
+    };
+}
+
+TriangleIndices::TriangleIndices(TopologyRefiner const &refiner, Options options) :
+    _level(0), _numVertices(0) {
+
+    _level = (options.level < 0) ? refiner.GetMaxLevel() : options.level;
+    if (_level > refiner.GetMaxLevel()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TriangleIndices::TriangleIndices() -- "
+            "level %d exceeds the maximum level %d of the refiner.",
+            _level, refiner.GetMaxLevel());
+        _level = refiner.GetMaxLevel();
+        return;
+    }
+
+    TopologyLevel const & level = refiner.GetLevel(_level);
+
+    _numVertices = level.GetNumVertices();
+
+    triangulateFaces(level);
+
+    if (options.optimizeVertexCache) {
+        optimizeVertexCache(std::max(options.vertexCacheSize, 4));
+    }
+}
+
+TriangleIndices::~TriangleIndices() {
+}
+
+void
+TriangleIndices::triangulateFaces(TopologyLevel const & level) {
+
+    //
+    //  Assign the first triangle of each face serially, then triangulate the
+    //  faces in parallel:
+    //
+    int numFaces = level.GetNumFaces();
+
+    std::vector<Index> faceOffsets(numFaces + 1);
+    faceOffsets[0] = 0;
+    for (int face = 0; face < numFaces; ++face) {
+        int numTriangles = level.IsFaceHole(face) ? 0 :
+                           std::max(level.GetFaceVertices(face).size() - 2, 0);
+        faceOffsets[face + 1] = faceOffsets[face] + numTriangles;
+    }
+
+    _triangleVertices.resize(faceOffsets[numFaces] * 3);
+    _triangleFaces.resize(faceOffsets[numFaces]);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static, 1024)
+#endif
+    for (int face = 0; face < numFaces; ++face) {
+        int numTriangles = faceOffsets[face + 1] - faceOffsets[face];
+        if (numTriangles == 0) continue;
+
+        ConstIndexArray fVerts = level.GetFaceVertices(face);
+
+        Index * triVerts = &_triangleVertices[faceOffsets[face] * 3];
+        Index * triFaces = &_triangleFaces[faceOffsets[face]];
+
+        //  Quads are split as {v0,v1,v2},{v0,v2,v3}, as with PatchTableFactory,
+        //  and generalized as a fan for other faces:
+        for (int i = 0; i < numTriangles; ++i) {
+            *triVerts++ = fVerts[0];
+            *triVerts++ = fVerts[i + 1];
+            *triVerts++ = fVerts[i + 2];
+            *triFaces++ = face;
+        }
+    }
+}
+
+void
+TriangleIndices::optimizeVertexCache(int cacheSize) {
+
+    int numTriangles = GetNumTriangles();
+    if (numTriangles == 0) return;
+
+    //
+    //  Gather the triangles incident each vertex -- the first of which are
+    //  those not yet emitted:
+    //
+    std::vector<int> vertTriOffsets(_numVertices + 1, 0);
+    for (int i = 0; i < numTriangles * 3; ++i) {
+        ++vertTriOffsets[_triangleVertices[i] + 1];
+    }
+    for (int i = 0; i < _numVertices; ++i) {
+        vertTriOffsets[i + 1] += vertTriOffsets[i];
+    }
+
+    std::vector<int> vertNumTris(_numVertices, 0);
+    std::vector<int> vertTris(numTriangles * 3);
+    for (int i = 0; i < numTriangles * 3; ++i) {
+        Index vert = _triangleVertices[i];
+        vertTris[vertTriOffsets[vert] + vertNumTris[vert]++] = i / 3;
+    }
+
+    VertexScorer scorer(cacheSize);
+
+    std::vector<float> vertScores(_numVertices);
+    for (int i = 0; i < _numVertices; ++i) {
+        vertScores[i] = scorer.GetScore(-1, vertNumTris[i]);
+    }
+
+    std::vector<bool> triEmitted(numTriangles, false);
+
+    //
+    //  Emit triangles greedily by score, maintaining a modeled LRU cache of
+    //  vertices.  Only triangles of vertices in the cache are rescored, so the
+    //  best is sought among those -- falling back on the next triangle in the
+    //  original order when none remain:
+    //
+    std::vector<Index> newTriangleVertices(numTriangles * 3);
+    std::vector<Index> newTriangleFaces(numTriangles);
+
+    std::vector<int> cache, newCache;
+    cache.reserve(cacheSize + 3);
+    newCache.reserve(cacheSize + 3);
+
+    int bestTri = -1;
+    int nextTri = 0;
+
+    for (int emitted = 0; emitted < numTriangles; ++emitted) {
+        if (bestTri < 0) {
+            while (triEmitted[nextTri]) ++nextTri;
+            bestTri = nextTri;
+        }
+
+        Index const * tri = &_triangleVertices[bestTri * 3];
+        for (int i = 0; i < 3; ++i) {
+            newTriangleVertices[emitted * 3 + i] = tri[i];
+        }
+        newTriangleFaces[emitted] = _triangleFaces[bestTri];
+        triEmitted[bestTri] = true;
+
+        //  Remove the triangle from those remaining for its vertices:
+        for (int i = 0; i < 3; ++i) {
+            int * vTris = &vertTris[vertTriOffsets[tri[i]]];
+            int & vNumTris = vertNumTris[tri[i]];
+            for (int j = 0; j < vNumTris; ++j) {
+                if (vTris[j] == bestTri) {
+                    std::swap(vTris[j], vTris[vNumTris - 1]);
+                    --vNumTris;
+                    break;
+                }
+            }
+        }
+
+        //  Move the vertices of the triangle to the front of the cache, the
+        //  last of which are evicted:
+        newCache.clear();
+        newCache.push_back(tri[0]);
+        newCache.push_back(tri[1]);
+        newCache.push_back(tri[2]);
+        for (int i = 0; i < (int)cache.size(); ++i) {
+            if ((cache[i] != tri[0]) && (cache[i] != tri[1]) && (cache[i] != tri[2])) {
+                newCache.push_back(cache[i]);
+            }
+        }
+        cache.swap(newCache);
+
+        //  Rescore the cached and evicted vertices and their remaining triangles:
+        for (int i = 0; i < (int)cache.size(); ++i) {
+            Index vert = cache[i];
+            vertScores[vert] = scorer.GetScore((i < cacheSize) ? i : -1, vertNumTris[vert]);
+        }
+
+        bestTri = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < (int)cache.size(); ++i) {
+            Index vert = cache[i];
+
+            int const * vTris = &vertTris[vertTriOffsets[vert]];
+            for (int j = 0; j < vertNumTris[vert]; ++j) {
+                Index const * t = &_triangleVertices[vTris[j] * 3];
+                float score = vertScores[t[0]] + vertScores[t[1]] + vertScores[t[2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTri = vTris[j];
+                }
+            }
+        }
+        if ((int)cache.size() > cacheSize) {
+            cache.resize(cacheSize);
+        }
+    }
+
+    _triangleVertices.swap(newTriangleVertices);
+    _triangleFaces.swap(newTriangleFaces);
+
+    //
+    //  Order vertices by first use, retaining those unused in their original
+    //  order following all others:
+    //
+    std::vector<Index> newVertexIndices(_numVertices, INDEX_INVALID);
+
+    _vertexOrder.reserve(_numVertices);
+    for (int i = 0; i < numTriangles * 3; ++i) {
+        Index & vert = _triangleVertices[i];
+        if (newVertexIndices[vert] == INDEX_INVALID) {
+            newVertexIndices[vert] = (Index)_vertexOrder.size();
+            _vertexOrder.push_back(vert);
+        }
+        vert = newVertexIndices[vert];
+    }
+    for (int i = 0; i < _numVertices; ++i) {
+        if (newVertexIndices[i] == INDEX_INVALID) {
+            _vertexOrder.push_back(i);
+        }
+    }
+    assert((int)_vertexOrder.size() == _numVertices);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
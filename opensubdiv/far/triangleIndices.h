@@ -0,0 +1,147 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_TRIANGLE_INDICES_H
+#define OPENSUBDIV3_FAR_TRIANGLE_INDICES_H
+
+#include "../version.h"
+
+#include "../far/topologyRefiner.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Object used to build a triangle index buffer for a refined level.
+///
+/// Given a refiner, constructing a TriangleIndices object triangulates the
+/// faces of one of its levels (the last by default) into an index buffer
+/// suitable for rendering.  Quads are split as with the triangulateQuads
+/// option of PatchTableFactory, other faces are split into fans, and holes
+/// are omitted.  Faces are triangulated in parallel when OpenMP is enabled.
+///
+/// The order of vertices and faces from refinement is not coherent enough to
+/// make good use of the post-transform vertex cache of a GPU.  Optionally,
+/// triangles can be reordered to reduce cache misses (following the linear
+/// algorithm of Forsyth) and vertices then reordered by first use.  The new
+/// order of vertices must be applied to the vertex data of the level -- e.g.
+/// the results of PrimvarRefiner or a StencilTable -- with PermuteVertices().
+///
+class TriangleIndices {
+
+public:
+
+    struct Options {
+
+        Options() : level(-1), optimizeVertexCache(false), vertexCacheSize(32) { }
+
+        int level;                          ///< Level to triangulate (the last
+                                            ///< level if negative)
+
+        unsigned int optimizeVertexCache:1; ///< Reorder triangles and vertices for
+                                            ///< the post-transform vertex cache
+
+        int vertexCacheSize;                ///< Number of entries of the modeled
+                                            ///< vertex cache
+    };
+
+    /// \brief Constructor
+    TriangleIndices(TopologyRefiner const &refiner, Options options = Options());
+
+    /// \brief Destructor
+    ~TriangleIndices();
+
+    /// \brief Returns the level triangulated
+    int GetLevel() const { return _level; }
+
+    /// \brief Returns the number of vertices of the level triangulated
+    int GetNumVertices() const { return _numVertices; }
+
+    /// \brief Returns the number of triangles
+    int GetNumTriangles() const { return (int)_triangleFaces.size(); }
+
+    /// \brief Returns the vertices of all triangles (three each)
+    std::vector<Index> const & GetTriangleVertices() const { return _triangleVertices; }
+
+    /// \brief Returns the face of the level from which each triangle originates
+    std::vector<Index> const & GetTriangleFaces() const { return _triangleFaces; }
+
+    /// \brief Returns true if vertices were reordered
+    bool HasVertexOrder() const { return !_vertexOrder.empty(); }
+
+    /// \brief Returns the vertex of the level at each new vertex index -- or an
+    ///        empty vector if vertices were not reordered
+    std::vector<Index> const & GetVertexOrder() const { return _vertexOrder; }
+
+    /// \brief Reorders the vertex data of the level to match the triangles
+    ///
+    /// @param src  Vertex data of the level (see PrimvarRefiner for the
+    ///             interface required of the buffer elements)
+    ///
+    /// @param dst  Destination for the reordered vertex data (must not overlap
+    ///             with \c src)
+    ///
+    template <class T, class U>
+    void PermuteVertices(T const & src, U & dst) const;
+
+private:
+
+    void triangulateFaces(TopologyLevel const & level);
+
+    void optimizeVertexCache(int cacheSize);
+
+private:
+
+    int _level;
+    int _numVertices;
+
+    std::vector<Index> _triangleVertices;
+    std::vector<Index> _triangleFaces;
+    std::vector<Index> _vertexOrder;
+};
+
+template <class T, class U>
+inline void
+TriangleIndices::PermuteVertices(T const & src, U & dst) const {
+
+    for (int i = 0; i < _numVertices; ++i) {
+        Index srcIndex = _vertexOrder.empty() ? i : _vertexOrder[i];
+
+        dst[i].Clear();
+        dst[i].AddWithWeight(src[srcIndex], 1.0f);
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TRIANGLE_INDICES_H */
@@ -174,6 +174,11 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
         return false;
     }
 
+    if (! CpuCheckPatchTypes("CpuEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrays)) {
+        return false;
+    }
+
     BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
     BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
 
@@ -202,8 +207,15 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
             Far::internal::GetBilinearWeights(param,
                                               coord.s, coord.t, wP, wDs, wDt);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriangleWeights(param,
+                                                    coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 3;
         } else {
-            assert(0);
             return false;
         }
 
@@ -251,6 +263,11 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
         if (srcDesc.length != dvDesc.length) return false;
     }
 
+    if (! CpuCheckPatchTypes("CpuEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrays)) {
+        return false;
+    }
+
     BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
     BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
     BufferAdapter<float>        duT(du,  duDesc.length,  duDesc.stride);
@@ -281,8 +298,16 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
             Far::internal::GetBilinearWeights(param,
                                               coord.s, coord.t, wP, wDs, wDt);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriangleWeights(param,
+                                                    coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 3;
         } else {
-            assert(0);
+            return false;
         }
 
         int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
@@ -350,6 +375,11 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
         if (srcDesc.length != dvvDesc.length) return false;
     }
 
+    if (! CpuCheckPatchTypes("CpuEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrays)) {
+        return false;
+    }
+
     BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
     BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
     BufferAdapter<float>       duT(du,   duDesc.length,  duDesc.stride);
@@ -386,8 +416,18 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
                                               coord.s, coord.t, wP, wDu, wDv,
                                               wDuu, wDuv, wDvv);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDu, wDv,
+                                          wDuu, wDuv, wDvv);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriangleWeights(param,
+                                                    coord.s, coord.t, wP, wDu, wDv,
+                                                    wDuu, wDuv, wDvv);
+            numControlVertices = 3;
         } else {
-            assert(0);
+            return false;
         }
 
         int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
@@ -24,6 +24,8 @@
 
 #include "../osd/cpuKernel.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/types.h"
+#include "../far/error.h"
 
 #include <cassert>
 #include <cmath>
@@ -239,6 +241,30 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     }
 }
 
+bool
+CpuCheckPatchTypes(char const * caller,
+                   int numPatchCoords,
+                   PatchCoord const * patchCoords,
+                   PatchArray const * patchArrays) {
+
+    for (int i = 0; i < numPatchCoords; ++i) {
+        int patchType =
+            patchArrays[patchCoords[i].handle.arrayIndex].GetPatchType();
+
+        if ((patchType != Far::PatchDescriptor::REGULAR) &&
+            (patchType != Far::PatchDescriptor::GREGORY_BASIS) &&
+            (patchType != Far::PatchDescriptor::QUADS) &&
+            (patchType != Far::PatchDescriptor::LOOP) &&
+            (patchType != Far::PatchDescriptor::TRIANGLES)) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                "Failure in %s -- patch type %d is not supported.",
+                caller, patchType);
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
@@ -34,6 +34,8 @@ namespace OPENSUBDIV_VERSION {
 namespace Osd {
 
 struct BufferDescriptor;
+struct PatchArray;
+struct PatchCoord;
 
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
@@ -76,6 +78,14 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvvWeights,
                 int start, int end);
 
+// Returns whether the patches of all patch coordinates are of a type the CPU
+// kernels evaluate, reporting an error on behalf of the caller otherwise
+bool
+CpuCheckPatchTypes(char const * caller,
+                   int numPatchCoords,
+                   PatchCoord const * patchCoords,
+                   PatchArray const * patchArrays);
+
 //
 // SIMD ICC optimization of the stencil kernel
 //
@@ -0,0 +1,478 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuPatchBVH.h"
+#include "../far/error.h"
+#include "../far/patchBasis.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    typedef Far::PatchTable::PatchHandle PatchHandle;
+
+    //
+    //  The depth of the hierarchy is limited by the nodes stacked when
+    //  traversing it, and the cost of traversing a node (relative to that of
+    //  intersecting a patch) is small:
+    //
+    int const   MAX_DEPTH      = 60;
+    float const TRAVERSAL_COST = 0.125f;
+
+    struct Bounds {
+        Bounds() {
+            for (int i = 0; i < 3; ++i) {
+                min[i] =  FLT_MAX;
+                max[i] = -FLT_MAX;
+            }
+        }
+
+        void Add(float const p[3]) {
+            for (int i = 0; i < 3; ++i) {
+                min[i] = std::min(min[i], p[i]);
+                max[i] = std::max(max[i], p[i]);
+            }
+        }
+        void Add(float const bMin[3], float const bMax[3]) {
+            for (int i = 0; i < 3; ++i) {
+                min[i] = std::min(min[i], bMin[i]);
+                max[i] = std::max(max[i], bMax[i]);
+            }
+        }
+
+        float GetHalfArea() const {
+            if (min[0] > max[0]) return 0.0f;
+
+            float dx = max[0] - min[0];
+            float dy = max[1] - min[1];
+            float dz = max[2] - min[2];
+            return dx * dy + dy * dz + dz * dx;
+        }
+
+        float min[3];
+        float max[3];
+    };
+
+    //  Gathers the positions of the control points of a patch:
+    inline void
+    gatherPoints(float const * src, int stride, Far::Index const * cvs,
+                 int numPoints, float points[][3]) {
+
+        for (int i = 0; i < numPoints; ++i) {
+            float const * p = src + cvs[i] * stride;
+            points[i][0] = p[0];
+            points[i][1] = p[1];
+            points[i][2] = p[2];
+        }
+    }
+
+    //  Replaces the points of a patch with those of its basis when missing
+    //  points are extrapolated at boundaries:
+    template <int N>
+    inline void
+    combineBasisPoints(float const wPoints[N][N], float points[N][3]) {
+
+        float basisPoints[N][3];
+        for (int i = 0; i < N; ++i) {
+            basisPoints[i][0] = basisPoints[i][1] = basisPoints[i][2] = 0.0f;
+            for (int j = 0; j < N; ++j) {
+                float w = wPoints[i][j];
+                if (w == 0.0f) continue;
+
+                basisPoints[i][0] += w * points[j][0];
+                basisPoints[i][1] += w * points[j][1];
+                basisPoints[i][2] += w * points[j][2];
+            }
+        }
+        std::copy(&basisPoints[0][0], &basisPoints[0][0] + N * 3, &points[0][0]);
+    }
+
+    //  Converts the 4x4 points of a B-spline patch to those of the equivalent
+    //  Bezier patch -- converting the rows and then the columns as curves:
+    inline void
+    convertBSplineToBezier(float points[16][3]) {
+
+        for (int pass = 0; pass < 2; ++pass) {
+            int step   = pass ? 4 : 1;
+            int stride = pass ? 1 : 4;
+
+            for (int i = 0; i < 4; ++i) {
+                float * p0 = points[i * stride];
+                float * p1 = points[i * stride + step];
+                float * p2 = points[i * stride + 2 * step];
+                float * p3 = points[i * stride + 3 * step];
+
+                for (int k = 0; k < 3; ++k) {
+                    float b0 = (p0[k] + 4.0f * p1[k] + p2[k]) / 6.0f;
+                    float b1 = (2.0f * p1[k] + p2[k]) / 3.0f;
+                    float b2 = (p1[k] + 2.0f * p2[k]) / 3.0f;
+                    float b3 = (p1[k] + 4.0f * p2[k] + p3[k]) / 6.0f;
+                    p0[k] = b0;
+                    p1[k] = b1;
+                    p2[k] = b2;
+                    p3[k] = b3;
+                }
+            }
+        }
+    }
+
+    //  Bins of the centroids of patches in which node splits are sought:
+    struct Bin {
+        Bin() : count(0) { }
+
+        Bounds bounds;
+        int    count;
+    };
+}
+
+CpuPatchBVH::CpuPatchBVH(Far::PatchTable const & patchTable) :
+    _isSupported(true) {
+
+    //
+    //  Identify the patches and their control points -- regular patches of
+    //  Gregory basis arrays are bounded as B-spline patches:
+    //
+    _patchVertexOffsets.push_back(0);
+
+    for (int array = 0; array < patchTable.GetNumPatchArrays(); ++array) {
+        Far::PatchDescriptor desc = patchTable.GetPatchArrayDescriptor(array);
+        Far::PatchDescriptor::Type type = desc.GetType();
+
+        if ((type != Far::PatchDescriptor::REGULAR) &&
+            (type != Far::PatchDescriptor::GREGORY_BASIS) &&
+            (type != Far::PatchDescriptor::LOOP) &&
+            (type != Far::PatchDescriptor::QUADS) &&
+            (type != Far::PatchDescriptor::TRIANGLES)) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                "Failure in CpuPatchBVH::CpuPatchBVH() -- "
+                "patch type %d is not supported.", (int)type);
+            _isSupported = false;
+            _patchHandles.clear();
+            return;
+        }
+
+        int numCVs = desc.GetNumControlVertices();
+
+        for (int i = 0; i < patchTable.GetNumPatches(array); ++i) {
+            PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = (Far::Index)_patchHandles.size();
+            handle.vertIndex  = i * numCVs;
+
+            Far::PatchParam param = patchTable.GetPatchParam(array, i);
+
+            bool isRegular = (type == Far::PatchDescriptor::GREGORY_BASIS) &&
+                             param.IsRegular();
+
+            Far::ConstIndexArray cvs = patchTable.GetPatchVertices(array, i);
+            int numPoints = isRegular ? 16 : numCVs;
+
+            _patchHandles.push_back(handle);
+            _patchParams.push_back(param);
+            _patchTypes.push_back((unsigned char)
+                (isRegular ? Far::PatchDescriptor::REGULAR : type));
+            _patchVertices.insert(_patchVertices.end(), &cvs[0], &cvs[0] + numPoints);
+            _patchVertexOffsets.push_back((int)_patchVertices.size());
+        }
+    }
+}
+
+CpuPatchBVH::~CpuPatchBVH() {
+}
+
+bool
+CpuPatchBVH::computePatchBounds(float const * src, BufferDescriptor const & srcDesc) {
+
+    if (!_isSupported || !src || (srcDesc.length < 3)) return false;
+
+    src += srcDesc.offset;
+
+    int numPatches = GetNumPatches();
+    int stride     = srcDesc.stride;
+
+    _patchBounds.resize(numPatches * 6);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static, 256)
+#endif
+    for (int patch = 0; patch < numPatches; ++patch) {
+        Far::PatchParam const & param = _patchParams[patch];
+
+        Far::Index const * cvs = &_patchVertices[_patchVertexOffsets[patch]];
+        int numPoints = _patchVertexOffsets[patch + 1] - _patchVertexOffsets[patch];
+
+        float points[20][3];
+        gatherPoints(src, stride, cvs, numPoints, points);
+
+        if (_patchTypes[patch] == Far::PatchDescriptor::REGULAR) {
+            if (param.GetBoundary()) {
+                float wPoints[16][16];
+                Far::internal::GetBSplineBasisPointWeights(param, wPoints);
+                combineBasisPoints<16>(wPoints, points);
+            }
+            convertBSplineToBezier(points);
+        } else if (_patchTypes[patch] == Far::PatchDescriptor::LOOP) {
+            if (param.GetBoundary()) {
+                float wPoints[12][12];
+                Far::internal::GetLoopBasisPointWeights(param, wPoints);
+                combineBasisPoints<12>(wPoints, points);
+            }
+        }
+
+        Bounds bounds;
+        for (int i = 0; i < numPoints; ++i) {
+            bounds.Add(points[i]);
+        }
+
+        float * patchBounds = &_patchBounds[patch * 6];
+        std::copy(bounds.min, bounds.min + 3, patchBounds);
+        std::copy(bounds.max, bounds.max + 3, patchBounds + 3);
+    }
+    return true;
+}
+
+bool
+CpuPatchBVH::Build(float const * src, BufferDescriptor const & srcDesc,
+                   Options const & options) {
+
+    _nodes.clear();
+    _leafPatches.clear();
+    _depthOffsets.clear();
+
+    if (!computePatchBounds(src, srcDesc)) return false;
+
+    if (GetNumPatches() > 0) {
+        buildNodes(options);
+    }
+    return true;
+}
+
+bool
+CpuPatchBVH::Refit(float const * src, BufferDescriptor const & srcDesc) {
+
+    if (_nodes.empty() && (GetNumPatches() > 0)) return false;
+
+    if (!computePatchBounds(src, srcDesc)) return false;
+
+    refitNodes();
+    return true;
+}
+
+void
+CpuPatchBVH::buildNodes(Options const & options) {
+
+    int numPatches = GetNumPatches();
+    int maxLeaf    = std::max(options.maxLeafPatches, 1);
+    int numBins    = std::max(options.numBins, 2);
+
+    std::vector<float> centroids(numPatches * 3);
+    for (int patch = 0; patch < numPatches; ++patch) {
+        float const * b = &_patchBounds[patch * 6];
+        for (int i = 0; i < 3; ++i) {
+            centroids[patch * 3 + i] = 0.5f * (b[i] + b[3 + i]);
+        }
+    }
+
+    _leafPatches.resize(numPatches);
+    for (int patch = 0; patch < numPatches; ++patch) {
+        _leafPatches[patch] = patch;
+    }
+
+    //
+    //  Nodes are split in the order created, ordering them breadth first --
+    //  the range of patches of each is retained until it is split:
+    //
+    std::vector<int> nodeBegins(1, 0);
+    std::vector<int> nodeEnds(1, numPatches);
+    std::vector<int> nodeDepths(1, 0);
+
+    _nodes.resize(1);
+
+    std::vector<Bin> bins(numBins);
+    std::vector<Bounds> rightBounds(numBins);
+
+    for (int n = 0; n < (int)_nodes.size(); ++n) {
+        int begin = nodeBegins[n];
+        int end   = nodeEnds[n];
+        int count = end - begin;
+        int depth = nodeDepths[n];
+
+        Bounds bounds, centroidBounds;
+        for (int i = begin; i < end; ++i) {
+            int patch = _leafPatches[i];
+            bounds.Add(&_patchBounds[patch * 6], &_patchBounds[patch * 6 + 3]);
+            centroidBounds.Add(&centroids[patch * 3]);
+        }
+        std::copy(bounds.min, bounds.min + 3, _nodes[n].boundsMin);
+        std::copy(bounds.max, bounds.max + 3, _nodes[n].boundsMax);
+
+        _nodes[n].index      = begin;
+        _nodes[n].numPatches = count;
+
+        if ((count == 1) || (depth == MAX_DEPTH - 1)) continue;
+
+        //
+        //  Seek the split of the binned centroids of least cost along each axis:
+        //
+        int   bestAxis = -1;
+        int   bestBin  = -1;
+        float bestCost = FLT_MAX;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            float cMin   = centroidBounds.min[axis];
+            float extent = centroidBounds.max[axis] - cMin;
+            if (extent <= 0.0f) continue;
+
+            float binScale = (float)numBins / extent;
+
+            std::fill(bins.begin(), bins.end(), Bin());
+            for (int i = begin; i < end; ++i) {
+                int patch = _leafPatches[i];
+                int bin = std::min((int)((centroids[patch * 3 + axis] - cMin) * binScale),
+                                   numBins - 1);
+                bins[bin].bounds.Add(&_patchBounds[patch * 6], &_patchBounds[patch * 6 + 3]);
+                ++bins[bin].count;
+            }
+
+            Bounds right;
+            for (int bin = numBins - 1; bin > 0; --bin) {
+                right.Add(bins[bin].bounds.min, bins[bin].bounds.max);
+                rightBounds[bin] = right;
+            }
+
+            Bounds left;
+            int    leftCount = 0;
+            for (int bin = 0; bin < numBins - 1; ++bin) {
+                left.Add(bins[bin].bounds.min, bins[bin].bounds.max);
+                leftCount += bins[bin].count;
+                if ((leftCount == 0) || (leftCount == count)) continue;
+
+                float cost = left.GetHalfArea() * (float)leftCount +
+                             rightBounds[bin + 1].GetHalfArea() * (float)(count - leftCount);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin  = bin;
+                }
+            }
+        }
+
+        //  Retain a leaf if small enough and not worth splitting, otherwise split
+        //  as chosen (or in half if the centroids are coincident):
+        int middle = begin + count / 2;
+        if (bestAxis >= 0) {
+            float nodeArea = bounds.GetHalfArea();
+            if ((count <= maxLeaf) &&
+                (TRAVERSAL_COST * nodeArea + bestCost >= nodeArea * (float)count)) {
+                continue;
+            }
+
+            float cMin     = centroidBounds.min[bestAxis];
+            float binScale = (float)numBins / (centroidBounds.max[bestAxis] - cMin);
+
+            int * first = &_leafPatches[0] + begin;
+            int * last  = &_leafPatches[0] + end;
+            for (int * p = first; p != last; ) {
+                int bin = std::min((int)((centroids[*p * 3 + bestAxis] - cMin) * binScale),
+                                   numBins - 1);
+                if (bin <= bestBin) {
+                    ++p;
+                } else {
+                    std::swap(*p, *--last);
+                }
+            }
+            middle = (int)(last - &_leafPatches[0]);
+            assert((middle > begin) && (middle < end));
+        } else if (count <= maxLeaf) {
+            continue;
+        }
+
+        _nodes[n].index      = (int)_nodes.size();
+        _nodes[n].numPatches = 0;
+
+        _nodes.resize(_nodes.size() + 2);
+
+        nodeBegins.push_back(begin);
+        nodeEnds.push_back(middle);
+        nodeBegins.push_back(middle);
+        nodeEnds.push_back(end);
+        nodeDepths.push_back(depth + 1);
+        nodeDepths.push_back(depth + 1);
+    }
+
+    //  Identify the consecutive nodes of each depth:
+    for (int n = 0; n < (int)_nodes.size(); ++n) {
+        if (nodeDepths[n] == (int)_depthOffsets.size()) {
+            _depthOffsets.push_back(n);
+        }
+    }
+    _depthOffsets.push_back((int)_nodes.size());
+}
+
+void
+CpuPatchBVH::refitNodes() {
+
+    //
+    //  Refit the nodes of each depth in parallel, deepest first -- the children
+    //  of interior nodes being refit before them:
+    //
+    for (int depth = (int)_depthOffsets.size() - 2; depth >= 0; --depth) {
+        int begin = _depthOffsets[depth];
+        int end   = _depthOffsets[depth + 1];
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(static, 256) if (end - begin > 256)
+#endif
+        for (int n = begin; n < end; ++n) {
+            Node & node = _nodes[n];
+
+            Bounds bounds;
+            if (node.IsLeaf()) {
+                for (int i = 0; i < node.numPatches; ++i) {
+                    float const * b = &_patchBounds[_leafPatches[node.index + i] * 6];
+                    bounds.Add(b, b + 3);
+                }
+            } else {
+                for (int i = 0; i < 2; ++i) {
+                    Node const & child = _nodes[node.index + i];
+                    bounds.Add(child.boundsMin, child.boundsMax);
+                }
+            }
+            std::copy(bounds.min, bounds.min + 3, node.boundsMin);
+            std::copy(bounds.max, bounds.max + 3, node.boundsMax);
+        }
+    }
+}
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,300 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_PATCH_BVH_H
+#define OPENSUBDIV3_OSD_CPU_PATCH_BVH_H
+
+#include "../version.h"
+
+#include "../far/patchParam.h"
+#include "../far/patchTable.h"
+#include "../osd/bufferDescriptor.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Bounding volume hierarchy over the patches of a PatchTable, e.g.
+///        to intersect rays with the limit surface on the CPU
+///
+/// The bounds of each patch are computed from its control points and are
+/// conservative:  B-spline patches are bounded by the hull of their Bezier
+/// points (extrapolating points missing at boundaries), Gregory basis and
+/// Loop patches by the hull of their control points, and bilinear patches by
+/// their vertices.  Legacy Gregory and eigen basis patches are not supported.
+///
+/// The hierarchy is built with the surface area heuristic and can be refit
+/// to new control point data -- e.g. as the control points are animated --
+/// without being rebuilt.  Patch bounds are computed and the hierarchy refit
+/// in parallel when OpenMP is enabled.
+///
+/// Control point data includes the local points of the PatchTable, as with
+/// CpuEvaluator::EvalPatches(), i.e. the refined vertices followed by the
+/// values of PatchTable::ComputeLocalPointValues() or its stencil table.
+///
+class CpuPatchBVH {
+
+public:
+
+    struct Options {
+
+        Options() : maxLeafPatches(4), numBins(16) { }
+
+        int maxLeafPatches;     ///< Maximum number of patches of leaf nodes
+        int numBins;            ///< Number of bins in which the split of each
+                                ///< node is sought
+    };
+
+    ///
+    /// \brief A node of the hierarchy -- the children of interior nodes are
+    ///        consecutive, and nodes are ordered breadth first
+    ///
+    struct Node {
+
+        /// \brief Returns true if the node is a leaf
+        bool IsLeaf() const { return numPatches > 0; }
+
+        float boundsMin[3];
+        float boundsMax[3];
+
+        int   index;        ///< First child node (interior) or first entry of
+                            ///< its patches in GetLeafPatches() (leaf)
+        int   numPatches;   ///< Number of patches of a leaf (zero if interior)
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param patchTable  PatchTable whose patches are bounded
+    ///
+    CpuPatchBVH(Far::PatchTable const & patchTable);
+
+    /// \brief Destructor
+    ~CpuPatchBVH();
+
+    /// \brief Returns the number of patches bounded
+    int GetNumPatches() const { return (int)_patchHandles.size(); }
+
+    /// \brief Returns the handle of a patch, e.g. to evaluate it
+    Far::PatchTable::PatchHandle const & GetPatchHandle(int patch) const {
+        return _patchHandles[patch];
+    }
+
+    /// \brief Returns the bounds of a patch -- its minimum followed by its
+    ///        maximum coordinates
+    float const * GetPatchBounds(int patch) const {
+        return &_patchBounds[patch * 6];
+    }
+
+    /// \brief Builds the hierarchy for the given control point data
+    ///
+    /// @param src      Control point data of the PatchTable (including any
+    ///                 local points) -- the first three floats of each are
+    ///                 the positions bounded
+    ///
+    /// @param srcDesc  Vertex buffer descriptor for the control point data
+    ///
+    /// @param options  Options controlling the construction
+    ///
+    /// @return         False if the PatchTable or given data is unsupported
+    ///
+    bool Build(float const * src, BufferDescriptor const & srcDesc,
+               Options const & options = Options());
+
+    /// \brief Refits the bounds of the patches and nodes of the hierarchy to
+    ///        new control point data, retaining its structure
+    ///
+    /// @param src      Control point data of the PatchTable (as with Build())
+    ///
+    /// @param srcDesc  Vertex buffer descriptor for the control point data
+    ///
+    /// @return         False if not yet built or the given data is unsupported
+    ///
+    bool Refit(float const * src, BufferDescriptor const & srcDesc);
+
+    /// \brief Returns the number of nodes -- the first of which is the root
+    int GetNumNodes() const { return (int)_nodes.size(); }
+
+    /// \brief Returns a node of the hierarchy
+    Node const & GetNode(int node) const { return _nodes[node]; }
+
+    /// \brief Returns the patches of all leaf nodes
+    std::vector<int> const & GetLeafPatches() const { return _leafPatches; }
+
+    /// \brief Traverses the hierarchy along a ray, nearest nodes first
+    ///
+    /// The intersector is invoked for each patch whose bounds intersect the
+    /// ray as bool intersector(int patch, float & tMax), returning true if
+    /// the ray hits the patch before tMax -- in which case it reduces tMax
+    /// to that of the hit to cull the patches and nodes beyond it.
+    ///
+    /// @param origin       Origin of the ray
+    ///
+    /// @param direction    Direction of the ray (need not be normalized)
+    ///
+    /// @param tMax         Maximum parameter of the ray -- updated with that
+    ///                     of the nearest hit
+    ///
+    /// @param intersector  Functor intersecting the ray with a patch
+    ///
+    /// @return             True if any patch was hit
+    ///
+    template <class INTERSECTOR>
+    bool Intersect(float const origin[3], float const direction[3],
+                   float & tMax, INTERSECTOR & intersector) const;
+
+private:
+
+    bool computePatchBounds(float const * src, BufferDescriptor const & srcDesc);
+
+    void buildNodes(Options const & options);
+
+    void refitNodes();
+
+    static bool intersectBounds(float const boundsMin[3], float const boundsMax[3],
+                                float const origin[3], float const invDirection[3],
+                                float tMax, float & tEntry);
+
+private:
+
+    bool _isSupported;
+
+    //  Patches -- their type (resolving regular patches of other arrays) and
+    //  parameterization, and their control points:
+    std::vector<Far::PatchTable::PatchHandle> _patchHandles;
+    std::vector<Far::PatchParam>              _patchParams;
+    std::vector<unsigned char>                _patchTypes;
+    std::vector<int>                          _patchVertexOffsets;
+    std::vector<Far::Index>                   _patchVertices;
+
+    std::vector<float> _patchBounds;
+
+    //  Nodes and the patches of their leaves -- the nodes of each depth are
+    //  consecutive, from which they are refit in parallel:
+    std::vector<Node> _nodes;
+    std::vector<int>  _leafPatches;
+    std::vector<int>  _depthOffsets;
+};
+
+inline bool
+CpuPatchBVH::intersectBounds(float const boundsMin[3], float const boundsMax[3],
+                             float const origin[3], float const invDirection[3],
+                             float tMax, float & tEntry) {
+
+    float tNear = 0.0f;
+    float tFar  = tMax;
+    for (int i = 0; i < 3; ++i) {
+        float t0 = (boundsMin[i] - origin[i]) * invDirection[i];
+        float t1 = (boundsMax[i] - origin[i]) * invDirection[i];
+        if (t0 > t1) {
+            float t = t0; t0 = t1; t1 = t;
+        }
+        tNear = (t0 > tNear) ? t0 : tNear;
+        tFar  = (t1 < tFar)  ? t1 : tFar;
+        if (tNear > tFar) return false;
+    }
+    tEntry = tNear;
+    return true;
+}
+
+template <class INTERSECTOR>
+inline bool
+CpuPatchBVH::Intersect(float const origin[3], float const direction[3],
+                       float & tMax, INTERSECTOR & intersector) const {
+
+    if (_nodes.empty()) return false;
+
+    float invDirection[3];
+    for (int i = 0; i < 3; ++i) {
+        invDirection[i] = 1.0f / direction[i];
+    }
+
+    //  The depth of the hierarchy is limited, bounding the nodes stacked --
+    //  each with the parameter at which the ray enters it:
+    struct Entry {
+        int   node;
+        float tEntry;
+    } stack[64];
+
+    int stackSize = 0;
+
+    float tEntry = 0.0f;
+    if (!intersectBounds(_nodes[0].boundsMin, _nodes[0].boundsMax,
+                         origin, invDirection, tMax, tEntry)) {
+        return false;
+    }
+    stack[stackSize].node   = 0;
+    stack[stackSize].tEntry = tEntry;
+    ++stackSize;
+
+    bool hit = false;
+    while (stackSize > 0) {
+        --stackSize;
+        if (stack[stackSize].tEntry > tMax) continue;
+
+        Node const & node = _nodes[stack[stackSize].node];
+        if (node.IsLeaf()) {
+            for (int i = 0; i < node.numPatches; ++i) {
+                int patch = _leafPatches[node.index + i];
+
+                float const * bounds = &_patchBounds[patch * 6];
+                if (intersectBounds(bounds, bounds + 3, origin, invDirection, tMax, tEntry) &&
+                    intersector(patch, tMax)) {
+                    hit = true;
+                }
+            }
+            continue;
+        }
+
+        //  Stack the children intersected, the nearer last to visit it first:
+        float tChild[2];
+        bool  isHit[2];
+        for (int i = 0; i < 2; ++i) {
+            Node const & child = _nodes[node.index + i];
+            isHit[i] = intersectBounds(child.boundsMin, child.boundsMax,
+                                       origin, invDirection, tMax, tChild[i]);
+        }
+        int nearer = (isHit[0] && isHit[1] && (tChild[1] < tChild[0])) ? 1 : 0;
+        for (int i = 0; i < 2; ++i) {
+            int c = (i == 0) ? (1 - nearer) : nearer;
+            if (isHit[c]) {
+                stack[stackSize].node   = node.index + c;
+                stack[stackSize].tEntry = tChild[c];
+                ++stackSize;
+            }
+        }
+    }
+    return hit;
+}
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_OSD_CPU_PATCH_BVH_H */
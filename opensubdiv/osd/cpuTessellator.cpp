@@ -0,0 +1,815 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuTessellator.h"
+#include "../osd/cpuEvaluator.h"
+#include "../far/error.h"
+#include "../far/patchTable.h"
+#include "../far/ptexIndices.h"
+#include "../far/topologyRefiner.h"
+#include "../sdc/types.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    typedef Far::PatchTable::PatchHandle PatchHandle;
+
+    //
+    //  Points are located by fixed-point coordinates within the ptex face of a
+    //  patch.  Patch parameters are limited to 10 levels, so 12 bits leave room
+    //  for the midpoints of the segments of transition edges:
+    //
+    int const FIXED_LEVEL = 12;
+    int const FIXED_ONE   = 1 << FIXED_LEVEL;
+
+    //
+    //  Key identifying a point independent of the ptex face locating it -- points
+    //  on the vertices and edges of the base level are identified by those (with
+    //  points on edges in units of half a ptex face so that the sub-faces of
+    //  irregular faces match those of quads), as are points on the "spokes" from
+    //  the midpoints of the edges of irregular faces to their centers.  Faces of
+    //  the regular size of the scheme -- quads or triangles -- are ptex faces:
+    //
+    enum PointType {
+        POINT_VERTEX,
+        POINT_EDGE,
+        POINT_SPOKE,
+        POINT_CENTER,
+        POINT_FACE
+    };
+
+    struct PointKey {
+        PointKey() : component(0), location(0) { }
+        PointKey(PointType type, int index, int a, int b) :
+            component(((unsigned int)type << 29) | (unsigned int)index),
+            location(((unsigned int)a << 16) | (unsigned int)b) { }
+
+        bool operator==(PointKey const & other) const {
+            return (component == other.component) && (location == other.location);
+        }
+        bool operator<(PointKey const & other) const {
+            return (component != other.component) ? (component < other.component) :
+                                                    (location < other.location);
+        }
+
+        unsigned int component;
+        unsigned int location;
+    };
+
+    class PointKeyFactory {
+    public:
+        PointKeyFactory(Far::TopologyRefiner const & refiner, int regularFaceSize);
+
+        PointKey GetKey(int ptexFace, int a, int b) const;
+
+        bool IsSubFace(int ptexFace) const { return _ptexSubFaces[ptexFace] >= 0; }
+
+    private:
+        PointKey getEdgeKey(Far::Index face, int faceEdge, int t) const;
+
+        Far::TopologyLevel const & _level;
+
+        std::vector<Far::Index> _ptexBaseFaces;
+        std::vector<int>   _ptexSubFaces;
+    };
+
+    PointKeyFactory::PointKeyFactory(Far::TopologyRefiner const & refiner,
+                                     int regularFaceSize) :
+        _level(refiner.GetLevel(0)) {
+
+        Far::PtexIndices ptexIndices(refiner);
+
+        _ptexBaseFaces.resize(ptexIndices.GetNumFaces());
+        _ptexSubFaces.resize(ptexIndices.GetNumFaces());
+        for (Far::Index face = 0; face < _level.GetNumFaces(); ++face) {
+            int ptexFace = ptexIndices.GetFaceId(face);
+            int faceSize = _level.GetFaceVertices(face).size();
+            if (faceSize == regularFaceSize) {
+                _ptexBaseFaces[ptexFace] = face;
+                _ptexSubFaces[ptexFace]  = -1;
+            } else {
+                for (int i = 0; i < faceSize; ++i) {
+                    _ptexBaseFaces[ptexFace + i] = face;
+                    _ptexSubFaces[ptexFace + i]  = i;
+                }
+            }
+        }
+    }
+
+    PointKey
+    PointKeyFactory::getEdgeKey(Far::Index face, int faceEdge, int t) const {
+
+        //  The position t is oriented with the face -- orient it with the edge:
+        Far::Index edge = _level.GetFaceEdges(face)[faceEdge];
+        if (_level.GetEdgeVertices(edge)[0] != _level.GetFaceVertices(face)[faceEdge]) {
+            t = 2 * FIXED_ONE - t;
+        }
+        return PointKey(POINT_EDGE, edge, 0, t);
+    }
+
+    PointKey
+    PointKeyFactory::GetKey(int ptexFace, int a, int b) const {
+
+        int const R = FIXED_ONE;
+
+        Far::Index      face   = _ptexBaseFaces[ptexFace];
+        int             sub    = _ptexSubFaces[ptexFace];
+        Far::ConstIndexArray fVerts = _level.GetFaceVertices(face);
+
+        if ((sub < 0) && (fVerts.size() == 3)) {
+            //  Corners of the triangle are its vertices and its sides its edges,
+            //  the second oriented along b and the third opposite it:
+            if ((b == 0) && ((a == 0) || (a == R))) {
+                return PointKey(POINT_VERTEX, fVerts[(a == 0) ? 0 : 1], 0, 0);
+            }
+            if ((a == 0) && (b == R)) return PointKey(POINT_VERTEX, fVerts[2], 0, 0);
+
+            if (b == 0)     return getEdgeKey(face, 0, 2 * a);
+            if (a + b == R) return getEdgeKey(face, 1, 2 * b);
+            if (a == 0)     return getEdgeKey(face, 2, 2 * (R - b));
+        } else if (sub < 0) {
+            //  Corners of the quad are its vertices and its sides its edges, the
+            //  last two of which are oriented opposite the ptex parameterization:
+            if (((a == 0) || (a == R)) && ((b == 0) || (b == R))) {
+                int corner = (b == 0) ? ((a == 0) ? 0 : 1) : ((a == R) ? 2 : 3);
+                return PointKey(POINT_VERTEX, fVerts[corner], 0, 0);
+            }
+            if (b == 0) return getEdgeKey(face, 0, 2 * a);
+            if (a == R) return getEdgeKey(face, 1, 2 * b);
+            if (b == R) return getEdgeKey(face, 2, 2 * (R - a));
+            if (a == 0) return getEdgeKey(face, 3, 2 * (R - b));
+        } else {
+            //  The sub-face of an irregular face spans its vertex, the first half
+            //  of the following edge, the face center and the second half of the
+            //  preceding edge -- the other sides are the spokes of both edges:
+            int prev = (sub ? sub : fVerts.size()) - 1;
+
+            if ((a == 0) && (b == 0)) return PointKey(POINT_VERTEX, fVerts[sub], 0, 0);
+            if ((a == R) && (b == R)) return PointKey(POINT_CENTER, face, 0, 0);
+
+            if (b == 0) return getEdgeKey(face, sub,  a);
+            if (a == 0) return getEdgeKey(face, prev, 2 * R - b);
+            if (a == R) return PointKey(POINT_SPOKE, face, sub,  b);
+            if (b == R) return PointKey(POINT_SPOKE, face, prev, a);
+        }
+        return PointKey(POINT_FACE, ptexFace, a, b);
+    }
+
+    //
+    //  Points and segments of patches to be sorted and shared -- segments are
+    //  identified by their midpoints:
+    //
+    struct PointEntry {
+        bool operator<(PointEntry const & other) const {
+            return (key == other.key) ? (slot < other.slot) : (key < other.key);
+        }
+
+        PointKey key;
+        int      slot;
+        int      a, b;
+    };
+
+    struct SegmentEntry {
+        bool operator<(SegmentEntry const & other) const {
+            return (key == other.key) ? (slot < other.slot) : (key < other.key);
+        }
+
+        PointKey key;
+        int      slot;
+        PointKey endKeys[2];
+        int      endPoints[2];
+        int      endCoords[4];
+        int      level;
+    };
+
+    inline PatchCoord
+    lerpCoord(PatchCoord const & c0, PatchCoord const & c1, float t) {
+        return PatchCoord(c0.handle, c0.s + (c1.s - c0.s) * t, c0.t + (c1.t - c0.t) * t);
+    }
+
+    //
+    //  Metrics determining the rate of a segment from its end and midpoints:
+    //
+    inline float
+    computeDistance(float const * p0, float const * p1) {
+        float d[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    }
+
+    inline void
+    transformPoint(float const m[16], float const * p, float dst[3]) {
+        for (int i = 0; i < 3; ++i) {
+            dst[i] = m[i] * p[0] + m[4 + i] * p[1] + m[8 + i] * p[2] + m[12 + i];
+        }
+    }
+
+    //  As with the GLSL patch shaders, the diameter of the bounding sphere of an
+    //  edge is projected rather than the edge itself to behave near silhouettes:
+    inline float
+    computeProjectedLength(CpuTessellator::Options const & options,
+                           float const * p0, float const * p1) {
+
+        float e0[3], e1[3];
+        transformPoint(options.modelViewMatrix, p0, e0);
+        transformPoint(options.modelViewMatrix, p1, e1);
+
+        float center[3] = { 0.5f * (e0[0] + e1[0]), 0.5f * (e0[1] + e1[1]), 0.5f * (e0[2] + e1[2]) };
+        float diameter  = computeDistance(e0, e1);
+
+        float const * P = options.projectionMatrix;
+        float w = P[3] * center[0] + P[7] * center[1] + P[11] * center[2] + P[15];
+        if (w == 0.0f) {
+            return (diameter > 0.0f) ? (float)options.maxTessLevel * options.edgeLength : 0.0f;
+        }
+        return std::fabs(diameter * P[5] / w) * 0.5f * options.viewportHeight;
+    }
+
+    inline int
+    clampRate(float rate, int maxRate) {
+        return (rate >= (float)maxRate) ? maxRate : std::max(1, (int)std::ceil(rate));
+    }
+
+    //  Index of the point (i, j) in the inner grid of a triangular patch, whose
+    //  rows j = 1 to rate - 2 each hold the points i = 1 to rate - 1 - j:
+    inline int
+    triangleGridIndex(int rate, int i, int j) {
+        return (j - 1) * (rate - 1) - ((j - 1) * j) / 2 + (i - 1);
+    }
+}
+
+CpuTessellator::Options::Options() :
+    mode(TESS_UNIFORM), tessLevel(1), edgeLength(1.0f), maxTessLevel(64), viewportHeight(1.0f) {
+
+    for (int i = 0; i < 16; ++i) {
+        modelViewMatrix[i] = projectionMatrix[i] = (i % 5) ? 0.0f : 1.0f;
+    }
+}
+
+CpuTessellator::CpuTessellator(Far::TopologyRefiner const & refiner,
+                               Far::PatchTable const & patchTable) :
+    _cpuPatchTable(&patchTable), _isSupported(true), _isTriangular(false) {
+
+    //
+    //  Identify the patches and their parameterization, which must be supported
+    //  -- patches of the Loop scheme are triangular, those of others quads:
+    //
+    int regularFaceSize = Sdc::SchemeTypeTraits::GetRegularFaceSize(refiner.GetSchemeType());
+
+    _isTriangular = (regularFaceSize == 3);
+
+    std::vector<Far::PatchParam> patchParams;
+
+    for (int array = 0; array < patchTable.GetNumPatchArrays(); ++array) {
+        Far::PatchDescriptor desc = patchTable.GetPatchArrayDescriptor(array);
+
+        bool isSupported = _isTriangular ?
+            ((desc.GetType() == Far::PatchDescriptor::LOOP) ||
+             (desc.GetType() == Far::PatchDescriptor::TRIANGLES)) :
+            ((desc.GetType() == Far::PatchDescriptor::REGULAR) ||
+             (desc.GetType() == Far::PatchDescriptor::GREGORY_BASIS) ||
+             (desc.GetType() == Far::PatchDescriptor::QUADS));
+        if (!isSupported) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                "Failure in CpuTessellator::CpuTessellator() -- "
+                "patch type %d is not supported.", (int)desc.GetType());
+            _isSupported = false;
+            _patchHandles.clear();
+            return;
+        }
+        for (int i = 0; i < patchTable.GetNumPatches(array); ++i) {
+            PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = (Far::Index)_patchHandles.size();
+            handle.vertIndex  = i * desc.GetNumControlVertices();
+
+            _patchHandles.push_back(handle);
+            patchParams.push_back(patchTable.GetPatchParam(array, i));
+        }
+    }
+    int numPatches = (int)_patchHandles.size();
+
+    //
+    //  Gather the corners of each patch and the segments of its edges, splitting
+    //  transition edges at their midpoints -- points are assigned slots 0-3 for
+    //  corners and 4-7 for the midpoints of edges, as are the segments of each
+    //  edge in pairs (leaving the last of each unused for triangles):
+    //
+    PointKeyFactory keyFactory(refiner, regularFaceSize);
+
+    int numCorners = regularFaceSize;
+
+    std::vector<PointEntry>   points;
+    std::vector<SegmentEntry> segments;
+    points.reserve(numPatches * 4);
+    segments.reserve(numPatches * 4);
+
+    for (int patch = 0; patch < numPatches; ++patch) {
+        Far::PatchParam const & param = patchParams[patch];
+
+        int ptexFace  = param.GetFaceId();
+        int level     = param.GetDepth() - (param.NonQuadRoot() ? 1 : 0);
+        int unit      = FIXED_ONE >> level;
+        int transMask = param.GetTransition();
+
+        int coords[8][2];
+        if (!_isTriangular) {
+            coords[0][0] = param.GetU() * unit;  coords[0][1] = param.GetV() * unit;
+            coords[1][0] = coords[0][0] + unit;  coords[1][1] = coords[0][1];
+            coords[2][0] = coords[0][0] + unit;  coords[2][1] = coords[0][1] + unit;
+            coords[3][0] = coords[0][0];         coords[3][1] = coords[0][1] + unit;
+        } else if (!param.IsTriangleRotated()) {
+            coords[0][0] = param.GetU() * unit;  coords[0][1] = param.GetV() * unit;
+            coords[1][0] = coords[0][0] + unit;  coords[1][1] = coords[0][1];
+            coords[2][0] = coords[0][0];         coords[2][1] = coords[0][1] + unit;
+        } else {
+            //  Rotated triangles are parameterized from their opposite corner:
+            int depthFactor = 1 << param.GetDepth();
+            coords[0][0] = (depthFactor - param.GetU()) * unit;
+            coords[0][1] = (depthFactor - param.GetV()) * unit;
+            coords[1][0] = coords[0][0] - unit;  coords[1][1] = coords[0][1];
+            coords[2][0] = coords[0][0];         coords[2][1] = coords[0][1] - unit;
+        }
+        for (int i = 0; i < numCorners; ++i) {
+            coords[4 + i][0] = (coords[i][0] + coords[(i + 1) % numCorners][0]) / 2;
+            coords[4 + i][1] = (coords[i][1] + coords[(i + 1) % numCorners][1]) / 2;
+        }
+
+        PointKey keys[8];
+        for (int i = 0; i < 4 + numCorners; ++i) {
+            if ((i < numCorners) || ((i >= 4) && ((transMask >> (i - 4)) & 1))) {
+                keys[i] = keyFactory.GetKey(ptexFace, coords[i][0], coords[i][1]);
+
+                PointEntry entry;
+                entry.key  = keys[i];
+                entry.slot = patch * 8 + i;
+                entry.a    = coords[i][0];
+                entry.b    = coords[i][1];
+                points.push_back(entry);
+            }
+        }
+
+        //  The level of a segment is that of its length relative to base edges:
+        int segmentLevel = level + (keyFactory.IsSubFace(ptexFace) ? 1 : 0);
+
+        for (int edge = 0; edge < numCorners; ++edge) {
+            bool isTransition = ((transMask >> edge) & 1) != 0;
+
+            int ends[3] = { edge, 4 + edge, (edge + 1) % numCorners };
+            if (!isTransition) ends[1] = ends[2];
+
+            for (int half = 0; half < (isTransition ? 2 : 1); ++half) {
+                int p0 = ends[half];
+                int p1 = ends[half + 1];
+
+                SegmentEntry entry;
+                entry.key = keyFactory.GetKey(ptexFace, (coords[p0][0] + coords[p1][0]) / 2,
+                                                        (coords[p0][1] + coords[p1][1]) / 2);
+                entry.slot         = patch * 8 + edge * 2 + half;
+                entry.endKeys[0]   = keys[p0];
+                entry.endKeys[1]   = keys[p1];
+                entry.endPoints[0] = patch * 8 + p0;
+                entry.endPoints[1] = patch * 8 + p1;
+                entry.endCoords[0] = coords[p0][0];
+                entry.endCoords[1] = coords[p0][1];
+                entry.endCoords[2] = coords[p1][0];
+                entry.endCoords[3] = coords[p1][1];
+                entry.level        = segmentLevel + (isTransition ? 1 : 0);
+                segments.push_back(entry);
+            }
+        }
+    }
+
+    //
+    //  Sort the points and segments to identify those shared -- the first patch
+    //  of each is chosen to evaluate it:
+    //
+    float const fixedScale = 1.0f / (float)FIXED_ONE;
+
+    std::sort(points.begin(), points.end());
+
+    _patchPoints.assign(numPatches * 8, -1);
+    for (int i = 0; i < (int)points.size(); ++i) {
+        PointEntry const & entry = points[i];
+        if ((i == 0) || !(entry.key == points[i - 1].key)) {
+            _pointCoords.push_back(PatchCoord(_patchHandles[entry.slot / 8],
+                entry.a * fixedScale, entry.b * fixedScale));
+        }
+        _patchPoints[entry.slot] = (int)_pointCoords.size() - 1;
+    }
+
+    std::sort(segments.begin(), segments.end());
+
+    _patchSegments.assign(numPatches * 8, -1);
+    int numSegments = 0;
+    for (int i = 0; i < (int)segments.size(); ++i) {
+        SegmentEntry const & entry = segments[i];
+
+        //  Orient each segment from the lesser of its end points:
+        int first = (entry.endKeys[1] < entry.endKeys[0]) ? 1 : 0;
+
+        if ((i == 0) || !(entry.key == segments[i - 1].key)) {
+            PatchHandle const & handle = _patchHandles[entry.slot / 8];
+
+            _segmentPoints.push_back(_patchPoints[entry.endPoints[first]]);
+            _segmentPoints.push_back(_patchPoints[entry.endPoints[1 - first]]);
+            _segmentCoords.push_back(PatchCoord(handle,
+                entry.endCoords[2 * first] * fixedScale, entry.endCoords[2 * first + 1] * fixedScale));
+            _segmentCoords.push_back(PatchCoord(handle,
+                entry.endCoords[2 - 2 * first] * fixedScale, entry.endCoords[3 - 2 * first] * fixedScale));
+            _segmentLevels.push_back((unsigned char)entry.level);
+            ++numSegments;
+        }
+        _patchSegments[entry.slot] = ((numSegments - 1) << 1) | first;
+    }
+}
+
+CpuTessellator::~CpuTessellator() {
+}
+
+void
+CpuTessellator::evalCoords(float const * src, BufferDescriptor const & srcDesc,
+                           PatchCoord const * coords, int numCoords, float * dst) const {
+
+    BufferDescriptor dstDesc(0, srcDesc.length, srcDesc.length);
+
+    int const chunkSize = 1024;
+    int numChunks = (numCoords + chunkSize - 1) / chunkSize;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
+        int first = chunk * chunkSize;
+
+        CpuEvaluator::EvalPatches(src, srcDesc,
+            dst + (size_t)first * srcDesc.length, dstDesc,
+            std::min(chunkSize, numCoords - first), coords + first,
+            _cpuPatchTable.GetPatchArrayBuffer(),
+            _cpuPatchTable.GetPatchIndexBuffer(),
+            _cpuPatchTable.GetPatchParamBuffer());
+    }
+}
+
+bool
+CpuTessellator::Tessellate(float const * src, BufferDescriptor const & srcDesc,
+                           Options const & options, Mesh & mesh) const {
+
+    int length = srcDesc.length;
+
+    mesh.length = length;
+    mesh.vertexValues.clear();
+    mesh.vertexCoords.clear();
+    mesh.triangles.clear();
+
+    if (!_isSupported || !src || (length <= 0)) return false;
+    if ((options.mode != TESS_UNIFORM) && (length < 3)) return false;
+
+    int numPatches  = GetNumPatches();
+    int numPoints   = (int)_pointCoords.size();
+    int numSegments = (int)_segmentLevels.size();
+    if (numPatches == 0) return true;
+
+    int maxRate = std::max(1, options.maxTessLevel);
+
+    //
+    //  Evaluate the points shared between patches -- the first vertices of the
+    //  mesh and those from which adaptive rates are determined:
+    //
+    mesh.vertexCoords.assign(_pointCoords.begin(), _pointCoords.end());
+    mesh.vertexValues.resize((size_t)numPoints * length);
+
+    evalCoords(src, srcDesc, &mesh.vertexCoords[0], numPoints, &mesh.vertexValues[0]);
+
+    //
+    //  Assign the rate of each segment, evaluating its midpoint when adaptive:
+    //
+    std::vector<int> segmentRates(numSegments);
+
+    if (options.mode == TESS_UNIFORM) {
+        for (int i = 0; i < numSegments; ++i) {
+            int level = _segmentLevels[i];
+            segmentRates[i] = std::min(maxRate,
+                std::max(1, (options.tessLevel + (1 << level) - 1) >> level));
+        }
+    } else {
+        std::vector<PatchCoord> midCoords(numSegments);
+        for (int i = 0; i < numSegments; ++i) {
+            midCoords[i] = lerpCoord(_segmentCoords[2 * i], _segmentCoords[2 * i + 1], 0.5f);
+        }
+        std::vector<float> midValues((size_t)numSegments * length);
+        evalCoords(src, srcDesc, &midCoords[0], numSegments, &midValues[0]);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for
+#endif
+        for (int i = 0; i < numSegments; ++i) {
+            float const * p0 = &mesh.vertexValues[(size_t)_segmentPoints[2 * i] * length];
+            float const * p1 = &mesh.vertexValues[(size_t)_segmentPoints[2 * i + 1] * length];
+            float const * pm = &midValues[(size_t)i * length];
+
+            float measure = (options.mode == TESS_EDGE_LENGTH) ?
+                (computeDistance(p0, pm) + computeDistance(pm, p1)) :
+                (computeProjectedLength(options, p0, pm) + computeProjectedLength(options, pm, p1));
+
+            segmentRates[i] = (options.edgeLength > 0.0f) ?
+                clampRate(measure / options.edgeLength, maxRate) : maxRate;
+        }
+    }
+
+    //
+    //  Assign the vertices interior to segments and patches, and the triangles
+    //  of patches -- the inner grid of a patch matches the rates of its edges
+    //  and is stitched to them (with no grid when all rates are 1).  The inner
+    //  grid of a triangular patch is a triangular lattice of its greatest rate:
+    //
+    int numCorners = _isTriangular ? 3 : 4;
+
+    std::vector<int> segmentOffsets(numSegments + 1);
+    segmentOffsets[0] = numPoints;
+    for (int i = 0; i < numSegments; ++i) {
+        segmentOffsets[i + 1] = segmentOffsets[i] + segmentRates[i] - 1;
+    }
+
+    std::vector<int> patchRates(numPatches * 2);
+    std::vector<int> patchOffsets(numPatches + 1);
+    std::vector<int> triangleOffsets(numPatches + 1);
+
+    patchOffsets[0]    = segmentOffsets[numSegments];
+    triangleOffsets[0] = 0;
+    for (int patch = 0; patch < numPatches; ++patch) {
+        int const * segments = &_patchSegments[patch * 8];
+
+        int edgeRates[4];
+        for (int edge = 0; edge < numCorners; ++edge) {
+            edgeRates[edge] = segmentRates[segments[2 * edge] >> 1] +
+                ((segments[2 * edge + 1] < 0) ? 0 : segmentRates[segments[2 * edge + 1] >> 1]);
+        }
+
+        int uRate, vRate;
+        int numInner = 0;
+        int numTriangles;
+        if (_isTriangular) {
+            uRate = std::max(edgeRates[0], std::max(edgeRates[1], edgeRates[2]));
+
+            numTriangles = 1;
+            if (uRate > 1) {
+                uRate = std::max(uRate, 3);
+
+                numInner     = ((uRate - 1) * (uRate - 2)) / 2;
+                numTriangles = (uRate - 3) * (uRate - 3);
+                for (int edge = 0; edge < 3; ++edge) {
+                    numTriangles += edgeRates[edge] + uRate - 3;
+                }
+            }
+            vRate = uRate;
+        } else {
+            uRate = std::max(edgeRates[0], edgeRates[2]);
+            vRate = std::max(edgeRates[1], edgeRates[3]);
+
+            numTriangles = 2;
+            if ((uRate > 1) || (vRate > 1)) {
+                uRate = std::max(uRate, 2);
+                vRate = std::max(vRate, 2);
+
+                numInner     = (uRate - 1) * (vRate - 1);
+                numTriangles = 2 * (uRate - 2) * (vRate - 2);
+                for (int edge = 0; edge < 4; ++edge) {
+                    numTriangles += edgeRates[edge] + ((edge & 1) ? vRate : uRate) - 2;
+                }
+            }
+        }
+        patchRates[2 * patch]     = uRate;
+        patchRates[2 * patch + 1] = vRate;
+
+        patchOffsets[patch + 1]    = patchOffsets[patch] + numInner;
+        triangleOffsets[patch + 1] = triangleOffsets[patch] + numTriangles;
+    }
+
+    int numVertices = patchOffsets[numPatches];
+
+    mesh.vertexCoords.resize(numVertices);
+    mesh.vertexValues.resize((size_t)numVertices * length);
+    mesh.triangles.resize(triangleOffsets[numPatches] * 3);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < numSegments; ++i) {
+        int rate = segmentRates[i];
+        for (int j = 1; j < rate; ++j) {
+            mesh.vertexCoords[segmentOffsets[i] + j - 1] = lerpCoord(
+                _segmentCoords[2 * i], _segmentCoords[2 * i + 1], (float)j / (float)rate);
+        }
+    }
+
+    PatchParam const * patchParams = _cpuPatchTable.GetPatchParamBuffer();
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int patch = 0; patch < numPatches; ++patch) {
+        int uRate = patchRates[2 * patch];
+        int vRate = patchRates[2 * patch + 1];
+
+        PatchCoord * coords = &mesh.vertexCoords[patchOffsets[patch]];
+        if (_isTriangular) {
+            for (int j = 1; j < vRate - 1; ++j) {
+                for (int i = 1; i < uRate - j; ++i) {
+                    float s = (float)i / (float)uRate;
+                    float t = (float)j / (float)uRate;
+                    patchParams[patch].UnnormalizeTriangle(s, t);
+
+                    *coords++ = PatchCoord(_patchHandles[patch], s, t);
+                }
+            }
+            continue;
+        }
+        for (int j = 1; j < vRate; ++j) {
+            for (int i = 1; i < uRate; ++i) {
+                float s = (float)i / (float)uRate;
+                float t = (float)j / (float)vRate;
+                patchParams[patch].Unnormalize(s, t);
+
+                *coords++ = PatchCoord(_patchHandles[patch], s, t);
+            }
+        }
+    }
+
+    evalCoords(src, srcDesc, &mesh.vertexCoords[numPoints], numVertices - numPoints,
+               &mesh.vertexValues[(size_t)numPoints * length]);
+
+    //
+    //  Triangulate each patch -- the inner grid is stitched to each edge in turn
+    //  by advancing along the edge or the side of the grid facing it, whichever
+    //  is behind, with both traversed counter-clockwise:
+    //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel
+#endif
+    {
+        std::vector<int>   outer, inner;
+        std::vector<float> outerParams, innerParams;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp for schedule(dynamic, 64)
+#endif
+        for (int patch = 0; patch < numPatches; ++patch) {
+            int const * points   = &_patchPoints[patch * 8];
+            int const * segments = &_patchSegments[patch * 8];
+
+            int uRate = patchRates[2 * patch];
+            int vRate = patchRates[2 * patch + 1];
+
+            int * triangles = &mesh.triangles[triangleOffsets[patch] * 3];
+
+            if (patchOffsets[patch + 1] == patchOffsets[patch]) {
+                int const tris[6] = { points[0], points[1], points[2],
+                                      points[0], points[2], points[3] };
+                std::copy(tris, tris + (_isTriangular ? 3 : 6), triangles);
+                continue;
+            }
+
+            int gridBase = patchOffsets[patch];
+            int gridSize = uRate - 1;
+
+            for (int edge = 0; edge < numCorners; ++edge) {
+                //  Gather the vertices along the edge from its segments:
+                int numHalves = (segments[2 * edge + 1] < 0) ? 1 : 2;
+
+                outer.clear();
+                outerParams.clear();
+                outer.push_back(points[edge]);
+                outerParams.push_back(0.0f);
+                for (int half = 0; half < numHalves; ++half) {
+                    int segment  = segments[2 * edge + half] >> 1;
+                    int reversed = segments[2 * edge + half] & 1;
+                    int rate     = segmentRates[segment];
+
+                    for (int j = 1; j < rate; ++j) {
+                        outer.push_back(segmentOffsets[segment] + (reversed ? (rate - j) : j) - 1);
+                        outerParams.push_back(((float)half + (float)j / (float)rate) / (float)numHalves);
+                    }
+                    outer.push_back((half + 1 < numHalves) ? points[4 + edge] :
+                                                             points[(edge + 1) % numCorners]);
+                    outerParams.push_back((float)(half + 1) / (float)numHalves);
+                }
+
+                //  Gather the side of the inner grid facing the edge -- the sides
+                //  of a triangular grid are offset by half a step from the edges:
+                inner.clear();
+                innerParams.clear();
+                if (_isTriangular) {
+                    for (int j = 1; j < uRate - 1; ++j) {
+                        int u = 0, v = 0;
+                        switch (edge) {
+                            case 0: u = j;             v = 1;             break;
+                            case 1: u = uRate - 1 - j; v = j;             break;
+                            case 2: u = 1;             v = uRate - 1 - j; break;
+                        }
+                        inner.push_back(gridBase + triangleGridIndex(uRate, u, v));
+                        innerParams.push_back(((float)j + 0.5f) / (float)uRate);
+                    }
+                } else {
+                    int rate = (edge & 1) ? vRate : uRate;
+                    for (int j = 1; j < rate; ++j) {
+                        int i = (edge < 2) ? j : (rate - j);
+                        int u = 0, v = 0;
+                        switch (edge) {
+                            case 0: u = i;         v = 1;         break;
+                            case 1: u = uRate - 1; v = i;         break;
+                            case 2: u = i;         v = vRate - 1; break;
+                            case 3: u = 1;         v = i;         break;
+                        }
+                        inner.push_back(gridBase + (v - 1) * gridSize + (u - 1));
+                        innerParams.push_back((float)j / (float)rate);
+                    }
+                }
+
+                int i = 0, j = 0;
+                int m = (int)outer.size() - 1;
+                int n = (int)inner.size();
+                while ((i < m) || (j < n - 1)) {
+                    bool advanceOuter = (j == n - 1) || ((i < m) &&
+                        (outerParams[i] + outerParams[i + 1] < innerParams[j] + innerParams[j + 1]));
+                    if (advanceOuter) {
+                        *triangles++ = outer[i];
+                        *triangles++ = outer[i + 1];
+                        *triangles++ = inner[j];
+                        ++i;
+                    } else {
+                        *triangles++ = outer[i];
+                        *triangles++ = inner[j + 1];
+                        *triangles++ = inner[j];
+                        ++j;
+                    }
+                }
+            }
+
+            //  Triangulate the triangles or quads of the inner grid:
+            if (_isTriangular) {
+                for (int v = 1; v < uRate - 2; ++v) {
+                    for (int u = 1; u < uRate - 1 - v; ++u) {
+                        int v0 = gridBase + triangleGridIndex(uRate, u,     v);
+                        int v1 = gridBase + triangleGridIndex(uRate, u + 1, v);
+                        int v2 = gridBase + triangleGridIndex(uRate, u,     v + 1);
+
+                        *triangles++ = v0;  *triangles++ = v1;  *triangles++ = v2;
+                        if (u + v < uRate - 2) {
+                            int v3 = gridBase + triangleGridIndex(uRate, u + 1, v + 1);
+
+                            *triangles++ = v1;  *triangles++ = v3;  *triangles++ = v2;
+                        }
+                    }
+                }
+            } else {
+                for (int v = 1; v < vRate - 1; ++v) {
+                    for (int u = 1; u < uRate - 1; ++u) {
+                        int v0 = gridBase + (v - 1) * gridSize + (u - 1);
+                        int v1 = v0 + 1;
+                        int v2 = v1 + gridSize;
+                        int v3 = v0 + gridSize;
+
+                        *triangles++ = v0;  *triangles++ = v1;  *triangles++ = v2;
+                        *triangles++ = v0;  *triangles++ = v2;  *triangles++ = v3;
+                    }
+                }
+            }
+            assert(triangles == &mesh.triangles[0] + triangleOffsets[patch + 1] * 3);
+        }
+    }
+    return true;
+}
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,189 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_TESSELLATOR_H
+#define OPENSUBDIV3_OSD_CPU_TESSELLATOR_H
+
+#include "../version.h"
+
+#include "../osd/bufferDescriptor.h"
+#include "../osd/cpuPatchTable.h"
+#include "../osd/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class PatchTable;
+    class TopologyRefiner;
+}
+
+namespace Osd {
+
+///
+/// \brief Tessellates the limit surface of a PatchTable into triangles on
+///        the CPU
+///
+/// The edges of all patches are divided into segments -- the edges of
+/// transition patches into two segments matching those of the adjacent
+/// patches of the next level -- and each segment is tessellated at a rate
+/// chosen once for it.  Vertices at patch corners and along segments are
+/// shared by all patches incident them, so the resulting mesh is free of
+/// cracks and each vertex is evaluated only once.  The interior of each
+/// patch is tessellated as a grid stitched to the vertices of its edges --
+/// a triangular lattice for the triangular patches of the Loop scheme.
+///
+/// Sharing vertices between patches of different base faces requires the
+/// topology of the base level, so the tessellator is constructed from the
+/// TopologyRefiner of the PatchTable.  The PatchTable must represent each
+/// face of the base level once (i.e. it cannot include all levels of a
+/// uniform refinement) and contain only patches supported by the
+/// CpuEvaluator:  REGULAR, GREGORY_BASIS or QUADS for quad-based schemes,
+/// and LOOP or TRIANGLES for the Loop scheme.
+///
+/// Vertices are evaluated with CpuEvaluator::EvalPatches() and patches are
+/// processed in parallel when OpenMP is enabled.  The resulting vertices
+/// and triangles are ordered deterministically regardless.
+///
+class CpuTessellator {
+
+public:
+
+    enum TessellationMode {
+        TESS_UNIFORM,       ///< Rate proportional to the parametric length of
+                            ///< segments
+        TESS_EDGE_LENGTH,   ///< Rate from the length of segments on the limit
+                            ///< surface
+        TESS_SCREEN_SPACE   ///< Rate from the projected length of segments
+    };
+
+    struct Options {
+
+        Options();
+
+        TessellationMode mode;
+
+        int   tessLevel;            ///< Rate of the edges of base faces (uniform)
+        float edgeLength;           ///< Target length of tessellated edges, in
+                                    ///< object space or pixels (screen space)
+        int   maxTessLevel;         ///< Maximum rate of any segment
+
+        float modelViewMatrix[16];  ///< Column-major matrices, as with OpenGL,
+        float projectionMatrix[16]; ///< for screen space tessellation
+        float viewportHeight;       ///< Height of the viewport in pixels
+    };
+
+    ///
+    /// \brief The triangles and vertices tessellating the limit surface
+    ///
+    struct Mesh {
+
+        /// \brief Returns the number of vertices of the mesh
+        int GetNumVertices() const { return (int)vertexCoords.size(); }
+
+        /// \brief Returns the number of triangles of the mesh
+        int GetNumTriangles() const { return (int)triangles.size() / 3; }
+
+        int                     length;        ///< number of floats per vertex
+
+        std::vector<float>      vertexValues;  ///< evaluated vertex data (length
+                                               ///< floats each)
+        std::vector<PatchCoord> vertexCoords;  ///< location of each vertex, e.g.
+                                               ///< to evaluate other primvars
+        std::vector<int>        triangles;     ///< vertices of the triangles (3
+                                               ///< each), counter-clockwise in the
+                                               ///< parametric space of patches
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param refiner     TopologyRefiner from which the PatchTable was created
+    ///                    (only its base level is used)
+    ///
+    /// @param patchTable  PatchTable to tessellate
+    ///
+    CpuTessellator(Far::TopologyRefiner const & refiner,
+                   Far::PatchTable const & patchTable);
+
+    /// \brief Destructor
+    ~CpuTessellator();
+
+    /// \brief Returns the number of patches tessellated
+    int GetNumPatches() const { return (int)_patchHandles.size(); }
+
+    /// \brief Tessellates all patches of the PatchTable
+    ///
+    /// @param src      Control point data of the PatchTable (including any
+    ///                 local points, as with CpuEvaluator::EvalPatches()) --
+    ///                 the first three floats of each are the positions used
+    ///                 by adaptive tessellation modes
+    ///
+    /// @param srcDesc  Vertex buffer descriptor for the control point data
+    ///
+    /// @param options  Options controlling the tessellation rates
+    ///
+    /// @param mesh     Mesh receiving the vertices and triangles
+    ///
+    /// @return         False if the PatchTable or given data is unsupported
+    ///
+    bool Tessellate(float const * src, BufferDescriptor const & srcDesc,
+                    Options const & options, Mesh & mesh) const;
+
+private:
+
+    void evalCoords(float const * src, BufferDescriptor const & srcDesc,
+                    PatchCoord const * coords, int numCoords, float * dst) const;
+
+private:
+
+    CpuPatchTable _cpuPatchTable;
+
+    bool _isSupported;
+    bool _isTriangular;
+
+    //  Patches -- the four (or three) corner points (and midpoints of transition
+    //  edges) and the two segments of each edge (the second of which is absent
+    //  if not a transition edge):
+    std::vector<Far::PatchTable::PatchHandle> _patchHandles;
+    std::vector<int>                          _patchPoints;
+    std::vector<int>                          _patchSegments;
+
+    //  Points and segments shared between patches -- segments are oriented
+    //  from their first to second point, each with the location of both:
+    std::vector<PatchCoord> _pointCoords;
+
+    std::vector<int>           _segmentPoints;
+    std::vector<PatchCoord>    _segmentCoords;
+    std::vector<unsigned char> _segmentLevels;
+};
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_OSD_CPU_TESSELLATOR_H */
@@ -0,0 +1,98 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_LEVEL_STENCILS_H
+#define OPENSUBDIV3_OSD_LEVEL_STENCILS_H
+
+#include "../version.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief Applies the per-level stencil tables of
+///        Far::StencilTableFactory::CreateLevelStencilTables() in order with
+///        the EvalStencils() function of an evaluator.
+///
+/// The buffer holds the control vertices followed by the vertices of each
+/// refined level, so that each table reads the vertices of the previous
+/// level and writes those of its own level.  Evaluators forward their
+/// EvalLevelStencils() to this function.
+///
+/// @param buffer             Primvar buffer of all levels, bound as both
+///                           source and destination of EvalStencils()
+///
+/// @param desc               vertex buffer descriptor of the control
+///                           vertices in the buffer
+///
+/// @param numControlVertices number of control vertices
+///
+/// @param levelTables        stencil table of each level, of the type
+///                           expected by the evaluator
+///
+/// @param numLevelTables     number of levels to evaluate
+///
+/// @param instance           evaluator instance passed to EvalStencils()
+///                           (its type selects the evaluator)
+///
+/// @param deviceContext      device context passed to EvalStencils()
+///
+template <typename EVALUATOR, typename BUFFER, typename STENCIL_TABLE,
+          typename DEVICE_CONTEXT>
+bool EvalLevelStencils(
+    BUFFER *buffer, BufferDescriptor const &desc,
+    int numControlVertices,
+    STENCIL_TABLE const * const *levelTables, int numLevelTables,
+    EVALUATOR const *instance,
+    DEVICE_CONTEXT deviceContext) {
+
+    BufferDescriptor srcDesc = desc;
+    BufferDescriptor dstDesc = desc;
+    dstDesc.offset += numControlVertices * desc.stride;
+
+    for (int i = 0; i < numLevelTables; ++i) {
+        int numStencils = levelTables[i]->GetNumStencils();
+
+        // levels without vertices (e.g. of sparse refinement) are skipped
+        if (numStencils > 0 &&
+            !EVALUATOR::EvalStencils(buffer, srcDesc, buffer, dstDesc,
+                                     levelTables[i], instance, deviceContext)) {
+            return false;
+        }
+        srcDesc.offset = dstDesc.offset;
+        dstDesc.offset += numStencils * desc.stride;
+    }
+    return true;
+}
+
+} // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_LEVEL_STENCILS_H
@@ -24,6 +24,7 @@
 
 #include "../osd/ompEvaluator.h"
 #include "../osd/ompKernel.h"
+#include "../osd/cpuKernel.h"
 #include "../far/patchBasis.h"
 #include <omp.h>
 
@@ -172,6 +173,12 @@ OmpEvaluator::EvalPatches(
     src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
     else return false;
+
+    if (! CpuCheckPatchTypes("OmpEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrays)) {
+        return false;
+    }
+
     BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
 
 #pragma omp parallel for
@@ -201,6 +208,14 @@ OmpEvaluator::EvalPatches(
             Far::internal::GetBilinearWeights(param,
                                               coord.s, coord.t, wP, wDs, wDt);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriangleWeights(param,
+                                                    coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 3;
         } else {
             continue;
         }
@@ -237,6 +252,11 @@ OmpEvaluator::EvalPatches(
     if (du)  du += duDesc.offset;
     if (dv)  dv += dvDesc.offset;
 
+    if (! CpuCheckPatchTypes("OmpEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrays)) {
+        return false;
+    }
+
     BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
 
 #pragma omp parallel for
@@ -268,6 +288,14 @@ OmpEvaluator::EvalPatches(
             Far::internal::GetBilinearWeights(param,
                                               coord.s, coord.t, wP, wDu, wDv);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDu, wDv);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriangleWeights(param,
+                                                    coord.s, coord.t, wP, wDu, wDv);
+            numControlVertices = 3;
         } else {
             continue;
         }
@@ -317,6 +345,11 @@ OmpEvaluator::EvalPatches(
     if (duv) duv += duvDesc.offset;
     if (dvv) dvv += dvvDesc.offset;
 
+    if (! CpuCheckPatchTypes("OmpEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrays)) {
+        return false;
+    }
+
     BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
 
 #pragma omp parallel for
@@ -354,6 +387,16 @@ OmpEvaluator::EvalPatches(
                                               coord.s, coord.t, wP,
                                               wDu, wDv, wDuu, wDuv, wDvv);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP,
+                                          wDu, wDv, wDuu, wDuv, wDvv);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriangleWeights(param,
+                                                    coord.s, coord.t, wP,
+                                                    wDu, wDv, wDuu, wDuv, wDvv);
+            numControlVertices = 3;
         } else {
             continue;
         }
@@ -27,6 +27,7 @@
 
 #include "../version.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/levelStencils.h"
 #include "../osd/types.h"
 
 #include <cstddef>
@@ -415,6 +416,45 @@ public:
         const float * dvvWeights,
         int start, int end);
 
+    /// \brief Generic static function applying the per-level stencil tables
+    ///        of Far::StencilTableFactory::CreateLevelStencilTables() in order.
+    ///
+    /// The buffer holds the control vertices followed by the vertices of each
+    /// refined level, so that each table reads the vertices of the previous
+    /// level and writes those of its own level.
+    ///
+    /// @param buffer             Primvar buffer of all levels.
+    ///                           must have BindCpuBuffer() method returning a
+    ///                           float pointer for read and write
+    ///
+    /// @param desc               vertex buffer descriptor of the control
+    ///                           vertices in the buffer
+    ///
+    /// @param numControlVertices number of control vertices
+    ///
+    /// @param levelTables        Far::StencilTable or equivalent of each level
+    ///
+    /// @param numLevelTables     number of levels to evaluate
+    ///
+    /// @param instance           not used in the omp kernel
+    ///                           (declared as a typed pointer to prevent
+    ///                            undesirable template resolution)
+    ///
+    /// @param deviceContext      not used in the omp kernel
+    ///
+    template <typename BUFFER, typename STENCIL_TABLE>
+    static bool EvalLevelStencils(
+        BUFFER *buffer, BufferDescriptor const &desc,
+        int numControlVertices,
+        STENCIL_TABLE const * const *levelTables, int numLevelTables,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        return Osd::EvalLevelStencils(buffer, desc, numControlVertices,
+                                      levelTables, numLevelTables,
+                                      instance, deviceContext);
+    }
+
     /// ----------------------------------------------------------------------
     ///
     ///   Limit evaluations with PatchTable
@@ -24,6 +24,7 @@
 
 #include "../osd/tbbEvaluator.h"
 #include "../osd/tbbKernel.h"
+#include "../osd/cpuKernel.h"
 
 #include <tbb/task_scheduler_init.h>
 
@@ -142,6 +143,11 @@ TbbEvaluator::EvalPatches(
 
     if (srcDesc.length != dstDesc.length) return false;
 
+    if (! CpuCheckPatchTypes("TbbEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrayBuffer)) {
+        return false;
+    }
+
     TbbEvalPatches(src, srcDesc, dst, dstDesc,
                    NULL, BufferDescriptor(),
                    NULL, BufferDescriptor(),
@@ -169,6 +175,11 @@ TbbEvaluator::EvalPatches(
 
     if (srcDesc.length != dstDesc.length) return false;
 
+    if (! CpuCheckPatchTypes("TbbEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrayBuffer)) {
+        return false;
+    }
+
     TbbEvalPatches(src, srcDesc, dst, dstDesc,
                    du,  duDesc,  dv,  dvDesc,
                    NULL, BufferDescriptor(),
@@ -198,6 +209,11 @@ TbbEvaluator::EvalPatches(
 
     if (srcDesc.length != dstDesc.length) return false;
 
+    if (! CpuCheckPatchTypes("TbbEvaluator::EvalPatches()", numPatchCoords,
+                             patchCoords, patchArrayBuffer)) {
+        return false;
+    }
+
     TbbEvalPatches(src, srcDesc, dst, dstDesc,
                    du,  duDesc,  dv,  dvDesc,
                    duu, duuDesc, duv, duvDesc, dvv, dvvDesc,
@@ -418,8 +418,16 @@ public:
                                                   coord.s, coord.t, wP,
                                                   wDu, wDv);
                 numControlVertices = 4;
-            } else {
-                assert(0);
+            } else if (patchType == Far::PatchDescriptor::LOOP) {
+                Far::internal::GetLoopWeights(param,
+                                              coord.s, coord.t, wP,
+                                              wDu, wDv);
+                numControlVertices = 12;
+            } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+                Far::internal::GetLinearTriangleWeights(param,
+                                                        coord.s, coord.t, wP,
+                                                        wDu, wDv);
+                numControlVertices = 3;
             }
 
             int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
@@ -480,8 +488,16 @@ public:
                                                   coord.s, coord.t,
                                                   wP, wDu, wDv);
                 numControlVertices = 4;
-            } else {
-                assert(0);
+            } else if (patchType == Far::PatchDescriptor::LOOP) {
+                Far::internal::GetLoopWeights(param,
+                                              coord.s, coord.t,
+                                              wP, wDu, wDv);
+                numControlVertices = 12;
+            } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+                Far::internal::GetLinearTriangleWeights(param,
+                                                        coord.s, coord.t,
+                                                        wP, wDu, wDv);
+                numControlVertices = 3;
             }
 
             int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
@@ -560,8 +576,16 @@ public:
                                                   coord.s, coord.t, wP,
                                                  wDu, wDv, wDuu, wDuv, wDvv);
                 numControlVertices = 4;
-            } else {
-                assert(0);
+            } else if (patchType == Far::PatchDescriptor::LOOP) {
+                Far::internal::GetLoopWeights(param,
+                                              coord.s, coord.t, wP,
+                                             wDu, wDv, wDuu, wDuv, wDvv);
+                numControlVertices = 12;
+            } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+                Far::internal::GetLinearTriangleWeights(param,
+                                                        coord.s, coord.t, wP,
+                                                       wDu, wDv, wDuu, wDuv, wDvv);
+                numControlVertices = 3;
             }
 
             int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
@@ -27,6 +27,7 @@
 #include "../version.h"
 
 #include "../sdc/scheme.h"
+#include "../sdc/valenceTables.h"
 
 #include <cassert>
 #include <cmath>
@@ -394,36 +395,50 @@ Scheme<SCHEME_CATMARK>::assignCreaseLimitTangentMasks(VERTEX const& vertex,
         tan2Mask.FaceWeight(creaseEnds[0])     = 1.0f / 6.0f;
         tan2Mask.FaceWeight(creaseEnds[0] + 1) = 1.0f / 6.0f;
     } else if (interiorEdgeCount > 1) {
-        //  The irregular case -- formulae from Biermann et al:
+        //  The irregular case -- formulae from Biermann et al (the weights
+        //  depend only on the interior edge count and are tabulated):
 
-        double k     = (double) (interiorEdgeCount + 1);
-        double theta = M_PI / k;
+        double const * weights =
+            ValenceTables::GetCatmarkCreaseTangentWeights(interiorEdgeCount);
 
-        double cosTheta = std::cos(theta);
-        double sinTheta = std::sin(theta);
+        if (weights) {
+            double const * edgeWeights = weights + 1;
+            double const * faceWeights = weights + 2 + interiorEdgeCount;
 
-        //  Loop/Schaefer use a different divisor here (3*k + cos(theta)):
-        double commonDenom = 1.0f / (k * (3.0f + cosTheta));
-        double R = (cosTheta + 1.0f) / sinTheta;
+            tan2Mask.VertexWeight(0) = (Weight) weights[0];
 
-        double vertexWeight = 4.0f * R * (cosTheta - 1.0f);
-        double creaseWeight = -R * (1.0f + 2.0f * cosTheta);
+            tan2Mask.EdgeWeight(creaseEnds[0]) = (Weight) edgeWeights[0];
+            tan2Mask.EdgeWeight(creaseEnds[1]) = (Weight) edgeWeights[0];
 
-        tan2Mask.VertexWeight(0) = (Weight) (vertexWeight * commonDenom);
+            tan2Mask.FaceWeight(creaseEnds[0]) = (Weight) faceWeights[0];
 
-        tan2Mask.EdgeWeight(creaseEnds[0]) = (Weight) (creaseWeight * commonDenom);
-        tan2Mask.EdgeWeight(creaseEnds[1]) = (Weight) (creaseWeight * commonDenom);
+            for (int i = 1; i <= interiorEdgeCount; ++i) {
+                tan2Mask.EdgeWeight(creaseEnds[0] + i) = (Weight) edgeWeights[i];
+                tan2Mask.FaceWeight(creaseEnds[0] + i) = (Weight) faceWeights[i];
+            }
+        } else {
+            //  Weights of higher interior edge counts are not tabulated:
+            int edgeOffset = 1;
+            int faceOffset = 2 + interiorEdgeCount;
+
+            Weight creaseWeight = (Weight)
+                ValenceTables::ComputeCatmarkCreaseTangentWeight(interiorEdgeCount, edgeOffset);
+
+            tan2Mask.VertexWeight(0) = (Weight)
+                ValenceTables::ComputeCatmarkCreaseTangentWeight(interiorEdgeCount, 0);
 
-        tan2Mask.FaceWeight(creaseEnds[0]) = (Weight) (sinTheta * commonDenom);
+            tan2Mask.EdgeWeight(creaseEnds[0]) = creaseWeight;
+            tan2Mask.EdgeWeight(creaseEnds[1]) = creaseWeight;
 
-        double sinThetaI      = 0.0f;
-        double sinThetaIplus1 = sinTheta;
-        for (int i = 1; i < k; ++i) {
-            sinThetaI      = sinThetaIplus1;
-            sinThetaIplus1 = std::sin((i+1)*theta);
+            tan2Mask.FaceWeight(creaseEnds[0]) = (Weight)
+                ValenceTables::ComputeCatmarkCreaseTangentWeight(interiorEdgeCount, faceOffset);
 
-            tan2Mask.EdgeWeight(creaseEnds[0] + i) = (Weight) ((4.0f * sinThetaI) * commonDenom);
-            tan2Mask.FaceWeight(creaseEnds[0] + i) = (Weight) ((sinThetaI + sinThetaIplus1) * commonDenom);
+            for (int i = 1; i <= interiorEdgeCount; ++i) {
+                tan2Mask.EdgeWeight(creaseEnds[0] + i) = (Weight)
+                    ValenceTables::ComputeCatmarkCreaseTangentWeight(interiorEdgeCount, edgeOffset + i);
+                tan2Mask.FaceWeight(creaseEnds[0] + i) = (Weight)
+                    ValenceTables::ComputeCatmarkCreaseTangentWeight(interiorEdgeCount, faceOffset + i);
+            }
         }
     } else {
         //  Special case for a single face -- simple average of boundary edges:
@@ -478,23 +493,22 @@ Scheme<SCHEME_CATMARK>::assignSmoothLimitTangentMasks(VERTEX const& vertex,
         tan1Mask.FaceWeight(2) = -1.0f;
         tan1Mask.FaceWeight(3) =  1.0f;
     } else {
-        double theta = 2.0f * M_PI / (double)valence;
-
-        double cosTheta     = std::cos(theta);
-        double cosHalfTheta = std::cos(theta * 0.5f);
-
-        double lambda = (5.0f / 16.0f) + (1.0f / 16.0f) *
-                (cosTheta + cosHalfTheta * std::sqrt(2.0f * (9.0f + cosTheta)));
-
-        double edgeWeightScale = 4.0f;
-        double faceWeightScale = 1.0f / (4.0f * lambda - 1.0f);
-
-        for (int i = 0; i < valence; ++i) {
-            double cosThetaI      = std::cos(  i  * theta);
-            double cosThetaIplus1 = std::cos((i+1)* theta);
-
-            tan1Mask.EdgeWeight(i) = (Weight) (edgeWeightScale * cosThetaI);
-            tan1Mask.FaceWeight(i) = (Weight) (faceWeightScale * (cosThetaI + cosThetaIplus1));
+        //  Weights are scaled cosines of multiples of 2*PI/valence (tabulated):
+        double const * weights =
+            ValenceTables::GetCatmarkSmoothTangentWeights(valence);
+
+        if (weights) {
+            for (int i = 0; i < valence; ++i) {
+                tan1Mask.EdgeWeight(i) = (Weight) weights[i];
+                tan1Mask.FaceWeight(i) = (Weight) weights[valence + i];
+            }
+        } else {
+            for (int i = 0; i < valence; ++i) {
+                tan1Mask.EdgeWeight(i) = (Weight)
+                    ValenceTables::ComputeCatmarkSmoothTangentWeight(valence, i);
+                tan1Mask.FaceWeight(i) = (Weight)
+                    ValenceTables::ComputeCatmarkSmoothTangentWeight(valence, valence + i);
+            }
         }
     }
 
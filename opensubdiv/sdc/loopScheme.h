@@ -27,6 +27,7 @@
 #include "../version.h"
 
 #include "../sdc/scheme.h"
+#include "../sdc/valenceTables.h"
 
 #include <cassert>
 
@@ -192,14 +193,9 @@ Scheme<SCHEME_LOOP>::assignSmoothMaskForVertex(VERTEX const& vertex, MASK& mask)
     Weight vWeight = (Weight) 0.625f;
 
     if (valence != 6) {
-        //  From HbrLoopSubdivision<T>::Subdivide(mesh, vertex):
-        //     - could use some lookup tables here for common irregular valence (5, 7, 8)
-        //       or all of these cosf() calls will be adding up...
-
-        Weight invValence = 1.0f / (Weight) valence;
-        Weight beta       = 0.25f * cosf((Weight)M_PI * 2.0f * invValence) + 0.375f;
-
-        eWeight = (0.625f - (beta * beta)) * invValence;;
+        //  From HbrLoopSubdivision<T>::Subdivide(mesh, vertex) -- the edge
+        //  weight is a function of cos(2*PI/valence) and so is tabulated:
+        eWeight = (Weight) ValenceTables::GetLoopSmoothVertexEdgeWeight(valence);
         vWeight = 1.0f - (eWeight * (Weight)valence);
     }
 
@@ -293,12 +289,7 @@ Scheme<SCHEME_LOOP>::assignSmoothLimitMask(VERTEX const& vertex, MASK& posMask)
         posMask.EdgeWeight(5) = eWeight;
 
     } else {
-        Weight invValence = 1.0f / valence;
-
-        Weight beta = 0.25f * cosf((Weight)M_PI * 2.0f * invValence) + 0.375f;
-        beta = (0.625f - (beta * beta)) * invValence;;
-
-        Weight eWeight = 1.0f / (valence + 3.0f / (8.0f * beta));
+        Weight eWeight = (Weight) ValenceTables::GetLoopSmoothLimitEdgeWeight(valence);
         Weight vWeight = (Weight)(1.0f - (eWeight * valence));
 
         posMask.VertexWeight(0) = vWeight;
@@ -487,18 +478,28 @@ Scheme<SCHEME_LOOP>::assignCreaseLimitTangentMasks(VERTEX const& vertex,
         //  2.0 for considering the region as a half-disk, and 1.5 in keeping
         //  with the crease tangent):
 
-        double theta = M_PI / (interiorEdgeCount + 1);
+        //  Weights are functions of the sines of multiples of PI/(interiorEdgeCount+1)
+        //  and so are tabulated:
+        float const * weights =
+            ValenceTables::GetLoopCreaseTangentWeights(interiorEdgeCount);
 
-        Weight cWeight      = -3.0f * (Weight) std::sin(theta);
-        Weight eWeightCoeff = -3.0f * (2.0f * (Weight) std::cos(theta) - 2.0f);
+        Weight cWeight = (Weight) (weights ? weights[0] :
+            ValenceTables::ComputeLoopCreaseTangentWeight(interiorEdgeCount, 0));
 
         tan2Mask.VertexWeight(0) = 0.0f;
 
         tan2Mask.EdgeWeight(creaseEnds[0]) = cWeight;
         tan2Mask.EdgeWeight(creaseEnds[1]) = cWeight;
 
-        for (int i = 1; i <= interiorEdgeCount; ++i) {
-            tan2Mask.EdgeWeight(creaseEnds[0] + i) = eWeightCoeff * (Weight) std::sin(i * theta);
+        if (weights) {
+            for (int i = 1; i <= interiorEdgeCount; ++i) {
+                tan2Mask.EdgeWeight(creaseEnds[0] + i) = (Weight) weights[i];
+            }
+        } else {
+            for (int i = 1; i <= interiorEdgeCount; ++i) {
+                tan2Mask.EdgeWeight(creaseEnds[0] + i) = (Weight)
+                    ValenceTables::ComputeLoopCreaseTangentWeight(interiorEdgeCount, i);
+            }
         }
     } else if (interiorEdgeCount == 1) {
         //  See notes above regarding scale factor of 3.0:
@@ -563,11 +564,22 @@ Scheme<SCHEME_LOOP>::assignSmoothLimitTangentMasks(VERTEX const& vertex,
         tan2Mask.EdgeWeight(4) = -Root3by2;
         tan2Mask.EdgeWeight(5) = -Root3by2;
     } else {
-        Weight alpha = (Weight) (2.0f * M_PI / valence);
-        for (int i = 0; i < valence; ++i) {
-            double alphaI = alpha * i;
-            tan1Mask.EdgeWeight(i) = (Weight) std::cos(alphaI);
-            tan2Mask.EdgeWeight(i) = (Weight) std::sin(alphaI);
+        //  Weights are the cosines and sines of multiples of 2*PI/valence (tabulated):
+        float const * weights =
+            ValenceTables::GetLoopSmoothTangentWeights(valence);
+
+        if (weights) {
+            for (int i = 0; i < valence; ++i) {
+                tan1Mask.EdgeWeight(i) = (Weight) weights[i];
+                tan2Mask.EdgeWeight(i) = (Weight) weights[valence + i];
+            }
+        } else {
+            for (int i = 0; i < valence; ++i) {
+                tan1Mask.EdgeWeight(i) = (Weight)
+                    ValenceTables::ComputeLoopSmoothTangentWeight(valence, i);
+                tan2Mask.EdgeWeight(i) = (Weight)
+                    ValenceTables::ComputeLoopSmoothTangentWeight(valence, valence + i);
+            }
         }
     }
 }
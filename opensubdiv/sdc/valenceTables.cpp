@@ -0,0 +1,300 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#include "../sdc/valenceTables.h"
+
+#include <cmath>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Sdc {
+
+namespace {
+
+    //
+    //  Computation of the individual weights of each table -- formulae and
+    //  their references are documented with the masks of each Scheme:
+    //
+    int catmarkSmoothTangentSize(int valence) { return 2 * valence; }
+
+    double
+    computeCatmarkSmoothTangentWeight(int valence, int index) {
+
+        double theta = 2.0 * M_PI / (double)valence;
+
+        if (index < valence) {
+            double edgeWeightScale = 4.0;
+
+            return edgeWeightScale * std::cos(index * theta);
+        }
+
+        double cosTheta     = std::cos(theta);
+        double cosHalfTheta = std::cos(theta * 0.5);
+
+        double lambda = (5.0 / 16.0) + (1.0 / 16.0) *
+                (cosTheta + cosHalfTheta * std::sqrt(2.0 * (9.0 + cosTheta)));
+
+        double faceWeightScale = 1.0 / (4.0 * lambda - 1.0);
+
+        int i = index - valence;
+        return faceWeightScale * (std::cos(i * theta) + std::cos((i+1) * theta));
+    }
+
+    int catmarkCreaseTangentSize(int interiorEdgeCount) { return 2 * interiorEdgeCount + 3; }
+
+    double
+    computeCatmarkCreaseTangentWeight(int interiorEdgeCount, int index) {
+
+        double k     = (double) (interiorEdgeCount + 1);
+        double theta = M_PI / k;
+
+        double cosTheta = std::cos(theta);
+        double sinTheta = std::sin(theta);
+
+        //  Loop/Schaefer use a different divisor here (3*k + cos(theta)):
+        double commonDenom = 1.0 / (k * (3.0 + cosTheta));
+        double R = (cosTheta + 1.0) / sinTheta;
+
+        //  Weights are ordered [V, C, E1 ... Ek-1, F0 ... Fk-1]:
+        int faceIndex = index - (interiorEdgeCount + 2);
+
+        if (index == 0) {
+            double vertexWeight = 4.0 * R * (cosTheta - 1.0);
+            return vertexWeight * commonDenom;
+        } else if (index == 1) {
+            double creaseWeight = -R * (1.0 + 2.0 * cosTheta);
+            return creaseWeight * commonDenom;
+        } else if (faceIndex < 0) {
+            return (4.0 * std::sin((index - 1) * theta)) * commonDenom;
+        } else if (faceIndex == 0) {
+            return sinTheta * commonDenom;
+        } else {
+            return (std::sin(faceIndex * theta) + std::sin((faceIndex + 1) * theta)) * commonDenom;
+        }
+    }
+
+    int loopSmoothEdgeSize(int) { return 1; }
+
+    float
+    computeLoopSmoothVertexEdgeWeight(int valence, int) {
+
+        //  From HbrLoopSubdivision<T>::Subdivide(mesh, vertex):
+        float invValence = 1.0f / (float) valence;
+        float beta       = 0.25f * std::cos((float)M_PI * 2.0f * invValence) + 0.375f;
+
+        return (0.625f - (beta * beta)) * invValence;
+    }
+
+    float
+    computeLoopSmoothLimitEdgeWeight(int valence, int) {
+
+        float invValence = 1.0f / valence;
+
+        float beta = 0.25f * std::cos((float)M_PI * 2.0f * invValence) + 0.375f;
+        beta = (0.625f - (beta * beta)) * invValence;
+
+        return 1.0f / (valence + 3.0f / (8.0f * beta));
+    }
+
+    int loopSmoothTangentSize(int valence) { return 2 * valence; }
+
+    float
+    computeLoopSmoothTangentWeight(int valence, int index) {
+
+        float alpha = (float) (2.0 * M_PI / valence);
+
+        //  Weights are ordered [cos(0) ... cos(n-1 * a), sin(0) ... sin(n-1 * a)]:
+        if (index < valence) {
+            double alphaI = alpha * index;
+            return (float) std::cos(alphaI);
+        } else {
+            double alphaI = alpha * (index - valence);
+            return (float) std::sin(alphaI);
+        }
+    }
+
+    int loopCreaseTangentSize(int interiorEdgeCount) { return interiorEdgeCount + 1; }
+
+    float
+    computeLoopCreaseTangentWeight(int interiorEdgeCount, int index) {
+
+        double theta = M_PI / (interiorEdgeCount + 1);
+
+        if (index == 0) {
+            return -3.0f * (float) std::sin(theta);
+        }
+
+        float eWeightCoeff = -3.0f * (2.0f * (float) std::cos(theta) - 2.0f);
+
+        return eWeightCoeff * (float) std::sin(index * theta);
+    }
+
+    //
+    //  Table of the arrays of weights for all valences up to MAX_VALENCE:
+    //
+    template <typename REAL>
+    class WeightTable {
+    public:
+        typedef int  (*SizeFunction)(int valence);
+        typedef REAL (*ComputeFunction)(int valence, int index);
+
+        WeightTable(SizeFunction size, ComputeFunction compute) {
+
+            _offsets.resize(ValenceTables::MAX_VALENCE + 1, 0);
+            for (int valence = 1; valence <= ValenceTables::MAX_VALENCE; ++valence) {
+                _offsets[valence] = (int) _weights.size();
+
+                int numWeights = size(valence);
+                for (int i = 0; i < numWeights; ++i) {
+                    _weights.push_back(compute(valence, i));
+                }
+            }
+        }
+
+        REAL const * Get(int valence) const {
+            return (valence <= ValenceTables::MAX_VALENCE) ?
+                &_weights[_offsets[valence]] : 0;
+        }
+
+    private:
+        std::vector<int>  _offsets;
+        std::vector<REAL> _weights;
+    };
+
+    //
+    //  The tables are initialized on first use:
+    //
+    WeightTable<double> const &
+    getCatmarkSmoothTangentTable() {
+        static WeightTable<double> const table(
+            catmarkSmoothTangentSize, computeCatmarkSmoothTangentWeight);
+        return table;
+    }
+
+    WeightTable<double> const &
+    getCatmarkCreaseTangentTable() {
+        static WeightTable<double> const table(
+            catmarkCreaseTangentSize, computeCatmarkCreaseTangentWeight);
+        return table;
+    }
+
+    WeightTable<float> const &
+    getLoopSmoothVertexTable() {
+        static WeightTable<float> const table(
+            loopSmoothEdgeSize, computeLoopSmoothVertexEdgeWeight);
+        return table;
+    }
+
+    WeightTable<float> const &
+    getLoopSmoothLimitTable() {
+        static WeightTable<float> const table(
+            loopSmoothEdgeSize, computeLoopSmoothLimitEdgeWeight);
+        return table;
+    }
+
+    WeightTable<float> const &
+    getLoopSmoothTangentTable() {
+        static WeightTable<float> const table(
+            loopSmoothTangentSize, computeLoopSmoothTangentWeight);
+        return table;
+    }
+
+    WeightTable<float> const &
+    getLoopCreaseTangentTable() {
+        static WeightTable<float> const table(
+            loopCreaseTangentSize, computeLoopCreaseTangentWeight);
+        return table;
+    }
+} // end namespace
+
+//
+//  Static methods for ValenceTables:
+//
+double const *
+ValenceTables::GetCatmarkSmoothTangentWeights(int valence) {
+
+    return getCatmarkSmoothTangentTable().Get(valence);
+}
+
+double
+ValenceTables::ComputeCatmarkSmoothTangentWeight(int valence, int index) {
+
+    return computeCatmarkSmoothTangentWeight(valence, index);
+}
+
+double const *
+ValenceTables::GetCatmarkCreaseTangentWeights(int interiorEdgeCount) {
+
+    return getCatmarkCreaseTangentTable().Get(interiorEdgeCount);
+}
+
+double
+ValenceTables::ComputeCatmarkCreaseTangentWeight(int interiorEdgeCount, int index) {
+
+    return computeCatmarkCreaseTangentWeight(interiorEdgeCount, index);
+}
+
+float
+ValenceTables::GetLoopSmoothVertexEdgeWeight(int valence) {
+
+    float const * weight = getLoopSmoothVertexTable().Get(valence);
+    return weight ? *weight : computeLoopSmoothVertexEdgeWeight(valence, 0);
+}
+
+float
+ValenceTables::GetLoopSmoothLimitEdgeWeight(int valence) {
+
+    float const * weight = getLoopSmoothLimitTable().Get(valence);
+    return weight ? *weight : computeLoopSmoothLimitEdgeWeight(valence, 0);
+}
+
+float const *
+ValenceTables::GetLoopSmoothTangentWeights(int valence) {
+
+    return getLoopSmoothTangentTable().Get(valence);
+}
+
+float
+ValenceTables::ComputeLoopSmoothTangentWeight(int valence, int index) {
+
+    return computeLoopSmoothTangentWeight(valence, index);
+}
+
+float const *
+ValenceTables::GetLoopCreaseTangentWeights(int interiorEdgeCount) {
+
+    return getLoopCreaseTangentTable().Get(interiorEdgeCount);
+}
+
+float
+ValenceTables::ComputeLoopCreaseTangentWeight(int interiorEdgeCount, int index) {
+
+    return computeLoopCreaseTangentWeight(interiorEdgeCount, index);
+}
+
+} // end namespace sdc
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,92 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_SDC_VALENCE_TABLES_H
+#define OPENSUBDIV3_SDC_VALENCE_TABLES_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Sdc {
+
+///
+///  \brief Tables of mask weights of the subdivision schemes indexed by valence.
+///
+///  Weights of the masks of smooth and crease vertices that are trigonometric
+///  functions of the valence are precomputed once for all valences up to
+///  MAX_VALENCE, rather than for every vertex at every level.  The arrays of
+///  weights are not available for higher valences (NULL is returned), in which
+///  case each weight is computed individually by the corresponding Compute
+///  method.
+///
+///  Weights of the Catmark scheme are computed in double precision and those
+///  of the Loop scheme in single precision -- as they were by the masks of
+///  each Scheme -- and are converted to the precision of the mask by the
+///  Scheme specializations.
+///
+struct ValenceTables {
+
+    enum { MAX_VALENCE = 32 };
+
+    //
+    //  Catmark:
+    //
+    //  Edge and face weights of the first limit tangent of a smooth interior
+    //  vertex (valence > 2 and != 4), i.e. [E0 ... En-1, F0 ... Fn-1]:
+    static double const * GetCatmarkSmoothTangentWeights(int valence);
+    static double ComputeCatmarkSmoothTangentWeight(int valence, int index);
+
+    //  Weights of the limit tangent across the interior of a crease vertex with
+    //  more than one interior edge, i.e. [V, C, E1 ... Ek-1, F0 ... Fk-1] where
+    //  C is the weight of both crease edges and k-1 the interior edge count:
+    static double const * GetCatmarkCreaseTangentWeights(int interiorEdgeCount);
+    static double ComputeCatmarkCreaseTangentWeight(int interiorEdgeCount, int index);
+
+    //
+    //  Loop:
+    //
+    //  Edge weight of the refinement and limit masks of a smooth vertex:
+    static float GetLoopSmoothVertexEdgeWeight(int valence);
+    static float GetLoopSmoothLimitEdgeWeight(int valence);
+
+    //  Edge weights of both limit tangents of a smooth interior vertex, i.e.
+    //  [cos(0) ... cos(n-1 * a), sin(0) ... sin(n-1 * a)] with a = 2*PI/n:
+    static float const * GetLoopSmoothTangentWeights(int valence);
+    static float ComputeLoopSmoothTangentWeight(int valence, int index);
+
+    //  Weights of the limit tangent across the interior of a crease vertex with
+    //  more than two interior edges, i.e. [C, E1 ... Ek-1] where C is the weight
+    //  of both crease edges and k-1 the interior edge count:
+    static float const * GetLoopCreaseTangentWeights(int interiorEdgeCount);
+    static float ComputeLoopCreaseTangentWeight(int interiorEdgeCount, int index);
+};
+
+} // end namespace sdc
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_SDC_VALENCE_TABLES_H */
@@ -82,6 +82,19 @@ FVarLevel::FVarLevel(Level const& level) :
 FVarLevel::~FVarLevel() {
 }
 
+size_t
+FVarLevel::getByteSize() const {
+
+    return _faceVertValues.size()      * sizeof(Index) +
+           _edgeTags.size()            * sizeof(ETag) +
+           _vertSiblingCounts.size()   * sizeof(Sibling) +
+           _vertSiblingOffsets.size()  * sizeof(int) +
+           _vertFaceSiblings.size()    * sizeof(Sibling) +
+           _vertValueIndices.size()    * sizeof(Index) +
+           _vertValueTags.size()       * sizeof(ValueTag) +
+           _vertValueCreaseEnds.size() * sizeof(CreaseEndPair);
+}
+
 //
 //  Initialization and sizing methods to allocate space:
 //
@@ -818,6 +831,32 @@ FVarLevel::initializeFaceValuesFromVertexFaceSiblings() {
     }
 }
 
+void
+FVarLevel::renumberVertices(std::vector<Index> const & vertexOrder) {
+
+    int vertCount = (int)vertexOrder.size();
+
+    std::vector<Sibling> siblingCounts(vertCount);
+    std::vector<int>     siblingOffsets(vertCount);
+    std::vector<Sibling> vertFaceSiblings;
+    vertFaceSiblings.reserve(_vertFaceSiblings.size());
+
+    for (int i = 0; i < vertCount; ++i) {
+        Index vIndex = vertexOrder[i];
+
+        siblingCounts[i]  = _vertSiblingCounts[vIndex];
+        siblingOffsets[i] = _vertSiblingOffsets[vIndex];
+
+        if (!_vertFaceSiblings.empty()) {
+            ConstSiblingArray vSiblings = getVertexFaceSiblings(vIndex);
+            vertFaceSiblings.insert(vertFaceSiblings.end(), vSiblings.begin(), vSiblings.end());
+        }
+    }
+    _vertSiblingCounts.swap(siblingCounts);
+    _vertSiblingOffsets.swap(siblingOffsets);
+    _vertFaceSiblings.swap(vertFaceSiblings);
+}
+
 void
 FVarLevel::buildFaceVertexSiblingsFromVertexFaceSiblings(std::vector<Sibling>& fvSiblings) const {
 
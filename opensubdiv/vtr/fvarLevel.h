@@ -175,6 +175,8 @@ public:
 
     Sdc::Options getOptions() const { return _options; }
 
+    size_t getByteSize() const;
+
     //  Queries per face:
     ConstIndexArray  getFaceValues(Index fIndex) const;
     IndexArray       getFaceValues(Index fIndex);
@@ -231,6 +233,11 @@ public:
     void initializeFaceValuesFromFaceVertices();
     void initializeFaceValuesFromVertexFaceSiblings();
 
+    //  Reorder per-vertex members when the vertices of the Level are renumbered --
+    //  before the Level, whose vertex-face offsets locate the vertex-face siblings
+    //  (the values themselves are not renumbered):
+    void renumberVertices(std::vector<Index> const & vertexOrder);
+
     struct ValueSpan;
     void gatherValueSpans(Index vIndex, ValueSpan * vValueSpans) const;
 
@@ -68,6 +68,10 @@ public:
     float getFractionalWeight(Index pVert, LocalIndex pSibling,
                               Index cVert, LocalIndex cSibling) const;
 
+    size_t getByteSize() const {
+        return _childValueParentSource.size() * sizeof(LocalIndex);
+    }
+
 
     //  Modifiers supporting application of the refinement:
     void applyRefinement();
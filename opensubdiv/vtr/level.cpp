@@ -64,7 +64,9 @@ Level::Level() :
     _vertCount(0),
     _depth(0),
     _maxEdgeFaces(0),
-    _maxValence(0) {
+    _maxValence(0),
+    _regFaceSize(0),
+    _releasedLocalIndices(false) {
 }
 
 Level::~Level() {
@@ -73,6 +75,44 @@ Level::~Level() {
     }
 }
 
+namespace {
+    template <typename TYPE>
+    inline size_t
+    vectorByteSize(std::vector<TYPE> const & v) {
+        return v.size() * sizeof(TYPE);
+    }
+}
+
+size_t
+Level::getByteSize() const {
+
+    size_t memory = vectorByteSize(_faceVertOffsets) +
+                    vectorByteSize(_faceVertIndices) +
+                    vectorByteSize(_faceEdgeIndices) +
+                    vectorByteSize(_faceTags) +
+
+                    vectorByteSize(_edgeVertIndices) +
+                    vectorByteSize(_edgeFaceOffsets) +
+                    vectorByteSize(_edgeFaceIndices) +
+                    vectorByteSize(_edgeFaceLocalIndices) +
+                    vectorByteSize(_edgeSharpness) +
+                    vectorByteSize(_edgeTags) +
+
+                    vectorByteSize(_vertFaceOffsets) +
+                    vectorByteSize(_vertFaceIndices) +
+                    vectorByteSize(_vertFaceLocalIndices) +
+                    vectorByteSize(_vertEdgeOffsets) +
+                    vectorByteSize(_vertEdgeIndices) +
+                    vectorByteSize(_vertEdgeLocalIndices) +
+                    vectorByteSize(_vertSharpness) +
+                    vectorByteSize(_vertTags);
+
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        memory += _fvarChannels[i]->getByteSize();
+    }
+    return memory;
+}
+
 
 char const *
 Level::getTopologyErrorString(TopologyError errCode) {
@@ -422,7 +462,7 @@ Level::print(const Refinement* pRefinement) const {
     printf("  Topology relation sizes:\n");
 
     printf("    Face relations:\n");
-    printf("      face-vert counts/offset = %lu\n", (unsigned long)_faceVertCountsAndOffsets.size());
+    printf("      face-vert offsets = %lu (regular size = %d)\n", (unsigned long)_faceVertOffsets.size(), _regFaceSize);
     printf("      face-vert indices = %lu\n", (unsigned long)_faceVertIndices.size());
     if (_faceVertIndices.size()) {
         for (int i = 0; printFaceVerts && i < getNumFaces(); ++i) {
@@ -459,7 +499,7 @@ Level::print(const Refinement* pRefinement) const {
             printIndexArray(getEdgeVertices(i));
         }
     }
-    printf("      edge-face counts/offset = %lu\n", (unsigned long)_edgeFaceCountsAndOffsets.size());
+    printf("      edge-face offsets       = %lu\n", (unsigned long)_edgeFaceOffsets.size());
     printf("      edge-face indices       = %lu\n", (unsigned long)_edgeFaceIndices.size());
     printf("      edge-face local-indices = %lu\n", (unsigned long)_edgeFaceLocalIndices.size());
     if (_edgeFaceIndices.size()) {
@@ -493,7 +533,7 @@ Level::print(const Refinement* pRefinement) const {
     }
 
     printf("    Vert relations:\n");
-    printf("      vert-face counts/offset = %lu\n", (unsigned long)_vertFaceCountsAndOffsets.size());
+    printf("      vert-face offsets       = %lu\n", (unsigned long)_vertFaceOffsets.size());
     printf("      vert-face indices       = %lu\n", (unsigned long)_vertFaceIndices.size());
     printf("      vert-face local-indices = %lu\n", (unsigned long)_vertFaceLocalIndices.size());
     if (_vertFaceIndices.size()) {
@@ -505,7 +545,7 @@ Level::print(const Refinement* pRefinement) const {
             printIndexArray(getVertexFaceLocalIndices(i));
         }
     }
-    printf("      vert-edge counts/offset = %lu\n", (unsigned long)_vertEdgeCountsAndOffsets.size());
+    printf("      vert-edge offsets       = %lu\n", (unsigned long)_vertEdgeOffsets.size());
     printf("      vert-edge indices       = %lu\n", (unsigned long)_vertEdgeIndices.size());
     printf("      vert-edge local-indices = %lu\n", (unsigned long)_vertEdgeLocalIndices.size());
     if (_vertEdgeIndices.size()) {
@@ -1375,8 +1415,8 @@ Level::gatherTriRegularCornerEdgePatchPoints(Index fIndex, Index points[], int c
     ConstIndexArray  v4Edges = getVertexEdges(points[4]);
     ConstIndexArray  v7Edges = getVertexEdges(points[7]);
 
-    points[5] = otherOfTwo(getEdgeVertices(v4Edges[v4Edges.size() - 3]), v1);
-    points[6] = otherOfTwo(getEdgeVertices(v7Edges[2]), v1);
+    points[5] = otherOfTwo(getEdgeVertices(v4Edges[v4Edges.size() - 3]), points[4]);
+    points[6] = otherOfTwo(getEdgeVertices(v7Edges[2]), points[7]);
 
     return 8;
 }
@@ -1458,7 +1498,7 @@ namespace {
     //  that do not have a predictable size, i.e. faces-per-edge, faces-per-vertex and
     //  edges-per-vertex.  Level manages these with two vectors:
     //
-    //      - a vector of integer pairs for the "counts" and "offsets"
+    //      - a vector of "offsets" (the "count" of each implied by the next offset)
     //      - a vector of incident members accessed by the "offset" of each
     //
     //  The "dynamic relation" allocates the latter vector of members based on a typical
@@ -1471,13 +1511,15 @@ namespace {
     //  separate vector in an std::map for the component.
     //
     //  Once all incident members have been added, the main vector is compressed and may
-    //  need to merge entries from the map in the process.
+    //  need to merge entries from the map in the process.  The counts and offsets are
+    //  managed as integer pairs during assembly, and the offsets of the Level assigned
+    //  from them once compressed.
     //
     typedef std::map<Index, IndexVector> IrregIndexMap;
 
     class DynamicRelation {
     public:
-        DynamicRelation(IndexVector& countAndOffsets, IndexVector& indices, int membersPerComp);
+        DynamicRelation(IndexVector& offsets, IndexVector& indices, int membersPerComp);
         ~DynamicRelation() { }
 
     public:
@@ -1489,25 +1531,31 @@ namespace {
         void appendComponent();
         int  compressMemberIndices();
 
+    private:
+        void assignOffsets(int memberCount);
+
     public:
         int _compCount;
         int _memberCountPerComp;
 
-        IndexVector & _countsAndOffsets;
+        IndexVector   _countsAndOffsets;
+        IndexVector & _offsets;
         IndexVector & _regIndices;
 
         IrregIndexMap _irregIndices;
     };
 
     inline
-    DynamicRelation::DynamicRelation(IndexVector& countAndOffsets, IndexVector& indices, int membersPerComp) :
+    DynamicRelation::DynamicRelation(IndexVector& offsets, IndexVector& indices, int membersPerComp) :
             _compCount(0),
             _memberCountPerComp(membersPerComp),
-            _countsAndOffsets(countAndOffsets),
+            _offsets(offsets),
             _regIndices(indices) {
 
-        _compCount = (int) _countsAndOffsets.size() / 2;
+        _compCount = (int) _offsets.size() - 1;
 
+        _countsAndOffsets.reserve(2 * _offsets.capacity());
+        _countsAndOffsets.resize(2 * _compCount);
         for (int i = 0; i < _compCount; ++i) {
             _countsAndOffsets[2*i]   = 0;
             _countsAndOffsets[2*i+1] = i * _memberCountPerComp;
@@ -1557,6 +1605,17 @@ namespace {
         ++ _compCount;
         _regIndices.resize(_compCount * _memberCountPerComp);
     }
+    inline void
+    DynamicRelation::assignOffsets(int memberCount) {
+
+        _offsets.resize(_compCount + 1);
+        for (int i = 0; i < _compCount; ++i) {
+            _offsets[i] = _countsAndOffsets[2*i + 1];
+        }
+        _offsets[_compCount] = memberCount;
+
+        IndexVector().swap(_countsAndOffsets);
+    }
     int
     DynamicRelation::compressMemberIndices() {
 
@@ -1574,6 +1633,7 @@ namespace {
                 memberMax    = std::max(memberMax, count);
             }
             _regIndices.resize(memberCount);
+            assignOffsets(memberCount);
             return memberMax;
         } else {
             //  Assign new offsets-per-component while determining if we can trivially compress in place:
@@ -1616,6 +1676,7 @@ namespace {
             } else {
                 _regIndices.resize(memberCount);
             }
+            assignOffsets(memberCount);
             return memberMax;
         }
     }
@@ -1683,7 +1744,7 @@ Level::completeTopologyFromFaceVertices() {
     this->_edgeVertIndices.reserve(eCountEstimate * 2);
     this->_edgeFaceIndices.reserve(eCountEstimate * 2);
 
-    this->_edgeFaceCountsAndOffsets.reserve(eCountEstimate * 2);
+    this->_edgeFaceOffsets.reserve(eCountEstimate + 1);
 
     //
     //  Create the dynamic relations to be populated (edge-faces will remain empty as reserved
@@ -1691,9 +1752,9 @@ Level::completeTopologyFromFaceVertices() {
     //
     const int avgSize = 6;
 
-    DynamicRelation dynEdgeFaces(this->_edgeFaceCountsAndOffsets, this->_edgeFaceIndices, 2);
-    DynamicRelation dynVertFaces(this->_vertFaceCountsAndOffsets, this->_vertFaceIndices, avgSize);
-    DynamicRelation dynVertEdges(this->_vertEdgeCountsAndOffsets, this->_vertEdgeIndices, avgSize);
+    DynamicRelation dynEdgeFaces(this->_edgeFaceOffsets, this->_edgeFaceIndices, 2);
+    DynamicRelation dynVertFaces(this->_vertFaceOffsets, this->_vertFaceIndices, avgSize);
+    DynamicRelation dynVertEdges(this->_vertEdgeOffsets, this->_vertEdgeIndices, avgSize);
 
     //  Inspect each edge created and identify those that are non-manifold as we go:
     IndexVector nonManifoldEdges;
@@ -1905,6 +1966,92 @@ Level::populateLocalIndices() {
     }
 }
 
+namespace {
+    //
+    //  Helpers to reorder per-vertex members -- the members of relations are
+    //  reordered before their offsets, which are then rebuilt from their counts:
+    //
+    template <typename MEMBER>
+    void
+    reorderRelationMembers(std::vector<Index> const & offsets, std::vector<MEMBER> & members,
+                           std::vector<Index> const & vertexOrder) {
+
+        if (members.empty()) return;
+
+        std::vector<MEMBER> reordered(members.size());
+
+        MEMBER * dst = reordered.empty() ? 0 : &reordered[0];
+        for (int i = 0; i < (int)vertexOrder.size(); ++i) {
+            Index vert = vertexOrder[i];
+            for (Index j = offsets[vert]; j < offsets[vert + 1]; ++j) {
+                *dst++ = members[j];
+            }
+        }
+        members.swap(reordered);
+    }
+
+    void
+    reorderRelationOffsets(std::vector<Index> & offsets, std::vector<Index> const & vertexOrder) {
+
+        if (offsets.empty()) return;
+
+        std::vector<Index> reordered(offsets.size());
+        reordered[0] = 0;
+        for (int i = 0; i < (int)vertexOrder.size(); ++i) {
+            Index vert = vertexOrder[i];
+            reordered[i + 1] = reordered[i] + (offsets[vert + 1] - offsets[vert]);
+        }
+        offsets.swap(reordered);
+    }
+
+    template <typename T>
+    void
+    reorderVertexValues(std::vector<T> & values, std::vector<Index> const & vertexOrder) {
+
+        if (values.empty()) return;
+
+        std::vector<T> reordered(vertexOrder.size());
+        for (int i = 0; i < (int)vertexOrder.size(); ++i) {
+            reordered[i] = values[vertexOrder[i]];
+        }
+        values.swap(reordered);
+    }
+}
+
+void
+Level::renumberVertices(std::vector<Index> const & vertexOrder) {
+
+    assert((int)vertexOrder.size() == _vertCount);
+
+    //  Face-varying channels locate members by the vertex-face offsets, so must
+    //  be reordered first:
+    for (int channel = 0; channel < (int)_fvarChannels.size(); ++channel) {
+        _fvarChannels[channel]->renumberVertices(vertexOrder);
+    }
+
+    std::vector<Index> newVertIndices(_vertCount);
+    for (int i = 0; i < _vertCount; ++i) {
+        newVertIndices[vertexOrder[i]] = i;
+    }
+    for (int i = 0; i < (int)_faceVertIndices.size(); ++i) {
+        _faceVertIndices[i] = newVertIndices[_faceVertIndices[i]];
+    }
+    for (int i = 0; i < (int)_edgeVertIndices.size(); ++i) {
+        _edgeVertIndices[i] = newVertIndices[_edgeVertIndices[i]];
+    }
+
+    reorderRelationMembers(_vertFaceOffsets, _vertFaceIndices,      vertexOrder);
+    reorderRelationMembers(_vertFaceOffsets, _vertFaceLocalIndices, vertexOrder);
+    reorderRelationOffsets(_vertFaceOffsets, vertexOrder);
+
+    reorderRelationMembers(_vertEdgeOffsets, _vertEdgeIndices,      vertexOrder);
+    reorderRelationMembers(_vertEdgeOffsets, _vertEdgeLocalIndices, vertexOrder);
+    reorderRelationOffsets(_vertEdgeOffsets, vertexOrder);
+
+    reorderVertexValues(_vertSharpness, vertexOrder);
+    reorderVertexValues(_vertTags,      vertexOrder);
+}
+
 void
 Level::orientIncidentComponents() {
 
@@ -199,6 +199,9 @@ public:
     int getMaxValence() const { return _maxValence; }
     int getMaxEdgeFaces() const { return _maxEdgeFaces; }
 
+    //  Memory used by the relations and tags of the level and its face-varying channels:
+    size_t getByteSize() const;
+
     //  Methods to access the relation tables/indices -- note that for some relations
     //  (i.e. those where a component is "contained by" a neighbor, or more generally
     //  when the neighbor is a simplex of higher dimension) we store an additional
@@ -389,8 +392,12 @@ public:
 
     //  Counts and offsets for all relation types:
     //      - these may be unwarranted if we let Refinement access members directly...
-    int getNumFaceVertices(     Index faceIndex) const { return _faceVertCountsAndOffsets[2*faceIndex]; }
-    int getOffsetOfFaceVertices(Index faceIndex) const { return _faceVertCountsAndOffsets[2*faceIndex + 1]; }
+    int getNumFaceVertices(Index faceIndex) const {
+        return _regFaceSize ? _regFaceSize : (_faceVertOffsets[faceIndex+1] - _faceVertOffsets[faceIndex]);
+    }
+    int getOffsetOfFaceVertices(Index faceIndex) const {
+        return _regFaceSize ? (faceIndex * _regFaceSize) : _faceVertOffsets[faceIndex];
+    }
 
     int getNumFaceEdges(     Index faceIndex) const { return getNumFaceVertices(faceIndex); }
     int getOffsetOfFaceEdges(Index faceIndex) const { return getOffsetOfFaceVertices(faceIndex); }
@@ -398,14 +405,19 @@ public:
     int getNumEdgeVertices(     Index )          const { return 2; }
     int getOffsetOfEdgeVertices(Index edgeIndex) const { return 2 * edgeIndex; }
 
-    int getNumEdgeFaces(     Index edgeIndex) const { return _edgeFaceCountsAndOffsets[2*edgeIndex]; }
-    int getOffsetOfEdgeFaces(Index edgeIndex) const { return _edgeFaceCountsAndOffsets[2*edgeIndex + 1]; }
+    int getNumEdgeFaces(     Index edgeIndex) const { return _edgeFaceOffsets[edgeIndex+1] - _edgeFaceOffsets[edgeIndex]; }
+    int getOffsetOfEdgeFaces(Index edgeIndex) const { return _edgeFaceOffsets[edgeIndex]; }
 
-    int getNumVertexFaces(     Index vertIndex) const { return _vertFaceCountsAndOffsets[2*vertIndex]; }
-    int getOffsetOfVertexFaces(Index vertIndex) const { return _vertFaceCountsAndOffsets[2*vertIndex + 1]; }
+    int getNumVertexFaces(     Index vertIndex) const { return _vertFaceOffsets[vertIndex+1] - _vertFaceOffsets[vertIndex]; }
+    int getOffsetOfVertexFaces(Index vertIndex) const { return _vertFaceOffsets[vertIndex]; }
 
-    int getNumVertexEdges(     Index vertIndex) const { return _vertEdgeCountsAndOffsets[2*vertIndex]; }
-    int getOffsetOfVertexEdges(Index vertIndex) const { return _vertEdgeCountsAndOffsets[2*vertIndex + 1]; }
+    int getNumVertexEdges(     Index vertIndex) const { return _vertEdgeOffsets[vertIndex+1] - _vertEdgeOffsets[vertIndex]; }
+    int getOffsetOfVertexEdges(Index vertIndex) const { return _vertEdgeOffsets[vertIndex]; }
+
+    //  When all faces are of the same size -- as is the case for all refined levels --
+    //  the face-vertex offsets are implicit and not stored (the size is 0 otherwise):
+    int  getRegularFaceSize() const { return _regFaceSize; }
+    void setRegularFaceSize(int faceSize);
 
     ConstIndexArray getFaceVertices() const;
 
@@ -418,6 +430,10 @@ public:
     //  both the size and the appropriate offset, while "trim" is use to quickly lower
     //  the size from an upper bound and nothing else.
     //
+    //  Only offsets are stored for each component -- the count being the difference
+    //  with the offset of the next -- so incident components must be resized (and
+    //  trimmed) in order of increasing component index.
+    //
     void resizeFaceVertices(Index FaceIndex, int count);
 
     void resizeEdgeFaces(Index edgeIndex, int count);
@@ -447,7 +463,15 @@ public:
     bool orderVertexFacesAndEdges(Index vIndex);
     void populateLocalIndices();
 
-    IndexArray shareFaceVertCountsAndOffsets() const;
+    //  The local indices of edge-faces and vertex-edges are only required to refine
+    //  the level (and by its face-varying channels) and can be released once the
+    //  next level is built -- vertex-face local indices are retained for patches:
+    void releaseRefinementLocalIndices();
+    bool hasRefinementLocalIndices() const { return !_releasedLocalIndices; }
+
+    //  Renumber the vertices (given the original index of each in its new position),
+    //  reordering all per-vertex members and those of face-varying channels:
+    void renumberVertices(std::vector<Index> const & vertexOrder);
 
 private:
     //  Refinement classes (including all subclasses) build a Level:
@@ -495,15 +519,23 @@ private:
     //      and child components, and so has been named to reflect that more clearly.
     //
 
+    //  The relations of varying size are stored as a vector of offsets -- one per
+    //  component plus one for the total -- into a packed vector of members.  The
+    //  face-vertex offsets are further omitted when all faces are of the same size,
+    //  i.e. for all refined levels.
+    //
+
     //  Per-face:
-    std::vector<Index> _faceVertCountsAndOffsets;  // 2 per face, redundant after level 0
-    std::vector<Index> _faceVertIndices;           // 3 or 4 per face, variable at level 0
-    std::vector<Index> _faceEdgeIndices;           // matches face-vert indices
-    std::vector<FTag>  _faceTags;                  // 1 per face:  includes "hole" tag
+    int                _regFaceSize;      // 0 unless all faces are of this size
+    bool               _releasedLocalIndices;  // edge-face and vert-edge local indices
+    std::vector<Index> _faceVertOffsets;  // 1 per face (+1), empty if regular
+    std::vector<Index> _faceVertIndices;  // 3 or 4 per face, variable at level 0
+    std::vector<Index> _faceEdgeIndices;  // matches face-vert indices
+    std::vector<FTag>  _faceTags;         // 1 per face:  includes "hole" tag
 
     //  Per-edge:
     std::vector<Index>      _edgeVertIndices;           // 2 per edge
-    std::vector<Index>      _edgeFaceCountsAndOffsets;  // 2 per edge
+    std::vector<Index>      _edgeFaceOffsets;           // 1 per edge (+1)
     std::vector<Index>      _edgeFaceIndices;           // varies with faces per edge
     std::vector<LocalIndex> _edgeFaceLocalIndices;      // varies with faces per edge
 
@@ -511,11 +543,11 @@ private:
     std::vector<ETag>       _edgeTags;                  // 1 per edge:  manifold, boundary, etc.
 
     //  Per-vertex:
-    std::vector<Index>      _vertFaceCountsAndOffsets;  // 2 per vertex
+    std::vector<Index>      _vertFaceOffsets;           // 1 per vertex (+1)
     std::vector<Index>      _vertFaceIndices;           // varies with valence
     std::vector<LocalIndex> _vertFaceLocalIndices;      // varies with valence, 8-bit for now
 
-    std::vector<Index>      _vertEdgeCountsAndOffsets;  // 2 per vertex
+    std::vector<Index>      _vertEdgeOffsets;           // 1 per vertex (+1)
     std::vector<Index>      _vertEdgeIndices;           // varies with valence
     std::vector<LocalIndex> _vertEdgeLocalIndices;      // varies with valence, 8-bit for now
 
@@ -531,22 +563,19 @@ private:
 //
 inline ConstIndexArray
 Level::getFaceVertices(Index faceIndex) const {
-    return ConstIndexArray(&_faceVertIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return ConstIndexArray(&_faceVertIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 inline IndexArray
 Level::getFaceVertices(Index faceIndex) {
-    return IndexArray(&_faceVertIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return IndexArray(&_faceVertIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 
 inline void
 Level::resizeFaceVertices(Index faceIndex, int count) {
 
-    int* countOffsetPair = &_faceVertCountsAndOffsets[faceIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (faceIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _faceVertOffsets[faceIndex+1] = _faceVertOffsets[faceIndex] + count;
 
     _maxValence = std::max(_maxValence, count);
 }
@@ -561,13 +590,13 @@ Level::getFaceVertices() const {
 //
 inline ConstIndexArray
 Level::getFaceEdges(Index faceIndex) const {
-    return ConstIndexArray(&_faceEdgeIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return ConstIndexArray(&_faceEdgeIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 inline IndexArray
 Level::getFaceEdges(Index faceIndex) {
-    return IndexArray(&_faceEdgeIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return IndexArray(&_faceEdgeIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 
 //
@@ -575,36 +604,33 @@ Level::getFaceEdges(Index faceIndex) {
 //
 inline ConstIndexArray
 Level::getVertexFaces(Index vertIndex) const {
-    return ConstIndexArray( (&_vertFaceIndices[0]) + _vertFaceCountsAndOffsets[vertIndex*2+1],
-                          _vertFaceCountsAndOffsets[vertIndex*2]);
+    return ConstIndexArray( (&_vertFaceIndices[0]) + _vertFaceOffsets[vertIndex],
+                          getNumVertexFaces(vertIndex));
 }
 inline IndexArray
 Level::getVertexFaces(Index vertIndex) {
-    return IndexArray( (&_vertFaceIndices[0]) + _vertFaceCountsAndOffsets[vertIndex*2+1],
-                          _vertFaceCountsAndOffsets[vertIndex*2]);
+    return IndexArray( (&_vertFaceIndices[0]) + _vertFaceOffsets[vertIndex],
+                          getNumVertexFaces(vertIndex));
 }
 
 inline ConstLocalIndexArray
 Level::getVertexFaceLocalIndices(Index vertIndex) const {
-    return ConstLocalIndexArray( (&_vertFaceLocalIndices[0]) + _vertFaceCountsAndOffsets[vertIndex*2+1],
-                               _vertFaceCountsAndOffsets[vertIndex*2]);
+    return ConstLocalIndexArray( (&_vertFaceLocalIndices[0]) + _vertFaceOffsets[vertIndex],
+                               getNumVertexFaces(vertIndex));
 }
 inline LocalIndexArray
 Level::getVertexFaceLocalIndices(Index vertIndex) {
-    return LocalIndexArray( (&_vertFaceLocalIndices[0]) + _vertFaceCountsAndOffsets[vertIndex*2+1],
-                               _vertFaceCountsAndOffsets[vertIndex*2]);
+    return LocalIndexArray( (&_vertFaceLocalIndices[0]) + _vertFaceOffsets[vertIndex],
+                               getNumVertexFaces(vertIndex));
 }
 
 inline void
 Level::resizeVertexFaces(Index vertIndex, int count) {
-    int* countOffsetPair = &_vertFaceCountsAndOffsets[vertIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (vertIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _vertFaceOffsets[vertIndex+1] = _vertFaceOffsets[vertIndex] + count;
 }
 inline void
 Level::trimVertexFaces(Index vertIndex, int count) {
-    _vertFaceCountsAndOffsets[vertIndex*2] = count;
+    _vertFaceOffsets[vertIndex+1] = _vertFaceOffsets[vertIndex] + count;
 }
 
 //
@@ -612,38 +638,35 @@ Level::trimVertexFaces(Index vertIndex, int count) {
 //
 inline ConstIndexArray
 Level::getVertexEdges(Index vertIndex) const {
-    return ConstIndexArray( (&_vertEdgeIndices[0]) +_vertEdgeCountsAndOffsets[vertIndex*2+1],
-                          _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return ConstIndexArray( (&_vertEdgeIndices[0]) +_vertEdgeOffsets[vertIndex],
+                          getNumVertexEdges(vertIndex));
 }
 inline IndexArray
 Level::getVertexEdges(Index vertIndex) {
-    return IndexArray( (&_vertEdgeIndices[0]) +_vertEdgeCountsAndOffsets[vertIndex*2+1],
-                          _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return IndexArray( (&_vertEdgeIndices[0]) +_vertEdgeOffsets[vertIndex],
+                          getNumVertexEdges(vertIndex));
 }
 
 inline ConstLocalIndexArray
 Level::getVertexEdgeLocalIndices(Index vertIndex) const {
-    return ConstLocalIndexArray( (&_vertEdgeLocalIndices[0]) + _vertEdgeCountsAndOffsets[vertIndex*2+1],
-                               _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return ConstLocalIndexArray( (&_vertEdgeLocalIndices[0]) + _vertEdgeOffsets[vertIndex],
+                               getNumVertexEdges(vertIndex));
 }
 inline LocalIndexArray
 Level::getVertexEdgeLocalIndices(Index vertIndex) {
-    return LocalIndexArray( (&_vertEdgeLocalIndices[0]) + _vertEdgeCountsAndOffsets[vertIndex*2+1],
-                               _vertEdgeCountsAndOffsets[vertIndex*2]);
+    return LocalIndexArray( (&_vertEdgeLocalIndices[0]) + _vertEdgeOffsets[vertIndex],
+                               getNumVertexEdges(vertIndex));
 }
 
 inline void
 Level::resizeVertexEdges(Index vertIndex, int count) {
-    int* countOffsetPair = &_vertEdgeCountsAndOffsets[vertIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (vertIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _vertEdgeOffsets[vertIndex+1] = _vertEdgeOffsets[vertIndex] + count;
 
     _maxValence = std::max(_maxValence, count);
 }
 inline void
 Level::trimVertexEdges(Index vertIndex, int count) {
-    _vertEdgeCountsAndOffsets[vertIndex*2] = count;
+    _vertEdgeOffsets[vertIndex+1] = _vertEdgeOffsets[vertIndex] + count;
 }
 
 inline void
@@ -669,41 +692,38 @@ Level::getEdgeVertices(Index edgeIndex) {
 inline ConstIndexArray
 Level::getEdgeFaces(Index edgeIndex) const {
     return ConstIndexArray(&_edgeFaceIndices[0] + 
-                           _edgeFaceCountsAndOffsets[edgeIndex*2+1],
-                           _edgeFaceCountsAndOffsets[edgeIndex*2]);
+                           _edgeFaceOffsets[edgeIndex],
+                           getNumEdgeFaces(edgeIndex));
 }
 inline IndexArray
 Level::getEdgeFaces(Index edgeIndex) {
     return IndexArray(&_edgeFaceIndices[0] +
-                      _edgeFaceCountsAndOffsets[edgeIndex*2+1],
-                      _edgeFaceCountsAndOffsets[edgeIndex*2]);
+                      _edgeFaceOffsets[edgeIndex],
+                      getNumEdgeFaces(edgeIndex));
 }
 
 inline ConstLocalIndexArray
 Level::getEdgeFaceLocalIndices(Index edgeIndex) const {
     return ConstLocalIndexArray(&_edgeFaceLocalIndices[0] +
-                                _edgeFaceCountsAndOffsets[edgeIndex*2+1],
-                                _edgeFaceCountsAndOffsets[edgeIndex*2]);
+                                _edgeFaceOffsets[edgeIndex],
+                                getNumEdgeFaces(edgeIndex));
 }
 inline LocalIndexArray
 Level::getEdgeFaceLocalIndices(Index edgeIndex) {
     return LocalIndexArray(&_edgeFaceLocalIndices[0] +
-                           _edgeFaceCountsAndOffsets[edgeIndex*2+1],
-                           _edgeFaceCountsAndOffsets[edgeIndex*2]);
+                           _edgeFaceOffsets[edgeIndex],
+                           getNumEdgeFaces(edgeIndex));
 }
 
 inline void
 Level::resizeEdgeFaces(Index edgeIndex, int count) {
-    int* countOffsetPair = &_edgeFaceCountsAndOffsets[edgeIndex*2];
-
-    countOffsetPair[0] = count;
-    countOffsetPair[1] = (edgeIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
+    _edgeFaceOffsets[edgeIndex+1] = _edgeFaceOffsets[edgeIndex] + count;
 
     _maxEdgeFaces = std::max(_maxEdgeFaces, count);
 }
 inline void
 Level::trimEdgeFaces(Index edgeIndex, int count) {
-    _edgeFaceCountsAndOffsets[edgeIndex*2] = count;
+    _edgeFaceOffsets[edgeIndex+1] = _edgeFaceOffsets[edgeIndex] + count;
 }
 
 //
@@ -771,7 +791,9 @@ Level::isVertexNonManifold(Index vertIndex) const {
 inline void
 Level::resizeFaces(int faceCount) {
     _faceCount = faceCount;
-    _faceVertCountsAndOffsets.resize(2 * faceCount);
+    if (_regFaceSize == 0) {
+        _faceVertOffsets.resize(faceCount + 1, 0);
+    }
 
     _faceTags.resize(faceCount);
     std::memset(&_faceTags[0], 0, _faceCount * sizeof(FTag));
@@ -789,7 +811,7 @@ inline void
 Level::resizeEdges(int edgeCount) {
 
     _edgeCount = edgeCount;
-    _edgeFaceCountsAndOffsets.resize(2 * edgeCount);
+    _edgeFaceOffsets.resize(edgeCount + 1, 0);
 
     _edgeSharpness.resize(edgeCount);
     _edgeTags.resize(edgeCount);
@@ -814,8 +836,8 @@ inline void
 Level::resizeVertices(int vertCount) {
 
     _vertCount = vertCount;
-    _vertFaceCountsAndOffsets.resize(2 * vertCount);
-    _vertEdgeCountsAndOffsets.resize(2 * vertCount);
+    _vertFaceOffsets.resize(vertCount + 1, 0);
+    _vertEdgeOffsets.resize(vertCount + 1, 0);
 
     _vertSharpness.resize(vertCount);
     _vertTags.resize(vertCount);
@@ -834,12 +856,22 @@ Level::resizeVertexEdges(int totalVertEdgeCount) {
     _vertEdgeLocalIndices.resize(totalVertEdgeCount);
 }
 
-inline IndexArray
-Level::shareFaceVertCountsAndOffsets() const {
-    // XXXX manuelk we have to force const casting here (classes don't 'share'
-    // members usually...)
-    return IndexArray(const_cast<Index *>(&_faceVertCountsAndOffsets[0]),
-        (int)_faceVertCountsAndOffsets.size());
+inline void
+Level::setRegularFaceSize(int faceSize) {
+    _regFaceSize = faceSize;
+
+    std::vector<Index>().swap(_faceVertOffsets);
+
+    _maxValence = std::max(_maxValence, faceSize);
+}
+
+inline void
+Level::releaseRefinementLocalIndices() {
+
+    std::vector<LocalIndex>().swap(_edgeFaceLocalIndices);
+    std::vector<LocalIndex>().swap(_vertEdgeLocalIndices);
+
+    _releasedLocalIndices = true;
 }
 
 } // end namespace internal
@@ -70,18 +70,14 @@ QuadRefinement::allocateParentChildIndices() {
     int vertChildVertCount = _parent->getNumVertices();
 
     //
-    //  First reference the parent Level's face-vertex counts/offsets -- they can be used
-    //  here for both the face-child-faces and face-child-edges as they both have one per
-    //  face-vertex.
+    //  Note the parent Level's face-vertex counts/offsets are used to access both the
+    //  face-child-faces and face-child-edges as they both have one per face-vertex.
     //
     //  Given we will be ignoring initial values with uniform refinement and assigning all
     //  directly, initializing here is a waste...
     //
     Index initValue = 0;
 
-    _faceChildFaceCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-    _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-
     _faceChildFaceIndices.resize(faceChildFaceCount, initValue);
     _faceChildEdgeIndices.resize(faceChildEdgeCount, initValue);
     _edgeChildEdgeIndices.resize(edgeChildEdgeCount, initValue);
@@ -99,28 +95,15 @@ QuadRefinement::allocateParentChildIndices() {
 void
 QuadRefinement::populateFaceVertexRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets within a
-    //  Level, so be sure not to re-initialize it if already done:
+    //  All child faces are quads, so the face-vertex counts/offsets (shared by the
+    //  face-edges) are implicit:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
+    _child->setRegularFaceSize(4);
     _child->_faceVertIndices.resize(_child->getNumFaces() * 4);
 
     populateFaceVerticesFromParentFaces();
 }
 
-void
-QuadRefinement::populateFaceVertexCountsAndOffsets() {
-
-    _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2);
-
-    for (int i = 0; i < _child->getNumFaces(); ++i) {
-        _child->_faceVertCountsAndOffsets[i*2 + 0] = 4;
-        _child->_faceVertCountsAndOffsets[i*2 + 1] = i << 2;
-    }
-}
-
 void
 QuadRefinement::populateFaceVerticesFromParentFaces() {
 
@@ -180,12 +163,9 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
 void
 QuadRefinement::populateFaceEdgeRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets, so be sure
-    //  not to re-initialize it if already done:
+    //  Both face-vertex and face-edge share the implicit face-vertex counts/offsets:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
+    _child->setRegularFaceSize(4);
     _child->_faceEdgeIndices.resize(_child->getNumFaces() * 4);
 
     populateFaceEdgesFromParentFaces();
@@ -367,7 +347,7 @@ QuadRefinement::populateEdgeFaceRelation() {
     int childEdgeFaceIndexSizeEstimate = (int)_parent->_faceVertIndices.size() * 2 +
                                          (int)_parent->_edgeFaceIndices.size() * 2;
 
-    _child->_edgeFaceCountsAndOffsets.resize(_child->getNumEdges() * 2);
+    _child->_edgeFaceOffsets.resize(_child->getNumEdges() + 1, 0);
     _child->_edgeFaceIndices.resize(     childEdgeFaceIndexSizeEstimate);
     _child->_edgeFaceLocalIndices.resize(childEdgeFaceIndexSizeEstimate);
 
@@ -535,7 +515,7 @@ QuadRefinement::populateVertexFaceRelation() {
                                        + (int)_parent->_edgeFaceIndices.size() * 2
                                        + (int)_parent->_vertFaceIndices.size();
 
-    _child->_vertFaceCountsAndOffsets.resize(_child->getNumVertices() * 2);
+    _child->_vertFaceOffsets.resize(_child->getNumVertices() + 1, 0);
     _child->_vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
@@ -722,7 +702,7 @@ QuadRefinement::populateVertexEdgeRelation() {
                                        + (int)_parent->_edgeFaceIndices.size() + _parent->getNumEdges() * 2
                                        + (int)_parent->_vertEdgeIndices.size();
 
-    _child->_vertEdgeCountsAndOffsets.resize(_child->getNumVertices() * 2);
+    _child->_vertEdgeOffsets.resize(_child->getNumVertices() + 1, 0);
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
@@ -68,7 +68,6 @@ protected:
     //
     //  Internal helper methods for populating the topology:
     //
-    void populateFaceVertexCountsAndOffsets();
     void populateFaceVerticesFromParentFaces();
 
     void populateFaceEdgesFromParentFaces();
@@ -52,6 +52,7 @@ Refinement::Refinement(Level const & parentArg, Level & childArg, Sdc::Options c
     _regFaceSize(-1),
     _uniform(false),
     _faceVertsFirst(false),
+    _releasedChildEdges(false),
     _childFaceFromFaceCount(0),
     _childEdgeFromFaceCount(0),
     _childEdgeFromEdgeCount(0),
@@ -76,6 +77,44 @@ Refinement::~Refinement() {
     }
 }
 
+size_t
+Refinement::getByteSize() const {
+
+    size_t memory = (_faceChildFaceIndices.size() +
+                     _faceChildEdgeIndices.size() +
+                     _faceChildVertIndex.size() +
+                     _edgeChildEdgeIndices.size() +
+                     _edgeChildVertIndex.size() +
+                     _vertChildVertIndex.size() +
+                     _childFaceParentIndex.size() +
+                     _childEdgeParentIndex.size() +
+                     _childVertexParentIndex.size()) * sizeof(Index) +
+                    (_childFaceTag.size() +
+                     _childEdgeTag.size() +
+                     _childVertexTag.size()) * sizeof(ChildTag) +
+                    (_parentFaceTag.size() +
+                     _parentEdgeTag.size() +
+                     _parentVertexTag.size()) * sizeof(SparseTag);
+
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        memory += _fvarChannels[i]->getByteSize();
+    }
+    return memory;
+}
+
+void
+Refinement::releaseChildEdgeMappings() {
+
+    IndexVector().swap(_faceChildEdgeIndices);
+    IndexVector().swap(_edgeChildEdgeIndices);
+    IndexVector().swap(_childEdgeParentIndex);
+
+    std::vector<ChildTag>().swap(_childEdgeTag);
+    std::vector<SparseTag>().swap(_parentEdgeTag);
+
+    _releasedChildEdges = true;
+}
+
 void
 Refinement::initializeChildComponentCounts() {
 
@@ -112,6 +151,7 @@ Refinement::initializeSparseSelectionTags() {
 //          - using the minimum required in the last Level is very advantageous
 //      - subdivide the sharpness values in the child Level
 //      - subdivide face-varying channels in the child Level
+//      - optionally reorder the child vertices now that the child Level is complete
 //
 void
 Refinement::refine(Options refineOptions) {
@@ -166,6 +206,10 @@ Refinement::refine(Options refineOptions) {
         subdivideFVarChannels();
     }
 
+    if (refineOptions._vertsByParentFace) {
+        reorderChildVerticesByParentFace();
+    }
+
     //  Various debugging support:
     //
     //printf("Vertex refinement to level %d completed...\n", _child->getDepth());
@@ -1082,6 +1126,91 @@ Refinement::subdivideFVarChannels() {
     }
 }
 
+//
+//  Methods to reorder child components:
+//
+//  Child vertices are numbered by the type of their parent -- all those from faces,
+//  then those from edges, then those from vertices (or vertices first) -- so that
+//  children of neighboring parent components are widely separated.  Renumbering
+//  them by parent face -- each face adding the children of its vertices and edges
+//  not already added, followed by its own child -- keeps the children of each face
+//  together, with the children of faces adjacent in the parent remaining close.
+//
+//  The topology is populated in the original order, as the incremental resizing of
+//  relations requires, and all members indexed by or referring to child vertices
+//  are then reordered in place.  Child vertices not incident any parent face (e.g.
+//  isolated vertices) follow all others in their original order:
+//
+namespace {
+    inline void
+    appendChildVertex(Index cVert, std::vector<Index> & vertexOrder,
+                      std::vector<Index> & newVertIndices) {
+
+        if (IndexIsValid(cVert) && !IndexIsValid(newVertIndices[cVert])) {
+            newVertIndices[cVert] = (Index) vertexOrder.size();
+            vertexOrder.push_back(cVert);
+        }
+    }
+
+    inline void
+    renumberIndices(IndexVector & indices, std::vector<Index> const & newIndices) {
+
+        for (int i = 0; i < (int)indices.size(); ++i) {
+            if (IndexIsValid(indices[i])) {
+                indices[i] = newIndices[indices[i]];
+            }
+        }
+    }
+
+    template <typename T>
+    inline void
+    reorderValues(std::vector<T> & values, std::vector<Index> const & order) {
+
+        std::vector<T> reordered(order.size());
+        for (int i = 0; i < (int)order.size(); ++i) {
+            reordered[i] = values[order[i]];
+        }
+        values.swap(reordered);
+    }
+}
+
+void
+Refinement::reorderChildVerticesByParentFace() {
+
+    int childVertCount = _child->getNumVertices();
+
+    std::vector<Index> vertexOrder;
+    std::vector<Index> newVertIndices(childVertCount, INDEX_INVALID);
+
+    vertexOrder.reserve(childVertCount);
+
+    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+        ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace);
+        ConstIndexArray pFaceEdges = _parent->getFaceEdges(pFace);
+
+        for (int i = 0; i < pFaceVerts.size(); ++i) {
+            appendChildVertex(_vertChildVertIndex[pFaceVerts[i]], vertexOrder, newVertIndices);
+            appendChildVertex(_edgeChildVertIndex[pFaceEdges[i]], vertexOrder, newVertIndices);
+        }
+        if (!_faceChildVertIndex.empty()) {
+            appendChildVertex(_faceChildVertIndex[pFace], vertexOrder, newVertIndices);
+        }
+    }
+    for (Index cVert = 0; cVert < childVertCount; ++cVert) {
+        appendChildVertex(cVert, vertexOrder, newVertIndices);
+    }
+    assert((int)vertexOrder.size() == childVertCount);
+
+    renumberIndices(_faceChildVertIndex, newVertIndices);
+    renumberIndices(_edgeChildVertIndex, newVertIndices);
+    renumberIndices(_vertChildVertIndex, newVertIndices);
+
+    reorderValues(_childVertexParentIndex, vertexOrder);
+    reorderValues(_childVertexTag,         vertexOrder);
+
+    _child->renumberVertices(vertexOrder);
+}
+
 //
 //  Marking of sparse child components -- including those selected and those neighboring...
 //
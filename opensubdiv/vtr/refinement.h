@@ -80,6 +80,9 @@ public:
     int getRegularFaceSize() const { return _regFaceSize; }
     Sdc::Options getOptions() const { return _options; }
 
+    //  Memory used by the mappings and tags of the refinement and its face-varying channels:
+    size_t getByteSize() const;
+
     //  Face-varying:
     int getNumFVarChannels() const { return (int) _fvarChannels.size(); }
 
@@ -100,6 +103,12 @@ public:
     //          vertex-faces for any face-varying channels present.  So it will
     //          generate one or two of the six possible topological relations.
     //
+    //      "verts by parent face":  once the child level is complete, renumber its
+    //          vertices so that the children of each parent face (from the face,
+    //          its edges and its vertices) are adjacent, rather than grouping them
+    //          by the type of their parent.  Child vertices are then no longer in
+    //          the ranges indicated by the "first child vertex" methods below.
+    //
     //  These are strictly controlled right now, e.g. for sparse refinement, we
     //  currently enforce full topology at the finest level to allow for subsequent
     //  patch construction.
@@ -107,12 +116,14 @@ public:
     struct Options {
         Options() : _sparse(false),
                     _faceVertsFirst(false),
-                    _minimalTopology(false)
+                    _minimalTopology(false),
+                    _vertsByParentFace(false)
                     { }
 
-        unsigned int _sparse          : 1;
-        unsigned int _faceVertsFirst  : 1;
-        unsigned int _minimalTopology : 1;
+        unsigned int _sparse            : 1;
+        unsigned int _faceVertsFirst    : 1;
+        unsigned int _minimalTopology   : 1;
+        unsigned int _vertsByParentFace : 1;
 
         //  Still under consideration:
         //unsigned int _childToParentMap : 1;
@@ -120,6 +131,11 @@ public:
 
     void refine(Options options = Options());
 
+    //  The child edges of parent faces and edges (and the tags and parents of child
+    //  edges) are only required while refining -- release them when no longer needed:
+    void releaseChildEdgeMappings();
+    bool hasChildEdgeMappings() const { return !_releasedChildEdges; }
+
     bool hasFaceVerticesFirst() const { return _faceVertsFirst; }
 
 public:
@@ -319,6 +335,11 @@ public:
     //
     void subdivideFVarChannels();
 
+    //
+    //  Methods involved in reordering child components once complete:
+    //
+    void reorderChildVerticesByParentFace();
+
 protected:
     // A debug method of Level prints a Refinement (should really change this)
     friend void Level::print(const Refinement *) const;
@@ -341,6 +362,9 @@ protected:
     bool _uniform;
     bool _faceVertsFirst;
 
+    //  Set once the child edge mappings have been released:
+    bool _releasedChildEdges;
+
     //
     //  Inventory and ordering of the types of child components:
     //
@@ -366,14 +390,11 @@ protected:
     //  that have not spawned all child components will have their missing children
     //  marked as invalid.
     //
-    //  NOTE the "Array" members here.  Often vectors within the Level can be shared
-    //  with the Refinement, and an Array instance is used to do so.  If not shared
-    //  the subclass just initializes the Array members after allocating its own local
-    //  vector members.
+    //  The children of parent faces are located using the face-vertex counts/offsets
+    //  of the parent Level -- there being one child edge per face-vertex and one child
+    //  face per face-vertex with the quad-split -- while the tri-split (applied only
+    //  to triangles) has a fixed four child faces per face.
     //
-    IndexArray _faceChildFaceCountsAndOffsets;
-    IndexArray _faceChildEdgeCountsAndOffsets;
-
     IndexVector _faceChildFaceIndices;  // *cannot* always use face-vert counts/offsets
     IndexVector _faceChildEdgeIndices;  // can use face-vert counts/offsets
     IndexVector _faceChildVertIndex;
@@ -410,28 +431,34 @@ protected:
 inline ConstIndexArray
 Refinement::getFaceChildFaces(Index parentFace) const {
 
-    return ConstIndexArray(&_faceChildFaceIndices[_faceChildFaceCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildFaceCountsAndOffsets[2*parentFace]);
+    if (_splitType == Sdc::SPLIT_TO_TRIS) {
+        return ConstIndexArray(&_faceChildFaceIndices[4*parentFace], 4);
+    }
+    return ConstIndexArray(&_faceChildFaceIndices[_parent->getOffsetOfFaceVertices(parentFace)],
+                                                  _parent->getNumFaceVertices(parentFace));
 }
 
 inline IndexArray
 Refinement::getFaceChildFaces(Index parentFace) {
 
-    return IndexArray(&_faceChildFaceIndices[_faceChildFaceCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildFaceCountsAndOffsets[2*parentFace]);
+    if (_splitType == Sdc::SPLIT_TO_TRIS) {
+        return IndexArray(&_faceChildFaceIndices[4*parentFace], 4);
+    }
+    return IndexArray(&_faceChildFaceIndices[_parent->getOffsetOfFaceVertices(parentFace)],
+                                             _parent->getNumFaceVertices(parentFace));
 }
 
 inline ConstIndexArray
 Refinement::getFaceChildEdges(Index parentFace) const {
 
-    return ConstIndexArray(&_faceChildEdgeIndices[_faceChildEdgeCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildEdgeCountsAndOffsets[2*parentFace]);
+    return ConstIndexArray(&_faceChildEdgeIndices[_parent->getOffsetOfFaceVertices(parentFace)],
+                                                  _parent->getNumFaceVertices(parentFace));
 }
 inline IndexArray
 Refinement::getFaceChildEdges(Index parentFace) {
 
-    return IndexArray(&_faceChildEdgeIndices[_faceChildEdgeCountsAndOffsets[2*parentFace+1]],
-                                             _faceChildEdgeCountsAndOffsets[2*parentFace]);
+    return IndexArray(&_faceChildEdgeIndices[_parent->getOffsetOfFaceVertices(parentFace)],
+                                             _parent->getNumFaceVertices(parentFace));
 }
 
 inline ConstIndexArray
@@ -78,21 +78,11 @@ TriRefinement::allocateParentChildIndices() {
     int vertChildVertCount = _parent->getNumVertices();
 
     //
-    //  First initialize the count/offset vectors for the child-faces and child-edges of
-    //  parent faces.  For now we can use the parent's face-vert counts for the child-edges
-    //  of faces, but we must use a local vector for the child-faces.
+    //  Note the parent's face-vert counts/offsets are used to access the child-edges of
+    //  faces, while the child-faces are a fixed four per face.
     //
-    //  This will be more necessary (and need adjustment) when N-sided faces are supported.
+    //  This will need adjustment when N-sided faces are supported.
     //
-    _localFaceChildFaceCountsAndOffsets.resize(_parent->getNumFaces() * 2, 4);
-    for (int i = 0; i < _parent->getNumFaces(); ++i) {
-        _localFaceChildFaceCountsAndOffsets[i*2 + 1] = 4 * i;
-    }
-
-    _faceChildFaceCountsAndOffsets = IndexArray(&_localFaceChildFaceCountsAndOffsets[0],
-                                                (int)_localFaceChildFaceCountsAndOffsets.size());
-    _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-
     //
     //  Given we will be ignoring initial values with uniform refinement and assigning all
     //  directly, initializing here is a waste...
@@ -116,27 +106,15 @@ TriRefinement::allocateParentChildIndices() {
 void
 TriRefinement::populateFaceVertexRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets within a
-    //  Level, so be sure not to re-initialize it if already done:
+    //  All child faces are triangles, so the face-vertex counts/offsets (shared by the
+    //  face-edges) are implicit:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
+    _child->setRegularFaceSize(3);
     _child->_faceVertIndices.resize(_child->getNumFaces() * 3);
 
     populateFaceVerticesFromParentFaces();
 }
 
-void
-TriRefinement::populateFaceVertexCountsAndOffsets() {
-
-    _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2, 3);
-
-    for (int i = 0; i < _child->getNumFaces(); ++i) {
-        _child->_faceVertCountsAndOffsets[i*2 + 1] = i * 3;
-    }
-}
-
 void
 TriRefinement::populateFaceVerticesFromParentFaces() {
 
@@ -202,12 +180,9 @@ TriRefinement::populateFaceVerticesFromParentFaces() {
 void
 TriRefinement::populateFaceEdgeRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets, so be sure
-    //  not to re-initialize it if already done:
+    //  Both face-vertex and face-edge share the implicit face-vertex counts/offsets:
     //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
+    _child->setRegularFaceSize(3);
     _child->_faceEdgeIndices.resize(_child->getNumFaces() * 3);
 
     populateFaceEdgesFromParentFaces();
@@ -363,7 +338,7 @@ TriRefinement::populateEdgeFaceRelation() {
     int childEdgeFaceIndexSizeEstimate = (int)_faceChildEdgeIndices.size() * 2 +
                                          (int)_parent->_edgeFaceIndices.size() * 2;
 
-    _child->_edgeFaceCountsAndOffsets.resize(_child->getNumEdges() * 2);
+    _child->_edgeFaceOffsets.resize(_child->getNumEdges() + 1, 0);
     _child->_edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
     _child->_edgeFaceLocalIndices.resize(childEdgeFaceIndexSizeEstimate);
 
@@ -514,7 +489,7 @@ TriRefinement::populateVertexFaceRelation() {
     int childVertFaceIndexSizeEstimate = (int)_parent->_edgeFaceIndices.size() * 3
                                        + (int)_parent->_vertFaceIndices.size();
 
-    _child->_vertFaceCountsAndOffsets.resize(_child->getNumVertices() * 2);
+    _child->_vertFaceOffsets.resize(_child->getNumVertices() + 1, 0);
     _child->_vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
@@ -675,7 +650,7 @@ TriRefinement::populateVertexEdgeRelation() {
     int childVertEdgeIndexSizeEstimate = (int)_parent->_edgeFaceIndices.size() * 2 + _parent->getNumEdges() * 2
                                        + (int)_parent->_vertEdgeIndices.size();
 
-    _child->_vertEdgeCountsAndOffsets.resize(_child->getNumVertices() * 2);
+    _child->_vertEdgeOffsets.resize(_child->getNumVertices() + 1, 0);
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
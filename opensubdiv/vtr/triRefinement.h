@@ -70,7 +70,6 @@ protected:
     //  identical to what is used for quad-splitting, so we may move them to the
     //  base class...
     //
-    void populateFaceVertexCountsAndOffsets();
     void populateFaceVerticesFromParentFaces();
 
     void populateFaceEdgesFromParentFaces();
@@ -86,15 +85,6 @@ protected:
 
     void populateVertexEdgesFromParentEdges();
     void populateVertexEdgesFromParentVertices();
-
-private:
-    //
-    //  Unlike the quad-split, which can share some vectors with the parent Level since
-    //  child components correspond to face-vertices, the tri-split must define its
-    //  own local vectors to identify the children for each parent component -- to
-    //  be referenced within the base class for more immediate/inline access:
-    //
-    IndexVector _localFaceChildFaceCountsAndOffsets;
 };
 
 } // end namespace internal
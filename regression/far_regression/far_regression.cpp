@@ -24,7 +24,23 @@
 
 #include <cassert>
 #include <cstdio>
-
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include <far/error.h>
+#include <far/patchMap.h>
+#include <far/patchTableFactory.h>
+#include <far/primvarRefinerPlan.h>
+#include <far/ptexIndices.h>
+#include <far/stencilTableFactory.h>
+#include <far/tileRefiner.h>
+#include <far/triangleIndices.h>
+#include <osd/cpuEvaluator.h>
+#include <osd/cpuPatchBVH.h>
+#include <osd/cpuPatchTable.h>
+#include <osd/cpuTessellator.h>
+#include <osd/cpuVertexBuffer.h>
 
 #include "../../regression/common/hbr_utils.h"
 #include "../../regression/common/far_utils.h"
@@ -119,6 +135,13 @@ typedef OpenSubdiv::Sdc::Options                       SdcOptions;
 typedef OpenSubdiv::Far::TopologyLevel                 FarTopologyLevel;
 typedef OpenSubdiv::Far::TopologyRefiner               FarTopologyRefiner;
 typedef OpenSubdiv::Far::TopologyRefinerFactory<Shape> FarTopologyRefinerFactory;
+typedef OpenSubdiv::Far::PatchTable                    FarPatchTable;
+typedef OpenSubdiv::Far::PatchTableFactory             FarPatchTableFactory;
+typedef OpenSubdiv::Far::PatchMap                      FarPatchMap;
+typedef OpenSubdiv::Far::StencilTable                  FarStencilTable;
+typedef OpenSubdiv::Far::StencilTableFactory           FarStencilTableFactory;
+typedef OpenSubdiv::Far::LimitStencilTable             FarLimitStencilTable;
+typedef OpenSubdiv::Far::LimitStencilTableFactory      FarLimitStencilTableFactory;
 
 //------------------------------------------------------------------------------
 #ifdef foo
@@ -307,26 +330,2768 @@ areVerticesCompatibleWithHbr(Shape const & shape, FarTopologyRefiner const & ref
 }
 
 //------------------------------------------------------------------------------
+//
+// Regression testing of Far features against reference evaluations
+//
+// Notes:
+// - each check refines its own copy of the shape, as most features require
+//   a particular form of refinement
+//
+// - values are compared within a precision relative to the size of the
+//   shape, as the features accumulate weights in a different order than
+//   the reference evaluations
+//
+#define FEATURE_PRECISION 1e-5
+
+static FarTopologyRefiner *
+createRefiner(Shape const & shape) {
+
+    return FarTopologyRefinerFactory::Create(shape,
+        FarTopologyRefinerFactory::Options(GetSdcType(shape), GetSdcOptions(shape)));
+}
+
+static void
+getControlVertexData(Shape const & shape, std::vector<xyzVV> & vertexData) {
+
+    vertexData.resize(shape.GetNumVertices());
+    for (int i=0; i<shape.GetNumVertices(); ++i) {
+        vertexData[i].SetPosition(shape.verts[i*3+0],
+                                  shape.verts[i*3+1],
+                                  shape.verts[i*3+2]);
+    }
+}
+
+static float
+getTolerance(std::vector<xyzVV> const & vertexData) {
+
+    float extent = 0.0f;
+    for (int i=0; i<(int)vertexData.size(); ++i) {
+        for (int k=0; k<3; ++k) {
+            extent = std::max(extent, std::abs(vertexData[i].GetPos()[k]));
+        }
+    }
+    return (float)FEATURE_PRECISION * std::max(extent, 1.0f);
+}
+
+static float
+getDistance(xyzVV const & a, xyzVV const & b) {
+
+    float delta[3] = { a.GetPos()[0] - b.GetPos()[0],
+                       a.GetPos()[1] - b.GetPos()[1],
+                       a.GetPos()[2] - b.GetPos()[2] };
+    return sqrtf(delta[0]*delta[0] + delta[1]*delta[1] + delta[2]*delta[2]);
+}
+
+// Compares values with those of a reference and reports a single failure
 static int
-checkMesh(Shape const & shape, std::string const& name, int maxlevel) {
+compareFeatureData(char const * feature, std::vector<xyzVV> const & values,
+                   std::vector<xyzVV> const & reference, float tolerance) {
 
-    std::string warningDetail;
+    if (values.size() != reference.size()) {
+        printf("  %s fails : %d values instead of %d\n", feature,
+               (int)values.size(), (int)reference.size());
+        return 1;
+    }
 
-    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
-    printf("- %-25s ( %-8s ): \n", name.c_str(), schemes[shape.scheme]);
+    int count = 0;
+    float maxDist = 0.0f;
+    for (int i=0; i<(int)values.size(); ++i) {
+        float dist = getDistance(values[i], reference[i]);
+        if (dist > tolerance) {
+            ++count;
+        }
+        maxDist = std::max(maxDist, dist);
+    }
+    if (count) {
+        printf("  %s fails : %d of %d values differ (max dist=%.10f)\n",
+               feature, count, (int)values.size(), maxDist);
+        return 1;
+    }
+    return 0;
+}
 
-    // Refine and interpolate vertex data for every shape:
-    std::vector<xyzVV> farVertexData;
+// Creates the stencils of the points of a PatchTable -- the control vertices,
+// the refined vertices indexed by its patches and its local points
+static FarStencilTable const *
+createPatchPointStencils(FarTopologyRefiner const & refiner, FarPatchTable const & patchTable) {
 
-    FarTopologyRefiner * refiner = InterpolateFarVertexData<xyzVV>(shape, maxlevel, farVertexData);
+    FarStencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateIntermediateLevels = ! refiner.IsUniform();
+    options.generateOffsets = true;
 
-    // Perform relevant tests and accumulate failures:
-    int failureCount = 0;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
 
-    if (areVerticesCompatibleWithHbr(shape, *refiner, &warningDetail)) {
-        failureCount = compareVerticesWithHbr(shape, *refiner, farVertexData);
+    if (FarStencilTable const * localPoints = patchTable.GetLocalPointStencilTable()) {
+        FarStencilTable const * table =
+            FarStencilTableFactory::AppendLocalPointStencilTable(refiner, stencils, localPoints);
+        delete stencils;
+        stencils = table;
+    }
+    return stencils;
+}
+
+static void
+computePatchPoints(FarTopologyRefiner const & refiner, FarPatchTable const & patchTable,
+                   std::vector<xyzVV> const & controlVerts, std::vector<xyzVV> & patchPoints) {
+
+    FarStencilTable const * stencils = createPatchPointStencils(refiner, patchTable);
+
+    patchPoints.resize(stencils->GetNumStencils());
+    stencils->UpdateValues(&controlVerts[0], &patchPoints[0]);
+
+    delete stencils;
+}
+
+// Evaluates a patch at the given (u,v) of its base face
+static void
+evaluatePatch(FarPatchTable const & patchTable, FarPatchTable::PatchHandle const & handle,
+              float u, float v, std::vector<xyzVV> const & patchPoints, xyzVV & result) {
+
+    OpenSubdiv::Far::ConstIndexArray cvs = patchTable.GetPatchVertices(handle);
+
+    std::vector<float> weights(cvs.size());
+    patchTable.EvaluateBasis(handle, u, v, &weights[0]);
+
+    result.Clear();
+    for (int i=0; i<cvs.size(); ++i) {
+        result.AddWithWeight(patchPoints[cvs[i]], weights[i]);
+    }
+}
+
+// Evaluates the position and first derivatives of a patch at the given (u,v)
+// of its base face
+static void
+evaluatePatchDerivatives(FarPatchTable const & patchTable,
+                         FarPatchTable::PatchHandle const & handle, float u, float v,
+                         std::vector<xyzVV> const & patchPoints, float result[3][3]) {
+
+    OpenSubdiv::Far::ConstIndexArray cvs = patchTable.GetPatchVertices(handle);
+
+    std::vector<float> weights(cvs.size() * 3);
+    patchTable.EvaluateBasis(handle, u, v, &weights[0], &weights[cvs.size()],
+                             &weights[cvs.size() * 2]);
+
+    for (int j=0; j<3; ++j) {
+        for (int k=0; k<3; ++k) {
+            result[j][k] = 0.0f;
+            for (int i=0; i<cvs.size(); ++i) {
+                result[j][k] += patchPoints[cvs[i]].GetPos()[k] * weights[cvs.size() * j + i];
+            }
+        }
+    }
+}
+
+static float
+getLength(float const v[3]) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+static void
+getUnitNormal(float const du[3], float const dv[3], float normal[3]) {
+    normal[0] = du[1] * dv[2] - du[2] * dv[1];
+    normal[1] = du[2] * dv[0] - du[0] * dv[2];
+    normal[2] = du[0] * dv[1] - du[1] * dv[0];
+
+    float length = getLength(normal);
+    for (int k=0; k<3; ++k) {
+        normal[k] = (length > 0.0f) ? (normal[k] / length) : 0.0f;
+    }
+}
+
+// Generates a few locations of each ptex face -- within the triangle of
+// the parameterization of Loop faces
+static void
+getPtexLocations(FarTopologyRefiner const & refiner, int numPerSide,
+                 std::vector<int> & faces, std::vector<float> & s,
+                 std::vector<float> & t) {
+
+    bool isTriangular = (refiner.GetSchemeType() == OpenSubdiv::Sdc::SCHEME_LOOP);
+
+    int numPtexFaces = OpenSubdiv::Far::PtexIndices(refiner).GetNumFaces();
+    for (int face=0; face<numPtexFaces; ++face) {
+        for (int i=0; i<numPerSide; ++i) {
+            for (int j=0; j<numPerSide; ++j) {
+                if (isTriangular && (i + j >= numPerSide)) continue;
+
+                faces.push_back(face);
+                s.push_back(((float)i + 0.25f) / (float)numPerSide);
+                t.push_back(((float)j + 0.25f) / (float)numPerSide);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+struct StencilChunks {
+    std::vector<xyzVV> const * controlVerts;
+    std::vector<xyzVV>         values;
+    int                        numChunks;
+};
+
+static void
+gatherStencilChunk(FarLimitStencilTable const * chunk, int firstStencil, void * clientData) {
+
+    StencilChunks * chunks = (StencilChunks *)clientData;
+
+    assert(firstStencil == (int)chunks->values.size());
+    chunks->values.resize(firstStencil + chunk->GetNumStencils());
+    chunk->UpdateValues(&(*chunks->controlVerts)[0], &chunks->values[firstStencil]);
+    ++chunks->numChunks;
+
+    delete chunk;
+}
+
+// Groups ptex locations into the location arrays of limit stencils
+static void
+getLocationArrays(std::vector<int> const & faces, std::vector<float> const & s,
+                  std::vector<float> const & t,
+                  FarLimitStencilTableFactory::LocationArrayVec & locations) {
+
+    for (int i=0; i<(int)faces.size(); ) {
+        int first = i;
+        while ((i < (int)faces.size()) && (faces[i] == faces[first])) ++i;
+
+        FarLimitStencilTableFactory::LocationArray array;
+        array.ptexIdx = faces[first];
+        array.numLocations = i - first;
+        array.s = &s[first];
+        array.t = &t[first];
+        locations.push_back(array);
+    }
+}
+
+static int
+checkLimitStencils(Shape const & shape) {
+
+    if (shape.scheme == kBilinear) return 0;
+
+    //
+    // Limit stencils of adaptively refined shapes -- created at once and in
+    // chunks -- must match the evaluation of their patches:
+    //
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    FarPatchTableFactory::Options patchOptions(3);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    std::vector<xyzVV> controlVerts, patchPoints;
+    getControlVertexData(shape, controlVerts);
+    computePatchPoints(*refiner, *patchTable, controlVerts, patchPoints);
+
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    getPtexLocations(*refiner, 3, faces, s, t);
+
+    FarLimitStencilTableFactory::LocationArrayVec locations;
+    getLocationArrays(faces, s, t, locations);
+
+    FarPatchMap patchMap(*patchTable);
+
+    std::vector<xyzVV> reference(faces.size());
+    for (int i=0; i<(int)faces.size(); ++i) {
+        FarPatchTable::PatchHandle const * handle = patchMap.FindPatch(faces[i], s[i], t[i]);
+        assert(handle);
+        evaluatePatch(*patchTable, *handle, s[i], t[i], patchPoints, reference[i]);
+    }
+
+    float tolerance = getTolerance(controlVerts);
+
+    int failures = 0;
+
+    FarStencilTable const * cvStencils = createPatchPointStencils(*refiner, *patchTable);
+
+    FarLimitStencilTable const * stencils =
+        FarLimitStencilTableFactory::Create(*refiner, locations, cvStencils, patchTable);
+
+    std::vector<xyzVV> values(stencils ? stencils->GetNumStencils() : 0);
+    if (! values.empty()) {
+        stencils->UpdateValues(&controlVerts[0], &values[0]);
+    }
+    failures += compareFeatureData("limit stencils", values, reference, tolerance);
+
+    StencilChunks chunks;
+    chunks.controlVerts = &controlVerts;
+    chunks.numChunks = 0;
+
+    int chunkSize = std::max((int)faces.size() / 5, 1);
+    int numStencils = FarLimitStencilTableFactory::CreateChunked(*refiner, locations,
+        chunkSize, gatherStencilChunk, &chunks, cvStencils, patchTable);
+    if ((numStencils != (int)faces.size()) ||
+        (chunks.numChunks != ((int)faces.size() + chunkSize - 1) / chunkSize)) {
+        printf("  chunked limit stencils fails : %d stencils in %d chunks\n",
+               numStencils, chunks.numChunks);
+        ++failures;
+    }
+    failures += compareFeatureData("chunked limit stencils", chunks.values, values, 0.0f);
+
+    //
+    // Limit stencils expressed in terms of the patch points must match once
+    // the patch points are computed from the control vertices:
+    //
+    FarLimitStencilTableFactory::Options limitOptions;
+    limitOptions.factorizePatchPoints = false;
+
+    FarStencilTable const * patchPointStencils =
+        FarLimitStencilTableFactory::CreatePatchPointStencilTable(*refiner, patchTable);
+
+    FarLimitStencilTable const * patchStencils = FarLimitStencilTableFactory::Create(
+        *refiner, locations, 0, patchTable, limitOptions);
+
+    std::vector<xyzVV> patchPointValues(patchPointStencils->GetNumStencils());
+    patchPointStencils->UpdateValues(&controlVerts[0], &patchPointValues[0]);
+
+    values.assign(patchStencils ? patchStencils->GetNumStencils() : 0, xyzVV());
+    if (! values.empty()) {
+        patchStencils->UpdateValues(&patchPointValues[0], &values[0]);
+    }
+    failures += compareFeatureData("patch point limit stencils", values, reference, tolerance);
+
+    delete patchPointStencils;
+    delete patchStencils;
+    delete stencils;
+    delete cvStencils;
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+// Returns the limit stencils of a bilinear refiner, with all derivatives, as
+// the limit positions and derivatives of the control vertices
+static void
+evaluateBilinearLimitStencils(FarTopologyRefiner const & refiner,
+                              FarLimitStencilTableFactory::LocationArrayVec const & locations,
+                              FarPatchTable const * patchTable,
+                              std::vector<xyzVV> const & controlVerts,
+                              std::vector<xyzVV> values[6]) {
+
+    FarLimitStencilTableFactory::Options limitOptions;
+    limitOptions.generate1stDerivatives = true;
+    limitOptions.generate2ndDerivatives = true;
+
+    FarLimitStencilTable const * stencils =
+        FarLimitStencilTableFactory::Create(refiner, locations, 0, patchTable, limitOptions);
+
+    int numStencils = stencils ? stencils->GetNumStencils() : 0;
+    for (int i=0; i<6; ++i) {
+        values[i].assign(numStencils, xyzVV(0.0f, 0.0f, 0.0f));
+    }
+    if (numStencils) {
+        stencils->UpdateValues(&controlVerts[0], &values[0][0]);
+        stencils->UpdateDerivs(&controlVerts[0], &values[1][0], &values[2][0]);
+        stencils->Update2ndDerivs(&controlVerts[0], &values[3][0], &values[4][0], &values[5][0]);
+    }
+    delete stencils;
+}
+
+static int
+checkBilinearLimitStencils(Shape const & shape) {
+
+    //
+    // Limit stencils evaluated directly on the base faces of a bilinear mesh
+    // must match those of the patches of its uniform refinement -- the shape
+    // is refined with the bilinear scheme to include its non-quad faces:
+    //
+    FarTopologyRefinerFactory::Options refinerOptions(
+        OpenSubdiv::Sdc::SCHEME_BILINEAR, GetSdcOptions(shape));
+
+    FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(shape, refinerOptions),
+                       * refined = FarTopologyRefinerFactory::Create(shape, refinerOptions);
+    refined->RefineUniform(FarTopologyRefiner::UniformOptions(1));
+
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*refined, FarPatchTableFactory::Options(1));
+
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    getPtexLocations(*refiner, 3, faces, s, t);
+
+    FarLimitStencilTableFactory::LocationArrayVec locations;
+    getLocationArrays(faces, s, t, locations);
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> direct[6], reference[6];
+    evaluateBilinearLimitStencils(*refiner, locations, 0, controlVerts, direct);
+    evaluateBilinearLimitStencils(*refined, locations, patchTable, controlVerts, reference);
+
+    // derivatives of sub-faces are scaled by up to 2 in each direction
+    float tolerance = 4.0f * getTolerance(controlVerts);
+
+    static char const * features[6] = { "bilinear limit stencils",
+        "bilinear limit stencils Ds", "bilinear limit stencils Dt",
+        "bilinear limit stencils Dss", "bilinear limit stencils Dst",
+        "bilinear limit stencils Dtt" };
+
+    int failures = 0;
+    if (reference[0].empty()) {
+        printf("  bilinear limit stencils fails : no patch stencils\n");
+        ++failures;
+    }
+    for (int i=0; i<6; ++i) {
+        failures += compareFeatureData(features[i], direct[i], reference[i], tolerance);
+    }
+
+    delete patchTable;
+    delete refined;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Interpolates vertex, varying or face-varying data of all levels -- following
+// the data of the base level -- with a PrimvarRefiner or a PrimvarRefinerPlan
+enum PrimvarType { PRIMVAR_VERTEX, PRIMVAR_VARYING, PRIMVAR_FACE_VARYING };
+
+static int
+getNumLevelValues(FarTopologyRefiner const & refiner, int level, PrimvarType type) {
+
+    return (type == PRIMVAR_FACE_VARYING) ?
+        refiner.GetLevel(level).GetNumFVarValues(0) :
+        refiner.GetLevel(level).GetNumVertices();
+}
+
+template <class PRIMVAR_REFINER>
+static void
+interpolateLevels(PRIMVAR_REFINER const & primvarRefiner, FarTopologyRefiner const & refiner,
+                  PrimvarType type, std::vector<xyzVV> const & baseData, std::vector<xyzVV> & data) {
+
+    int numValues = 0;
+    for (int level=0; level<=refiner.GetMaxLevel(); ++level) {
+        numValues += getNumLevelValues(refiner, level, type);
+    }
+    data.resize(numValues);
+    std::copy(baseData.begin(), baseData.end(), data.begin());
+
+    xyzVV * src = &data[0];
+    for (int level=1; level<=refiner.GetMaxLevel(); ++level) {
+        xyzVV * dst = src + getNumLevelValues(refiner, level-1, type);
+        if (getNumLevelValues(refiner, level, type) > 0) {
+            switch (type) {
+            case PRIMVAR_VERTEX:
+                primvarRefiner.Interpolate(level, src, dst);
+                break;
+            case PRIMVAR_VARYING:
+                primvarRefiner.InterpolateVarying(level, src, dst);
+                break;
+            case PRIMVAR_FACE_VARYING:
+                primvarRefiner.InterpolateFaceVarying(level, src, dst, 0);
+                break;
+            }
+        }
+        src = dst;
+    }
+}
+
+static void
+interpolateLevels(FarTopologyRefiner const & refiner,
+                  std::vector<xyzVV> const & controlVerts, std::vector<xyzVV> & vertexData) {
+
+    interpolateLevels(OpenSubdiv::Far::PrimvarRefiner(refiner), refiner,
+                      PRIMVAR_VERTEX, controlVerts, vertexData);
+}
+
+// Compares the level stencils of a refiner with the PrimvarRefiner
+static int
+compareLevelStencils(char const * feature, FarTopologyRefiner const & refiner,
+                     std::vector<FarStencilTable const *> const & levelTables,
+                     std::vector<xyzVV> const & controlVerts) {
+
+    std::vector<xyzVV> reference, values(refiner.GetNumVerticesTotal());
+    interpolateLevels(refiner, controlVerts, reference);
+
+    if ((int)levelTables.size() != refiner.GetMaxLevel()) {
+        printf("  %s fails : %d tables for %d levels\n", feature,
+               (int)levelTables.size(), refiner.GetMaxLevel());
+        return 1;
+    }
+
+    std::copy(controlVerts.begin(), controlVerts.end(), values.begin());
+
+    xyzVV * src = &values[0];
+    for (int level=1; level<=refiner.GetMaxLevel(); ++level) {
+        xyzVV * dst = src + refiner.GetLevel(level-1).GetNumVertices();
+        if (levelTables[level-1]->GetNumStencils() != refiner.GetLevel(level).GetNumVertices()) {
+            printf("  %s fails : %d stencils for %d vertices of level %d\n", feature,
+                   levelTables[level-1]->GetNumStencils(),
+                   refiner.GetLevel(level).GetNumVertices(), level);
+            return 1;
+        }
+        if (levelTables[level-1]->GetNumStencils()) {
+            levelTables[level-1]->UpdateValues(src, dst);
+        }
+        src = dst;
+    }
+    return compareFeatureData(feature, values, reference, getTolerance(controlVerts));
+}
+
+static void
+deleteLevelStencils(std::vector<FarStencilTable const *> & levelTables) {
+
+    for (int i=0; i<(int)levelTables.size(); ++i) {
+        delete levelTables[i];
+    }
+    levelTables.clear();
+}
+
+static int
+checkLevelStencils(Shape const & shape) {
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<FarStencilTable const *> levelTables;
+
+    int failures = 0;
+
+    //
+    // Level stencils must match the PrimvarRefiner for uniform refinement
+    // with either ordering of child vertices and for adaptive refinement:
+    //
+    for (int i=0; i<3; ++i) {
+        FarTopologyRefiner * refiner = createRefiner(shape);
+        if (i < 2) {
+            FarTopologyRefiner::UniformOptions options(3);
+            options.orderVerticesFromFacesFirst = (i == 1);
+            refiner->RefineUniform(options);
+        } else {
+            if (shape.scheme == kBilinear) {
+                delete refiner;
+                continue;
+            }
+            refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+        }
+
+        FarStencilTableFactory::CreateLevelStencilTables(*refiner, levelTables);
+
+        static char const * features[] = { "uniform level stencils",
+                                           "face-first level stencils",
+                                           "adaptive level stencils" };
+        failures += compareLevelStencils(features[i], *refiner, levelTables, controlVerts);
+
+        //
+        // The levels evaluated by an Osd evaluator in a single buffer must
+        // match those applied above:
+        //
+        if (i == 0) {
+            int numVertices = refiner->GetNumVerticesTotal();
+
+            OpenSubdiv::Osd::CpuVertexBuffer * buffer =
+                OpenSubdiv::Osd::CpuVertexBuffer::Create(3, numVertices);
+            for (int j=0; j<(int)controlVerts.size(); ++j) {
+                buffer->UpdateData(controlVerts[j].GetPos(), j, 1);
+            }
+
+            OpenSubdiv::Osd::CpuEvaluator::EvalLevelStencils(buffer,
+                OpenSubdiv::Osd::BufferDescriptor(0, 3, 3), (int)controlVerts.size(),
+                &levelTables[0], (int)levelTables.size());
+
+            std::vector<xyzVV> values(numVertices), reference;
+            for (int j=0; j<numVertices; ++j) {
+                float const * pos = buffer->BindCpuBuffer() + j*3;
+                values[j].SetPosition(pos[0], pos[1], pos[2]);
+            }
+            interpolateLevels(*refiner, controlVerts, reference);
+
+            failures += compareFeatureData("evaluated level stencils", values,
+                                           reference, getTolerance(controlVerts));
+            delete buffer;
+        }
+
+        deleteLevelStencils(levelTables);
+        delete refiner;
+    }
+    return failures;
+}
+
+static int
+checkPrimvarRefinerPlan(Shape const & shape) {
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> controlUVs(shape.uvs.size() / 2);
+    for (int i=0; i<(int)controlUVs.size(); ++i) {
+        controlUVs[i].SetPosition(shape.uvs[i*2+0], shape.uvs[i*2+1], 0.0f);
+    }
+
+    int failures = 0;
+
+    //
+    // Replaying a plan must match the PrimvarRefiner for vertex, varying and
+    // face-varying data of uniform, face-first and adaptive refinement:
+    //
+    for (int i=0; i<3; ++i) {
+        FarTopologyRefiner * refiner = createRefiner(shape);
+        if (i < 2) {
+            FarTopologyRefiner::UniformOptions options(3);
+            options.orderVerticesFromFacesFirst = (i == 1);
+            refiner->RefineUniform(options);
+        } else {
+            if (shape.scheme == kBilinear) {
+                delete refiner;
+                continue;
+            }
+            refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+        }
+
+        OpenSubdiv::Far::PrimvarRefinerPlan::Options planOptions;
+        planOptions.generateVarying = true;
+        planOptions.generateFaceVarying = true;
+
+        OpenSubdiv::Far::PrimvarRefinerPlan plan(*refiner, planOptions);
+        OpenSubdiv::Far::PrimvarRefiner primvarRefiner(*refiner);
+
+        static char const * features[3][3] = {
+            { "uniform plan", "uniform varying plan", "uniform face-varying plan" },
+            { "face-first plan", "face-first varying plan", "face-first face-varying plan" },
+            { "adaptive plan", "adaptive varying plan", "adaptive face-varying plan" } };
+
+        for (int type=PRIMVAR_VERTEX; type<=PRIMVAR_FACE_VARYING; ++type) {
+            bool isFVar = (type == PRIMVAR_FACE_VARYING);
+            if (isFVar && ((refiner->GetNumFVarChannels() == 0) || controlUVs.empty())) {
+                continue;
+            }
+            std::vector<xyzVV> const & baseData = isFVar ? controlUVs : controlVerts;
+
+            std::vector<xyzVV> values, reference;
+            interpolateLevels(plan, *refiner, (PrimvarType)type, baseData, values);
+            interpolateLevels(primvarRefiner, *refiner, (PrimvarType)type, baseData, reference);
+
+            failures += compareFeatureData(features[i][type], values, reference,
+                                           getTolerance(baseData));
+        }
+        delete refiner;
+    }
+    return failures;
+}
+
+// Refines a shape uniformly with full topology (as required to compute limit
+// values) or adaptively, returning 0 for adaptive refinement of bilinear shapes
+static FarTopologyRefiner *
+createRefinedLevels(Shape const & shape, bool adaptive) {
+
+    if (adaptive && (shape.scheme == kBilinear)) return 0;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    if (adaptive) {
+        refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
     } else {
-        printf("  warning : vertex data not compared with Hbr (%s)\n", warningDetail.c_str());
+        FarTopologyRefiner::UniformOptions options(3);
+        options.fullTopologyInLastLevel = true;
+        refiner->RefineUniform(options);
+    }
+    return refiner;
+}
+
+static int
+checkParallelPrimvarRefiner(Shape const & shape) {
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> controlUVs(shape.uvs.size() / 2);
+    for (int i=0; i<(int)controlUVs.size(); ++i) {
+        controlUVs[i].SetPosition(shape.uvs[i*2+0], shape.uvs[i*2+1], 0.0f);
+    }
+
+    int failures = 0;
+
+    //
+    // Interpolation in parallel must match the serial PrimvarRefiner exactly,
+    // as each destination value is computed alike:
+    //
+    for (int i=0; i<2; ++i) {
+        FarTopologyRefiner * refiner = createRefinedLevels(shape, i == 1);
+        if (! refiner) continue;
+
+        OpenSubdiv::Far::PrimvarRefiner::Options options;
+        options.parallel = true;
+
+        OpenSubdiv::Far::PrimvarRefiner serialRefiner(*refiner);
+        OpenSubdiv::Far::PrimvarRefiner parallelRefiner(*refiner, options);
+
+        static char const * features[2][3] = {
+            { "uniform parallel", "uniform parallel varying", "uniform parallel face-varying" },
+            { "adaptive parallel", "adaptive parallel varying", "adaptive parallel face-varying" } };
+
+        for (int type=PRIMVAR_VERTEX; type<=PRIMVAR_FACE_VARYING; ++type) {
+            bool isFVar = (type == PRIMVAR_FACE_VARYING);
+            if (isFVar && ((refiner->GetNumFVarChannels() == 0) || controlUVs.empty())) {
+                continue;
+            }
+            std::vector<xyzVV> const & baseData = isFVar ? controlUVs : controlVerts;
+
+            std::vector<xyzVV> values, reference;
+            interpolateLevels(parallelRefiner, *refiner, (PrimvarType)type, baseData, values);
+            interpolateLevels(serialRefiner, *refiner, (PrimvarType)type, baseData, reference);
+
+            failures += compareFeatureData(features[i][type], values, reference, 0.0f);
+
+            // Limit values of the last level of uniform refinement:
+            if ((i == 0) && (type == PRIMVAR_VERTEX)) {
+                int numLast = refiner->GetLevel(3).GetNumVertices();
+                std::vector<xyzVV> lastLevel(values.end() - numLast, values.end());
+
+                std::vector<xyzVV> limit(numLast), limitTan1(numLast), limitTan2(numLast);
+                std::vector<xyzVV> refLimit(numLast), refTan1(numLast), refTan2(numLast);
+                parallelRefiner.Limit(lastLevel, limit, limitTan1, limitTan2);
+                serialRefiner.Limit(lastLevel, refLimit, refTan1, refTan2);
+
+                limit.insert(limit.end(), limitTan1.begin(), limitTan1.end());
+                limit.insert(limit.end(), limitTan2.begin(), limitTan2.end());
+                refLimit.insert(refLimit.end(), refTan1.begin(), refTan1.end());
+                refLimit.insert(refLimit.end(), refTan2.begin(), refTan2.end());
+
+                failures += compareFeatureData("uniform parallel limit", limit, refLimit, 0.0f);
+            }
+        }
+        delete refiner;
+    }
+    return failures;
+}
+
+// Gathers vertex data into a float buffer of the given stride (or scatters it
+// back from one)
+static void
+packFloats(xyzVV const * values, int numValues, int stride, std::vector<float> & floats) {
+
+    floats.assign(numValues * stride, 0.0f);
+    for (int i=0; i<numValues; ++i) {
+        std::copy(values[i].GetPos(), values[i].GetPos() + 3, &floats[i * stride]);
+    }
+}
+
+static void
+unpackFloats(std::vector<float> const & floats, int stride, xyzVV * values) {
+
+    for (int i=0; i<(int)floats.size() / stride; ++i) {
+        values[i].SetPosition(floats[i*stride+0], floats[i*stride+1], floats[i*stride+2]);
+    }
+}
+
+// Interpolates vertex data through the float buffer overloads of a
+// PrimvarRefiner (with a stride exceeding the length of the data)
+class FloatPrimvarRefiner {
+public:
+    FloatPrimvarRefiner(OpenSubdiv::Far::PrimvarRefiner const & primvarRefiner,
+                        FarTopologyRefiner const & refiner) :
+        _primvarRefiner(primvarRefiner), _refiner(refiner) { }
+
+    void Interpolate(int level, xyzVV const * src, xyzVV * dst) const {
+        apply(level, PRIMVAR_VERTEX, src, dst);
+    }
+    void InterpolateVarying(int level, xyzVV const * src, xyzVV * dst) const {
+        apply(level, PRIMVAR_VARYING, src, dst);
+    }
+    void InterpolateFaceVarying(int level, xyzVV const * src, xyzVV * dst, int) const {
+        apply(level, PRIMVAR_FACE_VARYING, src, dst);
+    }
+
+    static int const STRIDE = 4;
+
+private:
+    void apply(int level, PrimvarType type, xyzVV const * src, xyzVV * dst) const {
+
+        std::vector<float> srcFloats, dstFloats;
+        packFloats(src, getNumLevelValues(_refiner, level-1, type), STRIDE, srcFloats);
+        dstFloats.resize(getNumLevelValues(_refiner, level, type) * STRIDE);
+
+        switch (type) {
+        case PRIMVAR_VERTEX:
+            _primvarRefiner.Interpolate(level, &srcFloats[0], &dstFloats[0], 3, STRIDE);
+            break;
+        case PRIMVAR_VARYING:
+            _primvarRefiner.InterpolateVarying(level, &srcFloats[0], &dstFloats[0], 3, STRIDE);
+            break;
+        case PRIMVAR_FACE_VARYING:
+            _primvarRefiner.InterpolateFaceVarying(level, &srcFloats[0], &dstFloats[0], 3, STRIDE);
+            break;
+        }
+        unpackFloats(dstFloats, STRIDE, dst);
+    }
+
+    OpenSubdiv::Far::PrimvarRefiner const & _primvarRefiner;
+    FarTopologyRefiner const &              _refiner;
+};
+
+static int
+checkFloatPrimvarRefiner(Shape const & shape) {
+
+    int const stride = FloatPrimvarRefiner::STRIDE;
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> controlUVs(shape.uvs.size() / 2);
+    for (int i=0; i<(int)controlUVs.size(); ++i) {
+        controlUVs[i].SetPosition(shape.uvs[i*2+0], shape.uvs[i*2+1], 0.0f);
+    }
+
+    int failures = 0;
+
+    //
+    // Interpolating float buffers must match interpolating vertex classes
+    // exactly, as the same weights are applied in the same order:
+    //
+    for (int i=0; i<2; ++i) {
+        FarTopologyRefiner * refiner = createRefinedLevels(shape, i == 1);
+        if (! refiner) continue;
+
+        OpenSubdiv::Far::PrimvarRefiner primvarRefiner(*refiner);
+        FloatPrimvarRefiner floatRefiner(primvarRefiner, *refiner);
+
+        static char const * features[2][3] = {
+            { "uniform float", "uniform float varying", "uniform float face-varying" },
+            { "adaptive float", "adaptive float varying", "adaptive float face-varying" } };
+
+        for (int type=PRIMVAR_VERTEX; type<=PRIMVAR_FACE_VARYING; ++type) {
+            bool isFVar = (type == PRIMVAR_FACE_VARYING);
+            if (isFVar && ((refiner->GetNumFVarChannels() == 0) || controlUVs.empty())) {
+                continue;
+            }
+            std::vector<xyzVV> const & baseData = isFVar ? controlUVs : controlVerts;
+
+            std::vector<xyzVV> values, reference;
+            interpolateLevels(floatRefiner, *refiner, (PrimvarType)type, baseData, values);
+            interpolateLevels(primvarRefiner, *refiner, (PrimvarType)type, baseData, reference);
+
+            failures += compareFeatureData(features[i][type], values, reference, 0.0f);
+
+            // Limit values of the last level of uniform refinement:
+            if ((i == 0) && (type != PRIMVAR_VARYING)) {
+                int numLast = getNumLevelValues(*refiner, 3, (PrimvarType)type);
+
+                std::vector<xyzVV> lastLevel(reference.end() - numLast, reference.end());
+                std::vector<float> src, dst[3];
+                packFloats(&lastLevel[0], numLast, stride, src);
+
+                std::vector<xyzVV> limit(numLast * 3), refLimit(numLast * 3);
+                for (int j=0; j<3; ++j) {
+                    dst[j].resize(numLast * stride);
+                }
+                if (isFVar) {
+                    primvarRefiner.LimitFaceVarying(&src[0], &dst[0][0], 3, stride);
+                    primvarRefiner.LimitFaceVarying(lastLevel, refLimit);
+                    limit.resize(numLast);
+                    refLimit.resize(numLast);
+                } else {
+                    primvarRefiner.Limit(&src[0], &dst[0][0], &dst[1][0], &dst[2][0], 3, stride);
+
+                    xyzVV * refTan1 = &refLimit[numLast];
+                    xyzVV * refTan2 = &refLimit[numLast * 2];
+                    primvarRefiner.Limit(lastLevel, refLimit, refTan1, refTan2);
+                }
+                for (int j=0; j<(int)limit.size() / numLast; ++j) {
+                    unpackFloats(dst[j], stride, &limit[numLast * j]);
+                }
+                failures += compareFeatureData(isFVar ? "uniform float face-varying limit" :
+                                                        "uniform float limit",
+                                               limit, refLimit, 0.0f);
+            }
+        }
+        delete refiner;
+    }
+    return failures;
+}
+
+// Returns the base face of each ptex face
+static void
+getPtexBaseFaces(FarTopologyRefiner const & refiner, std::vector<int> & ptexBaseFaces) {
+
+    OpenSubdiv::Far::PtexIndices ptexIndices(refiner);
+    OpenSubdiv::Far::TopologyLevel const & baseLevel = refiner.GetLevel(0);
+
+    int regularFaceSize =
+        (refiner.GetSchemeType() == OpenSubdiv::Sdc::SCHEME_LOOP) ? 3 : 4;
+
+    ptexBaseFaces.resize(ptexIndices.GetNumFaces());
+    for (int face=0; face<baseLevel.GetNumFaces(); ++face) {
+        int numFaceVerts = baseLevel.GetFaceVertices(face).size();
+        int numPtexFaces = (numFaceVerts == regularFaceSize) ? 1 : numFaceVerts;
+        for (int i=0; i<numPtexFaces; ++i) {
+            ptexBaseFaces[ptexIndices.GetFaceId(face) + i] = face;
+        }
+    }
+}
+
+static int g_numErrors = 0;
+
+static void
+countErrors(OpenSubdiv::Far::ErrorType, const char *) {
+
+    ++g_numErrors;
+}
+
+// Returns whether any edges or vertices of the base level are semi-sharp
+static bool
+hasSemiSharpFeatures(FarTopologyRefiner const & refiner) {
+
+    OpenSubdiv::Far::TopologyLevel const & level = refiner.GetLevel(0);
+
+    for (int i=0; i<level.GetNumEdges(); ++i) {
+        float sharpness = level.GetEdgeSharpness(i);
+        if ((sharpness > 0.0f) && (sharpness < OpenSubdiv::Sdc::Crease::SHARPNESS_INFINITE)) {
+            return true;
+        }
+    }
+    for (int i=0; i<level.GetNumVertices(); ++i) {
+        float sharpness = level.GetVertexSharpness(i);
+        if ((sharpness > 0.0f) && (sharpness < OpenSubdiv::Sdc::Crease::SHARPNESS_INFINITE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int
+checkLoopEndCaps(Shape const & shape) {
+
+    if (shape.scheme != kLoop) return 0;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    int failures = 0;
+
+    //
+    // All types of end caps must be supported by Loop patches -- planar
+    // triangles for bilinear end caps and smooth patches otherwise:
+    //
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+
+    static FarPatchTableFactory::Options::EndCapType const endCapTypes[] = {
+        FarPatchTableFactory::Options::ENDCAP_BILINEAR_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY,
+        FarPatchTableFactory::Options::ENDCAP_EIGEN_BASIS };
+
+    for (int i=0; i<5; ++i) {
+        FarPatchTableFactory::Options patchOptions(3);
+        patchOptions.SetEndCapType(endCapTypes[i]);
+
+        g_numErrors = 0;
+        delete FarPatchTableFactory::Create(*refiner, patchOptions);
+
+        if (g_numErrors != 0) {
+            printf("  loop end caps fails : %d errors for end caps of type %d\n",
+                   g_numErrors, endCapTypes[i]);
+            ++failures;
+        }
+    }
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    //
+    // Smooth end caps must interpolate the limit positions and tangent planes
+    // of their corners, which are those of a deeper refinement -- tangents are
+    // evaluated just inside each corner to remain within the sector of its
+    // face, and must also match in magnitude at regular vertices (i.e. where
+    // the deeper patch is regular).  End caps are identified by their local
+    // points, which follow the vertices of the refiner.  The rules of semi-sharp features change
+    // with refinement, so the limit is only represented without them:
+    //
+    if (hasSemiSharpFeatures(*refiner)) {
+        delete refiner;
+        return failures;
+    }
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    float tolerance = getTolerance(controlVerts);
+
+    int const levels[2] = { 2, 5 };
+
+    FarTopologyRefiner * refiners[2];
+    FarPatchTable const * patchTables[2];
+    std::vector<xyzVV> patchPoints[2];
+    for (int i=0; i<2; ++i) {
+        refiners[i] = createRefiner(shape);
+        refiners[i]->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(levels[i]));
+
+        FarPatchTableFactory::Options patchOptions(levels[i]);
+        patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+        patchTables[i] = FarPatchTableFactory::Create(*refiners[i], patchOptions);
+        computePatchPoints(*refiners[i], *patchTables[i], controlVerts, patchPoints[i]);
+    }
+    FarPatchMap patchMap(*patchTables[1]);
+
+    float const inset = 1.0e-3f;
+    float const insetCoords[3][2] = { { inset, inset }, { 1.0f - 2.0f * inset, inset },
+                                      { inset, 1.0f - 2.0f * inset } };
+
+    int numEndCaps = 0, positionFailures = 0, normalFailures = 0, tangentFailures = 0;
+    for (int array=0, patchIndex=0; array<patchTables[0]->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patchTables[0]->GetNumPatches(array); ++patch, ++patchIndex) {
+            OpenSubdiv::Far::PatchParam param = patchTables[0]->GetPatchParam(array, patch);
+            if (patchTables[0]->GetPatchVertices(array, patch)[0] <
+                refiners[0]->GetNumVerticesTotal()) continue;
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex  = patch * 12;
+            ++numEndCaps;
+
+            for (int corner=0; corner<3; ++corner) {
+                float values[2][2][3][3];
+                bool isRegular = false;
+                for (int i=0; i<2; ++i) {
+                    float u = (i == 0) ? (float)(corner == 1) : insetCoords[corner][0];
+                    float v = (i == 0) ? (float)(corner == 2) : insetCoords[corner][1];
+                    param.UnnormalizeTriangle(u, v);
+
+                    FarPatchTable::PatchHandle const * deepHandle =
+                        patchMap.FindPatch(param.GetFaceId(), u, v);
+                    assert(deepHandle);
+
+                    evaluatePatchDerivatives(*patchTables[0], handle, u, v,
+                                             patchPoints[0], values[i][0]);
+                    evaluatePatchDerivatives(*patchTables[1], *deepHandle, u, v,
+                                             patchPoints[1], values[i][1]);
+
+                    isRegular = (patchTables[1]->GetPatchVertices(*deepHandle)[0] <
+                                 refiners[1]->GetNumVerticesTotal());
+                }
+
+                float d[3];
+                for (int k=0; k<3; ++k) {
+                    d[k] = values[0][1][0][k] - values[0][0][0][k];
+                }
+                positionFailures += (getLength(d) > tolerance);
+
+                float normals[2][3];
+                getUnitNormal(values[1][0][1], values[1][0][2], normals[0]);
+                getUnitNormal(values[1][1][1], values[1][1][2], normals[1]);
+                for (int k=0; k<3; ++k) {
+                    d[k] = normals[1][k] - normals[0][k];
+                }
+                normalFailures += (getLength(d) > 1.0e-2f);
+
+                for (int j=1; isRegular && (j<3); ++j) {
+                    for (int k=0; k<3; ++k) {
+                        d[k] = values[1][1][j][k] - values[1][0][j][k];
+                    }
+                    tangentFailures += (getLength(d) > 1.0e-2f * getLength(values[1][1][j]));
+                }
+            }
+        }
+    }
+    if (positionFailures || normalFailures || tangentFailures) {
+        printf("  loop end caps fails : %d positions, %d normals and %d tangents "
+               "of corners of %d smooth end caps\n",
+               positionFailures, normalFailures, tangentFailures, numEndCaps);
+        ++failures;
+    }
+
+    for (int i=0; i<2; ++i) {
+        delete patchTables[i];
+        delete refiners[i];
+    }
+
+    delete refiner;
+    return failures;
+}
+
+static int
+checkEvaluatorPatchTypes(Shape const & shape) {
+
+    if (shape.scheme != kCatmark) return 0;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    getPtexLocations(*refiner, 3, faces, s, t);
+
+    int failures = 0;
+
+    //
+    // The Osd evaluators must report an error for patches they cannot
+    // evaluate, i.e. eigen basis end caps, rather than assert:
+    //
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+
+    for (int i=0; i<2; ++i) {
+        FarPatchTableFactory::Options patchOptions(3);
+        patchOptions.SetEndCapType((i == 0)
+            ? FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS
+            : FarPatchTableFactory::Options::ENDCAP_EIGEN_BASIS);
+
+        FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+        bool hasEigenPatches = false;
+        for (int array=0; array<patchTable->GetNumPatchArrays(); ++array) {
+            hasEigenPatches |= (patchTable->GetPatchArrayDescriptor(array).GetType() ==
+                                OpenSubdiv::Far::PatchDescriptor::EIGEN_BASIS);
+        }
+        if ((i == 1) && !hasEigenPatches) {
+            delete patchTable;
+            continue;
+        }
+
+        std::vector<xyzVV> patchPoints;
+        computePatchPoints(*refiner, *patchTable, controlVerts, patchPoints);
+
+        std::vector<float> src(patchPoints.size() * 3);
+        for (int j=0; j<(int)patchPoints.size(); ++j) {
+            std::copy(patchPoints[j].GetPos(), patchPoints[j].GetPos() + 3, &src[j * 3]);
+        }
+
+        FarPatchMap patchMap(*patchTable);
+
+        std::vector<OpenSubdiv::Osd::PatchCoord> coords;
+        for (int j=0; j<(int)faces.size(); ++j) {
+            if (FarPatchTable::PatchHandle const * handle = patchMap.FindPatch(faces[j], s[j], t[j])) {
+                coords.push_back(OpenSubdiv::Osd::PatchCoord(*handle, s[j], t[j]));
+            }
+        }
+
+        OpenSubdiv::Osd::CpuPatchTable * cpuPatchTable =
+            OpenSubdiv::Osd::CpuPatchTable::Create(patchTable);
+
+        std::vector<float> dst(coords.size() * 3);
+
+        g_numErrors = 0;
+        bool evaluated = OpenSubdiv::Osd::CpuEvaluator::EvalPatches(
+            &src[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3),
+            &dst[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3),
+            (int)coords.size(), &coords[0],
+            cpuPatchTable->GetPatchArrayBuffer(),
+            cpuPatchTable->GetPatchIndexBuffer(),
+            cpuPatchTable->GetPatchParamBuffer());
+
+        if ((evaluated != (i == 0)) || (g_numErrors != i)) {
+            printf("  evaluator patch types fails : %s with %d errors for %s end caps\n",
+                   evaluated ? "evaluated" : "not evaluated", g_numErrors,
+                   (i == 0) ? "Gregory basis" : "eigen basis");
+            ++failures;
+        }
+        delete cpuPatchTable;
+        delete patchTable;
+    }
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    delete refiner;
+    return failures;
+}
+
+// Reports a failure if an accessor of released topology did not return an
+// empty array with an error, or one of retained topology did
+static int
+checkReleasedAccessor(char const * accessor, int level, bool released, int size) {
+
+    if ((released != (size == 0)) || (g_numErrors != (released ? 1 : 0))) {
+        printf("  stencil topology fails : %s at level %d returned %d entries "
+               "with %d errors\n", accessor, level, size, g_numErrors);
+        return 1;
+    }
+    return 0;
+}
+
+static int
+checkStencilTopologyOnly(Shape const & shape) {
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+
+    FarTopologyRefiner::UniformOptions options(2);
+    options.stencilTopologyOnly = true;
+    refiner->RefineUniform(options);
+
+    int failures = 0;
+
+    //
+    // Topology released by the refinement must be reported by the accessors
+    // of TopologyLevel rather than read after its release:
+    //
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+
+    for (int i=0; i<refiner->GetMaxLevel(); ++i) {
+        FarTopologyLevel const & level = refiner->GetLevel(i);
+
+        bool localIndicesReleased = (i > 0) && (refiner->GetNumFVarChannels() == 0);
+
+        g_numErrors = 0;
+        failures += checkReleasedAccessor("GetVertexEdgeLocalIndices()", i,
+            localIndicesReleased, level.GetVertexEdgeLocalIndices(0).size());
+
+        g_numErrors = 0;
+        failures += checkReleasedAccessor("GetEdgeFaceLocalIndices()", i,
+            localIndicesReleased, level.GetEdgeFaceLocalIndices(0).size());
+
+        g_numErrors = 0;
+        failures += checkReleasedAccessor("GetFaceChildEdges()", i,
+            true, level.GetFaceChildEdges(0).size());
+
+        g_numErrors = 0;
+        failures += checkReleasedAccessor("GetEdgeChildEdges()", i,
+            true, level.GetEdgeChildEdges(0).size());
+    }
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    delete refiner;
+    return failures;
+}
+
+// Evaluates the limit surface of an adaptive refinement at ptex locations,
+// identifying the type of the patch evaluated at each
+static void
+evaluateAdaptiveLimit(Shape const & shape, int level, bool orderByParentFace,
+                      FarPatchTableFactory::Options::EndCapType endCapType,
+                      std::vector<int> const & faces, std::vector<float> const & s,
+                      std::vector<float> const & t, std::vector<xyzVV> & values,
+                      std::vector<int> & patchTypes) {
+
+    FarTopologyRefiner::AdaptiveOptions adaptiveOptions(level);
+    adaptiveOptions.orderVerticesByParentFace = orderByParentFace;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(adaptiveOptions);
+
+    FarPatchTableFactory::Options patchOptions(level);
+    patchOptions.SetEndCapType(endCapType);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> patchPoints;
+    computePatchPoints(*refiner, *patchTable, controlVerts, patchPoints);
+
+    FarPatchMap patchMap(*patchTable);
+
+    values.resize(faces.size());
+    patchTypes.assign(faces.size(), -1);
+    for (int i=0; i<(int)faces.size(); ++i) {
+        if (FarPatchTable::PatchHandle const * handle = patchMap.FindPatch(faces[i], s[i], t[i])) {
+            evaluatePatch(*patchTable, *handle, s[i], t[i], patchPoints, values[i]);
+            patchTypes[i] = patchTable->GetPatchArrayDescriptor(handle->arrayIndex).GetType();
+        }
+    }
+    delete patchTable;
+    delete refiner;
+}
+
+static int
+checkEigenEndCaps(Shape const & shape) {
+
+    if (shape.scheme != kCatmark) return 0;
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    {
+        FarTopologyRefiner * refiner = createRefiner(shape);
+        getPtexLocations(*refiner, 4, faces, s, t);
+        delete refiner;
+    }
+
+    std::vector<xyzVV> eigen, gregory, reference;
+    std::vector<int> eigenTypes, gregoryTypes, referenceTypes;
+    evaluateAdaptiveLimit(shape, 3, false, FarPatchTableFactory::Options::ENDCAP_EIGEN_BASIS,
+                          faces, s, t, eigen, eigenTypes);
+    evaluateAdaptiveLimit(shape, 3, false, FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+                          faces, s, t, gregory, gregoryTypes);
+    evaluateAdaptiveLimit(shape, 7, false, FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+                          faces, s, t, reference, referenceTypes);
+
+    // eigen basis end caps evaluate the exact limit surface, so they should
+    // match a much deeper refinement -- all other patches should match the
+    // patches of the Gregory end cap table
+    float tolerance = getTolerance(controlVerts);
+
+    int failures = 0;
+    for (int i=0; i<(int)faces.size(); ++i) {
+        if (eigenTypes[i] != gregoryTypes[i] &&
+            eigenTypes[i] != OpenSubdiv::Far::PatchDescriptor::EIGEN_BASIS) {
+            ++failures;
+        } else if (eigenTypes[i] == OpenSubdiv::Far::PatchDescriptor::EIGEN_BASIS) {
+            if (getDistance(eigen[i], reference[i]) > tolerance) ++failures;
+        } else if (getDistance(eigen[i], gregory[i]) > tolerance) {
+            ++failures;
+        }
+    }
+    if (failures) {
+        printf("  eigen end caps fails : %d of %d limit points differ\n",
+            failures, (int)faces.size());
+        return 1;
+    }
+    return 0;
+}
+
+// Returns the number of child vertices of each level not numbered in the
+// order of their parent faces
+static int
+countUnorderedVertices(Shape const & shape, FarTopologyRefiner const & refiner) {
+
+    int unordered = 0;
+    for (int level=0; level<refiner.GetMaxLevel(); ++level) {
+        FarTopologyLevel const & parent = refiner.GetLevel(level);
+
+        std::vector<bool> visited(refiner.GetLevel(level+1).GetNumVertices(), false);
+        int nextVertex = 0;
+
+        std::vector<int> children;
+        for (int face=0; face<parent.GetNumFaces(); ++face) {
+            OpenSubdiv::Far::ConstIndexArray fverts = parent.GetFaceVertices(face),
+                                            fedges = parent.GetFaceEdges(face);
+            children.clear();
+            for (int i=0; i<fverts.size(); ++i) {
+                children.push_back(parent.GetVertexChildVertex(fverts[i]));
+                children.push_back(parent.GetEdgeChildVertex(fedges[i]));
+            }
+            if (shape.scheme != kLoop) {
+                children.push_back(parent.GetFaceChildVertex(face));
+            }
+            for (int i=0; i<(int)children.size(); ++i) {
+                int child = children[i];
+                if (!OpenSubdiv::Far::IndexIsValid(child) || visited[child]) continue;
+                visited[child] = true;
+                if (child != nextVertex++) ++unordered;
+            }
+        }
+    }
+    return unordered;
+}
+
+// Returns the number of face vertices of each level whose positions differ
+// between two refinements with differently ordered vertices
+static int
+countMismatchedFaceVertices(FarTopologyRefiner const & refiner,
+                            FarTopologyRefiner const & reordered,
+                            std::vector<xyzVV> const & controlVerts, float tolerance) {
+
+    std::vector<xyzVV> values, reorderedValues;
+    interpolateLevels(refiner, controlVerts, values);
+    interpolateLevels(reordered, controlVerts, reorderedValues);
+
+    int mismatched = 0, offset = 0;
+    for (int level=0; level<=refiner.GetMaxLevel(); ++level) {
+        FarTopologyLevel const & a = refiner.GetLevel(level),
+                               & b = reordered.GetLevel(level);
+        if ((a.GetNumVertices() != b.GetNumVertices()) ||
+            (a.GetNumFaces() != b.GetNumFaces())) {
+            return std::max(a.GetNumVertices(), 1);
+        }
+        for (int face=0; face<a.GetNumFaces(); ++face) {
+            OpenSubdiv::Far::ConstIndexArray aVerts = a.GetFaceVertices(face),
+                                            bVerts = b.GetFaceVertices(face);
+            for (int i=0; i<aVerts.size(); ++i) {
+                if (getDistance(values[offset + aVerts[i]],
+                                reorderedValues[offset + bVerts[i]]) > tolerance) {
+                    ++mismatched;
+                }
+            }
+        }
+        offset += a.GetNumVertices();
+    }
+    return mismatched;
+}
+
+static int
+checkVertexOrdering(Shape const & shape) {
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    float tolerance = getTolerance(controlVerts);
+
+    int failures = 0;
+    for (int adaptive=0; adaptive<2; ++adaptive) {
+        if (adaptive && (shape.scheme == kBilinear)) continue;
+
+        FarTopologyRefiner * refiner = createRefiner(shape),
+                           * reordered = createRefiner(shape);
+        if (adaptive) {
+            FarTopologyRefiner::AdaptiveOptions options(3);
+            refiner->RefineAdaptive(options);
+            options.orderVerticesByParentFace = true;
+            reordered->RefineAdaptive(options);
+        } else {
+            FarTopologyRefiner::UniformOptions options(3);
+            options.fullTopologyInLastLevel = true;
+            refiner->RefineUniform(options);
+            options.orderVerticesByParentFace = true;
+            reordered->RefineUniform(options);
+        }
+
+        if (int unordered = countUnorderedVertices(shape, *reordered)) {
+            printf("  %s vertex ordering fails : %d vertices out of order\n",
+                adaptive ? "adaptive" : "uniform", unordered);
+            ++failures;
+        }
+        if (int mismatched = countMismatchedFaceVertices(*refiner, *reordered,
+                                                          controlVerts, tolerance)) {
+            printf("  %s vertex ordering fails : %d face vertices differ\n",
+                adaptive ? "adaptive" : "uniform", mismatched);
+            ++failures;
+        }
+        delete refiner;
+        delete reordered;
+    }
+    if (failures || (shape.scheme == kBilinear)) return failures;
+
+    // the patches of a reordered refinement should evaluate the same limit
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    {
+        FarTopologyRefiner * refiner = createRefiner(shape);
+        getPtexLocations(*refiner, 4, faces, s, t);
+        delete refiner;
+    }
+
+    FarPatchTableFactory::Options::EndCapType endCapType =
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+
+    std::vector<xyzVV> limit, reorderedLimit;
+    std::vector<int> patchTypes, reorderedPatchTypes;
+    evaluateAdaptiveLimit(shape, 3, false, endCapType, faces, s, t, limit, patchTypes);
+    evaluateAdaptiveLimit(shape, 3, true, endCapType, faces, s, t,
+                          reorderedLimit, reorderedPatchTypes);
+
+    if (patchTypes != reorderedPatchTypes) {
+        printf("  reordered patches fails : patch types differ\n");
+        return 1;
+    }
+    return compareFeatureData("reordered limit", reorderedLimit, limit, tolerance);
+}
+
+// Returns the number of ptex locations not covered by a patch
+static int
+countUncoveredLocations(FarTopologyRefiner const & refiner, FarPatchTable const & patchTable) {
+
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    getPtexLocations(refiner, 4, faces, s, t);
+
+    FarPatchMap patchMap(patchTable);
+
+    int count = 0;
+    for (int i=0; i<(int)faces.size(); ++i) {
+        if (! patchMap.FindPatch(faces[i], s[i], t[i])) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Returns the number of patches of an adaptive refinement
+static int
+countAdaptivePatches(FarTopologyRefiner const & refiner) {
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(refiner,
+        FarPatchTableFactory::Options(refiner.GetMaxLevel()));
+    int numPatches = patchTable->GetNumPatchesTotal();
+    delete patchTable;
+    return numPatches;
+}
+
+static int
+checkAdaptiveTolerance(Shape const & shape) {
+
+    if (shape.scheme == kBilinear) return 0;
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    float extent = getTolerance(controlVerts) / (float)FEATURE_PRECISION;
+
+    FarTopologyRefiner::AdaptiveOptions options(3);
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(options);
+    int numPatches = countAdaptivePatches(*refiner);
+
+    int failures = 0;
+
+    //
+    // No hull is within a zero tolerance, so all features must be isolated,
+    // while increasing tolerances must isolate fewer features but still
+    // produce patches for all faces:
+    //
+    static float const tolerances[] = { 0.0f, 1e-3f, 10.0f };
+
+    for (int i=0; i<3; ++i) {
+        FarTopologyRefiner * tolerant = createRefiner(shape);
+        tolerant->RefineAdaptive(options, &shape.verts[0], tolerances[i] * extent);
+
+        int numTolerantPatches = countAdaptivePatches(*tolerant);
+
+        FarPatchTableFactory::Options patchOptions(3);
+        patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+        FarPatchTable const * patchTable = FarPatchTableFactory::Create(*tolerant, patchOptions);
+        int numUncovered = countUncoveredLocations(*tolerant, *patchTable);
+        delete patchTable;
+
+        bool isConsistent = (i == 0) ?
+            ((tolerant->GetNumVerticesTotal() == refiner->GetNumVerticesTotal()) &&
+             (tolerant->GetNumFacesTotal() == refiner->GetNumFacesTotal())) :
+            (numTolerantPatches <= numPatches);
+
+        if (! isConsistent || numUncovered) {
+            printf("  adaptive tolerance fails : %d patches instead of %d "
+                   "(%d locations uncovered) for tolerance %g\n",
+                   numTolerantPatches, numPatches, numUncovered, tolerances[i]);
+            ++failures;
+        }
+        numPatches = numTolerantPatches;
+        delete tolerant;
+    }
+    delete refiner;
+    return failures;
+}
+
+static int
+checkAdaptiveBudget(Shape const & shape) {
+
+    if (shape.scheme == kBilinear) return 0;
+
+    typedef FarTopologyRefiner::AdaptiveBudget    Budget;
+    typedef FarTopologyRefiner::AdaptiveIsolation Isolation;
+
+    FarTopologyRefiner::AdaptiveOptions options(3);
+
+    int failures = 0;
+
+    //
+    // An unlimited budget must refine as without a budget:
+    //
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(options);
+
+    FarTopologyRefiner * unlimited = createRefiner(shape);
+    Isolation unlimitedIsolation;
+    unlimited->RefineAdaptive(options, Budget(), &unlimitedIsolation);
+
+    if ((unlimited->GetMaxLevel() != refiner->GetMaxLevel()) ||
+        (unlimited->GetNumVerticesTotal() != refiner->GetNumVerticesTotal()) ||
+        (unlimited->GetNumFacesTotal() != refiner->GetNumFacesTotal())) {
+        printf("  unlimited budget fails : %d vertices instead of %d\n",
+               unlimited->GetNumVerticesTotal(), refiner->GetNumVerticesTotal());
+        ++failures;
+    }
+    int numPatchesUnlimited = countAdaptivePatches(*refiner);
+    delete refiner;
+
+    //
+    // The least budget refines only the faces required for patches, and any
+    // budget between that and the unlimited one must be respected:
+    //
+    Budget budget;
+    budget.maxPatches = 1;
+
+    refiner = createRefiner(shape);
+    refiner->RefineAdaptive(options, budget);
+    int numPatchesRequired = countAdaptivePatches(*refiner);
+    delete refiner;
+
+    budget.maxPatches = (numPatchesRequired + numPatchesUnlimited) / 2;
+
+    refiner = createRefiner(shape);
+    Isolation isolation;
+    refiner->RefineAdaptive(options, budget, &isolation);
+    int numPatches = countAdaptivePatches(*refiner);
+
+    if ((numPatches < numPatchesRequired) || (numPatches > std::max(budget.maxPatches,
+                                                                    numPatchesRequired))) {
+        printf("  patch budget fails : %d patches for budget of %d (%d required)\n",
+               numPatches, budget.maxPatches, numPatchesRequired);
+        ++failures;
+    }
+
+    //
+    // The isolation reported for the base faces, vertices and edges must not
+    // exceed that without a budget, and the vertices and edges can only be
+    // isolated within faces that were refined as deep:
+    //
+    OpenSubdiv::Far::TopologyLevel const & baseLevel = refiner->GetLevel(0);
+
+    int numExceeded = 0;
+    for (int face=0; face<baseLevel.GetNumFaces(); ++face) {
+        numExceeded += (isolation.faceLevels[face] > unlimitedIsolation.faceLevels[face]);
+    }
+    for (int vert=0; vert<baseLevel.GetNumVertices(); ++vert) {
+        OpenSubdiv::Far::ConstIndexArray vFaces = baseLevel.GetVertexFaces(vert);
+        int faceLevel = 0;
+        for (int i=0; i<vFaces.size(); ++i) {
+            faceLevel = std::max(faceLevel, isolation.faceLevels[vFaces[i]]);
+        }
+        numExceeded += (isolation.vertexLevels[vert] > unlimitedIsolation.vertexLevels[vert]) ||
+                       (isolation.vertexLevels[vert] > faceLevel);
+    }
+    for (int edge=0; edge<baseLevel.GetNumEdges(); ++edge) {
+        OpenSubdiv::Far::ConstIndexArray eFaces = baseLevel.GetEdgeFaces(edge);
+        int faceLevel = 0;
+        for (int i=0; i<eFaces.size(); ++i) {
+            faceLevel = std::max(faceLevel, isolation.faceLevels[eFaces[i]]);
+        }
+        numExceeded += (isolation.edgeLevels[edge] > unlimitedIsolation.edgeLevels[edge]) ||
+                       (isolation.edgeLevels[edge] > faceLevel);
+    }
+    if (numExceeded) {
+        printf("  budget isolation fails : %d components beyond their isolation\n", numExceeded);
+        ++failures;
+    }
+    delete refiner;
+    delete unlimited;
+    return failures;
+}
+
+static int
+checkSparseRefinement(Shape const & shape) {
+
+    if (shape.scheme == kBilinear) return 0;
+
+    int const maxLevel = 3;
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+
+    //
+    // Refine faces to a mix of levels -- including faces left unrefined
+    // next to refined ones:
+    //
+    std::vector<int> baseFaceLevels(refiner->GetLevel(0).GetNumFaces());
+    for (int face=0; face<(int)baseFaceLevels.size(); ++face) {
+        baseFaceLevels[face] = (face % 3) ? (face % 3) + 1 : 0;
+    }
+    refiner->RefineSparse(FarTopologyRefiner::SparseOptions(maxLevel), &baseFaceLevels[0]);
+
+    int failures = 0;
+
+    std::vector<FarStencilTable const *> levelTables;
+    FarStencilTableFactory::CreateLevelStencilTables(*refiner, levelTables);
+    failures += compareLevelStencils("sparse level stencils", *refiner, levelTables, controlVerts);
+    deleteLevelStencils(levelTables);
+
+    //
+    // The patches must cover all faces -- whether refined or not -- and
+    // faces must be refined at least to their requested level:
+    //
+    FarPatchTableFactory::Options patchOptions(maxLevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    int numUncovered = countUncoveredLocations(*refiner, *patchTable);
+    if (numUncovered) {
+        printf("  sparse patches fails : %d locations not covered\n", numUncovered);
+        ++failures;
+    }
+
+    std::vector<int> ptexBaseFaces;
+    getPtexBaseFaces(*refiner, ptexBaseFaces);
+
+    int numShallow = 0;
+    for (int array=0; array<patchTable->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patchTable->GetNumPatches(array); ++patch) {
+            OpenSubdiv::Far::PatchParam param = patchTable->GetPatchParam(array, patch);
+            if (param.GetDepth() < baseFaceLevels[ptexBaseFaces[param.GetFaceId()]]) {
+                ++numShallow;
+            }
+        }
+    }
+    if (numShallow) {
+        printf("  sparse levels fails : %d patches short of their level\n", numShallow);
+        ++failures;
+    }
+    delete patchTable;
+    delete refiner;
+
+    //
+    // Refine a single face -- faces away from it must not be refined, other
+    // than irregular and non-manifold faces which may be refined once, while
+    // still being covered by patches:
+    //
+    refiner = createRefiner(shape);
+
+    FarTopologyLevel const & baseLevel = refiner->GetLevel(0);
+
+    int regularFaceSize = (shape.scheme == kLoop) ? 3 : 4;
+
+    std::vector<bool> isNearFace(baseLevel.GetNumFaces(), false);
+    OpenSubdiv::Far::ConstIndexArray fVerts = baseLevel.GetFaceVertices(0);
+    for (int i=0; i<fVerts.size(); ++i) {
+        OpenSubdiv::Far::ConstIndexArray vFaces = baseLevel.GetVertexFaces(fVerts[i]);
+        for (int j=0; j<vFaces.size(); ++j) {
+            isNearFace[vFaces[j]] = true;
+        }
+    }
+
+    OpenSubdiv::Far::Index selectedFace = 0;
+    refiner->RefineSparse(FarTopologyRefiner::SparseOptions(maxLevel),
+        OpenSubdiv::Far::ConstIndexArray(&selectedFace, 1));
+
+    patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    numUncovered = countUncoveredLocations(*refiner, *patchTable);
+    if (numUncovered) {
+        printf("  sparse face patches fails : %d locations not covered\n", numUncovered);
+        ++failures;
+    }
+
+    getPtexBaseFaces(*refiner, ptexBaseFaces);
+
+    int numRefined = 0;
+    for (int array=0; array<patchTable->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patchTable->GetNumPatches(array); ++patch) {
+            OpenSubdiv::Far::PatchParam param = patchTable->GetPatchParam(array, patch);
+
+            int baseFace = ptexBaseFaces[param.GetFaceId()];
+            if (isNearFace[baseFace]) continue;
+
+            OpenSubdiv::Far::ConstIndexArray baseVerts = baseLevel.GetFaceVertices(baseFace);
+
+            bool isIrregular = (baseVerts.size() != regularFaceSize);
+            for (int i=0; i<baseVerts.size(); ++i) {
+                isIrregular |= baseLevel.IsVertexNonManifold(baseVerts[i]);
+            }
+            if (param.GetDepth() > (isIrregular ? 1 : 0)) {
+                ++numRefined;
+            }
+        }
+    }
+    if (numRefined) {
+        printf("  sparse face levels fails : %d patches refined away from the face\n", numRefined);
+        ++failures;
+    }
+    delete patchTable;
+    delete refiner;
+
+    //
+    // Face indices out of range must be reported rather than refined:
+    //
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+
+    refiner = createRefiner(shape);
+
+    g_numErrors = 0;
+    selectedFace = refiner->GetLevel(0).GetNumFaces();
+    refiner->RefineSparse(FarTopologyRefiner::SparseOptions(maxLevel),
+        OpenSubdiv::Far::ConstIndexArray(&selectedFace, 1));
+    if ((g_numErrors != 1) || (refiner->GetMaxLevel() != 0)) {
+        printf("  sparse face range fails : %d errors for an invalid face\n", g_numErrors);
+        ++failures;
+    }
+    delete refiner;
+
+    OpenSubdiv::Far::SetErrorCallback(0);
+    return failures;
+}
+
+// Compares the stencils of two stencil tables
+static bool
+areStencilTablesEqual(FarStencilTable const & a, FarStencilTable const & b) {
+
+    return (a.GetNumStencils() == b.GetNumStencils()) &&
+           (a.GetNumControlVertices() == b.GetNumControlVertices()) &&
+           (a.GetSizes() == b.GetSizes()) &&
+           (a.GetControlIndices() == b.GetControlIndices()) &&
+           (a.GetWeights() == b.GetWeights());
+}
+
+// Compares the patches and local point stencils of two patch tables
+static bool
+arePatchTablesEqual(FarPatchTable const & a, FarPatchTable const & b) {
+
+    if (a.GetNumPatchArrays() != b.GetNumPatchArrays()) return false;
+
+    for (int array=0; array<a.GetNumPatchArrays(); ++array) {
+        if (!(a.GetPatchArrayDescriptor(array) == b.GetPatchArrayDescriptor(array))) {
+            return false;
+        }
+        OpenSubdiv::Far::ConstIndexArray aVerts = a.GetPatchArrayVertices(array),
+                                         bVerts = b.GetPatchArrayVertices(array);
+        if (aVerts.size() != bVerts.size()) return false;
+        for (int i=0; i<aVerts.size(); ++i) {
+            if (aVerts[i] != bVerts[i]) return false;
+        }
+        OpenSubdiv::Far::ConstPatchParamArray aParams = a.GetPatchParams(array),
+                                              bParams = b.GetPatchParams(array);
+        for (int i=0; i<aParams.size(); ++i) {
+            if ((aParams[i].field0 != bParams[i].field0) ||
+                (aParams[i].field1 != bParams[i].field1)) return false;
+        }
+    }
+
+    FarStencilTable const * aTables[2] = { a.GetLocalPointStencilTable(),
+                                           a.GetLocalPointVaryingStencilTable() };
+    FarStencilTable const * bTables[2] = { b.GetLocalPointStencilTable(),
+                                           b.GetLocalPointVaryingStencilTable() };
+    for (int i=0; i<2; ++i) {
+        if ((aTables[i] == 0) != (bTables[i] == 0)) return false;
+        if (aTables[i] && !areStencilTablesEqual(*aTables[i], *bTables[i])) return false;
+    }
+    return true;
+}
+
+static int
+checkSparseUpdate(Shape const & shape) {
+
+    if (shape.scheme == kBilinear) return 0;
+
+    int const maxLevel = 3;
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+
+    std::vector<int> baseFaceLevels(refiner->GetLevel(0).GetNumFaces());
+    for (int face=0; face<(int)baseFaceLevels.size(); ++face) {
+        baseFaceLevels[face] = (face % 3) ? (face % 3) + 1 : 0;
+    }
+    refiner->RefineSparse(FarTopologyRefiner::SparseOptions(maxLevel), &baseFaceLevels[0]);
+
+    std::vector<FarStencilTable const *> levelTables;
+    FarStencilTableFactory::CreateLevelStencilTables(*refiner, levelTables);
+
+    // Patch tables with each type of end cap generating local points:
+    FarPatchTableFactory::Options patchOptions[2];
+    patchOptions[0].SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    patchOptions[1].SetEndCapType(FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS);
+
+    FarPatchTable * patchTables[2];
+    for (int j=0; j<2; ++j) {
+        patchTables[j] = FarPatchTableFactory::Create(*refiner, patchOptions[j]);
+    }
+
+    int failures = 0;
+
+    //
+    // Update first with a change confined to the deepest levels (faces at
+    // level 2 refined to level 3) and then with one affecting all levels
+    // (unrefined faces refined to level 1) -- each update must match a new
+    // sparse refinement to the same levels:
+    //
+    static char const * features[] = { "deep sparse update", "full sparse update" };
+
+    for (int i=0; i<2; ++i) {
+        int oldLevel = (i == 0) ? 2 : 0,
+            newLevel = (i == 0) ? 3 : 1;
+        for (int face=0; face<(int)baseFaceLevels.size(); ++face) {
+            if (baseFaceLevels[face] == oldLevel) {
+                baseFaceLevels[face] = newLevel;
+            }
+        }
+        int firstLevel = refiner->UpdateSparse(
+            FarTopologyRefiner::SparseOptions(maxLevel), &baseFaceLevels[0]);
+        FarStencilTableFactory::UpdateLevelStencilTables(*refiner, levelTables, firstLevel);
+
+        FarTopologyRefiner * expected = createRefiner(shape);
+        expected->RefineSparse(FarTopologyRefiner::SparseOptions(maxLevel), &baseFaceLevels[0]);
+
+        std::vector<FarStencilTable const *> expectedTables;
+        FarStencilTableFactory::CreateLevelStencilTables(*expected, expectedTables);
+
+        if (refiner->GetNumVerticesTotal() != expected->GetNumVerticesTotal()) {
+            printf("  %s fails : %d vertices instead of %d\n", features[i],
+                   refiner->GetNumVerticesTotal(), expected->GetNumVerticesTotal());
+            ++failures;
+        } else if (levelTables.size() != expectedTables.size()) {
+            printf("  %s fails : %d tables instead of %d\n", features[i],
+                   (int)levelTables.size(), (int)expectedTables.size());
+            ++failures;
+        } else {
+            for (int level=1; level<=(int)levelTables.size(); ++level) {
+                if (!areStencilTablesEqual(*levelTables[level-1], *expectedTables[level-1])) {
+                    printf("  %s fails : stencils of level %d differ\n", features[i], level);
+                    ++failures;
+                    break;
+                }
+            }
+            failures += compareLevelStencils(features[i], *refiner, levelTables, controlVerts);
+        }
+
+        // Refinement of faces whose levels were not changed must be carried:
+        int numCarried = 0;
+        for (int level=firstLevel; level<=refiner->GetMaxLevel(); ++level) {
+            OpenSubdiv::Far::ConstIndexArray carried = refiner->GetCarriedVertices(level);
+            for (int v=0; v<carried.size(); ++v) {
+                numCarried += OpenSubdiv::Far::IndexIsValid(carried[v]);
+            }
+        }
+        bool expectCarried = false;
+        for (int face=0; face<(int)baseFaceLevels.size(); ++face) {
+            if ((baseFaceLevels[face] >= firstLevel) &&
+                (baseFaceLevels[face] != newLevel) &&
+                !refiner->GetLevel(0).IsFaceHole(face)) {
+                expectCarried = true;
+            }
+        }
+        if (expectCarried && (numCarried == 0)) {
+            printf("  %s fails : no vertices carried from level %d\n", features[i], firstLevel);
+            ++failures;
+        }
+
+        for (int j=0; j<2; ++j) {
+            FarPatchTable * updated =
+                FarPatchTableFactory::Update(*refiner, *patchTables[j], patchOptions[j]);
+            FarPatchTable * expectedPatches =
+                FarPatchTableFactory::Create(*expected, patchOptions[j]);
+
+            if (!arePatchTablesEqual(*updated, *expectedPatches)) {
+                printf("  %s fails : patch table %d differs\n", features[i], j);
+                ++failures;
+            }
+            delete expectedPatches;
+            delete patchTables[j];
+            patchTables[j] = updated;
+        }
+        deleteLevelStencils(expectedTables);
+        delete expected;
+    }
+    for (int j=0; j<2; ++j) {
+        delete patchTables[j];
+    }
+    deleteLevelStencils(levelTables);
+    delete refiner;
+    return failures;
+}
+
+// Returns the number of points not within tolerance of any of the reference
+static int
+countUnmatchedPoints(std::vector<xyzVV> const & points,
+                     std::vector<xyzVV> const & reference, float tolerance) {
+
+    int count = 0;
+    for (int i=0; i<(int)points.size(); ++i) {
+        float minDist = -1.0f;
+        for (int j=0; j<(int)reference.size(); ++j) {
+            float dist = getDistance(points[i], reference[j]);
+            if ((minDist < 0.0f) || (dist < minDist)) {
+                minDist = dist;
+            }
+        }
+        if ((minDist < 0.0f) || (minDist > tolerance)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static int
+checkTileRefiner(Shape const & shape) {
+
+    int const level = 3;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineUniform(FarTopologyRefiner::UniformOptions(level));
+
+    std::vector<xyzVV> controlVerts, vertexData;
+    getControlVertexData(shape, controlVerts);
+    interpolateLevels(*refiner, controlVerts, vertexData);
+
+    float tolerance = getTolerance(controlVerts);
+
+    OpenSubdiv::Far::TopologyLevel const & baseLevel = refiner->GetLevel(0);
+    OpenSubdiv::Far::TopologyLevel const & lastLevel = refiner->GetLevel(level);
+
+    int lastLevelOffset = (int)vertexData.size() - lastLevel.GetNumVertices();
+
+    //
+    // Gather the vertices and face centers of the last level descending from
+    // each base face:
+    //
+    std::vector<std::vector<xyzVV> > faceVerts(baseLevel.GetNumFaces()),
+                                     faceCenters(baseLevel.GetNumFaces());
+    for (int face=0; face<lastLevel.GetNumFaces(); ++face) {
+        int baseFace = face;
+        for (int i=level; i>0; --i) {
+            baseFace = refiner->GetLevel(i).GetFaceParentFace(baseFace);
+        }
+
+        OpenSubdiv::Far::ConstIndexArray fVerts = lastLevel.GetFaceVertices(face);
+
+        xyzVV center(0.0f, 0.0f, 0.0f);
+        for (int i=0; i<fVerts.size(); ++i) {
+            xyzVV const & vert = vertexData[lastLevelOffset + fVerts[i]];
+            center.AddWithWeight(vert, 1.0f / fVerts.size());
+            faceVerts[baseFace].push_back(vert);
+        }
+        faceCenters[baseFace].push_back(center);
+    }
+
+    //
+    // The tile of each face must match the global refinement of the face:
+    //
+    OpenSubdiv::Far::TileRefiner tileRefiner(*refiner, level);
+
+    std::vector<OpenSubdiv::Far::TileRefiner::Tile> tiles;
+    tileRefiner.RefineFaces(&shape.verts[0], 3, 3, tiles);
+
+    int count = 0;
+    for (int face=0; face<baseLevel.GetNumFaces(); ++face) {
+        if (baseLevel.IsFaceHole(face)) continue;
+
+        OpenSubdiv::Far::TileRefiner::Tile const & tile = tiles[face];
+
+        std::vector<xyzVV> tileVerts, tileCenters;
+        for (int i=0; i<tile.GetNumFaces(); ++i) {
+            xyzVV center(0.0f, 0.0f, 0.0f);
+            for (int j=0; j<tile.faceSize; ++j) {
+                float const * pos =
+                    &tile.vertexValues[tile.faceVertices[i*tile.faceSize + j] * tile.length];
+
+                xyzVV vert(pos[0], pos[1], pos[2]);
+                center.AddWithWeight(vert, 1.0f / tile.faceSize);
+                tileVerts.push_back(vert);
+            }
+            tileCenters.push_back(center);
+        }
+
+        if ((tileCenters.size() != faceCenters[face].size()) ||
+            countUnmatchedPoints(tileVerts, faceVerts[face], tolerance) ||
+            countUnmatchedPoints(tileCenters, faceCenters[face], tolerance)) {
+            ++count;
+        }
+    }
+    delete refiner;
+
+    if (count) {
+        printf("  tile refiner fails : %d of %d tiles differ\n", count, (int)tiles.size());
+        return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// Identifies whether the edges of the base level are manifold and whether
+// the limit surface of its faces is closed, i.e. has no boundaries
+static void
+getBaseEdgeProperties(FarTopologyRefiner const & refiner, bool & isManifold, bool & isClosed) {
+
+    FarTopologyLevel const & level = refiner.GetLevel(0);
+
+    isManifold = true;
+    isClosed = ! refiner.HasHoles();
+    for (int edge=0; edge<level.GetNumEdges(); ++edge) {
+        isManifold &= ! level.IsEdgeNonManifold(edge);
+        isClosed &= (level.GetEdgeFaces(edge).size() == 2);
+    }
+    isClosed &= isManifold;
+}
+
+// Reports a failure if the triangles of a tessellation are not free of
+// cracks -- each directed edge is shared with an adjacent triangle that
+// traverses it in reverse, unless on the boundary of an open surface
+static int
+checkTessellationEdges(char const * mode, OpenSubdiv::Osd::CpuTessellator::Mesh const & mesh,
+                       bool isClosed) {
+
+    std::vector<int> const & triangles = mesh.triangles;
+
+    std::vector<std::pair<int,int> > edges;
+    edges.reserve(triangles.size());
+    for (int i=0; i<(int)triangles.size(); i+=3) {
+        for (int j=0; j<3; ++j) {
+            int v0 = triangles[i + j];
+            int v1 = triangles[i + (j + 1) % 3];
+            if ((v0 < 0) || (v0 >= mesh.GetNumVertices()) || (v0 == v1)) {
+                printf("  cpu tessellator fails : invalid triangle %d (%s)\n", i / 3, mode);
+                return 1;
+            }
+            edges.push_back(std::make_pair(v0, v1));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    int numShared = 0, numUnshared = 0;
+    for (int i=0; i<(int)edges.size(); ++i) {
+        if ((i > 0) && (edges[i] == edges[i-1])) {
+            ++numShared;
+        } else if (isClosed && !std::binary_search(edges.begin(), edges.end(),
+                    std::make_pair(edges[i].second, edges[i].first))) {
+            ++numUnshared;
+        }
+    }
+    if (numShared || numUnshared) {
+        printf("  cpu tessellator fails : %d duplicate and %d unmatched edges (%s)\n",
+               numShared, numUnshared, mode);
+        return 1;
+    }
+    return 0;
+}
+
+static int
+checkCpuTessellator(Shape const & shape) {
+
+    if (shape.scheme == kBilinear) return 0;
+
+    typedef OpenSubdiv::Osd::CpuTessellator Tessellator;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    FarPatchTableFactory::Options patchOptions(3);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> patchPoints;
+    computePatchPoints(*refiner, *patchTable, controlVerts, patchPoints);
+
+    std::vector<float> src(patchPoints.size() * 3);
+    for (int i=0; i<(int)patchPoints.size(); ++i) {
+        std::copy(patchPoints[i].GetPos(), patchPoints[i].GetPos() + 3, &src[i * 3]);
+    }
+
+    float tolerance = getTolerance(controlVerts);
+    bool isManifold, isClosed;
+    getBaseEdgeProperties(*refiner, isManifold, isClosed);
+
+    Tessellator tessellator(*refiner, *patchTable);
+
+    int failures = 0;
+
+    //
+    // Tessellate uniformly and by edge length -- the vertices must lie on the
+    // limit surface at their locations and the triangles must share edges:
+    //
+    for (int i=0; i<2; ++i) {
+        char const * mode = (i == 0) ? "uniform" : "edge length";
+
+        Tessellator::Options options;
+        options.mode         = (i == 0) ? Tessellator::TESS_UNIFORM : Tessellator::TESS_EDGE_LENGTH;
+        options.tessLevel    = 3;
+        options.edgeLength   = tolerance * 1e4f;
+        options.maxTessLevel = 8;
+
+        Tessellator::Mesh mesh;
+        if (!tessellator.Tessellate(&src[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3),
+                                    options, mesh) || (mesh.GetNumTriangles() == 0)) {
+            printf("  cpu tessellator fails : no triangles (%s)\n", mode);
+            ++failures;
+            continue;
+        }
+
+        std::vector<xyzVV> values(mesh.GetNumVertices()), reference(mesh.GetNumVertices());
+        for (int j=0; j<mesh.GetNumVertices(); ++j) {
+            OpenSubdiv::Osd::PatchCoord const & coord = mesh.vertexCoords[j];
+
+            values[j].SetPosition(mesh.vertexValues[j*3+0],
+                                  mesh.vertexValues[j*3+1],
+                                  mesh.vertexValues[j*3+2]);
+            evaluatePatch(*patchTable, coord.handle, coord.s, coord.t, patchPoints, reference[j]);
+        }
+        failures += compareFeatureData("cpu tessellator", values, reference, tolerance);
+
+        if (isManifold) {
+            failures += checkTessellationEdges(mode, mesh, isClosed);
+        }
+
+        // A second tessellation must be identical:
+        Tessellator::Mesh repeated;
+        tessellator.Tessellate(&src[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3),
+                               options, repeated);
+        if ((repeated.triangles != mesh.triangles) ||
+            (repeated.vertexValues != mesh.vertexValues)) {
+            printf("  cpu tessellator fails : tessellation not deterministic (%s)\n", mode);
+            ++failures;
+        }
+    }
+
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Gathers the triangles of TriangleIndices in terms of the original vertices
+// of the level, each rotated to start with its lowest vertex and preceded by
+// its face, and sorted for comparison
+static void
+getSortedTriangles(OpenSubdiv::Far::TriangleIndices const & triangleIndices,
+                   std::vector<int> & sorted) {
+
+    std::vector<OpenSubdiv::Far::Index> const & verts = triangleIndices.GetTriangleVertices();
+    std::vector<OpenSubdiv::Far::Index> const & order = triangleIndices.GetVertexOrder();
+
+    int numTriangles = triangleIndices.GetNumTriangles();
+
+    std::vector<std::vector<int> > triangles(numTriangles, std::vector<int>(4));
+    for (int i=0; i<numTriangles; ++i) {
+        int tri[3];
+        for (int j=0; j<3; ++j) {
+            tri[j] = order.empty() ? verts[i*3+j] : order[verts[i*3+j]];
+        }
+        int first = (int)(std::min_element(tri, tri + 3) - tri);
+
+        triangles[i][0] = triangleIndices.GetTriangleFaces()[i];
+        for (int j=0; j<3; ++j) {
+            triangles[i][1+j] = tri[(first + j) % 3];
+        }
+    }
+    std::sort(triangles.begin(), triangles.end());
+
+    sorted.clear();
+    for (int i=0; i<numTriangles; ++i) {
+        sorted.insert(sorted.end(), triangles[i].begin(), triangles[i].end());
+    }
+}
+
+// Returns the number of misses of an LRU vertex cache rendering triangles
+static int
+countVertexCacheMisses(std::vector<OpenSubdiv::Far::Index> const & verts, int cacheSize) {
+
+    std::vector<int> cache;
+    int misses = 0;
+    for (int i=0; i<(int)verts.size(); ++i) {
+        std::vector<int>::iterator it = std::find(cache.begin(), cache.end(), verts[i]);
+        if (it == cache.end()) {
+            if ((int)cache.size() == cacheSize) {
+                cache.pop_back();
+            }
+            ++misses;
+        } else {
+            cache.erase(it);
+        }
+        cache.insert(cache.begin(), verts[i]);
+    }
+    return misses;
+}
+
+static int
+checkTriangleIndices(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::TriangleIndices TriangleIndices;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineUniform(FarTopologyRefiner::UniformOptions(2));
+
+    FarTopologyLevel const & level = refiner->GetLevel(2);
+
+    int failures = 0;
+
+    //
+    // Each face that is not a hole must be split into triangles of its own
+    // vertices:
+    //
+    TriangleIndices triangles(*refiner);
+
+    int numExpected = 0;
+    for (int face=0; face<level.GetNumFaces(); ++face) {
+        if (! level.IsFaceHole(face)) {
+            numExpected += level.GetFaceVertices(face).size() - 2;
+        }
+    }
+    int numInvalid = 0;
+    for (int i=0; i<triangles.GetNumTriangles(); ++i) {
+        OpenSubdiv::Far::ConstIndexArray faceVerts =
+            level.GetFaceVertices(triangles.GetTriangleFaces()[i]);
+        for (int j=0; j<3; ++j) {
+            numInvalid += (faceVerts.FindIndex(triangles.GetTriangleVertices()[i*3+j]) < 0);
+        }
+    }
+    if ((triangles.GetLevel() != 2) || (triangles.GetNumTriangles() != numExpected) ||
+        numInvalid || triangles.HasVertexOrder()) {
+        printf("  triangle indices fails : %d triangles instead of %d "
+               "(%d vertices not of their faces)\n",
+               triangles.GetNumTriangles(), numExpected, numInvalid);
+        ++failures;
+    }
+
+    //
+    // Optimizing the vertex cache must only reorder the same triangles and
+    // vertices, loading each vertex into the cache no more than 1.5 times on
+    // average (the order from refinement is already coherent, but a random
+    // order of triangles loads each vertex about 5 times):
+    //
+    TriangleIndices::Options options;
+    options.optimizeVertexCache = true;
+
+    TriangleIndices optimized(*refiner, options);
+
+    std::vector<int> sorted, sortedOptimized;
+    getSortedTriangles(triangles, sorted);
+    getSortedTriangles(optimized, sortedOptimized);
+
+    std::vector<OpenSubdiv::Far::Index> order = optimized.GetVertexOrder();
+    std::sort(order.begin(), order.end());
+
+    bool isPermutation = ((int)order.size() == level.GetNumVertices());
+    for (int i=0; isPermutation && (i<(int)order.size()); ++i) {
+        isPermutation = (order[i] == i);
+    }
+
+    if ((sortedOptimized != sorted) || !isPermutation) {
+        printf("  triangle indices fails : optimized triangles differ "
+               "(vertex order %s)\n", isPermutation ? "valid" : "invalid");
+        ++failures;
+    } else {
+        int misses = countVertexCacheMisses(optimized.GetTriangleVertices(),
+                                            options.vertexCacheSize);
+        if (2 * misses > 3 * level.GetNumVertices()) {
+            printf("  triangle indices fails : %d vertex cache misses for %d vertices\n",
+                   misses, level.GetNumVertices());
+            ++failures;
+        }
+
+        // Vertex data must follow the new order:
+        std::vector<xyzVV> levelVerts(level.GetNumVertices()), permuted(level.GetNumVertices());
+        for (int i=0; i<level.GetNumVertices(); ++i) {
+            levelVerts[i].SetPosition((float)i, 0.0f, 0.0f);
+        }
+        optimized.PermuteVertices(levelVerts, permuted);
+
+        for (int i=0; i<level.GetNumVertices(); ++i) {
+            if (permuted[i].GetPos()[0] != (float)optimized.GetVertexOrder()[i]) {
+                printf("  triangle indices fails : vertex %d not permuted\n", i);
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    //
+    // A level beyond those of the refiner must be reported:
+    //
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+
+    options.level = 3;
+
+    g_numErrors = 0;
+    TriangleIndices invalid(*refiner, options);
+    if ((g_numErrors != 1) || (invalid.GetNumTriangles() != 0)) {
+        printf("  triangle indices fails : %d errors for an invalid level\n", g_numErrors);
+        ++failures;
+    }
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+typedef OpenSubdiv::Osd::CpuPatchBVH CpuPatchBVH;
+
+// Returns whether a point lies within bounds (expanded by a tolerance)
+static bool
+isWithinBounds(float const * point, float const * boundsMin, float const * boundsMax,
+               float tolerance) {
+
+    for (int k=0; k<3; ++k) {
+        if ((point[k] < boundsMin[k] - tolerance) || (point[k] > boundsMax[k] + tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Intersects a ray with bounds, returning the parameter at which it enters
+// (computed as by CpuPatchBVH, so that rays grazing bounds hit them alike)
+static bool
+intersectRayBounds(float const * origin, float const * direction,
+                   float const * boundsMin, float const * boundsMax, float & tEntry) {
+
+    float tNear = 0.0f, tFar = std::numeric_limits<float>::max();
+    for (int k=0; k<3; ++k) {
+        float invDirection = 1.0f / direction[k];
+        float t0 = (boundsMin[k] - origin[k]) * invDirection;
+        float t1 = (boundsMax[k] - origin[k]) * invDirection;
+        tNear = std::max(tNear, std::min(t0, t1));
+        tFar  = std::min(tFar,  std::max(t0, t1));
+    }
+    tEntry = tNear;
+    return tNear <= tFar;
+}
+
+// Intersector recording the patches whose bounds a ray hits -- optionally
+// hitting each at the entry of its bounds to cull those beyond
+struct BoundsIntersector {
+    CpuPatchBVH const * bvh;
+    float const *       origin;
+    float const *       direction;
+    bool                cull;
+    std::vector<int>    patches;
+
+    bool operator()(int patch, float & tMax) {
+        patches.push_back(patch);
+
+        float const * bounds = bvh->GetPatchBounds(patch);
+        float tEntry;
+        if (cull && intersectRayBounds(origin, direction, bounds, bounds + 3, tEntry) &&
+            (tEntry < tMax)) {
+            tMax = tEntry;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Reports a failure if the nodes of a hierarchy do not bound their children
+// or leaves do not partition the patches
+static int
+checkPatchBVHNodes(CpuPatchBVH const & bvh) {
+
+    std::vector<int> patchLeaves(bvh.GetNumPatches(), 0);
+
+    int numInvalid = 0;
+    for (int i=0; i<bvh.GetNumNodes(); ++i) {
+        CpuPatchBVH::Node const & node = bvh.GetNode(i);
+        if (node.IsLeaf()) {
+            for (int j=0; j<node.numPatches; ++j) {
+                int patch = bvh.GetLeafPatches()[node.index + j];
+                ++patchLeaves[patch];
+
+                float const * bounds = bvh.GetPatchBounds(patch);
+                numInvalid += ! isWithinBounds(bounds, node.boundsMin, node.boundsMax, 0.0f) ||
+                              ! isWithinBounds(bounds + 3, node.boundsMin, node.boundsMax, 0.0f);
+            }
+        } else {
+            for (int j=0; j<2; ++j) {
+                CpuPatchBVH::Node const & child = bvh.GetNode(node.index + j);
+                numInvalid += ! isWithinBounds(child.boundsMin, node.boundsMin, node.boundsMax, 0.0f) ||
+                              ! isWithinBounds(child.boundsMax, node.boundsMin, node.boundsMax, 0.0f);
+            }
+        }
+    }
+    int numMisplaced = 0;
+    for (int i=0; i<bvh.GetNumPatches(); ++i) {
+        numMisplaced += (patchLeaves[i] != 1);
+    }
+    if (numInvalid || numMisplaced) {
+        printf("  patch bvh fails : %d nodes not bounding their children "
+               "and %d patches not in one leaf\n", numInvalid, numMisplaced);
+        return 1;
+    }
+    return 0;
+}
+
+static int
+checkCpuPatchBVH(Shape const & shape) {
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    FarPatchTableFactory::Options patchOptions(3);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> patchPoints;
+    computePatchPoints(*refiner, *patchTable, controlVerts, patchPoints);
+
+    std::vector<float> src(patchPoints.size() * 3);
+    for (int i=0; i<(int)patchPoints.size(); ++i) {
+        std::copy(patchPoints[i].GetPos(), patchPoints[i].GetPos() + 3, &src[i * 3]);
+    }
+
+    float tolerance = getTolerance(controlVerts);
+
+    CpuPatchBVH bvh(*patchTable);
+
+    int failures = 0;
+
+    if (! bvh.Build(&src[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3)) ||
+        (bvh.GetNumPatches() != patchTable->GetNumPatchesTotal())) {
+        printf("  patch bvh fails : not built for %d patches\n",
+               patchTable->GetNumPatchesTotal());
+        delete patchTable;
+        delete refiner;
+        return 1;
+    }
+    failures += checkPatchBVHNodes(bvh);
+
+    //
+    // Points of the limit surface must lie within the bounds of their patches:
+    //
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    getPtexLocations(*refiner, 3, faces, s, t);
+
+    FarPatchMap patchMap(*patchTable);
+
+    std::vector<xyzVV> surfacePoints;
+    int numOutside = 0;
+    for (int i=0; i<(int)faces.size(); ++i) {
+        FarPatchTable::PatchHandle const * handle = patchMap.FindPatch(faces[i], s[i], t[i]);
+        if (! handle) continue;
+
+        xyzVV point;
+        evaluatePatch(*patchTable, *handle, s[i], t[i], patchPoints, point);
+        surfacePoints.push_back(point);
+
+        float const * bounds = bvh.GetPatchBounds(handle->patchIndex);
+        numOutside += (bvh.GetPatchHandle(handle->patchIndex).arrayIndex != handle->arrayIndex) ||
+                      ! isWithinBounds(point.GetPos(), bounds, bounds + 3, tolerance);
+    }
+    if (numOutside) {
+        printf("  patch bvh fails : %d of %d limit points outside their patch bounds\n",
+               numOutside, (int)surfacePoints.size());
+        ++failures;
+    }
+
+    //
+    // Rays traversing the hierarchy must visit exactly the patches whose
+    // bounds they hit, and culling by the nearest hit must retain it:
+    //
+    CpuPatchBVH::Node const & root = bvh.GetNode(0);
+    float offset[3] = { 1.0f, 0.7f, 0.4f };
+    for (int k=0; k<3; ++k) {
+        offset[k] *= 2.0f * (root.boundsMax[k] - root.boundsMin[k]) + 1.0f;
+    }
+
+    int numMismatched = 0;
+    for (int i=0; i<(int)surfacePoints.size(); i+=7) {
+        float const * target = surfacePoints[i].GetPos();
+
+        float origin[3], direction[3];
+        for (int k=0; k<3; ++k) {
+            origin[k]    = target[k] + offset[(k + i) % 3];
+            direction[k] = target[k] - origin[k];
+        }
+
+        std::vector<int> expected;
+        float tNearest = std::numeric_limits<float>::max();
+        for (int patch=0; patch<bvh.GetNumPatches(); ++patch) {
+            float const * bounds = bvh.GetPatchBounds(patch);
+            float tEntry;
+            if (intersectRayBounds(origin, direction, bounds, bounds + 3, tEntry)) {
+                expected.push_back(patch);
+                tNearest = std::min(tNearest, tEntry);
+            }
+        }
+
+        BoundsIntersector intersector = { &bvh, origin, direction, false, std::vector<int>() };
+
+        float tMax = std::numeric_limits<float>::max();
+        bvh.Intersect(origin, direction, tMax, intersector);
+        std::sort(intersector.patches.begin(), intersector.patches.end());
+
+        bool traversed = (intersector.patches == expected);
+
+        intersector.cull = true;
+        bool hit = bvh.Intersect(origin, direction, tMax, intersector);
+
+        numMismatched += ! traversed || ! hit || (tMax != tNearest);
+    }
+    if (numMismatched) {
+        printf("  patch bvh fails : %d rays not traversed correctly\n", numMismatched);
+        ++failures;
+    }
+
+    //
+    // Refitting to displaced control points must match building anew:
+    //
+    for (int i=0; i<(int)src.size(); ++i) {
+        src[i] = src[i] * ((i % 3) ? 0.5f : 2.0f) + 1.0f;
+    }
+    CpuPatchBVH rebuilt(*patchTable);
+    if (! bvh.Refit(&src[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3)) ||
+        ! rebuilt.Build(&src[0], OpenSubdiv::Osd::BufferDescriptor(0, 3, 3)) ||
+        ! std::equal(bvh.GetPatchBounds(0), bvh.GetPatchBounds(0) + 6 * bvh.GetNumPatches(),
+                     rebuilt.GetPatchBounds(0)) ||
+        ! std::equal(bvh.GetNode(0).boundsMin, bvh.GetNode(0).boundsMin + 3,
+                     rebuilt.GetNode(0).boundsMin) ||
+        ! std::equal(bvh.GetNode(0).boundsMax, bvh.GetNode(0).boundsMax + 3,
+                     rebuilt.GetNode(0).boundsMax)) {
+        printf("  patch bvh fails : refit bounds differ from those rebuilt\n");
+        ++failures;
+    } else {
+        failures += checkPatchBVHNodes(bvh);
+    }
+
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkPatchAdjacency(Shape const & shape) {
+
+    if (shape.scheme != kCatmark) return 0;
+
+    FarTopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    FarPatchTableFactory::Options patchOptions(3);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    patchOptions.generatePatchAdjacency = true;
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    if (! patchTable->HasPatchAdjacency()) {
+        printf("  patch adjacency fails : no adjacency generated\n");
+        delete patchTable;
+        delete refiner;
+        return 1;
+    }
+
+    int failures = 0;
+
+    //
+    // Each neighbor of a patch must have the patch as neighbor of the edge
+    // adjacent to it (at either half of the edge, for transition edges):
+    //
+    int numAsymmetric = 0;
+    for (int array=0, index=0; array<patchTable->GetNumPatchArrays(); ++array) {
+        int numCVs = patchTable->GetPatchArrayDescriptor(array).GetNumControlVertices();
+        for (int patch=0; patch<patchTable->GetNumPatches(array); ++patch, ++index) {
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = index;
+            handle.vertIndex  = patch * numCVs;
+
+            for (int edge=0; edge<4; ++edge) {
+                for (int half=0; half<2; ++half) {
+                    FarPatchTable::PatchHandle neighbor;
+                    int neighborEdge;
+                    if (! patchTable->GetPatchNeighbor(handle, edge, half,
+                                                       neighbor, neighborEdge)) continue;
+
+                    bool isSymmetric = false;
+                    for (int j=0; j<2; ++j) {
+                        FarPatchTable::PatchHandle back;
+                        int backEdge;
+                        if (patchTable->GetPatchNeighbor(neighbor, neighborEdge, j,
+                                                         back, backEdge)) {
+                            isSymmetric |= (back.patchIndex == index) && (backEdge == edge);
+                        }
+                    }
+                    numAsymmetric += ! isSymmetric;
+                }
+            }
+        }
+    }
+    if (numAsymmetric) {
+        printf("  patch adjacency fails : %d neighbors not adjacent in return\n",
+               numAsymmetric);
+        ++failures;
+    }
+
+    //
+    // Walking across patches must be continuous -- walking a displacement in
+    // two halves, continuing with the direction returned by the first, must
+    // reach the same point of the limit surface as walking it at once:
+    //
+    std::vector<xyzVV> controlVerts;
+    getControlVertexData(shape, controlVerts);
+
+    std::vector<xyzVV> patchPoints;
+    computePatchPoints(*refiner, *patchTable, controlVerts, patchPoints);
+
+    float tolerance = getTolerance(controlVerts);
+
+    std::vector<int> faces;
+    std::vector<float> s, t;
+    getPtexLocations(*refiner, 3, faces, s, t);
+
+    FarPatchMap patchMap(*patchTable);
+
+    int numWalked = 0, numDiscontinuous = 0;
+    for (int i=0; i<(int)faces.size(); ++i) {
+        FarPatchTable::PatchHandle const * start = patchMap.FindPatch(faces[i], s[i], t[i]);
+        if (! start) continue;
+
+        float du = 0.6f * cosf(0.7f * (float)i),
+              dv = 0.6f * sinf(0.7f * (float)i);
+
+        FarPatchTable::PatchHandle handle = *start;
+        float u = s[i], v = t[i];
+        bool isComplete = patchTable->WalkPatchCoord(handle, u, v, du, dv);
+
+        FarPatchTable::PatchHandle halfHandle = *start;
+        float halfU = s[i], halfV = t[i];
+        float halfDu = 0.5f * 0.6f * cosf(0.7f * (float)i),
+              halfDv = 0.5f * 0.6f * sinf(0.7f * (float)i);
+        isComplete &= patchTable->WalkPatchCoord(halfHandle, halfU, halfV, halfDu, halfDv);
+        isComplete &= patchTable->WalkPatchCoord(halfHandle, halfU, halfV, halfDu, halfDv);
+
+        if (! isComplete) continue;
+        ++numWalked;
+
+        xyzVV point, halfPoint;
+        evaluatePatch(*patchTable, handle, u, v, patchPoints, point);
+        evaluatePatch(*patchTable, halfHandle, halfU, halfV, patchPoints, halfPoint);
+
+        bool isContinuous = (getDistance(point, halfPoint) <= tolerance);
+        if (isContinuous && (halfHandle.patchIndex == handle.patchIndex)) {
+            isContinuous = (std::abs(du - 2.0f * halfDu) <= 1e-4f) &&
+                           (std::abs(dv - 2.0f * halfDv) <= 1e-4f);
+        }
+        numDiscontinuous += ! isContinuous;
+    }
+    if (numDiscontinuous || (numWalked == 0)) {
+        printf("  patch adjacency fails : %d of %d walks discontinuous\n",
+               numDiscontinuous, numWalked);
+        ++failures;
+    }
+
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkMesh(Shape const & shape, std::string const& name, int maxlevel) {
+
+    std::string warningDetail;
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", name.c_str(), schemes[shape.scheme]);
+
+    // Refine and interpolate vertex data for every shape:
+    std::vector<xyzVV> farVertexData;
+
+    FarTopologyRefiner * refiner = InterpolateFarVertexData<xyzVV>(shape, maxlevel, farVertexData);
+
+    // Perform relevant tests and accumulate failures:
+    int failureCount = 0;
+
+    if (areVerticesCompatibleWithHbr(shape, *refiner, &warningDetail)) {
+        failureCount = compareVerticesWithHbr(shape, *refiner, farVertexData);
+    } else {
+        printf("  warning : vertex data not compared with Hbr (%s)\n", warningDetail.c_str());
+    }
+
+    // Test Far features against reference evaluations (unless vertices of
+    // excessively high valence make them too slow):
+    if (refiner->GetMaxValence() <= 64) {
+        failureCount += checkLimitStencils(shape);
+        failureCount += checkBilinearLimitStencils(shape);
+        failureCount += checkLoopEndCaps(shape);
+        failureCount += checkEvaluatorPatchTypes(shape);
+        failureCount += checkEigenEndCaps(shape);
+        failureCount += checkStencilTopologyOnly(shape);
+        failureCount += checkLevelStencils(shape);
+        failureCount += checkParallelPrimvarRefiner(shape);
+        failureCount += checkPrimvarRefinerPlan(shape);
+        failureCount += checkFloatPrimvarRefiner(shape);
+        failureCount += checkTileRefiner(shape);
+        failureCount += checkSparseRefinement(shape);
+        failureCount += checkSparseUpdate(shape);
+        failureCount += checkVertexOrdering(shape);
+        failureCount += checkAdaptiveTolerance(shape);
+        failureCount += checkAdaptiveBudget(shape);
+        failureCount += checkCpuTessellator(shape);
+        failureCount += checkTriangleIndices(shape);
+        failureCount += checkCpuPatchBVH(shape);
+        failureCount += checkPatchAdjacency(shape);
     }
 
     return failureCount;
@@ -364,6 +3129,7 @@ int main(int /* argc */, char ** /* argv */) {
         else
           printf("Total failures : %d\n", total);
     }
+    return (total==0) ? 0 : 1;
 }
 
 //------------------------------------------------------------------------------